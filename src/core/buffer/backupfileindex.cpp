@@ -0,0 +1,133 @@
+#include "backupfileindex.h"
+
+#include <QFileInfo>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QDebug>
+
+#include <core/configmgr.h>
+#include <core/exception.h>
+#include <utils/fileutils.h>
+#include <utils/pathutils.h>
+
+#include "backupfilewriter.h"
+
+using namespace vnotex;
+
+bool BackupFileIndex::Entry::isNull() const
+{
+    return m_backupFilePath.isEmpty();
+}
+
+void BackupFileIndex::load()
+{
+    if (m_loaded) {
+        return;
+    }
+
+    m_loaded = true;
+    m_indexFilePath = PathUtils::concatenateFilePath(ConfigMgr::getInst().getUserFolder(),
+                                                     QStringLiteral("backup_index.json"));
+    if (!QFileInfo::exists(m_indexFilePath)) {
+        return;
+    }
+
+    QJsonObject jobj;
+    try {
+        jobj = FileUtils::readJsonFile(m_indexFilePath);
+    } catch (Exception &p_e) {
+        qWarning() << "failed to read backup file index" << m_indexFilePath << p_e.what();
+        return;
+    }
+
+    const auto entriesObj = jobj[QStringLiteral("entries")].toObject();
+    for (auto it = entriesObj.constBegin(); it != entriesObj.constEnd(); ++it) {
+        const auto entryObj = it.value().toObject();
+        Entry entry;
+        entry.m_backupFilePath = entryObj[QStringLiteral("backup_file")].toString();
+        entry.m_contentHash = QByteArray::fromHex(entryObj[QStringLiteral("content_hash")].toString().toLatin1());
+        if (!entry.isNull()) {
+            m_entries.insert(it.key(), entry);
+        }
+    }
+
+    const auto foldersArr = jobj[QStringLiteral("migrated_folders")].toArray();
+    for (const auto &folder : foldersArr) {
+        m_migratedFolders.insert(folder.toString());
+    }
+}
+
+void BackupFileIndex::save() const
+{
+    QJsonObject entriesObj;
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        QJsonObject entryObj;
+        entryObj[QStringLiteral("backup_file")] = it->m_backupFilePath;
+        entryObj[QStringLiteral("content_hash")] = QString::fromLatin1(it->m_contentHash.toHex());
+        entriesObj[it.key()] = entryObj;
+    }
+
+    QJsonArray foldersArr;
+    for (const auto &folder : m_migratedFolders) {
+        foldersArr.append(folder);
+    }
+
+    QJsonObject jobj;
+    jobj[QStringLiteral("entries")] = entriesObj;
+    jobj[QStringLiteral("migrated_folders")] = foldersArr;
+
+    BackupFileWriter::getInst().write(m_indexFilePath, QJsonDocument(jobj).toJson(QJsonDocument::Compact));
+}
+
+QString BackupFileIndex::toKey(const QString &p_path)
+{
+    return PathUtils::normalizePath(p_path);
+}
+
+BackupFileIndex::Entry BackupFileIndex::find(const QString &p_contentPath)
+{
+    load();
+    return m_entries.value(toKey(p_contentPath));
+}
+
+void BackupFileIndex::update(const QString &p_contentPath, const QString &p_backupFilePath, const QByteArray &p_contentHash)
+{
+    load();
+    auto &entry = m_entries[toKey(p_contentPath)];
+    if (entry.m_backupFilePath == p_backupFilePath && entry.m_contentHash == p_contentHash) {
+        return;
+    }
+
+    entry.m_backupFilePath = p_backupFilePath;
+    entry.m_contentHash = p_contentHash;
+    save();
+}
+
+void BackupFileIndex::remove(const QString &p_contentPath)
+{
+    load();
+    if (m_entries.remove(toKey(p_contentPath)) > 0) {
+        save();
+    }
+}
+
+bool BackupFileIndex::isFolderMigrated(const QString &p_folderPath)
+{
+    load();
+    return m_migratedFolders.contains(toKey(p_folderPath));
+}
+
+void BackupFileIndex::migrateFolder(const QString &p_folderPath, const QHash<QString, Entry> &p_entries)
+{
+    load();
+    for (auto it = p_entries.constBegin(); it != p_entries.constEnd(); ++it) {
+        const auto key = toKey(it.key());
+        if (!m_entries.contains(key)) {
+            m_entries.insert(key, it.value());
+        }
+    }
+
+    m_migratedFolders.insert(toKey(p_folderPath));
+    save();
+}
@@ -0,0 +1,72 @@
+#ifndef BACKUPFILEINDEX_H
+#define BACKUPFILEINDEX_H
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QByteArray>
+
+#include <core/noncopyable.h>
+
+namespace vnotex
+{
+    // Index of backup files of all buffers: content file path -> backup file and content hash.
+    // Used to locate the backup file of previous session without scanning the backup directory.
+    // Backup files written before the index existed are added by a one-time scan of each backup
+    // directory. Stored in the user config folder.
+    class BackupFileIndex : private Noncopyable
+    {
+    public:
+        struct Entry
+        {
+            bool isNull() const;
+
+            QString m_backupFilePath;
+
+            // Hash of the content recorded by the backup file.
+            // Empty if unknown, such as after journal records are appended.
+            QByteArray m_contentHash;
+        };
+
+        static BackupFileIndex &getInst()
+        {
+            static BackupFileIndex inst;
+            return inst;
+        }
+
+        // Return a null entry if not found.
+        Entry find(const QString &p_contentPath);
+
+        void update(const QString &p_contentPath, const QString &p_backupFilePath, const QByteArray &p_contentHash);
+
+        void remove(const QString &p_contentPath);
+
+        bool isFolderMigrated(const QString &p_folderPath);
+
+        // Add @p_entries (content path -> Entry) found in backup directory @p_folderPath without
+        // overriding existing ones, and mark the folder as migrated.
+        void migrateFolder(const QString &p_folderPath, const QHash<QString, Entry> &p_entries);
+
+    private:
+        BackupFileIndex() = default;
+
+        void load();
+
+        // Persist the index via BackupFileWriter to keep order with backup file writes.
+        void save() const;
+
+        static QString toKey(const QString &p_path);
+
+        bool m_loaded = false;
+
+        QString m_indexFilePath;
+
+        // Key -> Entry.
+        QHash<QString, Entry> m_entries;
+
+        // Keys of backup directories scanned for backup files written before the index.
+        QSet<QString> m_migratedFolders;
+    };
+}
+
+#endif // BACKUPFILEINDEX_H
@@ -0,0 +1,111 @@
+#include "backupfilewriter.h"
+
+#include <QFile>
+#include <QDir>
+#include <QMutexLocker>
+#include <QDebug>
+
+#include <utils/pathutils.h>
+
+using namespace vnotex;
+
+BackupFileWriter::BackupFileWriter()
+    : QThread(nullptr)
+{
+    start(QThread::LowPriority);
+}
+
+BackupFileWriter::~BackupFileWriter()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_askedToStop = true;
+        m_requestAvailable.wakeAll();
+    }
+
+    // Pending requests will be handled before the worker exits.
+    wait();
+}
+
+void BackupFileWriter::write(const QString &p_filePath, const QByteArray &p_data)
+{
+    Request req;
+    req.m_op = Operation::Write;
+    req.m_filePath = p_filePath;
+    req.m_data = p_data;
+    enqueue(req);
+}
+
+void BackupFileWriter::append(const QString &p_filePath, const QByteArray &p_data)
+{
+    Request req;
+    req.m_op = Operation::Append;
+    req.m_filePath = p_filePath;
+    req.m_data = p_data;
+    enqueue(req);
+}
+
+void BackupFileWriter::remove(const QString &p_filePath)
+{
+    Request req;
+    req.m_op = Operation::Remove;
+    req.m_filePath = p_filePath;
+    enqueue(req);
+}
+
+void BackupFileWriter::enqueue(Request p_request)
+{
+    QMutexLocker locker(&m_mutex);
+    m_requests.enqueue(p_request);
+    m_requestAvailable.wakeOne();
+}
+
+void BackupFileWriter::run()
+{
+    while (true) {
+        Request req;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_requests.isEmpty()) {
+                if (m_askedToStop) {
+                    return;
+                }
+                m_requestAvailable.wait(&m_mutex);
+            }
+
+            req = m_requests.dequeue();
+        }
+
+        handleRequest(req);
+    }
+}
+
+void BackupFileWriter::handleRequest(const Request &p_request)
+{
+    switch (p_request.m_op) {
+    case Operation::Write:
+        Q_FALLTHROUGH();
+    case Operation::Append:
+    {
+        QDir().mkpath(PathUtils::parentDirPath(p_request.m_filePath));
+        QFile file(p_request.m_filePath);
+        const auto mode = p_request.m_op == Operation::Write ? QIODevice::WriteOnly
+                                                              : QIODevice::WriteOnly | QIODevice::Append;
+        if (!file.open(mode)) {
+            qWarning() << "failed to open backup file to write" << p_request.m_filePath;
+            break;
+        }
+
+        if (file.write(p_request.m_data) != p_request.m_data.size()) {
+            qWarning() << "failed to write backup file" << p_request.m_filePath;
+        }
+        break;
+    }
+
+    case Operation::Remove:
+        if (QFile::exists(p_request.m_filePath) && !QFile::remove(p_request.m_filePath)) {
+            qWarning() << "failed to remove backup file" << p_request.m_filePath;
+        }
+        break;
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef BACKUPFILEWRITER_H
+#define BACKUPFILEWRITER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QByteArray>
+
+#include <core/noncopyable.h>
+
+namespace vnotex
+{
+    // Write backup files of buffers in a background thread.
+    // Requests are handled in FIFO order, so requests of the same file keep their order.
+    class BackupFileWriter : public QThread, private Noncopyable
+    {
+        Q_OBJECT
+    public:
+        static BackupFileWriter &getInst()
+        {
+            static BackupFileWriter inst;
+            return inst;
+        }
+
+        ~BackupFileWriter();
+
+        // Overwrite @p_filePath with @p_data.
+        void write(const QString &p_filePath, const QByteArray &p_data);
+
+        // Append @p_data to @p_filePath.
+        void append(const QString &p_filePath, const QByteArray &p_data);
+
+        void remove(const QString &p_filePath);
+
+    protected:
+        void run() Q_DECL_OVERRIDE;
+
+    private:
+        enum class Operation
+        {
+            Write,
+            Append,
+            Remove
+        };
+
+        struct Request
+        {
+            Operation m_op = Operation::Write;
+
+            QString m_filePath;
+
+            QByteArray m_data;
+        };
+
+        BackupFileWriter();
+
+        void enqueue(Request p_request);
+
+        void handleRequest(const Request &p_request);
+
+        QMutex m_mutex;
+
+        // Wake up the worker when new requests come or asked to stop.
+        QWaitCondition m_requestAvailable;
+
+        QQueue<Request> m_requests;
+
+        bool m_askedToStop = false;
+    };
+}
+
+#endif // BACKUPFILEWRITER_H
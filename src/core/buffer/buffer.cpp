@@ -1,6 +1,8 @@
 #include "buffer.h"
 
 #include <QTimer>
+#include <QFileInfo>
+#include <QCryptographicHash>
 
 #include <notebook/node.h>
 #include <utils/fileutils.h>
@@ -11,10 +13,93 @@
 #include <core/editorconfig.h>
 
 #include "bufferprovider.h"
+#include "backupfilewriter.h"
+#include "backupfileindex.h"
 #include "exception.h"
 
 using namespace vnotex;
 
+// Compact the backup journal once the appended records exceed this size or the size of the content.
+static const qint64 c_backupJournalCompactSize = 64 * 1024;
+
+// A journal record: "@<position>,<removed length>,<inserted length>\n<inserted text>\n".
+// Lengths are in QChar.
+static QByteArray generateBackupJournalRecord(int p_pos, int p_removed, const QString &p_text)
+{
+    QByteArray record = QString("@%1,%2,%3\n").arg(p_pos).arg(p_removed).arg(p_text.size()).toUtf8();
+    record += p_text.toUtf8();
+    record += '\n';
+    return record;
+}
+
+// Replay the journal records from @p_journal.
+// Stop at the first incomplete record, which may be caused by crash while writing.
+static QString replayBackupJournal(const QString &p_journal)
+{
+    QString content;
+    int idx = 0;
+    while (idx < p_journal.size() && p_journal[idx] == QLatin1Char('@')) {
+        const int lineEnd = p_journal.indexOf(QLatin1Char('\n'), idx);
+        if (lineEnd == -1) {
+            break;
+        }
+
+        const auto fields = p_journal.midRef(idx + 1, lineEnd - idx - 1).split(QLatin1Char(','));
+        if (fields.size() != 3) {
+            break;
+        }
+
+        bool ok1 = false, ok2 = false, ok3 = false;
+        const int pos = fields[0].toInt(&ok1);
+        const int removed = fields[1].toInt(&ok2);
+        const int len = fields[2].toInt(&ok3);
+        if (!ok1 || !ok2 || !ok3
+            || pos < 0 || removed < 0 || len < 0
+            || pos + removed > content.size()
+            || lineEnd + 1 + len > p_journal.size()) {
+            qWarning() << "skip incomplete backup journal record at" << idx;
+            break;
+        }
+
+        content.replace(pos, removed, p_journal.mid(lineEnd + 1, len));
+        idx = lineEnd + 1 + len + 1;
+    }
+
+    return content;
+}
+
+static const QString c_backupFileHeadPrefix = QStringLiteral("vnotex_backup_journal ");
+
+// Legacy format with the whole content.
+static const QString c_legacyBackupFileHeadPrefix = QStringLiteral("vnotex_backup_file ");
+
+// Parse the data of a backup file "<head prefix><content path>|<body>" into @p_content.
+// Return false if it is not a backup file.
+static bool parseBackupFile(const QString &p_data, QString &p_content, QString *p_contentPath = nullptr)
+{
+    const bool isJournal = p_data.startsWith(c_backupFileHeadPrefix);
+    if (!isJournal && !p_data.startsWith(c_legacyBackupFileHeadPrefix)) {
+        return false;
+    }
+
+    const int idx = p_data.indexOf(QLatin1Char('|'));
+    if (idx == -1) {
+        return false;
+    }
+
+    if (p_contentPath) {
+        const int prefixSize = isJournal ? c_backupFileHeadPrefix.size() : c_legacyBackupFileHeadPrefix.size();
+        *p_contentPath = p_data.mid(prefixSize, idx - prefixSize);
+    }
+
+    if (isJournal) {
+        p_content = replayBackupJournal(p_data.mid(idx + 1));
+    } else {
+        p_content = p_data.mid(idx + 1);
+    }
+    return true;
+}
+
 static vnotex::ID generateBufferID()
 {
     static vnotex::ID id = 0;
@@ -34,6 +119,14 @@ Buffer::Buffer(const BufferParameters &p_parameters,
     connect(m_autoSaveTimer, &QTimer::timeout,
             this, &Buffer::autoSave);
 
+    {
+        const qint64 threshold = ConfigMgr::getInst().getEditorConfig().getLargeFileSizeThreshold();
+        m_largeFile = threshold > 0 && QFileInfo(getContentPath()).size() >= threshold * 1024 * 1024;
+        if (m_largeFile) {
+            qInfo() << "open buffer in large file mode" << getContentPath();
+        }
+    }
+
     readContent();
 
     checkBackupFileOfPreviousSession();
@@ -118,15 +211,51 @@ ID Buffer::getId() const
 
 const QString &Buffer::getContent() const
 {
-    const_cast<Buffer *>(this)->syncContent();
+    auto buffer = const_cast<Buffer *>(this);
+    buffer->syncContent();
+    if (!m_contentCached) {
+        buffer->m_content = m_provider->read();
+        buffer->m_contentCached = true;
+    }
     return m_content;
 }
 
+void Buffer::readContentInChunks(const std::function<bool(const QString &)> &p_func) const
+{
+    if (m_contentCached || m_viewWindowToSync) {
+        p_func(getContent());
+        return;
+    }
+
+    if (!m_provider->readInChunks(p_func)) {
+        // Fall back to read it as a whole.
+        p_func(getContent());
+    }
+}
+
+bool Buffer::isLargeFile() const
+{
+    return m_largeFile;
+}
+
+void Buffer::suspendAutoSave()
+{
+    ++m_autoSaveSuspendCount;
+}
+
+void Buffer::resumeAutoSave()
+{
+    Q_ASSERT(m_autoSaveSuspendCount > 0);
+    --m_autoSaveSuspendCount;
+}
+
 void Buffer::setContent(const QString &p_content, int &p_revision)
 {
     m_viewWindowToSync = nullptr;
     m_content = p_content;
+    m_contentCached = true;
     p_revision = ++m_revision;
+    m_backupFullWriteNeeded = true;
     setModified(true);
     m_autoSaveTimer->start();
     emit contentsChanged();
@@ -160,6 +289,7 @@ void Buffer::syncContent()
     if (m_viewWindowToSync) {
         // Need to sync content.
         m_content = m_viewWindowToSync->getLatestContent();
+        m_contentCached = true;
         m_viewWindowToSync = nullptr;
     }
 }
@@ -219,6 +349,11 @@ Buffer::OperationCode Buffer::save(bool p_force)
 
         setModified(false);
         m_state &= ~(StateFlag::FileMissingOnDisk | StateFlag::FileChangedOutside);
+
+        // Nothing left to back up. Keeps the hash in BackupFileIndex meaningful.
+        clearBackupFile();
+
+        releaseContentOfLargeFile();
     }
     return OperationCode::Success;
 }
@@ -234,6 +369,7 @@ Buffer::OperationCode Buffer::reload()
     if (m_modified
         || m_state & (StateFlag::FileMissingOnDisk | StateFlag::FileChangedOutside)) {
         readContent();
+        m_backupFullWriteNeeded = true;
 
         emit modified(m_modified);
         emit contentsChanged();
@@ -243,7 +379,14 @@ Buffer::OperationCode Buffer::reload()
 
 void Buffer::readContent()
 {
-    m_content = m_provider->read();
+    if (m_largeFile) {
+        // Do not hold the content. It will be read on demand or streamed via readContentInChunks().
+        m_content = QString();
+        m_contentCached = false;
+    } else {
+        m_content = m_provider->read();
+        m_contentCached = true;
+    }
     ++m_revision;
 
     // Reset state.
@@ -251,12 +394,23 @@ void Buffer::readContent()
     m_modified = false;
 }
 
+void Buffer::releaseContentOfLargeFile()
+{
+    if (!m_largeFile || m_modified || m_viewWindowToSync || !m_contentCached) {
+        return;
+    }
+
+    m_content = QString();
+    m_contentCached = false;
+}
+
 void Buffer::discard()
 {
     Q_ASSERT(!(m_state & StateFlag::Discarded));
     Q_ASSERT(m_attachedViewWindowCount == 1);
     m_autoSaveTimer->stop();
     m_content.clear();
+    m_contentCached = true;
     m_state |= StateFlag::Discarded;
     ++m_revision;
 
@@ -268,10 +422,23 @@ void Buffer::close()
 {
     // Delete the backup file if exists.
     m_autoSaveTimer->stop();
-    if (!m_backupFilePath.isEmpty()) {
-        FileUtils::removeFile(m_backupFilePath);
-        m_backupFilePath.clear();
+    clearBackupFile();
+}
+
+void Buffer::clearBackupFile()
+{
+    if (m_backupFilePath.isEmpty()) {
+        return;
     }
+
+    removeBackupFile(m_backupFilePath);
+    m_backupFilePath.clear();
+    m_backupJournalSize = 0;
+    m_backupContentSize = 0;
+    m_backupFullWriteNeeded = false;
+    m_backupDirtyPosition = -1;
+    m_backupDirtyRemoved = 0;
+    m_backupDirtyAdded = 0;
 }
 
 QString Buffer::getImageFolderPath() const
@@ -308,6 +475,12 @@ void Buffer::autoSave()
         return;
     }
 
+    if (m_autoSaveSuspendCount > 0) {
+        // Retry later.
+        m_autoSaveTimer->start();
+        return;
+    }
+
     if (m_state & (StateFlag::FileMissingOnDisk | StateFlag::FileChangedOutside)) {
         qDebug() << "disable AutoSave due to file missing on disk or changed outside";
         return;
@@ -338,27 +511,129 @@ void Buffer::autoSave()
 
 void Buffer::writeBackupFile()
 {
+    bool needCompact = false;
     if (m_backupFilePath.isEmpty()) {
         const auto &config = ConfigMgr::getInst().getEditorConfig();
-        QString backupDirPath(QDir(getResourcePath()).filePath(config.getBackupFileDirectory()));
-        backupDirPath = QDir::cleanPath(backupDirPath);
+        const auto backupDirPath = getBackupDirectoryPath();
         auto backupFileName = FileUtils::generateFileNameWithSequence(backupDirPath,
                                                                       getName(),
                                                                       config.getBackupFileExtension());
         QDir backupDir(backupDirPath);
         backupDir.mkpath(backupDirPath);
         m_backupFilePath = backupDir.filePath(backupFileName);
+        needCompact = true;
     }
 
     Q_ASSERT(m_backupFilePathOfPreviousSession.isEmpty());
 
-    // Just use FileUtils instead of notebook backend.
-    FileUtils::writeFile(m_backupFilePath, generateBackupFileHead() + getContent());
+    if (m_backupFullWriteNeeded
+        || m_backupJournalSize > qMax<qint64>(c_backupJournalCompactSize, m_backupContentSize)) {
+        needCompact = true;
+    }
+
+    QString text;
+    if (!needCompact) {
+        if (m_backupDirtyPosition == -1) {
+            // Nothing changed.
+            return;
+        }
+
+        text = getLatestContentRange(m_backupDirtyPosition, m_backupDirtyAdded);
+        if (text.size() != m_backupDirtyAdded
+            || (!text.isEmpty() && (text[0].isLowSurrogate() || text[text.size() - 1].isHighSurrogate()))) {
+            // Not available or splitting a surrogate pair.
+            needCompact = true;
+        }
+    }
+
+    // Just use BackupFileWriter instead of notebook backend.
+    auto &writer = BackupFileWriter::getInst();
+    auto &index = BackupFileIndex::getInst();
+    if (needCompact) {
+        const auto &content = getContent();
+        QByteArray data = generateBackupFileHead().toUtf8();
+        data += generateBackupJournalRecord(0, 0, content);
+        writer.write(m_backupFilePath, data);
+        m_backupJournalSize = 0;
+        m_backupContentSize = content.size();
+
+        // The whole content is at hand only on compaction.
+        index.update(getContentPath(), m_backupFilePath, calculateContentHash(content));
+    } else {
+        const auto record = generateBackupJournalRecord(m_backupDirtyPosition, m_backupDirtyRemoved, text);
+        m_backupJournalSize += record.size();
+        m_backupContentSize += m_backupDirtyAdded - m_backupDirtyRemoved;
+        writer.append(m_backupFilePath, record);
+
+        // The index is saved only on the first append after compaction.
+        index.update(getContentPath(), m_backupFilePath, QByteArray());
+    }
+
+    m_backupFullWriteNeeded = false;
+    m_backupDirtyPosition = -1;
+    m_backupDirtyRemoved = 0;
+    m_backupDirtyAdded = 0;
+}
+
+QString Buffer::getLatestContentRange(int p_position, int p_length) const
+{
+    if (m_viewWindowToSync) {
+        return m_viewWindowToSync->getLatestContent(p_position, p_length);
+    }
+
+    if (!m_contentCached) {
+        return QString();
+    }
+
+    return m_content.mid(p_position, p_length);
+}
+
+void Buffer::recordContentsChange(int p_position, int p_removed, int p_added)
+{
+    if (m_backupFilePath.isEmpty() || m_backupFullWriteNeeded) {
+        // The whole content will be written.
+        return;
+    }
+
+    // QTextDocument may count in the implicit paragraph separator at the end.
+    const int size = m_backupContentSize - m_backupDirtyRemoved + m_backupDirtyAdded;
+    const int excess = p_position + p_removed - size;
+    if (excess > 0) {
+        p_removed -= excess;
+        p_added -= excess;
+    }
+
+    if (p_position < 0 || p_removed < 0 || p_added < 0) {
+        qWarning() << "invalid contents change" << p_position << p_removed << p_added;
+        m_backupFullWriteNeeded = true;
+        return;
+    }
+
+    if (m_backupDirtyPosition == -1) {
+        m_backupDirtyPosition = p_position;
+        m_backupDirtyRemoved = p_removed;
+        m_backupDirtyAdded = p_added;
+        return;
+    }
+
+    // Merge into one range covering both changes in terms of the latest content.
+    const int dirtyEnd = m_backupDirtyPosition + m_backupDirtyAdded;
+    const int start = qMin(m_backupDirtyPosition, p_position);
+    const int end = qMax(dirtyEnd, p_position + p_removed);
+    m_backupDirtyRemoved += (m_backupDirtyPosition - start) + (end - dirtyEnd);
+    m_backupDirtyAdded = end - start - p_removed + p_added;
+    m_backupDirtyPosition = start;
 }
 
 QString Buffer::generateBackupFileHead() const
 {
-    return QString("vnotex_backup_file %1|").arg(getContentPath());
+    return QString("%1%2|").arg(c_backupFileHeadPrefix, getContentPath());
+}
+
+QString Buffer::getBackupDirectoryPath() const
+{
+    const auto &config = ConfigMgr::getInst().getEditorConfig();
+    return QDir::cleanPath(QDir(getResourcePath()).filePath(config.getBackupFileDirectory()));
 }
 
 void Buffer::checkBackupFileOfPreviousSession()
@@ -368,48 +643,90 @@ void Buffer::checkBackupFileOfPreviousSession()
         return;
     }
 
-    QString backupDirPath(QDir(getResourcePath()).filePath(config.getBackupFileDirectory()));
-    backupDirPath = QDir::cleanPath(backupDirPath);
-    QDir backupDir(backupDirPath);
-    QStringList backupFiles;
-    {
-        const QString nameFilter = QString("%1*%2").arg(getName(), config.getBackupFileExtension());
-        backupFiles = backupDir.entryList(QStringList(nameFilter),
-                                          QDir::Files | QDir::Hidden | QDir::NoSymLinks | QDir::NoDotAndDotDot);
+    migrateBackupFilesOfPreviousVersions();
+
+    auto &index = BackupFileIndex::getInst();
+    const auto entry = index.find(getContentPath());
+    if (entry.isNull()) {
+        return;
+    }
+
+    if (!QFileInfo::exists(entry.m_backupFilePath)) {
+        index.remove(getContentPath());
+        return;
     }
 
-    if (backupFiles.isEmpty()) {
+    if (!entry.m_contentHash.isEmpty() && entry.m_contentHash == calculateContentHash()) {
+        // Found backup file with identical content.
+        // Just discard the backup file.
+        removeBackupFile(entry.m_backupFilePath);
+        qInfo() << "delete identical backup file of previous session" << entry.m_backupFilePath;
+    } else {
+        m_backupFilePathOfPreviousSession = entry.m_backupFilePath;
+        qInfo() << "found backup file of previous session" << entry.m_backupFilePath;
+    }
+}
+
+void Buffer::migrateBackupFilesOfPreviousVersions() const
+{
+    auto &index = BackupFileIndex::getInst();
+    const auto backupDirPath = getBackupDirectoryPath();
+    if (index.isFolderMigrated(backupDirPath)) {
         return;
     }
 
+    // Backup files are named after their notes, so the whole directory is scanned once.
+    QHash<QString, BackupFileIndex::Entry> entries;
+    const auto &config = ConfigMgr::getInst().getEditorConfig();
+    QDir backupDir(backupDirPath);
+    const auto backupFiles = backupDir.entryList(QStringList(QStringLiteral("*") + config.getBackupFileExtension()),
+                                                 QDir::Files | QDir::Hidden | QDir::NoSymLinks | QDir::NoDotAndDotDot);
     for (const auto &file : backupFiles) {
         const auto filePath = backupDir.filePath(file);
-        if (isBackupFileOfBuffer(filePath)) {
-            const auto backupContent = readBackupFile(filePath);
-            if (backupContent == getContent()) {
-                // Found backup file with identical content.
-                // Just discard the backup file.
-                FileUtils::removeFile(filePath);
-                qInfo() << "delete identical backup file of previous session" << filePath;
-            } else {
-                m_backupFilePathOfPreviousSession = filePath;
-                qInfo() << "found backup file of previous session" << filePath;
-            }
-            break;
+        QString data;
+        try {
+            data = FileUtils::readTextFile(filePath);
+        } catch (Exception &p_e) {
+            qWarning() << "failed to read backup file" << filePath << p_e.what();
+            continue;
+        }
+
+        QString content;
+        QString contentPath;
+        if (!parseBackupFile(data, content, &contentPath) || contentPath.isEmpty()) {
+            continue;
         }
+
+        BackupFileIndex::Entry entry;
+        entry.m_backupFilePath = filePath;
+        entry.m_contentHash = calculateContentHash(content);
+        entries.insert(contentPath, entry);
     }
+
+    qInfo() << "migrated" << entries.size() << "backup files of previous versions in" << backupDirPath;
+    index.migrateFolder(backupDirPath, entries);
 }
 
-bool Buffer::isBackupFileOfBuffer(const QString &p_file) const
+QByteArray Buffer::calculateContentHash() const
 {
-    QFile file(p_file);
-    if (!file.open(QFile::ReadOnly | QIODevice::Text)) {
-        return false;
-    }
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    readContentInChunks([&hash](const QString &p_chunk) {
+        hash.addData(p_chunk.toUtf8());
+        return true;
+    });
+    return hash.result();
+}
+
+QByteArray Buffer::calculateContentHash(const QString &p_content)
+{
+    return QCryptographicHash::hash(p_content.toUtf8(), QCryptographicHash::Md5);
+}
 
-    QTextStream st(&file);
-    const auto head = st.readLine();
-    return head.startsWith(generateBackupFileHead());
+void Buffer::removeBackupFile(const QString &p_filePath)
+{
+    // Go through the writer to keep the order with pending writes and avoid blocking.
+    BackupFileWriter::getInst().remove(p_filePath);
+    BackupFileIndex::getInst().remove(getContentPath());
 }
 
 const QString &Buffer::getBackupFileOfPreviousSession() const
@@ -419,15 +736,18 @@ const QString &Buffer::getBackupFileOfPreviousSession() const
 
 QString Buffer::readBackupFile(const QString &p_filePath)
 {
-    auto content = FileUtils::readTextFile(p_filePath);
-    return content.mid(content.indexOf(QLatin1Char('|')) + 1);
+    QString content;
+    if (!parseBackupFile(FileUtils::readTextFile(p_filePath), content)) {
+        qWarning() << "invalid backup file" << p_filePath;
+    }
+    return content;
 }
 
 void Buffer::discardBackupFileOfPreviousSession()
 {
     Q_ASSERT(!m_backupFilePathOfPreviousSession.isEmpty());
 
-    FileUtils::removeFile(m_backupFilePathOfPreviousSession);
+    removeBackupFile(m_backupFilePathOfPreviousSession);
     qInfo() << "discard backup file of previous session" << m_backupFilePathOfPreviousSession;
     m_backupFilePathOfPreviousSession.clear();
 }
@@ -437,10 +757,11 @@ void Buffer::recoverFromBackupFileOfPreviousSession()
     Q_ASSERT(!m_backupFilePathOfPreviousSession.isEmpty());
 
     m_content = readBackupFile(m_backupFilePathOfPreviousSession);
+    m_contentCached = true;
     m_provider->write(m_content);
     ++m_revision;
 
-    FileUtils::removeFile(m_backupFilePathOfPreviousSession);
+    removeBackupFile(m_backupFilePathOfPreviousSession);
     qInfo() << "recover from backup file of previous session" << m_backupFilePathOfPreviousSession;
     m_backupFilePathOfPreviousSession.clear();
 
@@ -448,6 +769,8 @@ void Buffer::recoverFromBackupFileOfPreviousSession()
     m_viewWindowToSync = nullptr;
     m_modified = false;
 
+    releaseContentOfLargeFile();
+
     emit modified(m_modified);
     emit contentsChanged();
 }
@@ -95,6 +95,21 @@ namespace vnotex
         // the latest content.
         const QString &getContent() const;
 
+        // Read buffer content chunk by chunk.
+        // In large file mode, content will be streamed from the file on disk if possible,
+        // so that callers could load the content incrementally without another full copy.
+        // Return false in @p_func to stop reading.
+        void readContentInChunks(const std::function<bool(const QString &)> &p_func) const;
+
+        // Whether this buffer is opened in large file mode, in which content is loaded
+        // on demand and heavy features like highlight and preview are disabled.
+        bool isLargeFile() const;
+
+        // Hold back AutoSave, such as while a view window is loading the content and
+        // holds a partial document. Calls could be nested.
+        void suspendAutoSave();
+        void resumeAutoSave();
+
         // @p_revision will be set before contentsChanged is emitted.
         void setContent(const QString &p_content, int &p_revision);
 
@@ -107,6 +122,10 @@ namespace vnotex
         // Sync content with @p_win if @p_win is the window needed to sync.
         void syncContent(const ViewWindow *p_win);
 
+        // Record that @p_removed QChars at @p_position of the content are replaced by
+        // @p_added ones, so that the backup file could append only the changed range.
+        void recordContentsChange(int p_position, int p_removed, int p_added);
+
         int getRevision() const;
 
         bool isModified() const;
@@ -207,14 +226,41 @@ namespace vnotex
         // Get the path of the image folder.
         QString getImageFolderPath() const;
 
+        // Backup file is a journal of edits. The first write and compaction write the
+        // whole content while others append only the delta since last write.
+        // The I/O is done by BackupFileWriter in background.
         void writeBackupFile();
 
+        // Get the range of the latest content without a full copy.
+        // Return a null string if not available.
+        QString getLatestContentRange(int p_position, int p_length) const;
+
         // Generate backup file head.
         QString generateBackupFileHead() const;
 
+        QString getBackupDirectoryPath() const;
+
+        // Look up BackupFileIndex for the backup file of previous session and compare the
+        // content hash recorded there.
         void checkBackupFileOfPreviousSession();
 
-        bool isBackupFileOfBuffer(const QString &p_file) const;
+        // Add backup files written before BackupFileIndex existed to the index.
+        // Done once per backup directory.
+        void migrateBackupFilesOfPreviousVersions() const;
+
+        // Remove backup file @p_filePath in background and drop it from the index.
+        void removeBackupFile(const QString &p_filePath);
+
+        // Remove the backup file of current session if exists and reset its state.
+        void clearBackupFile();
+
+        // Hash of the content, streaming it in large file mode.
+        QByteArray calculateContentHash() const;
+
+        static QByteArray calculateContentHash(const QString &p_content);
+
+        // In large file mode, drop the cached content if it is identical to the file on disk.
+        void releaseContentOfLargeFile();
 
         // Will be assigned uniquely once created.
         const ID m_id = 0;
@@ -226,6 +272,15 @@ namespace vnotex
         // of the file content.
         QString m_content;
 
+        // Whether m_content holds the content.
+        // It may be false only in large file mode, in which content is read on demand.
+        bool m_contentCached = true;
+
+        bool m_largeFile = false;
+
+        // Nesting count of suspendAutoSave().
+        int m_autoSaveSuspendCount = 0;
+
         bool m_readOnly = false;
 
         bool m_modified = false;
@@ -239,6 +294,23 @@ namespace vnotex
 
         QString m_backupFilePath;
 
+        // Size in QChar of the content recorded by the backup file.
+        int m_backupContentSize = 0;
+
+        // Range changed since last write of the backup file. @m_backupDirtyRemoved is the
+        // length in the content recorded by the backup file while @m_backupDirtyAdded is the
+        // length in the latest content. -1 position if nothing changed.
+        int m_backupDirtyPosition = -1;
+        int m_backupDirtyRemoved = 0;
+        int m_backupDirtyAdded = 0;
+
+        // Whether the whole content should be written on next backup, such as when the content
+        // is replaced without recorded changes.
+        bool m_backupFullWriteNeeded = false;
+
+        // Size of the journal records appended since last compaction.
+        qint64 m_backupJournalSize = 0;
+
         QString m_backupFilePathOfPreviousSession;
 
         StateFlags m_state = StateFlag::Normal;
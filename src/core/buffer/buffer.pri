@@ -1,4 +1,6 @@
 SOURCES += \
+    $$PWD/backupfileindex.cpp \
+    $$PWD/backupfilewriter.cpp \
     $$PWD/buffer.cpp \
     $$PWD/bufferprovider.cpp \
     $$PWD/filebufferprovider.cpp \
@@ -10,6 +12,8 @@ SOURCES += \
     $$PWD/textbufferfactory.cpp
 
 HEADERS += \
+    $$PWD/backupfileindex.h \
+    $$PWD/backupfilewriter.h \
     $$PWD/bufferprovider.h \
     $$PWD/buffer.h \
     $$PWD/filebufferprovider.h \
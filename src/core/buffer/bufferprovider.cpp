@@ -1,9 +1,15 @@
 #include "bufferprovider.h"
 
 #include <QFileInfo>
+#include <QFile>
+#include <QTextCodec>
+#include <QDebug>
 
 using namespace vnotex;
 
+// Size in bytes of each chunk to decode.
+static const qint64 c_chunkSize = 4 * 1024 * 1024;
+
 bool BufferProvider::checkFileExistsOnDisk() const
 {
     return QFileInfo::exists(getContentPath());
@@ -22,3 +28,66 @@ bool BufferProvider::checkFileChangedOutside() const
     }
     return false;
 }
+
+bool BufferProvider::readInChunks(const std::function<bool(const QString &)> &p_func) const
+{
+    QFile file(getContentPath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "failed to open file to read in chunks" << getContentPath();
+        return false;
+    }
+
+    const_cast<BufferProvider *>(this)->m_lastModified = getLastModifiedFromFile();
+
+    const qint64 size = file.size();
+    if (size == 0) {
+        return true;
+    }
+
+    // Map the file to avoid reading it into a buffer. Fall back to plain read if not supported.
+    // The mapping will be released when @file is destroyed.
+    const uchar *data = file.map(0, size);
+    QByteArray fallbackData;
+    if (!data) {
+        qWarning() << "failed to map file, fall back to read in chunks" << getContentPath();
+    }
+
+    // The decoder will keep incomplete multi-byte sequence between chunks.
+    QScopedPointer<QTextDecoder> decoder(QTextCodec::codecForName("UTF-8")->makeDecoder());
+    QString pending;
+    qint64 offset = 0;
+    while (offset < size) {
+        const qint64 len = qMin(c_chunkSize, size - offset);
+        if (data) {
+            pending += decoder->toUnicode(reinterpret_cast<const char *>(data + offset), static_cast<int>(len));
+        } else {
+            fallbackData = file.read(len);
+            if (fallbackData.isEmpty()) {
+                break;
+            }
+            pending += decoder->toUnicode(fallbackData);
+        }
+        offset += len;
+
+        if (offset >= size) {
+            break;
+        }
+
+        // Only hand out complete lines.
+        const int idx = pending.lastIndexOf(QLatin1Char('\n'));
+        if (idx == -1) {
+            continue;
+        }
+
+        const QString chunk = pending.left(idx + 1);
+        pending.remove(0, idx + 1);
+        if (!p_func(chunk)) {
+            return true;
+        }
+    }
+
+    if (!pending.isEmpty()) {
+        p_func(pending);
+    }
+    return true;
+}
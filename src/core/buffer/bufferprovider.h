@@ -4,6 +4,8 @@
 #include <QObject>
 #include <QDateTime>
 
+#include <functional>
+
 #include "buffer.h"
 
 namespace vnotex
@@ -40,6 +42,12 @@ namespace vnotex
 
         virtual QString read() const = 0;
 
+        // Read the content file chunk by chunk without holding the whole content.
+        // Each chunk ends at a line boundary except the last one.
+        // Return false in @p_func to stop reading.
+        // Return false if failed to read the file.
+        virtual bool readInChunks(const std::function<bool(const QString &)> &p_func) const;
+
         virtual QString fetchImageFolderPath() = 0;
 
         virtual bool isChildOf(const Node *p_node) const = 0;
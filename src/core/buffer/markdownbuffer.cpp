@@ -3,6 +3,7 @@
 #include <QDir>
 
 #include <widgets/markdownviewwindow.h>
+#include <widgets/textviewwindow.h>
 #include <notebook/node.h>
 #include <utils/pathutils.h>
 #include <buffer/bufferprovider.h>
@@ -19,6 +20,10 @@ MarkdownBuffer::MarkdownBuffer(const BufferParameters &p_parameters,
 ViewWindow *MarkdownBuffer::createViewWindowInternal(const QSharedPointer<FileOpenParameters> &p_paras, QWidget *p_parent)
 {
     Q_UNUSED(p_paras);
+    if (isLargeFile()) {
+        // Use a plain text view window without highlight, in-place preview and web preview.
+        return new TextViewWindow(p_parent);
+    }
     return new MarkdownViewWindow(p_parent);
 }
 
@@ -35,6 +40,11 @@ QString MarkdownBuffer::insertImage(const QImage &p_image, const QString &p_imag
 void MarkdownBuffer::fetchInitialImages()
 {
     Q_ASSERT(m_initialImages.isEmpty());
+    if (isLargeFile()) {
+        // Avoid parsing the whole content on open.
+        return;
+    }
+
     // There is compilation error on Linux and macOS using TypeFlags directly.
     int linkFlags = vte::MarkdownLink::TypeFlag::LocalRelativeInternal | vte::MarkdownLink::TypeFlag::Remote;
     m_initialImages = vte::MarkdownUtils::fetchImagesFromMarkdownText(getContent(),
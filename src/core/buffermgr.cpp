@@ -148,6 +148,17 @@ void BufferMgr::open(const QString &p_filePath, const QSharedPointer<FileOpenPar
     emit bufferRequested(buffer, p_paras);
 }
 
+QVector<Buffer *> BufferMgr::getModifiedBuffers() const
+{
+    QVector<Buffer *> buffers;
+    for (auto buffer : m_buffers) {
+        if (buffer->isModified()) {
+            buffers.push_back(buffer);
+        }
+    }
+    return buffers;
+}
+
 Buffer *BufferMgr::findBuffer(const Node *p_node) const
 {
     auto it = std::find_if(m_buffers.constBegin(),
@@ -25,6 +25,9 @@ namespace vnotex
 
         void init();
 
+        // Buffers with unsaved changes.
+        QVector<Buffer *> getModifiedBuffers() const;
+
     public slots:
         void open(Node *p_node, const QSharedPointer<FileOpenParameters> &p_paras);
 
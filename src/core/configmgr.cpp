@@ -467,6 +467,20 @@ QString ConfigMgr::getUserSnippetFolder() const
     return folderPath;
 }
 
+QString ConfigMgr::getUserGraphCacheFolder() const
+{
+    auto folderPath = PathUtils::concatenateFilePath(m_userConfigFolderPath, QStringLiteral("graph_cache"));
+    QDir().mkpath(folderPath);
+    return folderPath;
+}
+
+QString ConfigMgr::getUserRenderSnapshotCacheFolder() const
+{
+    auto folderPath = PathUtils::concatenateFilePath(m_userConfigFolderPath, QStringLiteral("render_cache"));
+    QDir().mkpath(folderPath);
+    return folderPath;
+}
+
 QString ConfigMgr::getUserMarkdownUserStyleFile() const
 {
     auto folderPath = PathUtils::concatenateFilePath(m_userConfigFolderPath, QStringLiteral("web/css"));
@@ -97,6 +97,12 @@ namespace vnotex
 
         QString getUserSnippetFolder() const;
 
+        // Cache of rendered graphs.
+        QString getUserGraphCacheFolder() const;
+
+        // Cache of rendered HTML of notes.
+        QString getUserRenderSnapshotCacheFolder() const;
+
         // web/css/user.css.
         QString getUserMarkdownUserStyleFile() const;
 
@@ -16,6 +16,10 @@ SOURCES += \
     $$PWD/coreconfig.cpp \
     $$PWD/editorconfig.cpp \
     $$PWD/externalfile.cpp \
+    $$PWD/disklrucache.cpp \
+    $$PWD/graphcache.cpp \
+    $$PWD/rendersnapshotcache.cpp \
+    $$PWD/imagefetcher.cpp \
     $$PWD/file.cpp \
     $$PWD/historyitem.cpp \
     $$PWD/historymgr.cpp \
@@ -45,6 +49,10 @@ HEADERS += \
     $$PWD/file.h \
     $$PWD/filelocator.h \
     $$PWD/fileopenparameters.h \
+    $$PWD/disklrucache.h \
+    $$PWD/graphcache.h \
+    $$PWD/rendersnapshotcache.h \
+    $$PWD/imagefetcher.h \
     $$PWD/historyitem.h \
     $$PWD/historymgr.h \
     $$PWD/htmltemplatehelper.h \
@@ -68,4 +76,5 @@ HEADERS += \
     $$PWD/sessionconfig.h \
     $$PWD/clipboarddata.h \
     $$PWD/webresource.h \
+    $$PWD/imagetranscodeoption.h \
     $$PWD/widgetconfig.h
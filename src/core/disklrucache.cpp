@@ -0,0 +1,280 @@
+#include "disklrucache.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QThread>
+#include <QMutexLocker>
+#include <QVector>
+#include <QDebug>
+
+#include <algorithm>
+
+#include <utils/pathutils.h>
+
+using namespace vnotex;
+
+// Persist the access time of a file at most once a day, which is precise enough for LRU.
+static const qint64 c_accessTimeGranularity = 24 * 60 * 60 * 1000;
+
+// Persist access times once there are so many pending.
+static const int c_maxPendingAccessTimes = 64;
+
+DiskLruCache::DiskLruCache(const QString &p_name)
+    : m_name(p_name)
+{
+}
+
+DiskLruCache::~DiskLruCache()
+{
+    if (m_scanThread) {
+        m_scanThread->wait();
+        delete m_scanThread;
+        m_scanThread = nullptr;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    persistAccessTimesLocked();
+}
+
+void DiskLruCache::init(const QString &p_folderPath, qint64 p_maxSize)
+{
+    Q_ASSERT(!isInitialized());
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_folderPath = p_folderPath;
+        m_maxSize = p_maxSize;
+        m_scanning = true;
+    }
+
+    m_scanThread = QThread::create([this]() {
+        scan();
+    });
+    m_scanThread->start(QThread::LowPriority);
+}
+
+bool DiskLruCache::isInitialized() const
+{
+    QMutexLocker locker(&m_mutex);
+    return !m_folderPath.isEmpty();
+}
+
+void DiskLruCache::scan()
+{
+    const auto files = QDir(m_folderPath).entryInfoList(QDir::Files);
+
+    QMutexLocker locker(&m_mutex);
+    for (const auto &finfo : files) {
+        const auto key = finfo.fileName();
+        if (m_entries.contains(key) || m_removedWhileScanning.contains(key)) {
+            continue;
+        }
+
+        Entry entry;
+        entry.m_size = finfo.size();
+        entry.m_lastAccessed = finfo.lastModified().toMSecsSinceEpoch();
+        entry.m_persistedAccessed = entry.m_lastAccessed;
+        m_entries.insert(key, entry);
+        m_totalSize += entry.m_size;
+    }
+
+    m_scanning = false;
+    m_removedWhileScanning.clear();
+
+    evictLocked();
+}
+
+void DiskLruCache::setMaxSize(qint64 p_maxSize)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_maxSize == p_maxSize) {
+        return;
+    }
+
+    m_maxSize = p_maxSize;
+    if (!m_scanning) {
+        evictLocked();
+    }
+}
+
+qint64 DiskLruCache::getMaxSize() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_maxSize;
+}
+
+qint64 DiskLruCache::getTotalSize() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_totalSize;
+}
+
+QString DiskLruCache::getFilePath(const QString &p_key) const
+{
+    return PathUtils::concatenateFilePath(m_folderPath, p_key);
+}
+
+QByteArray DiskLruCache::read(const QString &p_key)
+{
+    QFile file(getFilePath(p_key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        QMutexLocker locker(&m_mutex);
+        if (m_entries.contains(p_key)) {
+            qWarning() << "failed to read" << m_name << "cache" << file.fileName() << file.errorString();
+            removeEntryLocked(p_key);
+        }
+        return QByteArray();
+    }
+
+    const auto data = file.readAll();
+    file.close();
+
+    QMutexLocker locker(&m_mutex);
+    touchLocked(p_key, data.size());
+    return data;
+}
+
+bool DiskLruCache::write(const QString &p_key, const QByteArray &p_data)
+{
+    QFile file(getFilePath(p_key));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "failed to write" << m_name << "cache" << file.fileName() << file.errorString();
+        return false;
+    }
+
+    if (file.write(p_data) != p_data.size()) {
+        qWarning() << "failed to write" << m_name << "cache" << file.fileName() << file.errorString();
+        file.close();
+        remove(p_key);
+        return false;
+    }
+
+    file.close();
+    add(p_key, p_data.size());
+    return true;
+}
+
+void DiskLruCache::remove(const QString &p_key)
+{
+    QFile::remove(getFilePath(p_key));
+
+    QMutexLocker locker(&m_mutex);
+    removeEntryLocked(p_key);
+    if (m_scanning) {
+        m_removedWhileScanning.insert(p_key);
+    }
+}
+
+void DiskLruCache::touch(const QString &p_key)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_entries.contains(p_key)) {
+        touchLocked(p_key, 0);
+    } else {
+        touchLocked(p_key, QFileInfo(getFilePath(p_key)).size());
+    }
+}
+
+void DiskLruCache::add(const QString &p_key, qint64 p_size)
+{
+    const auto now = QDateTime::currentMSecsSinceEpoch();
+
+    QMutexLocker locker(&m_mutex);
+    auto &entry = m_entries[p_key];
+    m_totalSize += p_size - entry.m_size;
+    entry.m_size = p_size;
+    // Just written.
+    entry.m_lastAccessed = now;
+    entry.m_persistedAccessed = now;
+    m_pendingAccessTimes.remove(p_key);
+
+    if (!m_scanning) {
+        evictLocked();
+    }
+}
+
+void DiskLruCache::touchLocked(const QString &p_key, qint64 p_size)
+{
+    const auto now = QDateTime::currentMSecsSinceEpoch();
+
+    auto it = m_entries.find(p_key);
+    if (it == m_entries.end()) {
+        // Not scanned yet.
+        Entry entry;
+        entry.m_size = p_size;
+        it = m_entries.insert(p_key, entry);
+        m_totalSize += p_size;
+    }
+
+    it->m_lastAccessed = now;
+    if (now - it->m_persistedAccessed > c_accessTimeGranularity) {
+        m_pendingAccessTimes.insert(p_key);
+        if (m_pendingAccessTimes.size() >= c_maxPendingAccessTimes) {
+            persistAccessTimesLocked();
+        }
+    }
+}
+
+void DiskLruCache::removeEntryLocked(const QString &p_key)
+{
+    auto it = m_entries.find(p_key);
+    if (it != m_entries.end()) {
+        m_totalSize -= it->m_size;
+        m_entries.erase(it);
+    }
+
+    m_pendingAccessTimes.remove(p_key);
+}
+
+void DiskLruCache::evictLocked()
+{
+    if (m_totalSize <= m_maxSize) {
+        return;
+    }
+
+    QVector<QPair<qint64, QString>> entries;
+    entries.reserve(m_entries.size());
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        entries.push_back(qMakePair(it->m_lastAccessed, it.key()));
+    }
+    std::sort(entries.begin(), entries.end());
+
+    // Leave some room to avoid evicting on each insertion.
+    const qint64 targetSize = m_maxSize * 9 / 10;
+    for (const auto &ent : entries) {
+        if (m_totalSize <= targetSize) {
+            break;
+        }
+
+        QFile::remove(getFilePath(ent.second));
+        removeEntryLocked(ent.second);
+    }
+
+    qDebug() << m_name << "cache evicted to" << m_totalSize << "bytes with" << m_entries.size() << "entries";
+}
+
+void DiskLruCache::persistAccessTimesLocked()
+{
+    if (m_pendingAccessTimes.isEmpty()) {
+        return;
+    }
+
+    const auto now = QDateTime::currentDateTimeUtc();
+    for (const auto &key : m_pendingAccessTimes) {
+        auto it = m_entries.find(key);
+        if (it == m_entries.end()) {
+            continue;
+        }
+
+        // It is fine to fail, such as for a read-only file, which only makes LRU less precise.
+        QFile file(getFilePath(key));
+        if (file.open(QIODevice::ReadWrite)) {
+            file.setFileTime(now, QFileDevice::FileModificationTime);
+        }
+        it->m_persistedAccessed = now.toMSecsSinceEpoch();
+    }
+
+    m_pendingAccessTimes.clear();
+}
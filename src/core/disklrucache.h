@@ -0,0 +1,101 @@
+#ifndef DISKLRUCACHE_H
+#define DISKLRUCACHE_H
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QByteArray>
+#include <QMutex>
+
+#include <core/noncopyable.h>
+
+class QThread;
+
+namespace vnotex
+{
+    // A folder of cache files evicted in LRU order once the total size exceeds the limit.
+    // Existing files are scanned in background on init. Access times are kept in memory and
+    // persisted as file modification times lazily, so that reading never needs write access.
+    // Thread-safe.
+    class DiskLruCache : private Noncopyable
+    {
+    public:
+        // @p_name: name of the cache for logging.
+        explicit DiskLruCache(const QString &p_name);
+
+        ~DiskLruCache();
+
+        void init(const QString &p_folderPath, qint64 p_maxSize);
+
+        bool isInitialized() const;
+
+        void setMaxSize(qint64 p_maxSize);
+
+        qint64 getMaxSize() const;
+
+        qint64 getTotalSize() const;
+
+        QString getFilePath(const QString &p_key) const;
+
+        // Return a null QByteArray if not found.
+        QByteArray read(const QString &p_key);
+
+        bool write(const QString &p_key, const QByteArray &p_data);
+
+        void remove(const QString &p_key);
+
+        // Record the access of a file read directly via getFilePath().
+        void touch(const QString &p_key);
+
+        // Record a file written directly via getFilePath().
+        void add(const QString &p_key, qint64 p_size);
+
+    private:
+        struct Entry
+        {
+            qint64 m_size = 0;
+
+            // Msecs since epoch of last access.
+            qint64 m_lastAccessed = 0;
+
+            // Msecs since epoch of last access persisted to disk.
+            qint64 m_persistedAccessed = 0;
+        };
+
+        void scan();
+
+        void touchLocked(const QString &p_key, qint64 p_size);
+
+        void removeEntryLocked(const QString &p_key);
+
+        // Evict least recently used entries until the total size is within the limit.
+        void evictLocked();
+
+        void persistAccessTimesLocked();
+
+        const QString m_name;
+
+        QString m_folderPath;
+
+        qint64 m_maxSize = 0;
+
+        mutable QMutex m_mutex;
+
+        // Key -> Entry.
+        QHash<QString, Entry> m_entries;
+
+        qint64 m_totalSize = 0;
+
+        // Keys whose access times need to be persisted.
+        QSet<QString> m_pendingAccessTimes;
+
+        QThread *m_scanThread = nullptr;
+
+        bool m_scanning = false;
+
+        // Keys removed while scanning, which should not be picked up by the scan.
+        QSet<QString> m_removedWhileScanning;
+    };
+}
+
+#endif // DISKLRUCACHE_H
@@ -88,6 +88,11 @@ void EditorConfig::loadCore(const QJsonObject &p_app, const QJsonObject &p_user)
 
     m_backupFileExtension = READSTR(QStringLiteral("backup_file_extension"));
 
+    m_largeFileSizeThreshold = READINT(QStringLiteral("large_file_size_threshold"));
+    if (m_largeFileSizeThreshold < 0) {
+        m_largeFileSizeThreshold = 0;
+    }
+
     loadShortcuts(appObj, userObj);
 
     m_spellCheckAutoDetectLanguageEnabled = READBOOL(QStringLiteral("spell_check_auto_detect_language"));
@@ -109,6 +114,7 @@ QJsonObject EditorConfig::saveCore() const
     obj[QStringLiteral("auto_save_policy")] = autoSavePolicyToString(m_autoSavePolicy);
     obj[QStringLiteral("backup_file_directory")] = m_backupFileDirectory;
     obj[QStringLiteral("backup_file_extension")] = m_backupFileExtension;
+    obj[QStringLiteral("large_file_size_threshold")] = m_largeFileSizeThreshold;
     obj[QStringLiteral("shortcuts")] = saveShortcuts();
     obj[QStringLiteral("spell_check_auto_detect_language")] = m_spellCheckAutoDetectLanguageEnabled;
     obj[QStringLiteral("spell_check_default_dictionary")] = m_spellCheckDefaultDictionary;
@@ -289,6 +295,11 @@ const QString &EditorConfig::getBackupFileExtension() const
     return m_backupFileExtension;
 }
 
+int EditorConfig::getLargeFileSizeThreshold() const
+{
+    return m_largeFileSizeThreshold;
+}
+
 bool EditorConfig::isSpellCheckAutoDetectLanguageEnabled() const
 {
     return m_spellCheckAutoDetectLanguageEnabled;
@@ -319,6 +330,10 @@ void EditorConfig::loadImageHost(const QJsonObject &p_app, const QJsonObject &p_
 
     m_defaultImageHost = READSTR(QStringLiteral("default_image_host"));
     m_clearObsoleteImageAtImageHost = READBOOL(QStringLiteral("clear_obsolete_image"));
+    m_imageHostUploadConcurrency = READINT(QStringLiteral("upload_concurrency"));
+    if (m_imageHostUploadConcurrency < 1) {
+        m_imageHostUploadConcurrency = 1;
+    }
 }
 
 QJsonObject EditorConfig::saveImageHost() const
@@ -335,6 +350,7 @@ QJsonObject EditorConfig::saveImageHost() const
 
     obj[QStringLiteral("default_image_host")] = m_defaultImageHost;
     obj[QStringLiteral("clear_obsolete_image")] = m_clearObsoleteImageAtImageHost;
+    obj[QStringLiteral("upload_concurrency")] = m_imageHostUploadConcurrency;
 
     return obj;
 }
@@ -369,6 +385,11 @@ void EditorConfig::setClearObsoleteImageAtImageHostEnabled(bool p_enabled)
     updateConfig(m_clearObsoleteImageAtImageHost, p_enabled, this);
 }
 
+int EditorConfig::getImageHostUploadConcurrency() const
+{
+    return m_imageHostUploadConcurrency;
+}
+
 const QSharedPointer<vte::ViConfig> &EditorConfig::getViConfig() const
 {
     return m_viConfig;
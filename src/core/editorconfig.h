@@ -114,6 +114,9 @@ namespace vnotex
 
         const QString &getBackupFileExtension() const;
 
+        // In MiB.
+        int getLargeFileSizeThreshold() const;
+
         const QString &getShortcut(Shortcut p_shortcut) const;
 
         bool isSpellCheckAutoDetectLanguageEnabled() const;
@@ -130,6 +133,8 @@ namespace vnotex
         bool isClearObsoleteImageAtImageHostEnabled() const;
         void setClearObsoleteImageAtImageHostEnabled(bool p_enabled);
 
+        int getImageHostUploadConcurrency() const;
+
         const QSharedPointer<vte::ViConfig> &getViConfig() const;
 
         LineEndingPolicy getLineEndingPolicy() const;
@@ -169,6 +174,10 @@ namespace vnotex
         // Backup file extension.
         QString m_backupFileExtension;
 
+        // Files larger than this size (in MiB) will be opened in large file mode.
+        // 0 to disable large file mode.
+        int m_largeFileSizeThreshold = 20;
+
         // Will be shared with MarkdownEditorConfig.
         QSharedPointer<TextEditorConfig> m_textEditorConfig;
 
@@ -184,6 +193,9 @@ namespace vnotex
 
         bool m_clearObsoleteImageAtImageHost = false;
 
+        // Max number of images uploaded to image host at the same time.
+        int m_imageHostUploadConcurrency = 3;
+
         QSharedPointer<vte::ViConfig> m_viConfig;
 
         LineEndingPolicy m_lineEnding = LineEndingPolicy::LF;
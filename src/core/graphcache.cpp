@@ -0,0 +1,53 @@
+#include "graphcache.h"
+
+#include <QCryptographicHash>
+
+#include <core/configmgr.h>
+
+using namespace vnotex;
+
+// Limit of the total size of cached graphs.
+static const qint64 c_maxCacheSize = 64 * 1024 * 1024;
+
+GraphCache::GraphCache()
+    : m_cache(QStringLiteral("graph"))
+{
+}
+
+QByteArray GraphCache::calculateKey(const QStringList &p_parts)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (const auto &part : p_parts) {
+        const auto ba = part.toUtf8();
+        // Prefix with size to avoid collision of different splits.
+        hash.addData(QByteArray::number(ba.size()) + ':');
+        hash.addData(ba);
+    }
+    return hash.result().toHex();
+}
+
+void GraphCache::init()
+{
+    if (!m_cache.isInitialized()) {
+        m_cache.init(ConfigMgr::getInst().getUserGraphCacheFolder(), c_maxCacheSize);
+    }
+}
+
+QString GraphCache::get(const QByteArray &p_key)
+{
+    init();
+
+    const auto data = m_cache.read(QString::fromLatin1(p_key));
+    if (data.isNull()) {
+        return QString();
+    }
+
+    return QString::fromUtf8(data);
+}
+
+void GraphCache::set(const QByteArray &p_key, const QString &p_data)
+{
+    init();
+
+    m_cache.write(QString::fromLatin1(p_key), p_data.toUtf8());
+}
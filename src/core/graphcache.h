@@ -0,0 +1,43 @@
+#ifndef GRAPHCACHE_H
+#define GRAPHCACHE_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+
+#include <core/noncopyable.h>
+#include <core/disklrucache.h>
+
+namespace vnotex
+{
+    // Persistent cache of rendered graphs in the user config folder, shared by all
+    // renderings of external graph programs.
+    // Entries are content-addressed by a hash of the renderer, format and source text,
+    // and evicted in LRU order once the total size exceeds the limit.
+    class GraphCache : private Noncopyable
+    {
+    public:
+        static GraphCache &getInst()
+        {
+            static GraphCache inst;
+            return inst;
+        }
+
+        // @p_parts: things affecting the rendering result, such as renderer, format and text.
+        static QByteArray calculateKey(const QStringList &p_parts);
+
+        // Return a null string if not found.
+        QString get(const QByteArray &p_key);
+
+        void set(const QByteArray &p_key, const QString &p_data);
+
+    private:
+        GraphCache();
+
+        void init();
+
+        DiskLruCache m_cache;
+    };
+}
+
+#endif // GRAPHCACHE_H
@@ -0,0 +1,224 @@
+#include "imagefetcher.h"
+
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QTemporaryFile>
+#include <QTimer>
+#include <QDebug>
+
+#include <vtextedit/networkutils.h>
+
+#include <utils/fileutils.h>
+#include <utils/imageutils.h>
+
+using namespace vnotex;
+
+static const int c_maxConcurrency = 8;
+
+static const int c_maxConcurrencyPerHost = 4;
+
+// Default period to abort a request if no data is received.
+static const int c_idleTimeout = 15 * 1000;
+
+// Give up the rest requests of a host after timing out so many times.
+static const int c_maxTimeoutsPerHost = 2;
+
+ImageFetcher::ImageFetcher(QObject *p_parent)
+    : QObject(p_parent),
+      m_idleTimeout(c_idleTimeout)
+{
+}
+
+void ImageFetcher::addUrl(const QUrl &p_url, const QString &p_suffix)
+{
+    Q_ASSERT(!m_netMgr);
+    if (m_taskIndexes.contains(p_url)) {
+        return;
+    }
+
+    Task task;
+    task.m_url = p_url;
+    task.m_suffix = p_suffix;
+    m_taskIndexes.insert(p_url, m_tasks.size());
+    m_pendingTasks.push_back(m_tasks.size());
+    m_tasks.push_back(task);
+}
+
+int ImageFetcher::getUrlCount() const
+{
+    return m_tasks.size();
+}
+
+void ImageFetcher::setIdleTimeout(int p_msecs)
+{
+    m_idleTimeout = p_msecs;
+}
+
+void ImageFetcher::start()
+{
+    Q_ASSERT(!m_netMgr);
+    m_netMgr = new QNetworkAccessManager(this);
+    schedule();
+}
+
+void ImageFetcher::schedule()
+{
+    auto it = m_pendingTasks.begin();
+    while (it != m_pendingTasks.end() && m_replies.size() < c_maxConcurrency) {
+        const int idx = *it;
+        const auto host = m_tasks[idx].m_url.host();
+        if (m_timeoutsPerHost.value(host) >= c_maxTimeoutsPerHost) {
+            qWarning() << "skipped fetching image from slow host" << m_tasks[idx].m_url;
+            it = m_pendingTasks.erase(it);
+            finishTask(idx);
+            continue;
+        }
+
+        if (m_runningPerHost.value(host) >= c_maxConcurrencyPerHost) {
+            ++it;
+            continue;
+        }
+
+        it = m_pendingTasks.erase(it);
+        request(idx);
+    }
+
+    if (m_replies.isEmpty() && m_pendingTasks.isEmpty()) {
+        finish();
+    }
+}
+
+void ImageFetcher::request(int p_idx)
+{
+    const auto &url = m_tasks[p_idx].m_url;
+    qDebug() << "fetching image" << url;
+
+    auto reply = m_netMgr->get(vte::NetworkUtils::networkRequest(url));
+    m_replies.insert(reply, p_idx);
+    ++m_runningPerHost[url.host()];
+
+    // Restart the timer on any progress so that large images are not aborted.
+    auto timer = new QTimer(reply);
+    timer->setSingleShot(true);
+    timer->setInterval(m_idleTimeout);
+    connect(timer, &QTimer::timeout,
+            this, [this, reply]() {
+                if (m_replies.contains(reply)) {
+                    m_timedOutReplies.insert(reply);
+                    reply->abort();
+                }
+            });
+    connect(reply, &QNetworkReply::downloadProgress,
+            timer, static_cast<void (QTimer::*)()>(&QTimer::start));
+    connect(reply, &QNetworkReply::finished,
+            this, [this, reply]() {
+                handleReply(reply);
+            });
+    timer->start();
+}
+
+void ImageFetcher::handleReply(QNetworkReply *p_reply)
+{
+    const int idx = m_replies.take(p_reply);
+    auto &task = m_tasks[idx];
+    --m_runningPerHost[task.m_url.host()];
+
+    if (m_timedOutReplies.remove(p_reply)) {
+        qWarning() << "timed out fetching image" << task.m_url;
+        ++m_timeoutsPerHost[task.m_url.host()];
+    } else if (p_reply->error() != QNetworkReply::NoError) {
+        qWarning() << "failed to fetch image" << task.m_url << p_reply->errorString();
+    } else {
+        // Write it out as soon as it is done to release the memory.
+        saveData(task, p_reply->readAll());
+    }
+
+    p_reply->deleteLater();
+
+    finishTask(idx);
+
+    if (m_aborted) {
+        if (m_replies.isEmpty()) {
+            finish();
+        }
+    } else {
+        schedule();
+    }
+}
+
+void ImageFetcher::saveData(Task &p_task, const QByteArray &p_data)
+{
+    if (p_data.isEmpty()) {
+        return;
+    }
+
+    // Prefer the suffix from the real data.
+    auto suffix = ImageUtils::guessImageSuffix(p_data);
+    if (suffix.isEmpty()) {
+        suffix = p_task.m_suffix;
+    } else if (p_task.m_suffix != suffix) {
+        qWarning() << "guess a different suffix from image data" << p_task.m_suffix << suffix;
+    }
+
+    QSharedPointer<QTemporaryFile> file(FileUtils::createTemporaryFile(suffix));
+    if (!file->open() || file->write(p_data) != p_data.size()) {
+        qWarning() << "failed to write fetched image" << p_task.m_url << file->errorString();
+        return;
+    }
+
+    // Need to close it explicitly to flush cache of small file.
+    file->close();
+    p_task.m_file = file;
+}
+
+void ImageFetcher::finishTask(int p_idx)
+{
+    ++m_doneCount;
+    emit progressUpdated(m_doneCount, m_tasks.size(), m_tasks[p_idx].m_url);
+}
+
+void ImageFetcher::abort()
+{
+    if (m_aborted || m_finished) {
+        return;
+    }
+
+    m_aborted = true;
+    m_pendingTasks.clear();
+
+    // Aborting will finish the reply synchronously.
+    const auto replies = m_replies.keys();
+    for (auto reply : replies) {
+        reply->abort();
+    }
+
+    if (m_replies.isEmpty()) {
+        finish();
+    }
+}
+
+void ImageFetcher::finish()
+{
+    if (m_finished) {
+        return;
+    }
+
+    m_finished = true;
+    emit finished();
+}
+
+bool ImageFetcher::isFinished() const
+{
+    return m_finished;
+}
+
+QString ImageFetcher::getFilePath(const QUrl &p_url) const
+{
+    auto it = m_taskIndexes.find(p_url);
+    if (it == m_taskIndexes.end()) {
+        return QString();
+    }
+
+    const auto &file = m_tasks[it.value()].m_file;
+    return file ? file->fileName() : QString();
+}
@@ -0,0 +1,107 @@
+#ifndef IMAGEFETCHER_H
+#define IMAGEFETCHER_H
+
+#include <QObject>
+#include <QUrl>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QSharedPointer>
+
+class QNetworkAccessManager;
+class QNetworkReply;
+class QTemporaryFile;
+
+namespace vnotex
+{
+    // Fetch remote images into local temporary files asynchronously.
+    // Duplicated URLs are fetched once. Requests are issued with bounded concurrency in total
+    // and per host, and a host will be given up after timing out several times.
+    class ImageFetcher : public QObject
+    {
+        Q_OBJECT
+    public:
+        explicit ImageFetcher(QObject *p_parent = nullptr);
+
+        // @p_suffix: suffix to use if it could not be guessed from the fetched data.
+        void addUrl(const QUrl &p_url, const QString &p_suffix);
+
+        int getUrlCount() const;
+
+        // Abort a request if no data is received in @p_msecs.
+        void setIdleTimeout(int p_msecs);
+
+        // finished() will be emitted when all URLs are done or aborted.
+        void start();
+
+        void abort();
+
+        bool isFinished() const;
+
+        // Return the local file fetched from @p_url, or empty if failed.
+        // Files are removed when the fetcher is destroyed.
+        QString getFilePath(const QUrl &p_url) const;
+
+    signals:
+        // @p_url: the URL just done.
+        void progressUpdated(int p_done, int p_total, const QUrl &p_url);
+
+        void finished();
+
+    private:
+        struct Task
+        {
+            QUrl m_url;
+
+            QString m_suffix;
+
+            QSharedPointer<QTemporaryFile> m_file;
+        };
+
+        // Issue requests of pending tasks as concurrency allows.
+        void schedule();
+
+        void request(int p_idx);
+
+        void handleReply(QNetworkReply *p_reply);
+
+        // Mark task @p_idx done and report the progress.
+        void finishTask(int p_idx);
+
+        void saveData(Task &p_task, const QByteArray &p_data);
+
+        void finish();
+
+        QNetworkAccessManager *m_netMgr = nullptr;
+
+        QVector<Task> m_tasks;
+
+        // URL -> index of task.
+        QHash<QUrl, int> m_taskIndexes;
+
+        // Indexes of tasks not requested yet in order.
+        QList<int> m_pendingTasks;
+
+        // Running reply -> index of task.
+        QHash<QNetworkReply *, int> m_replies;
+
+        QSet<QNetworkReply *> m_timedOutReplies;
+
+        // Host -> number of running requests.
+        QHash<QString, int> m_runningPerHost;
+
+        // Host -> number of timed out requests.
+        QHash<QString, int> m_timeoutsPerHost;
+
+        int m_idleTimeout = 0;
+
+        int m_doneCount = 0;
+
+        bool m_aborted = false;
+
+        bool m_finished = false;
+    };
+}
+
+#endif // IMAGEFETCHER_H
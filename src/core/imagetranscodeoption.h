@@ -0,0 +1,53 @@
+#ifndef IMAGETRANSCODEOPTION_H
+#define IMAGETRANSCODEOPTION_H
+
+#include <QJsonObject>
+#include <QString>
+
+namespace vnotex
+{
+    // How to encode image data, such as pasted screenshots, when inserting into notes.
+    struct ImageTranscodeOption
+    {
+        void init(const QJsonObject &p_obj)
+        {
+            m_enabled = p_obj[QStringLiteral("enabled")].toBool();
+            m_maxWidth = p_obj[QStringLiteral("max_width")].toInt();
+            m_maxHeight = p_obj[QStringLiteral("max_height")].toInt();
+            m_format = p_obj[QStringLiteral("format")].toString();
+            m_quality = p_obj[QStringLiteral("quality")].toInt(-1);
+            m_losslessRecompress = p_obj[QStringLiteral("lossless_recompress")].toBool();
+        }
+
+        QJsonObject toJson() const
+        {
+            QJsonObject obj;
+            obj[QStringLiteral("enabled")] = m_enabled;
+            obj[QStringLiteral("max_width")] = m_maxWidth;
+            obj[QStringLiteral("max_height")] = m_maxHeight;
+            obj[QStringLiteral("format")] = m_format;
+            obj[QStringLiteral("quality")] = m_quality;
+            obj[QStringLiteral("lossless_recompress")] = m_losslessRecompress;
+            return obj;
+        }
+
+        // Images are saved as PNG as is if disabled.
+        bool m_enabled = false;
+
+        // Downscale images larger than this keeping the aspect ratio. 0 for no limit.
+        int m_maxWidth = 0;
+
+        int m_maxHeight = 0;
+
+        // Target format like "png", "jpg" or "webp". Empty for PNG.
+        QString m_format;
+
+        // [0, 100] for lossy formats. -1 for the default of the format.
+        int m_quality = -1;
+
+        // Compress PNG harder and drop the alpha channel if the image is opaque.
+        bool m_losslessRecompress = false;
+    };
+}
+
+#endif // IMAGETRANSCODEOPTION_H
@@ -62,6 +62,20 @@ void MarkdownEditorConfig::init(const QJsonObject &p_app, const QJsonObject &p_u
     m_smartTableEnabled = READBOOL(QStringLiteral("smart_table"));
     m_smartTableInterval = READINT(QStringLiteral("smart_table_interval"));
 
+    m_previewImageCacheSize = READINT(QStringLiteral("preview_image_cache_size"));
+
+    m_exportViewerPoolSize = READINT(QStringLiteral("export_viewer_pool_size"));
+
+    m_renderSnapshotCacheEnabled = READBOOL(QStringLiteral("render_snapshot_cache"));
+    m_renderSnapshotCacheSize = READINT(QStringLiteral("render_snapshot_cache_size"));
+
+    m_linkIdenticalImagesEnabled = READBOOL(QStringLiteral("link_identical_images"));
+
+    {
+        const QString name(QStringLiteral("image_transcode"));
+        m_imageTranscodeOption.init(userObj.contains(name) ? userObj[name].toObject() : appObj[name].toObject());
+    }
+
     m_spellCheckEnabled = READBOOL(QStringLiteral("spell_check"));
 
     m_editorOverriddenFontFamily = READSTR(QStringLiteral("editor_overridden_font_family"));
@@ -107,6 +121,12 @@ QJsonObject MarkdownEditorConfig::toJson() const
     obj[QStringLiteral("indent_first_line")] = m_indentFirstLineEnabled;
     obj[QStringLiteral("smart_table")] = m_smartTableEnabled;
     obj[QStringLiteral("smart_table_interval")] = m_smartTableInterval;
+    obj[QStringLiteral("preview_image_cache_size")] = m_previewImageCacheSize;
+    obj[QStringLiteral("export_viewer_pool_size")] = m_exportViewerPoolSize;
+    obj[QStringLiteral("render_snapshot_cache")] = m_renderSnapshotCacheEnabled;
+    obj[QStringLiteral("render_snapshot_cache_size")] = m_renderSnapshotCacheSize;
+    obj[QStringLiteral("image_transcode")] = m_imageTranscodeOption.toJson();
+    obj[QStringLiteral("link_identical_images")] = m_linkIdenticalImagesEnabled;
     obj[QStringLiteral("spell_check")] = m_spellCheckEnabled;
     obj[QStringLiteral("editor_overridden_font_family")] = m_editorOverriddenFontFamily;
 
@@ -494,6 +514,46 @@ int MarkdownEditorConfig::getSmartTableInterval() const
     return m_smartTableInterval;
 }
 
+int MarkdownEditorConfig::getPreviewImageCacheSize() const
+{
+    return m_previewImageCacheSize;
+}
+
+void MarkdownEditorConfig::setPreviewImageCacheSize(int p_size)
+{
+    updateConfig(m_previewImageCacheSize, p_size, this);
+}
+
+int MarkdownEditorConfig::getExportViewerPoolSize() const
+{
+    return m_exportViewerPoolSize;
+}
+
+bool MarkdownEditorConfig::getRenderSnapshotCacheEnabled() const
+{
+    return m_renderSnapshotCacheEnabled;
+}
+
+int MarkdownEditorConfig::getRenderSnapshotCacheSize() const
+{
+    return m_renderSnapshotCacheSize;
+}
+
+const ImageTranscodeOption &MarkdownEditorConfig::getImageTranscodeOption() const
+{
+    return m_imageTranscodeOption;
+}
+
+bool MarkdownEditorConfig::getLinkIdenticalImagesEnabled() const
+{
+    return m_linkIdenticalImagesEnabled;
+}
+
+void MarkdownEditorConfig::setLinkIdenticalImagesEnabled(bool p_enabled)
+{
+    updateConfig(m_linkIdenticalImagesEnabled, p_enabled, this);
+}
+
 bool MarkdownEditorConfig::isSpellCheckEnabled() const
 {
     return m_spellCheckEnabled;
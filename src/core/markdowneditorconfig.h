@@ -4,6 +4,7 @@
 #include "iconfig.h"
 
 #include "webresource.h"
+#include "imagetranscodeoption.h"
 
 #include <QSharedPointer>
 #include <QVector>
@@ -127,6 +128,20 @@ namespace vnotex
 
         int getSmartTableInterval() const;
 
+        int getPreviewImageCacheSize() const;
+        void setPreviewImageCacheSize(int p_size);
+
+        int getExportViewerPoolSize() const;
+
+        bool getRenderSnapshotCacheEnabled() const;
+
+        int getRenderSnapshotCacheSize() const;
+
+        const ImageTranscodeOption &getImageTranscodeOption() const;
+
+        bool getLinkIdenticalImagesEnabled() const;
+        void setLinkIdenticalImagesEnabled(bool p_enabled);
+
         bool isSpellCheckEnabled() const;
         void setSpellCheckEnabled(bool p_enabled);
 
@@ -232,6 +247,25 @@ namespace vnotex
         // Interval time to do smart table format.
         int m_smartTableInterval = 2000;
 
+        // Memory budget in MiB of in-place preview images shared by all editors.
+        int m_previewImageCacheSize = 256;
+
+        // Number of offscreen viewers to render notes concurrently in batch export.
+        int m_exportViewerPoolSize = 4;
+
+        // Whether persist rendered HTML of notes to show it instantly on next open in read mode.
+        bool m_renderSnapshotCacheEnabled = true;
+
+        // Disk budget in MiB of render snapshots.
+        int m_renderSnapshotCacheSize = 128;
+
+        // How to encode image data on insertion. Could be overridden per notebook.
+        ImageTranscodeOption m_imageTranscodeOption;
+
+        // Whether hard link an inserted image to an identical one of other notes.
+        // Off by default since editing a hard linked image in place changes all of them.
+        bool m_linkIdenticalImagesEnabled = false;
+
         // Override the config in TextEditorConfig.
         bool m_spellCheckEnabled = true;
 
@@ -2,10 +2,17 @@
 
 #include <QDebug>
 #include <QCoreApplication>
+#include <QThread>
+#include <QEventLoop>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDir>
+#include <QHash>
 
 #include <notebookconfigmgr/bundlenotebookconfigmgr.h>
 #include <notebookconfigmgr/notebookconfig.h>
 #include <utils/fileutils.h>
+#include <utils/pathutils.h>
 #include <core/historymgr.h>
 #include <core/exception.h>
 #include <notebookbackend/inotebookbackend.h>
@@ -259,3 +266,198 @@ int BundleNotebook::getConfigVersion() const
 {
     return m_configVersion;
 }
+
+QStringList BundleNotebook::findIdenticalImages(const QString &p_hash, qint64 p_size)
+{
+    QStringList images;
+    if (!m_dbAccess->isValid()) {
+        return images;
+    }
+
+    auto backend = getBackend();
+    const auto imageRecs = m_dbAccess->queryImagesOfHash(p_hash);
+    for (const auto &rec : imageRecs) {
+        const auto filePath = backend->getFullPath(rec.m_path);
+        QFileInfo info(filePath);
+        if (!info.isFile()) {
+            // Removed or moved along with its node.
+            m_dbAccess->removeImage(rec.m_path);
+            continue;
+        }
+
+        if (info.size() != rec.m_size || info.lastModified().toMSecsSinceEpoch() != rec.m_modifiedTime) {
+            // Modified after indexed.
+            if (indexImage(filePath) != p_hash) {
+                continue;
+            }
+        }
+
+        if (info.size() == p_size) {
+            images << filePath;
+        }
+    }
+
+    return images;
+}
+
+QString BundleNotebook::indexImage(const QString &p_filePath)
+{
+    if (!m_dbAccess->isValid()) {
+        return QString();
+    }
+
+    auto hash = queryIndexedImageHash(p_filePath);
+    if (hash.isEmpty()) {
+        hash = FileUtils::calculateFileHash(p_filePath);
+        addImageRecord(p_filePath, hash);
+    }
+    return hash;
+}
+
+QString BundleNotebook::queryIndexedImageHash(const QString &p_filePath) const
+{
+    QFileInfo info(p_filePath);
+    auto rec = m_dbAccess->queryImage(getBackend()->getRelativePath(p_filePath));
+    if (rec && rec->m_size == info.size() && rec->m_modifiedTime == info.lastModified().toMSecsSinceEpoch()) {
+        return rec->m_hash;
+    }
+    return QString();
+}
+
+void BundleNotebook::addImageRecord(const QString &p_filePath, const QString &p_hash)
+{
+    QFileInfo info(p_filePath);
+    NotebookDatabaseAccess::ImageRecord rec;
+    rec.m_path = getBackend()->getRelativePath(p_filePath);
+    rec.m_size = info.size();
+    rec.m_modifiedTime = info.lastModified().toMSecsSinceEpoch();
+    rec.m_hash = p_hash;
+
+    if (rec.m_hash.isEmpty()) {
+        qWarning() << "failed to index image" << p_filePath;
+        m_dbAccess->removeImage(rec.m_path);
+        return;
+    }
+
+    m_dbAccess->addImage(rec);
+}
+
+int BundleNotebook::deduplicateImages()
+{
+    if (!m_dbAccess->isValid()) {
+        return -1;
+    }
+
+    QStringList folders;
+    collectImageFolders(getRootNode().data(), folders);
+
+    // Look up indexed hashes first and hash the rest in a worker thread to keep the GUI
+    // responsive. The database is only accessed on this thread.
+    QStringList files;
+    QStringList hashes;
+    QVector<int> unindexed;
+    for (const auto &folder : folders) {
+        const auto names = QDir(folder).entryList(QDir::Files | QDir::NoSymLinks, QDir::Name);
+        for (const auto &name : names) {
+            const auto filePath = PathUtils::concatenateFilePath(folder, name);
+            const auto hash = queryIndexedImageHash(filePath);
+            if (hash.isEmpty()) {
+                unindexed.push_back(files.size());
+            }
+            files << filePath;
+            hashes << hash;
+        }
+    }
+
+    if (!unindexed.isEmpty()) {
+        QStringList newHashes;
+        auto thread = QThread::create([&files, &unindexed, &newHashes]() {
+            for (int idx : unindexed) {
+                newHashes << FileUtils::calculateFileHash(files[idx]);
+            }
+        });
+        QEventLoop loop;
+        QObject::connect(thread, &QThread::finished,
+                         &loop, &QEventLoop::quit);
+        thread->start();
+        // Exclude user input to keep nodes and files unchanged.
+        loop.exec(QEventLoop::ExcludeUserInputEvents);
+        thread->wait();
+        delete thread;
+
+        for (int i = 0; i < unindexed.size(); ++i) {
+            const int idx = unindexed[i];
+            hashes[idx] = newHashes[i];
+            addImageRecord(files[idx], hashes[idx]);
+        }
+    }
+
+    // Hash -> the image to keep.
+    QHash<QString, QString> keptImages;
+    int dedupCnt = 0;
+    for (int i = 0; i < files.size(); ++i) {
+        const auto &filePath = files[i];
+        const auto &hash = hashes[i];
+        if (hash.isEmpty()) {
+            continue;
+        }
+
+        auto it = keptImages.find(hash);
+        if (it == keptImages.end()) {
+            keptImages.insert(hash, filePath);
+            continue;
+        }
+
+        if (FileUtils::isSameFile(it.value(), filePath)) {
+            continue;
+        }
+
+        if (replaceWithLink(it.value(), filePath)) {
+            // The link shares the data but gets a new modified time.
+            addImageRecord(filePath, hash);
+            ++dedupCnt;
+        }
+    }
+
+    qDebug() << "deduplicated images" << dedupCnt << "of" << files.size();
+    return dedupCnt;
+}
+
+void BundleNotebook::collectImageFolders(Node *p_node, QStringList &p_folders)
+{
+    if (!p_node->isContainer()) {
+        return;
+    }
+
+    p_node->load();
+
+    const auto folder = PathUtils::concatenateFilePath(p_node->fetchAbsolutePath(), getImageFolder());
+    if (QFileInfo(folder).isDir()) {
+        p_folders << folder;
+    }
+
+    const auto &children = p_node->getChildrenRef();
+    for (const auto &child : children) {
+        collectImageFolders(child.data(), p_folders);
+    }
+}
+
+bool BundleNotebook::replaceWithLink(const QString &p_targetFilePath, const QString &p_filePath)
+{
+    // Keep the original file aside until the link is created.
+    auto backend = getBackend();
+    const auto backupFilePath = backend->renameIfExistsCaseInsensitive(p_filePath + QStringLiteral(".vx_dedup"));
+    try {
+        backend->renameFile(p_filePath, PathUtils::fileName(backupFilePath));
+        if (backend->linkFile(p_targetFilePath, p_filePath)) {
+            backend->removeFile(backupFilePath);
+            return true;
+        }
+
+        backend->renameFile(backupFilePath, PathUtils::fileName(p_filePath));
+    } catch (Exception &p_e) {
+        qWarning() << "failed to replace image with hard link" << p_filePath << p_e.what();
+    }
+
+    return false;
+}
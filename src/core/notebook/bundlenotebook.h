@@ -37,6 +37,12 @@ namespace vnotex
 
         bool rebuildDatabase() Q_DECL_OVERRIDE;
 
+        QStringList findIdenticalImages(const QString &p_hash, qint64 p_size) Q_DECL_OVERRIDE;
+
+        QString indexImage(const QString &p_filePath) Q_DECL_OVERRIDE;
+
+        int deduplicateImages() Q_DECL_OVERRIDE;
+
         NotebookDatabaseAccess *getDatabaseAccess() const;
 
         TagI *tag() Q_DECL_OVERRIDE;
@@ -71,6 +77,18 @@ namespace vnotex
 
         NotebookTagMgr *getTagMgr() const;
 
+        // Collect existing image folders of @p_node and its descendants.
+        void collectImageFolders(Node *p_node, QStringList &p_folders);
+
+        // Return the hash of @p_filePath recorded in the database if it is still valid.
+        QString queryIndexedImageHash(const QString &p_filePath) const;
+
+        // Record @p_hash of @p_filePath, or drop the record if @p_hash is empty.
+        void addImageRecord(const QString &p_filePath, const QString &p_hash);
+
+        // Replace @p_filePath with a hard link to @p_targetFilePath.
+        bool replaceWithLink(const QString &p_targetFilePath, const QString &p_filePath);
+
         const int m_configVersion;
 
         QVector<HistoryItem> m_history;
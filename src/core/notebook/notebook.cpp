@@ -388,6 +388,24 @@ bool Notebook::rebuildDatabase()
     return false;
 }
 
+QStringList Notebook::findIdenticalImages(const QString &p_hash, qint64 p_size)
+{
+    Q_UNUSED(p_hash);
+    Q_UNUSED(p_size);
+    return QStringList();
+}
+
+QString Notebook::indexImage(const QString &p_filePath)
+{
+    Q_UNUSED(p_filePath);
+    return QString();
+}
+
+int Notebook::deduplicateImages()
+{
+    return -1;
+}
+
 HistoryI *Notebook::history()
 {
     return nullptr;
@@ -145,6 +145,17 @@ namespace vnotex
 
         virtual bool rebuildDatabase();
 
+        // Image content index.
+        // Return images within notebook whose content hash is @p_hash, or empty if not supported.
+        virtual QStringList findIdenticalImages(const QString &p_hash, qint64 p_size);
+
+        // Add image @p_filePath within notebook to the index and return its content hash.
+        virtual QString indexImage(const QString &p_filePath);
+
+        // Replace duplicated images in image folders with hard links to one copy.
+        // Return the number of images replaced, or -1 if not supported.
+        virtual int deduplicateImages();
+
         static const QString c_defaultAttachmentFolder;
 
         static const QString c_defaultImageFolder;
@@ -17,6 +17,8 @@ static QString c_tagTableName = "tag";
 
 static QString c_nodeTagTableName = "tag_node";
 
+static QString c_imageTableName = "image";
+
 NotebookDatabaseAccess::NotebookDatabaseAccess(Notebook *p_notebook, const QString &p_databaseFile, QObject *p_parent)
     : QObject(p_parent),
       m_notebook(p_notebook),
@@ -104,6 +106,23 @@ void NotebookDatabaseAccess::setupTables(QSqlDatabase &p_db, int p_configVersion
             return;
         }
     }
+
+    // Image. It is a cache and could be added to an existing database.
+    {
+        bool ret = query.exec(QString("CREATE TABLE IF NOT EXISTS %1 (\n"
+                                      "    path TEXT PRIMARY KEY,\n"
+                                      "    hash TEXT NOT NULL,\n"
+                                      "    size INTEGER NOT NULL,\n"
+                                      "    modified_time INTEGER NOT NULL) WITHOUT ROWID\n").arg(c_imageTableName));
+        if (ret) {
+            ret = query.exec(QString("CREATE INDEX IF NOT EXISTS %1_hash_index ON %1 (hash)").arg(c_imageTableName));
+        }
+        if (!ret) {
+            qWarning() << QString("failed to create database table (%1) (%2)").arg(c_imageTableName, query.lastError().text());
+            m_valid = false;
+            return;
+        }
+    }
 }
 
 void NotebookDatabaseAccess::initialize(int p_configVersion)
@@ -776,3 +795,82 @@ QList<NotebookDatabaseAccess::TagRecord> NotebookDatabaseAccess::getAllTags()
     }
     return ret;
 }
+
+bool NotebookDatabaseAccess::addImage(const ImageRecord &p_rec)
+{
+    auto db = getDatabase();
+    QSqlQuery query(db);
+    query.prepare(QString("INSERT OR REPLACE INTO %1 (path, hash, size, modified_time)\n"
+                          "    VALUES (:path, :hash, :size, :modified_time)").arg(c_imageTableName));
+    query.bindValue(":path", p_rec.m_path);
+    query.bindValue(":hash", p_rec.m_hash);
+    query.bindValue(":size", p_rec.m_size);
+    query.bindValue(":modified_time", p_rec.m_modifiedTime);
+    if (!query.exec()) {
+        qWarning() << "failed to add image" << query.executedQuery() << query.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+bool NotebookDatabaseAccess::removeImage(const QString &p_path)
+{
+    auto db = getDatabase();
+    QSqlQuery query(db);
+    query.prepare(QString("DELETE FROM %1\n"
+                          "WHERE path = :path").arg(c_imageTableName));
+    query.bindValue(":path", p_path);
+    if (!query.exec()) {
+        qWarning() << "failed to remove image" << query.executedQuery() << query.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+QSharedPointer<NotebookDatabaseAccess::ImageRecord> NotebookDatabaseAccess::queryImage(const QString &p_path)
+{
+    auto db = getDatabase();
+    QSqlQuery query(db);
+    query.prepare(QString("SELECT path, hash, size, modified_time FROM %1 WHERE path = :path").arg(c_imageTableName));
+    query.bindValue(":path", p_path);
+    if (!query.exec()) {
+        qWarning() << "failed to query image" << query.executedQuery() << query.lastError().text();
+        return nullptr;
+    }
+
+    if (query.next()) {
+        auto imageRec = QSharedPointer<ImageRecord>::create();
+        imageRec->m_path = query.value(0).toString();
+        imageRec->m_hash = query.value(1).toString();
+        imageRec->m_size = query.value(2).toLongLong();
+        imageRec->m_modifiedTime = query.value(3).toLongLong();
+        return imageRec;
+    }
+
+    return nullptr;
+}
+
+QList<NotebookDatabaseAccess::ImageRecord> NotebookDatabaseAccess::queryImagesOfHash(const QString &p_hash)
+{
+    QList<ImageRecord> ret;
+
+    auto db = getDatabase();
+    QSqlQuery query(db);
+    query.prepare(QString("SELECT path, hash, size, modified_time FROM %1 WHERE hash = :hash ORDER BY path").arg(c_imageTableName));
+    query.bindValue(":hash", p_hash);
+    if (!query.exec()) {
+        qWarning() << "failed to query images" << query.executedQuery() << query.lastError().text();
+        return ret;
+    }
+
+    while (query.next()) {
+        ret.append(ImageRecord());
+        ret.last().m_path = query.value(0).toString();
+        ret.last().m_hash = query.value(1).toString();
+        ret.last().m_size = query.value(2).toLongLong();
+        ret.last().m_modifiedTime = query.value(3).toLongLong();
+    }
+    return ret;
+}
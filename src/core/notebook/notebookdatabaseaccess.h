@@ -31,6 +31,20 @@ namespace vnotex
             QString m_parentName;
         };
 
+        struct ImageRecord
+        {
+            // Relative to the root of notebook.
+            QString m_path;
+
+            // SHA1 of the content in hex.
+            QString m_hash;
+
+            qint64 m_size = 0;
+
+            // Milliseconds since epoch.
+            qint64 m_modifiedTime = 0;
+        };
+
         friend class tests::TestNotebookDatabase;
 
         NotebookDatabaseAccess(Notebook *p_notebook, const QString &p_databaseFile, QObject *p_parent = nullptr);
@@ -83,6 +97,18 @@ namespace vnotex
         // Return the relative path of nodes of tags @p_tags.
         QStringList getNodesOfTags(const QStringList &p_tags);
 
+        // Image table as a content index of images.
+    public:
+        // Will update the image if exists.
+        bool addImage(const ImageRecord &p_rec);
+
+        bool removeImage(const QString &p_path);
+
+        // Return null if not exists.
+        QSharedPointer<ImageRecord> queryImage(const QString &p_path);
+
+        QList<ImageRecord> queryImagesOfHash(const QString &p_hash);
+
     private:
         struct NodeRecord
         {
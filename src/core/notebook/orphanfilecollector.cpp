@@ -0,0 +1,205 @@
+#include "orphanfilecollector.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QThread>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QCoreApplication>
+#include <QDebug>
+
+#include <vtextedit/markdownutils.h>
+
+#include <buffer/filetypehelper.h>
+#include <utils/fileutils.h>
+#include <utils/pathutils.h>
+#include <core/exception.h>
+
+#include "notebook.h"
+#include "node.h"
+
+using namespace vnotex;
+
+OrphanFileCollector::OrphanFileCollector(Notebook *p_notebook)
+    : m_notebook(p_notebook)
+{
+    Q_ASSERT(m_notebook);
+}
+
+void OrphanFileCollector::setContent(const QString &p_contentPath, const QString &p_content)
+{
+    m_contents.insert(PathUtils::normalizePath(p_contentPath), p_content);
+}
+
+void OrphanFileCollector::walk()
+{
+    m_notePaths.clear();
+    m_imageFolders.clear();
+    m_attachmentFolders.clear();
+    collectNode(m_notebook->getRootNode().data());
+}
+
+OrphanFileCollector::Result OrphanFileCollector::collect()
+{
+    Result result;
+    result.m_noteCount = m_notePaths.size();
+
+    const auto referencedImages = collectReferencedImages();
+
+    for (const auto &folder : m_imageFolders) {
+        const auto entries = QDir(folder).entryInfoList(QDir::Files, QDir::Name);
+        for (const auto &entry : entries) {
+            const auto filePath = entry.absoluteFilePath();
+            if (!referencedImages.contains(PathUtils::normalizePath(filePath))) {
+                result.m_images << filePath;
+                result.m_size += entry.size();
+            }
+        }
+    }
+
+    for (const auto &folder : m_attachmentFolders) {
+        const auto names = QDir(folder.first).entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+        for (const auto &name : names) {
+            if (folder.second.contains(name)) {
+                continue;
+            }
+
+            const auto dirPath = PathUtils::concatenateFilePath(folder.first, name);
+
+            // Keep it if any of its files is still referenced.
+            const auto prefix = PathUtils::normalizePath(dirPath) + QLatin1Char('/');
+            bool referenced = false;
+            for (const auto &image : referencedImages) {
+                if (image.startsWith(prefix)) {
+                    referenced = true;
+                    break;
+                }
+            }
+
+            if (referenced) {
+                continue;
+            }
+
+            result.m_attachmentFolders << dirPath;
+            QDirIterator it(dirPath, QDir::Files | QDir::Hidden | QDir::System, QDirIterator::Subdirectories);
+            while (it.hasNext()) {
+                it.next();
+                result.m_size += it.fileInfo().size();
+            }
+        }
+    }
+
+    qDebug() << "collected orphan files of notebook" << m_notebook->getName()
+             << "notes" << result.m_noteCount
+             << "images" << result.m_images.size()
+             << "attachment folders" << result.m_attachmentFolders.size()
+             << "size" << result.m_size;
+    return result;
+}
+
+void OrphanFileCollector::collectNode(Node *p_node)
+{
+    p_node->load();
+
+    if (p_node->hasContent()) {
+        const auto filePath = p_node->fetchAbsolutePath();
+        if (FileTypeHelper::getInst().checkFileType(filePath, FileType::Markdown)) {
+            m_notePaths << filePath;
+        }
+    }
+
+    if (!p_node->isContainer()) {
+        return;
+    }
+
+    // Loading nodes of a large notebook takes a while.
+    QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+
+    // Images and attachments of a note locate in the folder of its parent.
+    const auto folderPath = p_node->fetchAbsolutePath();
+    const auto imageFolder = PathUtils::concatenateFilePath(folderPath, m_notebook->getImageFolder());
+    if (QFileInfo(imageFolder).isDir()) {
+        m_imageFolders << imageFolder;
+    }
+
+    const auto attachmentFolder = PathUtils::concatenateFilePath(folderPath, m_notebook->getAttachmentFolder());
+    const bool hasAttachmentFolder = QFileInfo(attachmentFolder).isDir();
+    QSet<QString> ownedFolders;
+
+    const auto &children = p_node->getChildrenRef();
+    for (const auto &child : children) {
+        if (hasAttachmentFolder && child->hasContent() && !child->getAttachmentFolder().isEmpty()) {
+            ownedFolders.insert(child->getAttachmentFolder());
+        }
+
+        collectNode(child.data());
+    }
+
+    if (hasAttachmentFolder) {
+        m_attachmentFolders.push_back(qMakePair(attachmentFolder, ownedFolders));
+    }
+}
+
+QSet<QString> OrphanFileCollector::collectReferencedImages() const
+{
+    QSet<QString> images;
+    if (m_notePaths.isEmpty()) {
+        return images;
+    }
+
+    QAtomicInt nextIdx(0);
+    QMutex imagesMutex;
+    const auto parseFunc = [this, &nextIdx, &imagesMutex, &images]() {
+        QSet<QString> localImages;
+        while (true) {
+            const int idx = nextIdx.fetchAndAddRelaxed(1);
+            if (idx >= m_notePaths.size()) {
+                break;
+            }
+
+            const auto &notePath = m_notePaths[idx];
+            QString content;
+            auto it = m_contents.find(PathUtils::normalizePath(notePath));
+            if (it != m_contents.end()) {
+                content = it.value();
+            } else {
+                try {
+                    content = FileUtils::readTextFile(notePath);
+                } catch (Exception &p_e) {
+                    qWarning() << "failed to read note to collect images" << notePath << p_e.what();
+                    continue;
+                }
+            }
+
+            const auto links = vte::MarkdownUtils::fetchImagesFromMarkdownText(content,
+                                                                               PathUtils::parentDirPath(notePath),
+                                                                               vte::MarkdownLink::TypeFlag::LocalRelativeInternal);
+            for (const auto &link : links) {
+                localImages.insert(PathUtils::normalizePath(link.m_path));
+            }
+        }
+
+        QMutexLocker locker(&imagesMutex);
+        images.unite(localImages);
+    };
+
+    // Parsing is mostly bound by CPU.
+    const int numOfThreads = qMin(m_notePaths.size(), qMax(QThread::idealThreadCount(), 1));
+    QVector<QThread *> threads;
+    for (int i = 1; i < numOfThreads; ++i) {
+        auto thread = QThread::create(parseFunc);
+        thread->start();
+        threads.push_back(thread);
+    }
+
+    // The current thread works too.
+    parseFunc();
+
+    for (auto thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+
+    return images;
+}
@@ -0,0 +1,72 @@
+#ifndef ORPHANFILECOLLECTOR_H
+#define ORPHANFILECOLLECTOR_H
+
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QPair>
+
+#include <core/noncopyable.h>
+
+namespace vnotex
+{
+    class Notebook;
+    class Node;
+
+    // Collect images and attachment folders of a notebook not referenced by any note.
+    // Nodes are walked in the thread of the notebook by walk(), and then collect() could run in
+    // a worker thread to read and parse notes in parallel.
+    class OrphanFileCollector : private Noncopyable
+    {
+    public:
+        struct Result
+        {
+            // Files in image folders not referenced by any note.
+            QStringList m_images;
+
+            // Attachment folders not owned by any node and not referenced by any note.
+            QStringList m_attachmentFolders;
+
+            qint64 m_size = 0;
+
+            // Number of notes parsed.
+            int m_noteCount = 0;
+        };
+
+        explicit OrphanFileCollector(Notebook *p_notebook);
+
+        // Use @p_content as the content of note @p_contentPath instead of reading it from disk.
+        // Used for unsaved buffers.
+        void setContent(const QString &p_contentPath, const QString &p_content);
+
+        // Walk nodes of the notebook to find notes and folders to check.
+        // Events except user input are processed during walking.
+        void walk();
+
+        // Must be called after walk(). It does not touch nodes.
+        Result collect();
+
+    private:
+        // Walk @p_node recursively to collect notes and folders to check.
+        void collectNode(Node *p_node);
+
+        // Return normalized paths of all local images referenced by notes.
+        QSet<QString> collectReferencedImages() const;
+
+        Notebook *m_notebook = nullptr;
+
+        // Normalized content path -> content.
+        QHash<QString, QString> m_contents;
+
+        // Absolute paths of Markdown notes.
+        QStringList m_notePaths;
+
+        QStringList m_imageFolders;
+
+        // Attachment folder of a folder node -> names of sub-folders owned by its children.
+        QVector<QPair<QString, QSet<QString>>> m_attachmentFolders;
+    };
+}
+
+#endif // ORPHANFILECOLLECTOR_H
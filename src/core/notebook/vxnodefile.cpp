@@ -1,11 +1,21 @@
 #include "vxnodefile.h"
 
 #include <QImage>
+#include <QBuffer>
+#include <QFileInfo>
+#include <QCryptographicHash>
+#include <QDebug>
+
+#include <vtextedit/markdownutils.h>
 
 #include <notebookbackend/inotebookbackend.h>
 #include <notebookconfigmgr/inotebookconfigmgr.h>
 #include <notebookconfigmgr/vxnotebookconfigmgr.h>
 #include <utils/pathutils.h>
+#include <utils/fileutils.h>
+#include <core/configmgr.h>
+#include <core/editorconfig.h>
+#include <core/markdowneditorconfig.h>
 #include "vxnode.h"
 #include "notebook.h"
 
@@ -69,23 +79,115 @@ QString VXNodeFile::fetchImageFolderPath()
 
 QString VXNodeFile::insertImage(const QString &p_srcImagePath, const QString &p_imageFileName)
 {
+    const auto hash = FileUtils::calculateFileHash(p_srcImagePath);
+    auto destFilePath = insertIdenticalImage(hash, QFileInfo(p_srcImagePath).size(), p_imageFileName);
+    if (!destFilePath.isEmpty()) {
+        return destFilePath;
+    }
+
     auto backend = m_node->getBackend();
     const auto imageFolderPath = fetchImageFolderPath();
-    auto destFilePath = backend->renameIfExistsCaseInsensitive(PathUtils::concatenateFilePath(imageFolderPath, p_imageFileName));
+    destFilePath = backend->renameIfExistsCaseInsensitive(PathUtils::concatenateFilePath(imageFolderPath, p_imageFileName));
     backend->copyFile(p_srcImagePath, destFilePath);
+    m_node->getNotebook()->indexImage(destFilePath);
     return destFilePath;
 }
 
 QString VXNodeFile::insertImage(const QImage &p_image, const QString &p_imageFileName)
 {
+    // Encode it first to look up identical images by content.
+    auto format = QFileInfo(p_imageFileName).suffix().toLatin1();
+    if (format.isEmpty()) {
+        format = "png";
+    }
+
+    QByteArray data;
+    {
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        if (!p_image.save(&buffer, format.constData())) {
+            qWarning() << "failed to encode image" << p_imageFileName;
+            data.clear();
+        }
+    }
+
+    QString destFilePath;
+    if (!data.isEmpty()) {
+        const auto hash = QString::fromLatin1(QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex());
+        destFilePath = insertIdenticalImage(hash, data.size(), p_imageFileName);
+        if (!destFilePath.isEmpty()) {
+            return destFilePath;
+        }
+    }
+
     auto backend = m_node->getBackend();
     const auto imageFolderPath = fetchImageFolderPath();
-    auto destFilePath = backend->renameIfExistsCaseInsensitive(PathUtils::concatenateFilePath(imageFolderPath, p_imageFileName));
-    p_image.save(destFilePath);
-    backend->addFile(destFilePath);
+    destFilePath = backend->renameIfExistsCaseInsensitive(PathUtils::concatenateFilePath(imageFolderPath, p_imageFileName));
+    if (data.isEmpty()) {
+        p_image.save(destFilePath);
+        backend->addFile(destFilePath);
+    } else {
+        backend->writeFile(destFilePath, data);
+    }
+    m_node->getNotebook()->indexImage(destFilePath);
     return destFilePath;
 }
 
+QString VXNodeFile::insertIdenticalImage(const QString &p_hash, qint64 p_size, const QString &p_imageFileName)
+{
+    if (p_hash.isEmpty()) {
+        return QString();
+    }
+
+    const auto identicalImages = m_node->getNotebook()->findIdenticalImages(p_hash, p_size);
+    if (identicalImages.isEmpty()) {
+        return QString();
+    }
+
+    // Images are deleted along with the file referencing them, so only the one already
+    // referenced by this file could be shared. Others are hard linked to save space if enabled.
+    auto imagePath = findReferencedImage(identicalImages);
+    if (!imagePath.isEmpty()) {
+        qDebug() << "reuse identical image" << imagePath;
+        return imagePath;
+    }
+
+    // Editing a hard linked image in place changes all of them, so it is opt-in.
+    if (!ConfigMgr::getInst().getEditorConfig().getMarkdownEditorConfig().getLinkIdenticalImagesEnabled()) {
+        return QString();
+    }
+
+    auto backend = m_node->getBackend();
+    const auto imageFolderPath = fetchImageFolderPath();
+    imagePath = backend->renameIfExistsCaseInsensitive(PathUtils::concatenateFilePath(imageFolderPath, p_imageFileName));
+    for (const auto &image : identicalImages) {
+        if (backend->linkFile(image, imagePath)) {
+            qDebug() << "hard link identical image" << image << imagePath;
+            backend->addFile(imagePath);
+            m_node->getNotebook()->indexImage(imagePath);
+            return imagePath;
+        }
+    }
+
+    return QString();
+}
+
+QString VXNodeFile::findReferencedImage(const QStringList &p_images) const
+{
+    const auto links = vte::MarkdownUtils::fetchImagesFromMarkdownText(read(),
+                                                                       getResourcePath(),
+                                                                       vte::MarkdownLink::TypeFlag::LocalRelativeInternal);
+    for (const auto &link : links) {
+        for (const auto &image : p_images) {
+            if (PathUtils::areSamePaths(link.m_path, image)) {
+                return image;
+            }
+        }
+    }
+
+    return QString();
+}
+
 void VXNodeFile::removeImage(const QString &p_imagePath)
 {
     // Just move it to recycle bin but not added as a child node of recycle bin.
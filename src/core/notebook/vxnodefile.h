@@ -45,6 +45,14 @@ namespace vnotex
         void removeImage(const QString &p_imagePath) Q_DECL_OVERRIDE;
 
     private:
+        // Return an image in @p_images already referenced by this file, which could be shared
+        // without being deleted along with other files.
+        QString findReferencedImage(const QStringList &p_images) const;
+
+        // Reuse or hard link an image within notebook with content hash @p_hash.
+        // Return inserted image file path, or empty if there is no identical image.
+        QString insertIdenticalImage(const QString &p_hash, qint64 p_size, const QString &p_imageFileName);
+
         QSharedPointer<VXNode> m_node;
     };
 }
@@ -2,6 +2,8 @@
 #define INOTEBOOKBACKEND_H
 
 #include <QObject>
+#include <QVector>
+#include <QPair>
 
 #include <utils/pathutils.h>
 
@@ -85,6 +87,14 @@ namespace vnotex
         // @p_filePath could be outside notebook.
         virtual void copyFile(const QString &p_filePath, const QString &p_destPath, bool p_move = false) = 0;
 
+        // Copy @p_files, pairs of source and target file path, in batch.
+        // Source files could be outside notebook.
+        virtual void copyFiles(const QVector<QPair<QString, QString>> &p_files) = 0;
+
+        // Create @p_destPath as a hard link to @p_filePath, both within notebook.
+        // Return false with nothing done if it is not supported.
+        virtual bool linkFile(const QString &p_filePath, const QString &p_destPath) = 0;
+
         // Delete @p_filePath from disk.
         virtual void removeFile(const QString &p_filePath) = 0;
 
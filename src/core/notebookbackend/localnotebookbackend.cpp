@@ -135,6 +135,27 @@ void LocalNotebookBackend::copyFile(const QString &p_filePath, const QString &p_
     FileUtils::copyFile(filePath, getFullPath(p_destPath), p_move);
 }
 
+void LocalNotebookBackend::copyFiles(const QVector<QPair<QString, QString>> &p_files)
+{
+    QVector<QPair<QString, QString>> files;
+    files.reserve(p_files.size());
+    for (const auto &file : p_files) {
+        auto filePath = file.first;
+        if (QFileInfo(filePath).isRelative()) {
+            filePath = getFullPath(filePath);
+        }
+
+        files.push_back(qMakePair(filePath, getFullPath(file.second)));
+    }
+
+    FileUtils::copyFiles(files);
+}
+
+bool LocalNotebookBackend::linkFile(const QString &p_filePath, const QString &p_destPath)
+{
+    return FileUtils::linkFile(getFullPath(p_filePath), getFullPath(p_destPath));
+}
+
 void LocalNotebookBackend::copyDir(const QString &p_dirPath, const QString &p_destPath, bool p_move)
 {
     auto dirPath = p_dirPath;
@@ -71,6 +71,11 @@ namespace vnotex
         // @p_filePath may beyond this notebook backend.
         void copyFile(const QString &p_filePath, const QString &p_destPath, bool p_move = false) Q_DECL_OVERRIDE;
 
+        // Copy files concurrently.
+        void copyFiles(const QVector<QPair<QString, QString>> &p_files) Q_DECL_OVERRIDE;
+
+        bool linkFile(const QString &p_filePath, const QString &p_destPath) Q_DECL_OVERRIDE;
+
         // Copy @p_dirPath to as @p_destPath.
         void copyDir(const QString &p_dirPath, const QString &p_destPath, bool p_move = false) Q_DECL_OVERRIDE;
 
@@ -0,0 +1,73 @@
+#include "rendersnapshotcache.h"
+
+#include <QCryptographicHash>
+
+#include <core/configmgr.h>
+#include <core/editorconfig.h>
+#include <core/markdowneditorconfig.h>
+#include <utils/pathutils.h>
+
+using namespace vnotex;
+
+RenderSnapshotCache::RenderSnapshotCache()
+    : m_cache(QStringLiteral("render snapshot"))
+{
+}
+
+QByteArray RenderSnapshotCache::calculateKey(const QString &p_text, const QString &p_template, const QString &p_theme)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (const auto &part : {p_text, p_template, p_theme}) {
+        const auto ba = part.toUtf8();
+        // Prefix with size to avoid collision of different splits.
+        hash.addData(QByteArray::number(ba.size()) + ':');
+        hash.addData(ba);
+    }
+    return hash.result().toHex();
+}
+
+void RenderSnapshotCache::init()
+{
+    if (!m_cache.isInitialized()) {
+        const auto &markdownEditorConfig = ConfigMgr::getInst().getEditorConfig().getMarkdownEditorConfig();
+        const qint64 maxSize = static_cast<qint64>(qMax(markdownEditorConfig.getRenderSnapshotCacheSize(), 1)) * 1024 * 1024;
+        m_cache.init(ConfigMgr::getInst().getUserRenderSnapshotCacheFolder(), maxSize);
+    }
+}
+
+QString RenderSnapshotCache::getFileName(const QString &p_contentPath)
+{
+    const auto path = PathUtils::normalizePath(p_contentPath).toUtf8();
+    return QString::fromLatin1(QCryptographicHash::hash(path, QCryptographicHash::Sha1).toHex());
+}
+
+QString RenderSnapshotCache::get(const QString &p_contentPath, const QByteArray &p_key)
+{
+    init();
+
+    const auto data = m_cache.read(getFileName(p_contentPath));
+    if (data.isNull()) {
+        return QString();
+    }
+
+    // The first line is the key.
+    const int idx = data.indexOf('\n');
+    if (idx == -1 || data.left(idx) != p_key) {
+        return QString();
+    }
+
+    return QString::fromUtf8(data.mid(idx + 1));
+}
+
+void RenderSnapshotCache::set(const QString &p_contentPath, const QByteArray &p_key, const QString &p_html)
+{
+    init();
+
+    const auto name = getFileName(p_contentPath);
+    if (p_html.isEmpty()) {
+        m_cache.remove(name);
+        return;
+    }
+
+    m_cache.write(name, p_key + '\n' + p_html.toUtf8());
+}
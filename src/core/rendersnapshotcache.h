@@ -0,0 +1,44 @@
+#ifndef RENDERSNAPSHOTCACHE_H
+#define RENDERSNAPSHOTCACHE_H
+
+#include <QString>
+#include <QByteArray>
+
+#include <core/noncopyable.h>
+#include <core/disklrucache.h>
+
+namespace vnotex
+{
+    // Persistent cache of the rendered HTML of notes in read mode, to show a note instantly
+    // before the viewer finishes rendering it.
+    // There is at most one snapshot per note, validated by a key of everything affecting the
+    // rendering result. Entries are evicted in LRU order once the total size exceeds the limit.
+    class RenderSnapshotCache : private Noncopyable
+    {
+    public:
+        static RenderSnapshotCache &getInst()
+        {
+            static RenderSnapshotCache inst;
+            return inst;
+        }
+
+        // @p_template: HTML template of the viewer, which embeds the render options and theme styles.
+        static QByteArray calculateKey(const QString &p_text, const QString &p_template, const QString &p_theme);
+
+        // Return a null string if not found or the snapshot is out of date.
+        QString get(const QString &p_contentPath, const QByteArray &p_key);
+
+        void set(const QString &p_contentPath, const QByteArray &p_key, const QString &p_html);
+
+    private:
+        RenderSnapshotCache();
+
+        void init();
+
+        static QString getFileName(const QString &p_contentPath);
+
+        DiskLruCache m_cache;
+    };
+}
+
+#endif // RENDERSNAPSHOTCACHE_H
@@ -88,16 +88,49 @@ class GraphPreviewer {
     }
 
     // Interface 2.
-    previewMath(p_id, p_timeStamp, p_text) {
-        if (p_text.length == 0) {
-            this.setMathPreviewData(p_id, p_timeStamp);
+    // Preview a batch of math and set back all the results in one call.
+    // @p_items: array of {id, text}.
+    previewMath(p_timeStamp, p_items) {
+        let results = [];
+        let pending = p_items.length;
+        if (pending == 0) {
+            this.vnotex.setMathPreviewData(p_timeStamp, results);
             return;
         }
 
         this.initOnFirstPreview();
 
-        // Do we need to go through TexMath plugin? I don't think so.
-        this.renderMath(p_id, p_timeStamp, p_text, this.setMathPreviewData.bind(this));
+        let dataSetter = (p_id, p_timeStamp, p_format = '', p_data = '', p_base64 = false, p_needScale = false) => {
+            results.push({
+                id: p_id,
+                format: p_format,
+                data: p_data,
+                base64: p_base64,
+                needScale: p_needScale
+            });
+            --pending;
+            if (pending == 0) {
+                this.vnotex.setMathPreviewData(p_timeStamp, results);
+            }
+        };
+
+        let renderItem = (p_item, p_dataSetter) => {
+            if (p_item.text.length == 0) {
+                p_dataSetter(p_item.id, p_timeStamp);
+                return;
+            }
+
+            // Do we need to go through TexMath plugin? I don't think so.
+            this.renderMath(p_item.id, p_timeStamp, p_item.text, p_dataSetter);
+        };
+
+        // Render the first one before others, which will wait for MathJax to be loaded.
+        renderItem(p_items[0], (...p_args) => {
+            dataSetter(...p_args);
+            for (let i = 1; i < p_items.length; ++i) {
+                renderItem(p_items[i], dataSetter);
+            }
+        });
     }
 
     initOnFirstPreview() {
@@ -239,16 +272,4 @@ class GraphPreviewer {
         };
         this.vnotex.setGraphPreviewData(previewData);
     }
-
-    setMathPreviewData(p_id, p_timeStamp, p_format = '', p_data = '', p_base64 = false, p_needScale = false) {
-        let previewData = {
-            id: p_id,
-            timeStamp: p_timeStamp,
-            format: p_format,
-            data: p_data,
-            base64: p_base64,
-            needScale: p_needScale
-        };
-        this.vnotex.setMathPreviewData(previewData);
-    }
 }
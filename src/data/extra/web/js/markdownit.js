@@ -116,6 +116,13 @@ class MarkdownIt extends VxWorker {
 
         this.codeNodesCollected = false;
 
+        // Top-level blocks of last render in @lastContainerNode: [{ key, line, marker }].
+        // Used to update only changed blocks in next render.
+        this.blocks = null;
+
+        // [begin, end) of blocks updated in last render. Null if all are updated.
+        this.freshBlockRange = null;
+
         // Used to deduplicate header Ids.
         // One for markdownItAnchor and one for markdownItTocDoneRight.
         this.headerIds = [new Set(), new Set()];
@@ -254,27 +261,41 @@ class MarkdownIt extends VxWorker {
     // Render Markdown @p_text to HTML in @p_node.
     // @p_finishCbStr will be called after finishing loading new content nodes.
     // This could prevent Mermaid Gantt from negative width error.
+    // Only top-level blocks changed since last render in @p_node will be replaced.
     render(p_node, p_text, p_finishCbStr) {
         this.frontMatterNode = null;
         this.codeNodesStore.clearNodes();
         this.codeNodesCollected = false;
         this.headerIds[0].clear();
         this.headerIds[1].clear();
+        this.freshBlockRange = null;
 
         if (p_node != this.lastContainerNode) {
             this.lastContainerNode = p_node;
             this.preNodes = null;
+            this.blocks = null;
         }
 
         if (!p_text) {
             p_node.innerHTML = '';
+            this.blocks = null;
             this.finishWork();
             this.markdownRenderFinished();
             return;
         }
 
-        let html = this.mdit.render(p_text);
-        p_node.innerHTML = html + this.loadedGuard(p_finishCbStr);
+        let env = {};
+        let blocks = this.renderBlocks(this.mdit.parse(p_text, env), env);
+
+        if (this.blocks && !this.frontMatterNode && this.updateBlocks(p_node, blocks)) {
+            p_node.insertAdjacentHTML('beforeend', this.loadedGuard(p_finishCbStr));
+        } else {
+            p_node.innerHTML = MarkdownIt.joinBlocksHtml(blocks) + this.loadedGuard(p_finishCbStr);
+            if (!MarkdownIt.collectBlockMarkers(p_node, blocks)) {
+                // Some blocks are nested by raw HTML. Always do a full render.
+                blocks = null;
+            }
+        }
 
         if (this.preNodes == null) {
             this.preNodes = p_node.getElementsByTagName('pre');
@@ -282,11 +303,177 @@ class MarkdownIt extends VxWorker {
 
         if (this.frontMatterNode) {
             p_node.insertAdjacentElement('afterbegin', this.frontMatterNode);
+            blocks = null;
+        }
+
+        if (blocks) {
+            blocks.forEach((p_block) => {
+                p_block.html = null;
+            });
         }
+        this.blocks = blocks;
 
         this.finishWork();
     }
 
+    // Render top-level blocks of @p_tokens separately.
+    // Return [{ html, key, line, marker }]. @key is the HTML with source line
+    // numbers relative to the block, which identifies a block regardless of its position.
+    renderBlocks(p_tokens, p_env) {
+        let blocks = [];
+        let begin = 0;
+        for (let i = 0; i < p_tokens.length; ++i) {
+            let token = p_tokens[i];
+            if (token.level != 0 || token.nesting == 1) {
+                continue;
+            }
+
+            let html = this.mdit.renderer.render(p_tokens.slice(begin, i + 1), this.mdit.options, p_env);
+            let line = p_tokens[begin].map ? p_tokens[begin].map[0] : 0;
+            blocks.push({
+                html: html,
+                key: html.replace(/ data-source-line="(\d+)"/g, (p_match, p_num) => {
+                    return ' data-source-line="' + (parseInt(p_num) - line) + '"';
+                }),
+                line: line,
+                marker: null
+            });
+            begin = i + 1;
+        }
+        return blocks;
+    }
+
+    static joinBlocksHtml(p_blocks) {
+        return p_blocks.map((p_block) => {
+            return '<!--' + MarkdownIt.blockMarker + '-->' + p_block.html;
+        }).join('');
+    }
+
+    static isBlockMarker(p_node) {
+        return p_node.nodeType == Node.COMMENT_NODE && p_node.nodeValue == MarkdownIt.blockMarker;
+    }
+
+    // Assign block markers among children of @p_parent to @p_blocks.
+    // Return false if they do not match.
+    static collectBlockMarkers(p_parent, p_blocks) {
+        let idx = 0;
+        for (let node = p_parent.firstChild; node; node = node.nextSibling) {
+            if (MarkdownIt.isBlockMarker(node)) {
+                if (idx >= p_blocks.length) {
+                    return false;
+                }
+                p_blocks[idx++].marker = node;
+            }
+        }
+        return idx == p_blocks.length;
+    }
+
+    // Call @p_func on each node of the block started with @p_marker.
+    static forEachBlockNode(p_marker, p_func) {
+        for (let node = p_marker.nextSibling; node && !MarkdownIt.isBlockMarker(node);) {
+            // @p_func may remove the node.
+            let next = node.nextSibling;
+            p_func(node);
+            node = next;
+        }
+    }
+
+    // Replace blocks of last render in @p_node with @p_blocks, keeping the unchanged
+    // ones at the head and tail.
+    // Return false if it fails and nothing is changed.
+    updateBlocks(p_node, p_blocks) {
+        let oldBlocks = this.blocks;
+        let minLen = Math.min(oldBlocks.length, p_blocks.length);
+        let prefix = 0;
+        while (prefix < minLen && oldBlocks[prefix].key == p_blocks[prefix].key) {
+            ++prefix;
+        }
+
+        let suffix = 0;
+        while (suffix < minLen - prefix
+               && oldBlocks[oldBlocks.length - 1 - suffix].key == p_blocks[p_blocks.length - 1 - suffix].key) {
+            ++suffix;
+        }
+
+        let oldEnd = oldBlocks.length - suffix;
+        let newEnd = p_blocks.length - suffix;
+
+        let fragment = null;
+        if (prefix < newEnd) {
+            let tpl = document.createElement('template');
+            tpl.innerHTML = MarkdownIt.joinBlocksHtml(p_blocks.slice(prefix, newEnd));
+            fragment = tpl.content;
+            if (!MarkdownIt.collectBlockMarkers(fragment, p_blocks.slice(prefix, newEnd))) {
+                return false;
+            }
+        }
+
+        let refNode = oldEnd < oldBlocks.length ? oldBlocks[oldEnd].marker : null;
+        for (let i = prefix; i < oldEnd; ++i) {
+            MarkdownIt.forEachBlockNode(oldBlocks[i].marker, (p_node) => {
+                p_node.remove();
+            });
+            oldBlocks[i].marker.remove();
+        }
+
+        if (fragment) {
+            p_node.insertBefore(fragment, refNode);
+        }
+
+        for (let i = 0; i < prefix; ++i) {
+            MarkdownIt.reuseBlock(p_blocks[i], oldBlocks[i]);
+        }
+        for (let i = 1; i <= suffix; ++i) {
+            MarkdownIt.reuseBlock(p_blocks[p_blocks.length - i], oldBlocks[oldBlocks.length - i]);
+        }
+
+        this.freshBlockRange = [prefix, newEnd];
+        return true;
+    }
+
+    // Take over nodes of @p_oldBlock and shift their source line numbers.
+    static reuseBlock(p_block, p_oldBlock) {
+        p_block.marker = p_oldBlock.marker;
+        let delta = p_block.line - p_oldBlock.line;
+        if (delta == 0) {
+            return;
+        }
+
+        let shift = (p_node) => {
+            let line = p_node.getAttribute('data-source-line');
+            if (line !== null) {
+                p_node.setAttribute('data-source-line', parseInt(line) + delta);
+            }
+        };
+        MarkdownIt.forEachBlockNode(p_block.marker, (p_node) => {
+            if (p_node.nodeType != Node.ELEMENT_NODE) {
+                return;
+            }
+            shift(p_node);
+            let nodes = p_node.querySelectorAll('[data-source-line]');
+            for (let i = 0; i < nodes.length; ++i) {
+                shift(nodes[i]);
+            }
+        });
+    }
+
+    // Get the top-level nodes updated by last render in @p_node.
+    getRenderedRoots(p_node) {
+        if (p_node != this.lastContainerNode || !this.freshBlockRange) {
+            return [p_node];
+        }
+
+        let roots = [];
+        for (let i = this.freshBlockRange[0]; i < this.freshBlockRange[1]; ++i) {
+            MarkdownIt.forEachBlockNode(this.blocks[i].marker, (p_node) => {
+                if (p_node.nodeType == Node.ELEMENT_NODE) {
+                    roots.push(p_node);
+                }
+            });
+        }
+        return roots;
+    }
+
     loadedGuard(p_cbStr) {
         if (!p_cbStr) {
             return '';
@@ -318,8 +505,21 @@ class MarkdownIt extends VxWorker {
         if (!this.codeNodesCollected) {
             // Collect code nodes.
             this.codeNodesCollected = true;
-            for (let i = 0; i < this.preNodes.length; ++i) {
-                this.codeNodesStore.addNode(this.preNodes[i].firstElementChild);
+            if (this.freshBlockRange) {
+                // Only nodes updated by last render.
+                this.getRenderedRoots(this.lastContainerNode).forEach((p_root) => {
+                    if (p_root.tagName.toLowerCase() == 'pre') {
+                        this.codeNodesStore.addNode(p_root.firstElementChild);
+                    }
+                    let preNodes = p_root.getElementsByTagName('pre');
+                    for (let i = 0; i < preNodes.length; ++i) {
+                        this.codeNodesStore.addNode(preNodes[i].firstElementChild);
+                    }
+                });
+            } else {
+                for (let i = 0; i < this.preNodes.length; ++i) {
+                    this.codeNodesStore.addNode(this.preNodes[i].firstElementChild);
+                }
             }
         }
 
@@ -342,4 +542,6 @@ class MarkdownIt extends VxWorker {
     }
 }
 
+MarkdownIt.blockMarker = 'vx-block';
+
 window.vnotex.registerWorker(new MarkdownIt(null));
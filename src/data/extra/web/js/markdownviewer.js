@@ -11,6 +11,10 @@ new QWebChannel(qt.webChannelTransport,
             window.vnotex.setMarkdownText(p_text);
         });
 
+        adapter.textPatched.connect(function(p_lineNumber, p_removedLines, p_lines) {
+            window.vnotex.patchMarkdownText(p_lineNumber, p_removedLines, p_lines);
+        });
+
         adapter.editLineNumberUpdated.connect(function(p_lineNumber) {
             window.vnotex.scrollToLine(p_lineNumber);
         });
@@ -23,8 +27,8 @@ new QWebChannel(qt.webChannelTransport,
             window.vnotex.previewGraph(p_id, p_timeStamp, p_lang, p_text);
         });
 
-        adapter.mathPreviewRequested.connect(function(p_id, p_timeStamp, p_text) {
-            window.vnotex.previewMath(p_id, p_timeStamp, p_text);
+        adapter.mathPreviewRequested.connect(function(p_timeStamp, p_items) {
+            window.vnotex.previewMath(p_timeStamp, p_items);
         });
 
         adapter.scrollRequested.connect(function(p_up) {
@@ -47,6 +51,14 @@ new QWebChannel(qt.webChannelTransport,
             window.vnotex.saveContent();
         });
 
+        adapter.snapshotShowRequested.connect(function(p_html) {
+            window.vnotex.showSnapshot(p_html);
+        });
+
+        adapter.snapshotRequested.connect(function() {
+            window.vnotex.saveSnapshot();
+        });
+
         adapter.graphRenderDataReady.connect(function(p_id, p_index, p_format, p_data) {
             window.vnotex.graphRenderDataReady(p_id, p_index, p_format, p_data);
         });
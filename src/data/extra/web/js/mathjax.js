@@ -70,18 +70,26 @@ class MathJaxRenderer extends VxWorker {
         this.nodesToRender = [];
 
         // Transform extra class nodes.
-        let extraNodes = this.vnotex.getWorker('markdownit').getCodeNodes(this.langs);
+        let markdownIt = this.vnotex.getWorker('markdownit');
+        let extraNodes = markdownIt.getCodeNodes(this.langs);
         this.transformExtraNodes(p_node, p_className, extraNodes);
 
-        // Collect nodes to render.
-        let nodes = p_node.getElementsByClassName(p_className);
-        if (nodes.length == 0) {
+        // Collect nodes to render within nodes updated by last render.
+        markdownIt.getRenderedRoots(p_node).forEach((p_root) => {
+            if (p_root != p_node && p_root.classList.contains(p_className)) {
+                this.nodesToRender.push(p_root);
+            }
+            let nodes = p_root.getElementsByClassName(p_className);
+            for (let i = 0; i < nodes.length; ++i) {
+                this.nodesToRender.push(nodes[i]);
+            }
+        });
+
+        if (this.nodesToRender.length == 0) {
             this.finishWork();
             return;
         }
 
-        this.nodesToRender = Array.from(nodes);
-
         if (!this.initialize(() => {
             this.renderNodes();
             })) {
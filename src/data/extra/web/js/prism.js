@@ -58,8 +58,9 @@ class PrismRenderer extends VxWorker {
     renderCodeNodes(p_node) {
         this.initialize();
 
-        let codeNodes = this.vnotex.getWorker('markdownit').getCodeNodes(null);
-        this.doRender(p_node, codeNodes);
+        let markdownIt = this.vnotex.getWorker('markdownit');
+        let codeNodes = markdownIt.getCodeNodes(null);
+        this.doRender(p_node, codeNodes, markdownIt.getRenderedRoots(p_node));
     }
 
     // Whether has class lang- or language-.
@@ -74,7 +75,8 @@ class PrismRenderer extends VxWorker {
         return false;
     }
 
-    doRender(p_containerNode, p_nodes) {
+    // @p_roots: nodes within @p_containerNode to highlight code under.
+    doRender(p_containerNode, p_nodes, p_roots = [p_containerNode]) {
         if (p_nodes.length > 0) {
             // Add `lang-txt` to code nodes without any class to let Prism catch them.
             for (let i = 0; i < p_nodes.length; ++i) {
@@ -85,12 +87,14 @@ class PrismRenderer extends VxWorker {
 
             p_containerNode.classList.add('line-numbers');
 
-            Prism.highlightAllUnder(p_containerNode, false /* async or not */);
+            p_roots.forEach((p_root) => {
+                Prism.highlightAllUnder(p_root, false /* async or not */);
 
-            // Remove the toolbar.
-            if (window.vxOptions.removeCodeToolBarEnabled) {
-                this.removeToolBar(p_containerNode);
-            }
+                // Remove the toolbar.
+                if (window.vxOptions.removeCodeToolBarEnabled) {
+                    this.removeToolBar(p_root);
+                }
+            });
         }
 
         this.finishWork();
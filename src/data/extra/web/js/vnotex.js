@@ -25,6 +25,15 @@ class VNoteX extends EventEmitter {
 
         this.numOfOngoingWorkers = 0;
 
+        // Start time of current render round.
+        this.renderStartTime = 0;
+
+        // Lines of current Markdown text, to apply patches against.
+        this.markdownLines = null;
+
+        // Node showing the snapshot of last render until current render round finishes.
+        this.snapshotContainer = null;
+
         this.pendingData = {
             text: null,
             lineNumber: -1,
@@ -110,13 +119,16 @@ class VNoteX extends EventEmitter {
     finishWorker(p_name) {
         --this.numOfOngoingWorkers;
         if (this.numOfOngoingWorkers == 0) {
+            this.hideSnapshot();
+
             // Signal out anyway.
             this.emit('fullMarkdownRendered');
-            window.vxMarkdownAdapter.setWorkFinished();
+            let renderTime = Math.round(performance.now() - this.renderStartTime);
+            window.vxMarkdownAdapter.setWorkFinished(renderTime);
 
             // Check pending work.
             if (this.pendingData.text) {
-                this.setMarkdownText(this.pendingData.text);
+                this.renderMarkdownText(this.pendingData.text);
             } else if (this.pendingData.lineNumber > -1) {
                 this.scrollToLine(this.pendingData.lineNumber);
             }
@@ -139,6 +151,24 @@ class VNoteX extends EventEmitter {
     }
 
     setMarkdownText(p_text) {
+        this.markdownLines = p_text.split('\n');
+        this.renderMarkdownText(p_text);
+    }
+
+    // Replace @p_removedLines lines starting from @p_lineNumber with @p_lines.
+    patchMarkdownText(p_lineNumber, p_removedLines, p_lines) {
+        if (!this.markdownLines) {
+            console.error('no Markdown text to patch');
+            // Ask for the full text.
+            window.vxMarkdownAdapter.setWorkFinished(-1);
+            return;
+        }
+
+        this.markdownLines.splice(p_lineNumber, p_removedLines, ...p_lines);
+        this.renderMarkdownText(this.markdownLines.join('\n'));
+    }
+
+    renderMarkdownText(p_text) {
         if (this.numOfOngoingWorkers > 0) {
             this.pendingData.text = p_text;
             console.info('wait for last render finish with remaing workers',
@@ -146,6 +176,7 @@ class VNoteX extends EventEmitter {
         } else {
             this.numOfOngoingWorkers = this.workers.size;
             this.pendingData.text = null;
+            this.renderStartTime = performance.now();
             console.log('start new round with ' + this.numOfOngoingWorkers + ' workers');
             this.emit('markdownTextUpdated', p_text);
         }
@@ -210,9 +241,9 @@ class VNoteX extends EventEmitter {
         }
     }
 
-    previewMath(p_id, p_timeStamp, p_text) {
+    previewMath(p_timeStamp, p_items) {
         if (this.graphPreviewer) {
-            this.graphPreviewer.previewMath(p_id, p_timeStamp, p_text);
+            this.graphPreviewer.previewMath(p_timeStamp, p_items);
         }
     }
 
@@ -225,13 +256,9 @@ class VNoteX extends EventEmitter {
                                                      p_data.needScale);
     }
 
-    setMathPreviewData(p_data) {
-        window.vxMarkdownAdapter.setMathPreviewData(p_data.id,
-                                                    p_data.timeStamp,
-                                                    p_data.format,
-                                                    p_data.data,
-                                                    p_data.base64,
-                                                    p_data.needScale);
+    // @p_data: array of {id, format, data, base64, needScale}.
+    setMathPreviewData(p_timeStamp, p_data) {
+        window.vxMarkdownAdapter.setMathPreviewData(p_timeStamp, p_data);
     }
 
     setHeadings(p_headings) {
@@ -302,6 +329,55 @@ class VNoteX extends EventEmitter {
                                                  document.body.classList.value);
     }
 
+    // Show @p_html in place of the content container until current render round finishes,
+    // so that the content shows up without waiting for slow rendering like Mermaid and MathJax.
+    showSnapshot(p_html) {
+        if (!p_html || this.snapshotContainer || this.numOfOngoingWorkers > 0) {
+            return;
+        }
+
+        // Clone to keep the id and classes for styles.
+        this.snapshotContainer = this.contentContainer.cloneNode(false);
+        this.snapshotContainer.innerHTML = p_html;
+        // Ids must stay unique. Lend the container id to the snapshot for styles while it is shown
+        // and drop ids of the snapshot contents, such as those of headings, to keep anchors and
+        // lookups on the real content.
+        let nodes = this.snapshotContainer.querySelectorAll('[id]');
+        for (let i = 0; i < nodes.length; ++i) {
+            nodes[i].removeAttribute('id');
+        }
+        this.contentContainer.removeAttribute('id');
+        this.contentContainer.parentNode.insertBefore(this.snapshotContainer, this.contentContainer);
+
+        // Keep it laid out for graphs to get correct sizes while out of sight.
+        this.contentContainer.style.visibility = 'hidden';
+        this.contentContainer.style.height = '0';
+        this.contentContainer.style.overflow = 'hidden';
+    }
+
+    hideSnapshot() {
+        if (!this.snapshotContainer) {
+            return;
+        }
+
+        this.contentContainer.id = this.snapshotContainer.id;
+        this.snapshotContainer.remove();
+        this.snapshotContainer = null;
+
+        this.contentContainer.style.visibility = '';
+        this.contentContainer.style.height = '';
+        this.contentContainer.style.overflow = '';
+    }
+
+    saveSnapshot() {
+        if (!this.initialized) {
+            console.warn('saveSnapshot() called before initialization');
+            window.vxMarkdownAdapter.setSnapshot('');
+            return;
+        }
+        window.vxMarkdownAdapter.setSnapshot(this.contentContainer.innerHTML);
+    }
+
     setBodySize(p_width, p_height) {
         if (p_width > 0) {
             document.body.style.width = p_width + 'px';
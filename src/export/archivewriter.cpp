@@ -0,0 +1,424 @@
+#include "archivewriter.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QDebug>
+
+using namespace vnotex;
+
+// Files not larger than this are read into memory and compressed if worth it.
+static const qint64 c_maxInMemorySize = 4 * 1024 * 1024;
+
+static const qint64 c_chunkSize = 256 * 1024;
+
+static const quint64 c_maxUint32 = 0xFFFFFFFFULL;
+
+static const quint16 c_versionNeeded = 20;
+
+static const quint16 c_versionNeededZip64 = 45;
+
+// UTF-8 file name.
+static const quint16 c_flagUtf8 = 0x0800;
+
+static const quint16 c_flagDataDescriptor = 0x0008;
+
+static const quint16 c_methodStored = 0;
+
+static const quint16 c_methodDeflated = 8;
+
+static void appendUint16(QByteArray &p_data, quint16 p_val)
+{
+    p_data.append(static_cast<char>(p_val & 0xFF));
+    p_data.append(static_cast<char>((p_val >> 8) & 0xFF));
+}
+
+static void appendUint32(QByteArray &p_data, quint32 p_val)
+{
+    appendUint16(p_data, static_cast<quint16>(p_val & 0xFFFF));
+    appendUint16(p_data, static_cast<quint16>(p_val >> 16));
+}
+
+static void appendUint64(QByteArray &p_data, quint64 p_val)
+{
+    appendUint32(p_data, static_cast<quint32>(p_val & c_maxUint32));
+    appendUint32(p_data, static_cast<quint32>(p_val >> 32));
+}
+
+ArchiveWriter::ArchiveWriter(const QString &p_filePath)
+    : m_file(p_filePath)
+{
+}
+
+ArchiveWriter::~ArchiveWriter()
+{
+    if (m_file.isOpen()) {
+        Q_ASSERT(!m_finished);
+        m_file.close();
+        m_file.remove();
+    }
+}
+
+bool ArchiveWriter::open()
+{
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_errorString = QString("failed to open archive (%1) (%2)").arg(m_file.fileName(), m_file.errorString());
+        return false;
+    }
+
+    const auto now = QDateTime::currentDateTime();
+    const auto date = now.date();
+    const auto time = now.time();
+    m_dosDate = static_cast<quint16>(((qMax(date.year(), 1980) - 1980) << 9) | (date.month() << 5) | date.day());
+    m_dosTime = static_cast<quint16>((time.hour() << 11) | (time.minute() << 5) | (time.second() / 2));
+    return true;
+}
+
+bool ArchiveWriter::addFile(const QString &p_name, const QByteArray &p_data)
+{
+    Q_ASSERT(m_file.isOpen());
+
+    Entry entry;
+    entry.m_name = p_name.toUtf8();
+    entry.m_crc = crc32(0, p_data.constData(), p_data.size());
+    entry.m_uncompressedSize = static_cast<quint64>(p_data.size());
+    entry.m_offset = static_cast<quint64>(m_file.pos());
+
+    const auto compressedData = deflate(p_data);
+    if (compressedData.isEmpty()) {
+        entry.m_method = c_methodStored;
+        entry.m_compressedSize = entry.m_uncompressedSize;
+    } else {
+        entry.m_method = c_methodDeflated;
+        entry.m_compressedSize = static_cast<quint64>(compressedData.size());
+    }
+
+    if (!writeLocalHeader(entry)
+        || !write(compressedData.isEmpty() ? p_data : compressedData)) {
+        return false;
+    }
+
+    m_entries.push_back(entry);
+    addName(p_name);
+    return true;
+}
+
+bool ArchiveWriter::addFileFromDisk(const QString &p_name, const QString &p_filePath)
+{
+    Q_ASSERT(m_file.isOpen());
+
+    QFile file(p_filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_errorString = QString("failed to read file (%1) (%2)").arg(p_filePath, file.errorString());
+        return false;
+    }
+
+    const auto size = file.size();
+    if (size <= c_maxInMemorySize) {
+        const auto data = file.readAll();
+        if (data.size() != size) {
+            m_errorString = QString("failed to read file (%1) (%2)").arg(p_filePath, file.errorString());
+            return false;
+        }
+
+        return addFile(p_name, data);
+    }
+
+    // Stream it stored, with CRC and sizes in a data descriptor following the data.
+    Entry entry;
+    entry.m_name = p_name.toUtf8();
+    entry.m_method = c_methodStored;
+    entry.m_offset = static_cast<quint64>(m_file.pos());
+    entry.m_hasDataDescriptor = true;
+    // Leave some room in case the file grows during reading.
+    entry.m_zip64 = static_cast<quint64>(size) >= c_maxUint32 - c_maxUint32 / 16;
+    if (!writeLocalHeader(entry)) {
+        return false;
+    }
+
+    QByteArray buf(static_cast<int>(c_chunkSize), '\0');
+    quint64 total = 0;
+    while (true) {
+        const auto len = file.read(buf.data(), c_chunkSize);
+        if (len < 0) {
+            // Skip this entry by not adding it to the central directory.
+            m_errorString = QString("failed to read file (%1) (%2)").arg(p_filePath, file.errorString());
+            return false;
+        } else if (len == 0) {
+            break;
+        }
+
+        entry.m_crc = crc32(entry.m_crc, buf.constData(), len);
+        if (!write(QByteArray::fromRawData(buf.constData(), static_cast<int>(len)))) {
+            return false;
+        }
+        total += static_cast<quint64>(len);
+    }
+
+    if (!entry.m_zip64 && total >= c_maxUint32) {
+        m_errorString = QString("file (%1) grows too large during reading").arg(p_filePath);
+        return false;
+    }
+
+    entry.m_compressedSize = total;
+    entry.m_uncompressedSize = total;
+    if (!writeDataDescriptor(entry)) {
+        return false;
+    }
+
+    m_entries.push_back(entry);
+    addName(p_name);
+    return true;
+}
+
+bool ArchiveWriter::writeLocalHeader(const Entry &p_entry)
+{
+    const bool zip64 = p_entry.m_zip64
+                       || p_entry.m_compressedSize >= c_maxUint32
+                       || p_entry.m_uncompressedSize >= c_maxUint32;
+
+    QByteArray header;
+    header.reserve(30 + p_entry.m_name.size() + 20);
+    appendUint32(header, 0x04034b50);
+    appendUint16(header, zip64 ? c_versionNeededZip64 : c_versionNeeded);
+    appendUint16(header, p_entry.m_hasDataDescriptor ? (c_flagUtf8 | c_flagDataDescriptor) : c_flagUtf8);
+    appendUint16(header, p_entry.m_method);
+    appendUint16(header, m_dosTime);
+    appendUint16(header, m_dosDate);
+    if (p_entry.m_hasDataDescriptor) {
+        appendUint32(header, 0);
+        appendUint32(header, zip64 ? c_maxUint32 : 0);
+        appendUint32(header, zip64 ? c_maxUint32 : 0);
+    } else {
+        appendUint32(header, p_entry.m_crc);
+        appendUint32(header, zip64 ? c_maxUint32 : static_cast<quint32>(p_entry.m_compressedSize));
+        appendUint32(header, zip64 ? c_maxUint32 : static_cast<quint32>(p_entry.m_uncompressedSize));
+    }
+    appendUint16(header, static_cast<quint16>(p_entry.m_name.size()));
+    appendUint16(header, zip64 ? 20 : 0);
+    header.append(p_entry.m_name);
+    if (zip64) {
+        appendUint16(header, 0x0001);
+        appendUint16(header, 16);
+        appendUint64(header, p_entry.m_hasDataDescriptor ? 0 : p_entry.m_uncompressedSize);
+        appendUint64(header, p_entry.m_hasDataDescriptor ? 0 : p_entry.m_compressedSize);
+    }
+
+    return write(header);
+}
+
+bool ArchiveWriter::writeDataDescriptor(const Entry &p_entry)
+{
+    QByteArray data;
+    appendUint32(data, 0x08074b50);
+    appendUint32(data, p_entry.m_crc);
+    if (p_entry.m_zip64) {
+        appendUint64(data, p_entry.m_compressedSize);
+        appendUint64(data, p_entry.m_uncompressedSize);
+    } else {
+        appendUint32(data, static_cast<quint32>(p_entry.m_compressedSize));
+        appendUint32(data, static_cast<quint32>(p_entry.m_uncompressedSize));
+    }
+    return write(data);
+}
+
+bool ArchiveWriter::writeCentralDirectory()
+{
+    const auto cdOffset = static_cast<quint64>(m_file.pos());
+    for (const auto &entry : m_entries) {
+        const bool zip64Sizes = entry.m_compressedSize >= c_maxUint32 || entry.m_uncompressedSize >= c_maxUint32;
+        const bool zip64Offset = entry.m_offset >= c_maxUint32;
+
+        QByteArray extra;
+        if (zip64Sizes || zip64Offset) {
+            appendUint16(extra, 0x0001);
+            appendUint16(extra, static_cast<quint16>((zip64Sizes ? 16 : 0) + (zip64Offset ? 8 : 0)));
+            if (zip64Sizes) {
+                appendUint64(extra, entry.m_uncompressedSize);
+                appendUint64(extra, entry.m_compressedSize);
+            }
+            if (zip64Offset) {
+                appendUint64(extra, entry.m_offset);
+            }
+        }
+
+        const quint16 version = (entry.m_zip64 || !extra.isEmpty()) ? c_versionNeededZip64 : c_versionNeeded;
+
+        QByteArray header;
+        header.reserve(46 + entry.m_name.size() + extra.size());
+        appendUint32(header, 0x02014b50);
+        // Version made by.
+        appendUint16(header, c_versionNeededZip64);
+        appendUint16(header, version);
+        appendUint16(header, entry.m_hasDataDescriptor ? (c_flagUtf8 | c_flagDataDescriptor) : c_flagUtf8);
+        appendUint16(header, entry.m_method);
+        appendUint16(header, m_dosTime);
+        appendUint16(header, m_dosDate);
+        appendUint32(header, entry.m_crc);
+        appendUint32(header, zip64Sizes ? c_maxUint32 : static_cast<quint32>(entry.m_compressedSize));
+        appendUint32(header, zip64Sizes ? c_maxUint32 : static_cast<quint32>(entry.m_uncompressedSize));
+        appendUint16(header, static_cast<quint16>(entry.m_name.size()));
+        appendUint16(header, static_cast<quint16>(extra.size()));
+        // Comment length, disk number start, internal and external attributes.
+        appendUint16(header, 0);
+        appendUint16(header, 0);
+        appendUint16(header, 0);
+        appendUint32(header, 0);
+        appendUint32(header, zip64Offset ? c_maxUint32 : static_cast<quint32>(entry.m_offset));
+        header.append(entry.m_name);
+        header.append(extra);
+        if (!write(header)) {
+            return false;
+        }
+    }
+
+    const auto cdEnd = static_cast<quint64>(m_file.pos());
+    const auto cdSize = cdEnd - cdOffset;
+    const auto numOfEntries = static_cast<quint64>(m_entries.size());
+    const bool zip64 = numOfEntries >= 0xFFFF || cdSize >= c_maxUint32 || cdOffset >= c_maxUint32;
+
+    QByteArray data;
+    if (zip64) {
+        // ZIP64 end of central directory record.
+        appendUint32(data, 0x06064b50);
+        appendUint64(data, 44);
+        appendUint16(data, c_versionNeededZip64);
+        appendUint16(data, c_versionNeededZip64);
+        appendUint32(data, 0);
+        appendUint32(data, 0);
+        appendUint64(data, numOfEntries);
+        appendUint64(data, numOfEntries);
+        appendUint64(data, cdSize);
+        appendUint64(data, cdOffset);
+
+        // ZIP64 end of central directory locator.
+        appendUint32(data, 0x07064b50);
+        appendUint32(data, 0);
+        appendUint64(data, cdEnd);
+        appendUint32(data, 1);
+    }
+
+    appendUint32(data, 0x06054b50);
+    appendUint16(data, 0);
+    appendUint16(data, 0);
+    appendUint16(data, zip64 ? 0xFFFF : static_cast<quint16>(numOfEntries));
+    appendUint16(data, zip64 ? 0xFFFF : static_cast<quint16>(numOfEntries));
+    appendUint32(data, zip64 ? c_maxUint32 : static_cast<quint32>(cdSize));
+    appendUint32(data, zip64 ? c_maxUint32 : static_cast<quint32>(cdOffset));
+    // Comment length.
+    appendUint16(data, 0);
+    return write(data);
+}
+
+bool ArchiveWriter::finish()
+{
+    Q_ASSERT(m_file.isOpen());
+
+    if (!writeCentralDirectory()) {
+        return false;
+    }
+
+    if (!m_file.flush()) {
+        m_errorString = QString("failed to write archive (%1) (%2)").arg(m_file.fileName(), m_file.errorString());
+        return false;
+    }
+
+    m_file.close();
+    m_finished = true;
+    return true;
+}
+
+bool ArchiveWriter::write(const QByteArray &p_data)
+{
+    if (m_file.write(p_data) != p_data.size()) {
+        m_errorString = QString("failed to write archive (%1) (%2)").arg(m_file.fileName(), m_file.errorString());
+        return false;
+    }
+
+    return true;
+}
+
+void ArchiveWriter::addName(const QString &p_name)
+{
+    const auto name = p_name.toLower();
+    m_names.insert(name);
+
+    // Parent folders.
+    int idx = name.lastIndexOf(QLatin1Char('/'));
+    while (idx > 0) {
+        m_names.insert(name.left(idx));
+        idx = name.lastIndexOf(QLatin1Char('/'), idx - 1);
+    }
+}
+
+bool ArchiveWriter::contains(const QString &p_name) const
+{
+    return m_names.contains(p_name.toLower());
+}
+
+QString ArchiveWriter::generateName(const QString &p_name) const
+{
+    if (!contains(p_name)) {
+        return p_name;
+    }
+
+    const int idx = p_name.lastIndexOf(QLatin1Char('/'));
+    const auto dirPath = p_name.left(idx + 1);
+    const QFileInfo fi(p_name.mid(idx + 1));
+    const auto baseName = fi.completeBaseName();
+    const auto suffix = fi.suffix().isEmpty() ? QString() : QStringLiteral(".") + fi.suffix();
+    int seq = 1;
+    QString name;
+    do {
+        name = QString("%1%2_%3%4").arg(dirPath, baseName, QString::number(seq++), suffix);
+    } while (contains(name));
+
+    return name;
+}
+
+const QString &ArchiveWriter::errorString() const
+{
+    return m_errorString;
+}
+
+quint32 ArchiveWriter::crc32(quint32 p_crc, const char *p_data, qint64 p_size)
+{
+    static const QVector<quint32> table = []() {
+        QVector<quint32> tb(256);
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? (0xEDB88320U ^ (c >> 1)) : (c >> 1);
+            }
+            tb[static_cast<int>(i)] = c;
+        }
+        return tb;
+    }();
+
+    quint32 crc = p_crc ^ 0xFFFFFFFFU;
+    for (qint64 i = 0; i < p_size; ++i) {
+        crc = table[static_cast<int>((crc ^ static_cast<quint8>(p_data[i])) & 0xFF)] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFU;
+}
+
+QByteArray ArchiveWriter::deflate(const QByteArray &p_data)
+{
+    if (p_data.size() < 64) {
+        return QByteArray();
+    }
+
+    // qCompress() returns a 4-byte size header followed by a zlib stream, which wraps raw
+    // deflate data with a 2-byte header and a 4-byte Adler-32 checksum.
+    const auto data = qCompress(p_data, 6);
+    if (data.size() <= 10) {
+        return QByteArray();
+    }
+
+    const int rawSize = data.size() - 10;
+    if (rawSize >= p_data.size() / 10 * 9) {
+        // Not worth it, such as images.
+        return QByteArray();
+    }
+
+    return data.mid(6, rawSize);
+}
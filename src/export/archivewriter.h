@@ -0,0 +1,97 @@
+#ifndef ARCHIVEWRITER_H
+#define ARCHIVEWRITER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <QSet>
+#include <QFile>
+
+#include <core/noncopyable.h>
+
+namespace vnotex
+{
+    // Write a ZIP archive sequentially without temporary files.
+    // Files on disk are streamed into the archive in chunks, so memory usage is bounded
+    // regardless of the file size. ZIP64 is used when needed.
+    class ArchiveWriter : private Noncopyable
+    {
+    public:
+        explicit ArchiveWriter(const QString &p_filePath);
+
+        // Unfinished archive will be removed.
+        ~ArchiveWriter();
+
+        bool open();
+
+        // Add @p_data as file @p_name, which is a relative path separated by '/'.
+        bool addFile(const QString &p_name, const QByteArray &p_data);
+
+        // Add file @p_filePath on disk as file @p_name.
+        bool addFileFromDisk(const QString &p_name, const QString &p_filePath);
+
+        // Write the central directory and close the archive.
+        bool finish();
+
+        // Whether @p_name exists case-insensitively.
+        bool contains(const QString &p_name) const;
+
+        // Return @p_name if it does not exist, or a name with sequence like "name_1.suffix".
+        QString generateName(const QString &p_name) const;
+
+        const QString &errorString() const;
+
+    private:
+        struct Entry
+        {
+            QByteArray m_name;
+
+            quint32 m_crc = 0;
+
+            quint16 m_method = 0;
+
+            quint64 m_compressedSize = 0;
+
+            quint64 m_uncompressedSize = 0;
+
+            quint64 m_offset = 0;
+
+            // Whether sizes follow the data in a data descriptor.
+            bool m_hasDataDescriptor = false;
+
+            bool m_zip64 = false;
+        };
+
+        bool writeLocalHeader(const Entry &p_entry);
+
+        bool writeDataDescriptor(const Entry &p_entry);
+
+        bool writeCentralDirectory();
+
+        bool write(const QByteArray &p_data);
+
+        void addName(const QString &p_name);
+
+        static quint32 crc32(quint32 p_crc, const char *p_data, qint64 p_size);
+
+        // Return raw deflate data of @p_data, or empty if it is not worth compressing.
+        static QByteArray deflate(const QByteArray &p_data);
+
+        QFile m_file;
+
+        QString m_errorString;
+
+        QVector<Entry> m_entries;
+
+        // Lower-cased names of files and their parent folders.
+        QSet<QString> m_names;
+
+        quint16 m_dosTime = 0;
+
+        quint16 m_dosDate = 0;
+
+        bool m_finished = false;
+    };
+}
+
+#endif // ARCHIVEWRITER_H
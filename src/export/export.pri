@@ -1,11 +1,19 @@
 QT += widgets
 
 SOURCES += \
+    $$PWD/archivewriter.cpp \
     $$PWD/exportdata.cpp \
     $$PWD/exporter.cpp \
+    $$PWD/exportmanifest.cpp \
+    $$PWD/exportresourcecache.cpp \
+    $$PWD/markdownhtmlrenderer.cpp \
     $$PWD/webviewexporter.cpp
 
 HEADERS += \
+    $$PWD/archivewriter.h \
     $$PWD/exportdata.h \
     $$PWD/exporter.h \
+    $$PWD/exportmanifest.h \
+    $$PWD/exportresourcecache.h \
+    $$PWD/markdownhtmlrenderer.h \
     $$PWD/webviewexporter.h
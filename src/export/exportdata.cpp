@@ -15,6 +15,7 @@ QJsonObject ExportHtmlOption::toJson() const
     obj["use_mime_html_format"] = m_useMimeHtmlFormat;
     obj["add_outline_panel"] = m_addOutlinePanel;
     obj["scrollable"] = m_scrollable;
+    obj["use_native_renderer"] = m_useNativeRenderer;
     return obj;
 }
 
@@ -30,6 +31,7 @@ void ExportHtmlOption::fromJson(const QJsonObject &p_obj)
     m_useMimeHtmlFormat = p_obj["use_mime_html_format"].toBool();
     m_addOutlinePanel = p_obj["add_outline_panel"].toBool();
     m_scrollable = p_obj["scrollable"].toBool(true);
+    m_useNativeRenderer = p_obj["use_native_renderer"].toBool();
 }
 
 bool ExportHtmlOption::operator==(const ExportHtmlOption &p_other) const
@@ -39,7 +41,8 @@ bool ExportHtmlOption::operator==(const ExportHtmlOption &p_other) const
            && m_embedImages == p_other.m_embedImages
            && m_useMimeHtmlFormat == p_other.m_useMimeHtmlFormat
            && m_addOutlinePanel == p_other.m_addOutlinePanel
-           && m_scrollable == p_other.m_scrollable;
+           && m_scrollable == p_other.m_scrollable
+           && m_useNativeRenderer == p_other.m_useNativeRenderer;
 }
 
 ExportPdfOption::ExportPdfOption()
@@ -130,6 +133,7 @@ QJsonObject ExportOption::toJson() const
     obj["output_dir"] = m_outputDir;
     obj["recursive"] = m_recursive;
     obj["export_attachments"] = m_exportAttachments;
+    obj["incremental"] = m_incremental;
     obj["html_option"] = m_htmlOption.toJson();
     obj["pdf_option"] = m_pdfOption.toJson();
     obj["custom_export"] = m_customExport;
@@ -157,6 +161,10 @@ void ExportOption::fromJson(const QJsonObject &p_obj)
             m_targetFormat = ExportFormat::Custom;
             break;
 
+        case static_cast<int>(ExportFormat::Archive):
+            m_targetFormat = ExportFormat::Archive;
+            break;
+
         case static_cast<int>(ExportFormat::HTML):
             Q_FALLTHROUGH();
         default:
@@ -169,6 +177,7 @@ void ExportOption::fromJson(const QJsonObject &p_obj)
     m_outputDir = p_obj["output_dir"].toString();
     m_recursive = p_obj["recursive"].toBool();
     m_exportAttachments = p_obj["export_attachments"].toBool();
+    m_incremental = p_obj["incremental"].toBool();
     m_htmlOption.fromJson(p_obj["html_option"].toObject());
     m_pdfOption.fromJson(p_obj["pdf_option"].toObject());
     m_customExport = p_obj["custom_export"].toString();
@@ -180,7 +189,8 @@ bool ExportOption::operator==(const ExportOption &p_other) const
                && m_useTransparentBg == p_other.m_useTransparentBg
                && m_outputDir == p_other.m_outputDir
                && m_recursive == p_other.m_recursive
-               && m_exportAttachments == p_other.m_exportAttachments;
+               && m_exportAttachments == p_other.m_exportAttachments
+               && m_incremental == p_other.m_incremental;
 
     if (!ret) {
         return false;
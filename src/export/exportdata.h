@@ -20,7 +20,9 @@ namespace vnotex
         Markdown = 0,
         HTML,
         PDF,
-        Custom
+        Custom,
+        // Notes with media and attachments in one ZIP archive.
+        Archive
     };
 
     struct ExportHtmlOption
@@ -43,6 +45,9 @@ namespace vnotex
 
         // When exporting to PDF or custom format, we may need to export to HTML first without scrollable.
         bool m_scrollable = true;
+
+        // Render notes without JavaScript-only features in-process instead of via the web engine.
+        bool m_useNativeRenderer = false;
     };
 
     struct ExportPdfOption
@@ -120,6 +125,10 @@ namespace vnotex
 
         bool m_exportAttachments = true;
 
+        // Skip notes unchanged since last export to the same output folder.
+        // Valid only when exporting folder or notebook.
+        bool m_incremental = false;
+
         ExportHtmlOption m_htmlOption;
 
         ExportPdfOption m_pdfOption;
@@ -149,6 +158,9 @@ namespace vnotex
 
         case ExportFormat::Custom:
             return QStringLiteral("Custom");
+
+        case ExportFormat::Archive:
+            return QStringLiteral("Archive");
         }
 
         return QStringLiteral("Unknown");
@@ -2,17 +2,33 @@
 
 #include <QWidget>
 #include <QTemporaryDir>
+#include <QHash>
+#include <QSet>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QCryptographicHash>
+#include <QPageLayout>
+
+#include <vtextedit/markdownutils.h>
+#include <vtextedit/textutils.h>
 
 #include <notebook/notebook.h>
 #include <notebook/node.h>
 #include <buffer/buffer.h>
 #include <core/file.h>
+#include <core/configmgr.h>
+#include <core/editorconfig.h>
+#include <core/markdowneditorconfig.h>
 #include <utils/fileutils.h>
 #include <utils/utils.h>
 #include <utils/pathutils.h>
 #include <utils/processutils.h>
 #include <utils/contentmediautils.h>
 #include "webviewexporter.h"
+#include "exportmanifest.h"
+#include "exportresourcecache.h"
+#include "archivewriter.h"
 #include <core/exception.h>
 
 using namespace vnotex;
@@ -39,16 +55,26 @@ QString Exporter::doExport(const ExportOption &p_option, Buffer *p_buffer)
         return outputFile;
     }
 
-    outputFile = doExport(p_option, p_option.m_outputDir, file.data());
+    if (p_option.m_targetFormat == ExportFormat::Archive) {
+        QVector<ExportTask> tasks;
+        tasks.push_back(ExportTask{QString(), file, QString()});
+        outputFile = doExportArchive(p_option,
+                                     p_option.m_outputDir,
+                                     QFileInfo(file->getName()).completeBaseName(),
+                                     tasks);
+    } else {
+        outputFile = doExport(p_option, p_option.m_outputDir, file.data());
+    }
 
     cleanUp();
 
     return outputFile;
 }
 
-static QString makeOutputFolder(const QString &p_outputDir, const QString &p_folderName)
+// @p_reuse: whether reuse existing folder instead of making a new one.
+static QString makeOutputFolder(const QString &p_outputDir, const QString &p_folderName, bool p_reuse = false)
 {
-    const auto name = FileUtils::generateFileNameWithSequence(p_outputDir, p_folderName);
+    const auto name = p_reuse ? p_folderName : FileUtils::generateFileNameWithSequence(p_outputDir, p_folderName);
     const auto outputFolder = PathUtils::concatenateFilePath(p_outputDir, name);
     if (!QDir().mkpath(outputFolder)) {
         return QString();
@@ -84,13 +110,180 @@ QString Exporter::doExportMarkdown(const ExportOption &p_option, const QString &
 
     // Copy attachments if available.
     if (p_option.m_exportAttachments) {
-        exportAttachments(p_file->getNode(), srcFilePath, outputFolder, destFilePath);
+        exportAttachments(p_option, p_file->getNode(), srcFilePath, outputFolder, destFilePath);
     }
 
     return outputFile;
 }
 
-void Exporter::exportAttachments(Node *p_node,
+QString Exporter::doExportArchive(const ExportOption &p_option,
+                                  const QString &p_outputDir,
+                                  const QString &p_name,
+                                  QVector<ExportTask> &p_tasks)
+{
+    if (!QDir().mkpath(p_outputDir)) {
+        emit logRequested(tr("Failed to create output folder (%1).").arg(p_outputDir));
+        return QString();
+    }
+
+    const auto fileName = FileUtils::generateFileNameWithSequence(p_outputDir, p_name, "zip");
+    const auto archivePath = PathUtils::concatenateFilePath(p_outputDir, fileName);
+    // Unfinished archive will be removed by the writer.
+    ArchiveWriter writer(archivePath);
+    if (!writer.open()) {
+        emit logRequested(tr("Failed to create archive (%1).").arg(writer.errorString()));
+        return QString();
+    }
+
+    emit progressUpdated(0, p_tasks.size());
+    for (int i = 0; i < p_tasks.size(); ++i) {
+        if (checkAskedToStop()) {
+            return QString();
+        }
+
+        const auto &file = p_tasks[i].m_file;
+        const auto entryName = doExportArchive(p_option, writer, p_tasks[i].m_outputDir, file.data());
+        if (!entryName.isEmpty()) {
+            emit logRequested(tr("File (%1) exported to (%2)").arg(file->getFilePath(), entryName));
+        } else {
+            emit logRequested(tr("Failed to export file (%1)").arg(file->getFilePath()));
+        }
+
+        emit progressUpdated(i + 1, p_tasks.size());
+    }
+
+    if (!writer.finish()) {
+        emit logRequested(tr("Failed to write archive (%1).").arg(writer.errorString()));
+        return QString();
+    }
+
+    emit logRequested(tr("Exported to (%1).").arg(archivePath));
+    return archivePath;
+}
+
+QString Exporter::doExportArchive(const ExportOption &p_option,
+                                  ArchiveWriter &p_writer,
+                                  const QString &p_dir,
+                                  const File *p_file)
+{
+    // Export it to a folder with the same name as exporting to Markdown does.
+    const auto outputFolder = p_writer.generateName(PathUtils::concatenateFilePath(p_dir, p_file->getName()));
+    const auto srcFilePath = p_file->getFilePath();
+
+    bool success = false;
+    QString entryName;
+    if (p_file->getContentType().isMarkdown()) {
+        auto content = p_file->read();
+        exportArchiveMediaFiles(p_writer, content, p_file->getResourcePath(), outputFolder);
+        entryName = p_writer.generateName(PathUtils::concatenateFilePath(outputFolder, p_file->getName()));
+        success = p_writer.addFile(entryName, content.toUtf8());
+    } else {
+        // Keep other files as they are.
+        entryName = p_writer.generateName(PathUtils::concatenateFilePath(outputFolder, p_file->getName()));
+        success = p_writer.addFileFromDisk(entryName, p_file->getContentPath());
+    }
+
+    if (!success) {
+        emit logRequested(tr("Failed to add file to archive (%1).").arg(p_writer.errorString()));
+        return QString();
+    }
+
+    if (p_option.m_exportAttachments) {
+        exportArchiveAttachments(p_writer, p_file->getNode(), srcFilePath, outputFolder);
+    }
+
+    return entryName;
+}
+
+void Exporter::exportArchiveMediaFiles(ArchiveWriter &p_writer,
+                                       QString &p_content,
+                                       const QString &p_basePath,
+                                       const QString &p_dir)
+{
+    const auto images =
+        vte::MarkdownUtils::fetchImagesFromMarkdownText(p_content,
+                                                        p_basePath,
+                                                        vte::MarkdownLink::TypeFlag::LocalRelativeInternal);
+
+    // {image path} -> new URL in link, or empty if not renamed.
+    QHash<QString, QString> handledImages;
+    int lastPos = p_content.size();
+    for (const auto &link : images) {
+        Q_ASSERT(link.m_urlInLinkPos < lastPos);
+        lastPos = link.m_urlInLinkPos;
+
+        auto it = handledImages.find(link.m_path);
+        if (it != handledImages.end()) {
+            if (!it.value().isEmpty()) {
+                p_content.replace(link.m_urlInLinkPos, link.m_urlInLink.size(), it.value());
+            }
+            continue;
+        }
+
+        handledImages.insert(link.m_path, QString());
+
+        if (!QFileInfo::exists(link.m_path)) {
+            qWarning() << "image of Markdown file does not exist" << link.m_path << link.m_urlInLink;
+            continue;
+        }
+
+        // Apply the relative path of the image to the folder in archive.
+        const auto oldName = QDir::cleanPath(PathUtils::concatenateFilePath(p_dir,
+                                                                            vte::TextUtils::decodeUrl(link.m_urlInLink)));
+        if (oldName.startsWith(QStringLiteral("../"))) {
+            emit logRequested(tr("Skipped image (%1) outside of archive.").arg(link.m_path));
+            continue;
+        }
+
+        const auto name = p_writer.generateName(oldName);
+        if (name != oldName) {
+            const auto oldFileName = PathUtils::fileName(oldName);
+            const auto newFileName = PathUtils::fileName(name);
+            qWarning() << QString("image name conflicts in archive, renamed from (%1) to (%2)").arg(oldFileName, newFileName);
+
+            // Update the text content.
+            const auto encodedOldFileName = vte::TextUtils::encodeUrl(oldFileName);
+            const auto encodedNewFileName = vte::TextUtils::encodeUrl(newFileName);
+            auto newUrlInLink(link.m_urlInLink);
+            newUrlInLink.replace(newUrlInLink.size() - encodedOldFileName.size(),
+                                 encodedOldFileName.size(),
+                                 encodedNewFileName);
+
+            p_content.replace(link.m_urlInLinkPos, link.m_urlInLink.size(), newUrlInLink);
+            handledImages.insert(link.m_path, newUrlInLink);
+        }
+
+        if (!p_writer.addFileFromDisk(name, link.m_path)) {
+            emit logRequested(tr("Failed to add image to archive (%1).").arg(p_writer.errorString()));
+        }
+    }
+}
+
+void Exporter::exportArchiveAttachments(ArchiveWriter &p_writer,
+                                        Node *p_node,
+                                        const QString &p_srcFilePath,
+                                        const QString &p_dir)
+{
+    if (!p_node || p_node->getAttachmentFolder().isEmpty()) {
+        return;
+    }
+
+    const auto attachmentFolderPath = p_node->fetchAttachmentFolderPath();
+    const auto relativePath = PathUtils::relativePath(PathUtils::parentDirPath(p_srcFilePath), attachmentFolderPath);
+    const auto destFolder = QDir::cleanPath(PathUtils::concatenateFilePath(p_dir, relativePath));
+    QDirIterator it(attachmentFolderPath, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const auto filePath = it.next();
+        const auto name = p_writer.generateName(
+            PathUtils::concatenateFilePath(destFolder, PathUtils::relativePath(attachmentFolderPath, filePath)));
+        if (!p_writer.addFileFromDisk(name, filePath)) {
+            emit logRequested(tr("Failed to add attachment to archive (%1).").arg(p_writer.errorString()));
+        }
+    }
+}
+
+void Exporter::exportAttachments(const ExportOption &p_option,
+                                 Node *p_node,
                                  const QString &p_srcFilePath,
                                  const QString &p_outputFolder,
                                  const QString &p_destFilePath)
@@ -103,8 +296,21 @@ void Exporter::exportAttachments(Node *p_node,
         auto relativePath = PathUtils::relativePath(PathUtils::parentDirPath(p_srcFilePath),
                                                     p_node->fetchAttachmentFolderPath());
         auto destAttachmentFolderPath = QDir(p_outputFolder).filePath(relativePath);
-        destAttachmentFolderPath = FileUtils::renameIfExistsCaseInsensitive(destAttachmentFolderPath);
+        if (p_option.m_incremental) {
+            // Outputs are tracked by the manifest. Replace the folder left by last export instead
+            // of exporting to a new folder each time.
+            if (QFileInfo::exists(destAttachmentFolderPath)) {
+                try {
+                    FileUtils::removeDir(destAttachmentFolderPath);
+                } catch (Exception &p_e) {
+                    emit logRequested(tr("Failed to remove obsolete attachments (%1) (%2).").arg(destAttachmentFolderPath, p_e.what()));
+                }
+            }
+        } else {
+            destAttachmentFolderPath = FileUtils::renameIfExistsCaseInsensitive(destAttachmentFolderPath);
+        }
         ContentMediaUtils::copyAttachment(p_node, nullptr, p_destFilePath, destAttachmentFolderPath);
+        m_attachmentOutputs.insert(p_destFilePath, destAttachmentFolderPath);
     }
 }
 
@@ -121,7 +327,16 @@ QString Exporter::doExport(const ExportOption &p_option, Node *p_note)
         return outputFile;
     }
 
-    outputFile = doExport(p_option, p_option.m_outputDir, file.data());
+    if (p_option.m_targetFormat == ExportFormat::Archive) {
+        QVector<ExportTask> tasks;
+        tasks.push_back(ExportTask{QString(), file, QString()});
+        outputFile = doExportArchive(p_option,
+                                     p_option.m_outputDir,
+                                     QFileInfo(file->getName()).completeBaseName(),
+                                     tasks);
+    } else {
+        outputFile = doExport(p_option, p_option.m_outputDir, file.data());
+    }
 
     cleanUp();
 
@@ -276,6 +491,13 @@ QStringList Exporter::doExportFolder(const ExportOption &p_option, Node *p_folde
         if (!file.isEmpty()) {
             outputFiles << file;
         }
+    } else if (p_option.m_targetFormat == ExportFormat::Archive) {
+        QVector<ExportTask> tasks;
+        collectExportTasks(p_option, QString(), p_folder, tasks);
+        auto file = doExportArchive(p_option, p_option.m_outputDir, p_folder->getName(), tasks);
+        if (!file.isEmpty()) {
+            outputFiles << file;
+        }
     } else {
         outputFiles = doExport(p_option, p_option.m_outputDir, p_folder);
     }
@@ -287,15 +509,35 @@ QStringList Exporter::doExportFolder(const ExportOption &p_option, Node *p_folde
 
 QStringList Exporter::doExport(const ExportOption &p_option, const QString &p_outputDir, Node *p_folder)
 {
-    Q_ASSERT(p_folder->isContainer());
+    QVector<ExportTask> tasks;
+    QString outputFolder;
+    const bool complete = collectExportTasks(p_option, p_outputDir, p_folder, tasks, &outputFolder);
+    if (p_option.m_incremental && !outputFolder.isEmpty()) {
+        return doExportIncrementally(p_option, outputFolder, tasks, complete);
+    }
 
-    QStringList outputFiles;
+    return doExport(p_option, tasks);
+}
 
-    // Make path.
-    const auto outputFolder = makeOutputFolder(p_outputDir, p_folder->getName());
+bool Exporter::collectExportTasks(const ExportOption &p_option,
+                                  const QString &p_outputDir,
+                                  Node *p_folder,
+                                  QVector<ExportTask> &p_tasks,
+                                  QString *p_outputFolder)
+{
+    Q_ASSERT(p_folder->isContainer());
+
+    // Make path. Paths within an archive are not created on disk.
+    const auto outputFolder = p_option.m_targetFormat == ExportFormat::Archive
+                              ? PathUtils::concatenateFilePath(p_outputDir, p_folder->getName())
+                              : makeOutputFolder(p_outputDir, p_folder->getName(), p_option.m_incremental);
     if (outputFolder.isEmpty()) {
         emit logRequested(tr("Failed to create output folder under (%1).").arg(p_outputDir));
-        return outputFiles;
+        return false;
+    }
+
+    if (p_outputFolder) {
+        *p_outputFolder = outputFolder;
     }
 
     try {
@@ -304,34 +546,291 @@ QStringList Exporter::doExport(const ExportOption &p_option, const QString &p_ou
         QString msg = tr("Failed to load node (%1) (%2).").arg(p_folder->fetchPath(), p_e.what());
         qWarning() << msg;
         emit logRequested(msg);
-        return outputFiles;
+        return false;
     }
 
+    bool complete = true;
     const auto &children = p_folder->getChildrenRef();
-    emit progressUpdated(0, children.size());
-    for (int i = 0; i < children.size(); ++i) {
+    for (const auto &child : children) {
+        if (m_askedToStop) {
+            return false;
+        }
+
+        if (child->hasContent()) {
+            p_tasks.push_back(ExportTask{outputFolder, child->getContentFile(), QString()});
+        }
+        if (p_option.m_recursive && child->isContainer() && child->getUse() == Node::Use::Normal) {
+            if (!collectExportTasks(p_option, outputFolder, child.data(), p_tasks)) {
+                complete = false;
+            }
+        }
+    }
+
+    return complete;
+}
+
+QStringList Exporter::doExportIncrementally(const ExportOption &p_option,
+                                            const QString &p_rootOutputFolder,
+                                            QVector<ExportTask> &p_tasks,
+                                            bool p_complete)
+{
+    ExportManifest manifest(p_rootOutputFolder);
+    manifest.load();
+
+    const auto optionHash = calculateOptionHash(p_option);
+    if (manifest.getOptionHash() != optionHash) {
+        // Outputs of different options could not be reused.
+        manifest.removeAllOutputs();
+        manifest.setOptionHash(optionHash);
+    }
+
+    QSet<QString> keys;
+    QVector<ExportTask> changedTasks;
+    QVector<int> changedTaskIndexes;
+    QVector<QPair<QString, ExportManifest::Entry>> changedEntries;
+    for (int i = 0; i < p_tasks.size(); ++i) {
+        auto &task = p_tasks[i];
+        const auto key = manifest.getRelativePath(PathUtils::concatenateFilePath(task.m_outputDir,
+                                                                                 task.m_file->getName()));
+        keys.insert(key);
+
+        ExportManifest::Entry entry;
+        entry.m_contentHash = ExportManifest::calculateFileHash(task.m_file->getContentPath());
+        entry.m_resourceHash = calculateResourceHash(p_option, task.m_file.data());
+
+        auto it = manifest.getEntries().find(key);
+        if (it != manifest.getEntries().end()) {
+            const auto outputFile = manifest.getAbsolutePath(it->m_outputFile);
+            if (it->m_contentHash == entry.m_contentHash
+                && it->m_resourceHash == entry.m_resourceHash
+                && QFileInfo::exists(outputFile)) {
+                task.m_outputFile = outputFile;
+                emit logRequested(tr("Skipped unchanged file (%1)").arg(task.m_file->getFilePath()));
+                continue;
+            }
+
+            // Remove the obsolete outputs to let the new outputs take the same names.
+            manifest.removeOutputs(it.value());
+            manifest.removeEntry(key);
+        }
+
+        changedTasks.push_back(task);
+        changedTaskIndexes.push_back(i);
+        changedEntries.push_back(qMakePair(key, entry));
+    }
+
+    if (p_complete && !m_askedToStop) {
+        // Remove outputs of deleted files.
+        const auto entries = manifest.getEntries();
+        for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+            if (!keys.contains(it.key())) {
+                manifest.removeOutputs(it.value());
+                manifest.removeEntry(it.key());
+                emit logRequested(tr("Removed output of deleted file (%1)").arg(it.key()));
+            }
+        }
+    }
+
+    m_attachmentOutputs.clear();
+    doExport(p_option, changedTasks);
+
+    for (int i = 0; i < changedTasks.size(); ++i) {
+        const auto &outputFile = changedTasks[i].m_outputFile;
+        if (outputFile.isEmpty()) {
+            continue;
+        }
+
+        p_tasks[changedTaskIndexes[i]].m_outputFile = outputFile;
+
+        auto &entry = changedEntries[i].second;
+        entry.m_outputFile = manifest.getRelativePath(outputFile);
+        for (const auto &output : getExportOutputs(p_option, outputFile)) {
+            entry.m_outputs << manifest.getRelativePath(output);
+        }
+        if (p_option.m_targetFormat != ExportFormat::Markdown) {
+            // Attachments of Markdown are within its own folder.
+            const auto attachmentFolder = m_attachmentOutputs.value(outputFile);
+            if (!attachmentFolder.isEmpty()) {
+                entry.m_outputs << manifest.getRelativePath(attachmentFolder);
+            }
+        }
+        manifest.setEntry(changedEntries[i].first, entry);
+    }
+
+    if (!manifest.save()) {
+        emit logRequested(tr("Failed to save export manifest in (%1).").arg(p_rootOutputFolder));
+    }
+
+    QStringList outputFiles;
+    for (const auto &task : p_tasks) {
+        if (!task.m_outputFile.isEmpty()) {
+            outputFiles << task.m_outputFile;
+        }
+    }
+    return outputFiles;
+}
+
+QStringList Exporter::getExportOutputs(const ExportOption &p_option, const QString &p_outputFile)
+{
+    QStringList outputs;
+    if (p_option.m_targetFormat == ExportFormat::Markdown) {
+        // Markdown is exported to a folder of its own.
+        outputs << PathUtils::parentDirPath(p_outputFile);
+        return outputs;
+    }
+
+    outputs << p_outputFile;
+
+    // Resource folder of HTML.
+    const auto resourceFolder = PathUtils::concatenateFilePath(PathUtils::parentDirPath(p_outputFile),
+                                                               QFileInfo(p_outputFile).completeBaseName() + "_files");
+    if (QFileInfo::exists(resourceFolder)) {
+        outputs << resourceFolder;
+    }
+    return outputs;
+}
+
+QString Exporter::calculateOptionHash(const ExportOption &p_option)
+{
+    auto obj = p_option.toJson();
+    obj.remove(QStringLiteral("output_dir"));
+    obj.remove(QStringLiteral("incremental"));
+    obj[QStringLiteral("transform_svg_to_png")] = p_option.m_transformSvgToPngEnabled;
+    obj[QStringLiteral("remove_code_tool_bar")] = p_option.m_removeCodeToolBarEnabled;
+    if (p_option.m_customOption) {
+        obj[QStringLiteral("custom_option")] = p_option.m_customOption->toJson();
+    }
+    if (p_option.m_pdfOption.m_layout) {
+        const auto &layout = p_option.m_pdfOption.m_layout;
+        const auto margins = layout->margins(QPageLayout::Millimeter);
+        obj[QStringLiteral("pdf_layout")] = QString("%1,%2,%3,%4,%5,%6").arg(layout->pageSize().key(),
+                                                                              QString::number(layout->orientation()),
+                                                                              QString::number(margins.left()),
+                                                                              QString::number(margins.top()),
+                                                                              QString::number(margins.right()),
+                                                                              QString::number(margins.bottom()));
+    }
+
+    {
+        // Only keys affecting the rendering result, so that unrelated changes like cache sizes
+        // do not invalidate all the outputs.
+        static const QStringList renderKeys = {
+            QStringLiteral("viewer_resource"),
+            QStringLiteral("export_resource"),
+            QStringLiteral("web_plantuml"),
+            QStringLiteral("plantuml_jar"),
+            QStringLiteral("plantuml_command"),
+            QStringLiteral("web_graphviz"),
+            QStringLiteral("graphviz_exe"),
+            QStringLiteral("section_number"),
+            QStringLiteral("section_number_base_level"),
+            QStringLiteral("section_number_style"),
+            QStringLiteral("constrain_image_width"),
+            QStringLiteral("image_align_center"),
+            QStringLiteral("protect_from_xss"),
+            QStringLiteral("html_tag"),
+            QStringLiteral("auto_break"),
+            QStringLiteral("linkify"),
+            QStringLiteral("indent_first_line")
+        };
+
+        const auto configObj = ConfigMgr::getInst().getEditorConfig().getMarkdownEditorConfig().toJson();
+        QJsonObject renderObj;
+        for (const auto &key : renderKeys) {
+            renderObj[key] = configObj.value(key);
+        }
+        obj[QStringLiteral("markdown_editor_config")] = renderObj;
+    }
+    obj[QStringLiteral("version")] = ConfigMgr::getApplicationVersion();
+
+    // Theme.
+    obj[QStringLiteral("rendering_style")] = ExportManifest::calculateFileHash(p_option.m_renderingStyleFile);
+    obj[QStringLiteral("syntax_highlight_style")] = ExportManifest::calculateFileHash(p_option.m_syntaxHighlightStyleFile);
+
+    const auto data = QJsonDocument(obj).toJson(QJsonDocument::Compact);
+    return QString::fromLatin1(QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex());
+}
+
+QString Exporter::calculateResourceHash(const ExportOption &p_option, const File *p_file)
+{
+    QStringList files;
+    if (p_file->getContentType().isMarkdown()) {
+        const auto images =
+            vte::MarkdownUtils::fetchImagesFromMarkdownText(p_file->read(),
+                                                            p_file->getResourcePath(),
+                                                            vte::MarkdownLink::TypeFlag::LocalRelativeInternal);
+        for (const auto &link : images) {
+            files << link.m_path;
+        }
+    }
+
+    auto node = p_file->getNode();
+    if (p_option.m_exportAttachments && node && !node->getAttachmentFolder().isEmpty()) {
+        QDirIterator it(node->fetchAttachmentFolderPath(), QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            files << it.next();
+        }
+    }
+
+    return ExportManifest::calculateStatHash(files);
+}
+
+QStringList Exporter::doExport(const ExportOption &p_option, QVector<ExportTask> &p_tasks)
+{
+    QStringList outputFiles;
+
+    QVector<WebViewExporter *> idleExporters;
+    if (p_option.m_targetFormat == ExportFormat::HTML || p_option.m_targetFormat == ExportFormat::PDF) {
+        const auto &config = ConfigMgr::getInst().getEditorConfig().getMarkdownEditorConfig();
+        const int poolSize = qMin(config.getExportViewerPoolSize(), p_tasks.size());
+        if (poolSize > 1) {
+            idleExporters = getWebViewExporters(p_option, poolSize);
+        }
+    }
+
+    // {task index} -> exporter which has loaded the file of the task.
+    QHash<int, WebViewExporter *> loadedExporters;
+    int nextTaskToLoad = 0;
+
+    emit progressUpdated(0, p_tasks.size());
+    for (int i = 0; i < p_tasks.size(); ++i) {
         if (checkAskedToStop()) {
             break;
         }
 
-        const auto &child = children[i];
-        if (child->hasContent()) {
-            auto outputFile = doExport(p_option, outputFolder, child->getContentFile().data());
-            if (!outputFile.isEmpty()) {
-                outputFiles << outputFile;
+        // Load following files into idle exporters to render them concurrently.
+        while (nextTaskToLoad < p_tasks.size() && !idleExporters.isEmpty()) {
+            const auto &file = p_tasks[nextTaskToLoad].m_file;
+            if (file->getContentType().isMarkdown()) {
+                auto exporter = idleExporters.takeLast();
+                exporter->load(p_option, file.data());
+                loadedExporters.insert(nextTaskToLoad, exporter);
             }
+            ++nextTaskToLoad;
         }
-        if (p_option.m_recursive && child->isContainer() && child->getUse() == Node::Use::Normal) {
-            outputFiles.append(doExport(p_option, outputFolder, child.data()));
+
+        // Finish files in order to keep the output deterministic.
+        auto &task = p_tasks[i];
+        auto exporter = loadedExporters.take(i);
+        task.m_outputFile = doExport(p_option, task.m_outputDir, task.m_file.data(), exporter);
+        if (!task.m_outputFile.isEmpty()) {
+            outputFiles << task.m_outputFile;
+        }
+
+        if (exporter) {
+            idleExporters.push_back(exporter);
         }
 
-        emit progressUpdated(i + 1, children.size());
+        emit progressUpdated(i + 1, p_tasks.size());
     }
 
     return outputFiles;
 }
 
-QString Exporter::doExport(const ExportOption &p_option, const QString &p_outputDir, const File *p_file)
+QString Exporter::doExport(const ExportOption &p_option,
+                           const QString &p_outputDir,
+                           const File *p_file,
+                           WebViewExporter *p_exporter)
 {
     QString outputFile;
 
@@ -341,11 +840,11 @@ QString Exporter::doExport(const ExportOption &p_option, const QString &p_output
         break;
 
     case ExportFormat::HTML:
-        outputFile = doExportHtml(p_option, p_outputDir, p_file);
+        outputFile = doExportHtml(p_option, p_outputDir, p_file, p_exporter);
         break;
 
     case ExportFormat::PDF:
-        outputFile = doExportPdf(p_option, p_outputDir, p_file);
+        outputFile = doExportPdf(p_option, p_outputDir, p_file, p_exporter);
         break;
 
     case ExportFormat::Custom:
@@ -400,8 +899,10 @@ QStringList Exporter::doExportNotebook(const ExportOption &p_option, const QStri
 
     QStringList outputFiles;
 
-    // Make path.
-    const auto outputFolder = makeOutputFolder(p_outputDir, tr("notebook_%1").arg(p_notebook->getName()));
+    // Make path. Paths within an archive are not created on disk.
+    const bool isArchive = p_option.m_targetFormat == ExportFormat::Archive;
+    const auto name = tr("notebook_%1").arg(p_notebook->getName());
+    const auto outputFolder = isArchive ? name : makeOutputFolder(p_outputDir, name, p_option.m_incremental);
     if (outputFolder.isEmpty()) {
         emit logRequested(tr("Failed to create output folder under (%1).").arg(p_outputDir));
         return outputFiles;
@@ -410,25 +911,34 @@ QStringList Exporter::doExportNotebook(const ExportOption &p_option, const QStri
     auto rootNode = p_notebook->getRootNode();
     Q_ASSERT(rootNode->isLoaded());
 
+    QVector<ExportTask> tasks;
+    bool complete = true;
     const auto &children = rootNode->getChildrenRef();
-    emit progressUpdated(0, children.size());
-    for (int i = 0; i < children.size(); ++i) {
-        if (checkAskedToStop()) {
+    for (const auto &child : children) {
+        if (m_askedToStop) {
+            complete = false;
             break;
         }
 
-        const auto &child = children[i];
         if (child->hasContent()) {
-            auto outputFile = doExport(p_option, outputFolder, child->getContentFile().data());
-            if (!outputFile.isEmpty()) {
-                outputFiles << outputFile;
-            }
+            tasks.push_back(ExportTask{outputFolder, child->getContentFile(), QString()});
         }
         if (child->isContainer() && child->getUse() == Node::Use::Normal) {
-            outputFiles.append(doExport(p_option, outputFolder, child.data()));
+            if (!collectExportTasks(p_option, outputFolder, child.data(), tasks)) {
+                complete = false;
+            }
         }
+    }
 
-        emit progressUpdated(i + 1, children.size());
+    if (isArchive) {
+        const auto file = doExportArchive(p_option, p_outputDir, name, tasks);
+        if (!file.isEmpty()) {
+            outputFiles << file;
+        }
+    } else if (p_option.m_incremental) {
+        outputFiles = doExportIncrementally(p_option, outputFolder, tasks, complete);
+    } else {
+        outputFiles = doExport(p_option, tasks);
     }
 
     cleanUp();
@@ -436,7 +946,10 @@ QStringList Exporter::doExportNotebook(const ExportOption &p_option, const QStri
     return outputFiles;
 }
 
-QString Exporter::doExportHtml(const ExportOption &p_option, const QString &p_outputDir, const File *p_file)
+QString Exporter::doExportHtml(const ExportOption &p_option,
+                               const QString &p_outputDir,
+                               const File *p_file,
+                               WebViewExporter *p_exporter)
 {
     QString outputFile;
     if (!p_file->getContentType().isMarkdown()) {
@@ -450,13 +963,29 @@ QString Exporter::doExportHtml(const ExportOption &p_option, const QString &p_ou
                                                             suffix);
     auto destFilePath = PathUtils::concatenateFilePath(p_outputDir, fileName);
 
-    bool success = getWebViewExporter(p_option)->doExport(p_option, p_file, destFilePath);
+    return doExportByWebView(p_option, p_outputDir, p_file, destFilePath, p_exporter);
+}
+
+QString Exporter::doExportByWebView(const ExportOption &p_option,
+                                    const QString &p_outputDir,
+                                    const File *p_file,
+                                    const QString &p_destFilePath,
+                                    WebViewExporter *p_exporter)
+{
+    QString outputFile;
+
+    if (!p_exporter) {
+        p_exporter = getWebViewExporter(p_option);
+        p_exporter->load(p_option, p_file);
+    }
+
+    bool success = p_exporter->finishExport(p_option, p_destFilePath);
     if (success) {
-        outputFile = destFilePath;
+        outputFile = p_destFilePath;
 
         // Copy attachments if available.
         if (p_option.m_exportAttachments) {
-            exportAttachments(p_file->getNode(), p_file->getFilePath(), p_outputDir, destFilePath);
+            exportAttachments(p_option, p_file->getNode(), p_file->getFilePath(), p_outputDir, p_destFilePath);
         }
     }
     return outputFile;
@@ -464,23 +993,37 @@ QString Exporter::doExportHtml(const ExportOption &p_option, const QString &p_ou
 
 WebViewExporter *Exporter::getWebViewExporter(const ExportOption &p_option)
 {
-    if (!m_webViewExporter) {
-        m_webViewExporter = new WebViewExporter(static_cast<QWidget *>(parent()));
-        connect(m_webViewExporter, &WebViewExporter::logRequested,
+    return getWebViewExporters(p_option, 1).first();
+}
+
+QVector<WebViewExporter *> Exporter::getWebViewExporters(const ExportOption &p_option, int p_size)
+{
+    if (!m_resourceCache) {
+        m_resourceCache.reset(new ExportResourceCache());
+    }
+
+    while (m_webViewExporters.size() < p_size) {
+        auto exporter = new WebViewExporter(static_cast<QWidget *>(parent()));
+        connect(exporter, &WebViewExporter::logRequested,
                 this, &Exporter::logRequested);
-        m_webViewExporter->prepare(p_option);
+        exporter->setResourceCache(m_resourceCache);
+        exporter->prepare(p_option);
+        m_webViewExporters.push_back(exporter);
     }
 
-    return m_webViewExporter;
+    return m_webViewExporters.mid(0, p_size);
 }
 
 void Exporter::cleanUpWebViewExporter()
 {
-    if (m_webViewExporter) {
-        m_webViewExporter->clear();
-        delete m_webViewExporter;
-        m_webViewExporter = nullptr;
+    for (auto exporter : m_webViewExporters) {
+        exporter->clear();
+        delete exporter;
     }
+    m_webViewExporters.clear();
+
+    // Resources may change before next export.
+    m_resourceCache.clear();
 }
 
 void Exporter::cleanUp()
@@ -492,8 +1035,8 @@ void Exporter::stop()
 {
     m_askedToStop = true;
 
-    if (m_webViewExporter) {
-        m_webViewExporter->stop();
+    for (auto exporter : m_webViewExporters) {
+        exporter->stop();
     }
 }
 
@@ -507,7 +1050,10 @@ bool Exporter::checkAskedToStop() const
     return false;
 }
 
-QString Exporter::doExportPdf(const ExportOption &p_option, const QString &p_outputDir, const File *p_file)
+QString Exporter::doExportPdf(const ExportOption &p_option,
+                              const QString &p_outputDir,
+                              const File *p_file,
+                              WebViewExporter *p_exporter)
 {
     QString outputFile;
     if (!p_file->getContentType().isMarkdown()) {
@@ -520,16 +1066,7 @@ QString Exporter::doExportPdf(const ExportOption &p_option, const QString &p_out
                                                             "pdf");
     auto destFilePath = PathUtils::concatenateFilePath(p_outputDir, fileName);
 
-    bool success = getWebViewExporter(p_option)->doExport(p_option, p_file, destFilePath);
-    if (success) {
-        outputFile = destFilePath;
-
-        // Copy attachments if available.
-        if (p_option.m_exportAttachments) {
-            exportAttachments(p_file->getNode(), p_file->getFilePath(), p_outputDir, destFilePath);
-        }
-    }
-    return outputFile;
+    return doExportByWebView(p_option, p_outputDir, p_file, destFilePath, p_exporter);
 }
 
 QString Exporter::doExportCustom(const ExportOption &p_option, const QString &p_outputDir, const File *p_file)
@@ -577,7 +1114,7 @@ QString Exporter::doExportCustom(const ExportOption &p_option, const QString &p_
     if (success) {
         // Copy attachments if available.
         if (p_option.m_exportAttachments) {
-            exportAttachments(p_file->getNode(), p_file->getFilePath(), p_outputDir, destFilePath);
+            exportAttachments(p_option, p_file->getNode(), p_file->getFilePath(), p_outputDir, destFilePath);
         }
 
         return destFilePath;
@@ -590,6 +1127,7 @@ ExportOption Exporter::getExportOptionForIntermediateHtml(const ExportOption &p_
 {
     ExportOption tmpOption(p_option);
     tmpOption.m_exportAttachments = false;
+    tmpOption.m_incremental = false;
     tmpOption.m_targetFormat = ExportFormat::HTML;
     tmpOption.m_transformSvgToPngEnabled = true;
     tmpOption.m_removeCodeToolBarEnabled = true;
@@ -3,6 +3,9 @@
 
 #include <QObject>
 #include <QStringList>
+#include <QSharedPointer>
+#include <QVector>
+#include <QHash>
 
 #include "exportdata.h"
 
@@ -13,6 +16,8 @@ namespace vnotex
     class Buffer;
     class File;
     class WebViewExporter;
+    class ExportResourceCache;
+    class ArchiveWriter;
 
     class Exporter : public QObject
     {
@@ -40,15 +45,98 @@ namespace vnotex
         void logRequested(const QString &p_log);
 
     private:
+        struct ExportTask
+        {
+            // Output folder of the file.
+            QString m_outputDir;
+
+            QSharedPointer<File> m_file;
+
+            // Output.
+            QString m_outputFile;
+        };
+
         QStringList doExport(const ExportOption &p_option, const QString &p_outputDir, Node *p_folder);
 
-        QString doExport(const ExportOption &p_option, const QString &p_outputDir, const File *p_file);
+        // @p_exporter: exporter which has loaded @p_file already, if not null.
+        QString doExport(const ExportOption &p_option,
+                         const QString &p_outputDir,
+                         const File *p_file,
+                         WebViewExporter *p_exporter = nullptr);
 
-        QString doExportMarkdown(const ExportOption &p_option, const QString &p_outputDir, const File *p_file);
+        // Export files in order.
+        // Files exported via web view will be loaded into a pool of exporters ahead and be rendered concurrently.
+        QStringList doExport(const ExportOption &p_option, QVector<ExportTask> &p_tasks);
+
+        // Export files under @p_rootOutputFolder, skipping those unchanged since last export
+        // according to the manifest in @p_rootOutputFolder.
+        // @p_complete: whether @p_tasks contains all the files, so outputs of files not in it could be removed.
+        QStringList doExportIncrementally(const ExportOption &p_option,
+                                          const QString &p_rootOutputFolder,
+                                          QVector<ExportTask> &p_tasks,
+                                          bool p_complete);
+
+        // Make output folder for @p_folder under @p_outputDir and collect files to export in it.
+        // Return false if failed to collect some of the files.
+        bool collectExportTasks(const ExportOption &p_option,
+                                const QString &p_outputDir,
+                                Node *p_folder,
+                                QVector<ExportTask> &p_tasks,
+                                QString *p_outputFolder = nullptr);
+
+        // Files and folders generated by exporting to @p_outputFile.
+        static QStringList getExportOutputs(const ExportOption &p_option, const QString &p_outputFile);
 
-        QString doExportHtml(const ExportOption &p_option, const QString &p_outputDir, const File *p_file);
+        // Hash of all the things affecting the output besides the note itself.
+        static QString calculateOptionHash(const ExportOption &p_option);
 
-        QString doExportPdf(const ExportOption &p_option, const QString &p_outputDir, const File *p_file);
+        static QString calculateResourceHash(const ExportOption &p_option, const File *p_file);
+
+        QString doExportMarkdown(const ExportOption &p_option, const QString &p_outputDir, const File *p_file);
+
+        // Export @p_tasks into one archive named after @p_name under @p_outputDir.
+        // Output folders of @p_tasks are paths within the archive.
+        // Return the archive file.
+        QString doExportArchive(const ExportOption &p_option,
+                                const QString &p_outputDir,
+                                const QString &p_name,
+                                QVector<ExportTask> &p_tasks);
+
+        // Add @p_file with its media files and attachments under @p_dir of @p_writer.
+        // Return the path of @p_file within the archive.
+        QString doExportArchive(const ExportOption &p_option,
+                                ArchiveWriter &p_writer,
+                                const QString &p_dir,
+                                const File *p_file);
+
+        // Add local images of Markdown @p_content under @p_dir of @p_writer and fix links of renamed ones.
+        void exportArchiveMediaFiles(ArchiveWriter &p_writer,
+                                     QString &p_content,
+                                     const QString &p_basePath,
+                                     const QString &p_dir);
+
+        void exportArchiveAttachments(ArchiveWriter &p_writer,
+                                      Node *p_node,
+                                      const QString &p_srcFilePath,
+                                      const QString &p_dir);
+
+        QString doExportHtml(const ExportOption &p_option,
+                             const QString &p_outputDir,
+                             const File *p_file,
+                             WebViewExporter *p_exporter);
+
+        QString doExportPdf(const ExportOption &p_option,
+                            const QString &p_outputDir,
+                            const File *p_file,
+                            WebViewExporter *p_exporter);
+
+        // Export @p_file loaded in @p_exporter to @p_destFilePath.
+        // Will load it first if @p_exporter is null.
+        QString doExportByWebView(const ExportOption &p_option,
+                                  const QString &p_outputDir,
+                                  const File *p_file,
+                                  const QString &p_destFilePath,
+                                  WebViewExporter *p_exporter);
 
         QString doExportCustom(const ExportOption &p_option, const QString &p_outputDir, const File *p_file);
 
@@ -62,13 +150,17 @@ namespace vnotex
 
         QString doExportCustomAllInOne(const ExportOption &p_option, Notebook *p_notebook, Node *p_folder);
 
-        void exportAttachments(Node *p_node,
+        void exportAttachments(const ExportOption &p_option,
+                               Node *p_node,
                                const QString &p_srcFilePath,
                                const QString &p_outputFolder,
                                const QString &p_destFilePath);
 
         WebViewExporter *getWebViewExporter(const ExportOption &p_option);
 
+        // Get a pool of @p_size exporters.
+        QVector<WebViewExporter *> getWebViewExporters(const ExportOption &p_option, int p_size);
+
         void cleanUpWebViewExporter();
 
         void cleanUp();
@@ -89,9 +181,16 @@ namespace vnotex
         static void collectFiles(const QList<QSharedPointer<File>> &p_files, QStringList &p_inputFiles, QStringList &p_resourcePaths);
 
         // Managed by QObject.
-        WebViewExporter *m_webViewExporter = nullptr;
+        QVector<WebViewExporter *> m_webViewExporters;
+
+        // Resources embedded or copied during current export, shared by all WebViewExporters.
+        QSharedPointer<ExportResourceCache> m_resourceCache;
 
         bool m_askedToStop = false;
+
+        // Output file path -> attachment folder exported with it.
+        // Used to record attachments in the manifest of incremental export.
+        QHash<QString, QString> m_attachmentOutputs;
     };
 }
 
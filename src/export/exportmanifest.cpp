@@ -0,0 +1,185 @@
+#include "exportmanifest.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QCryptographicHash>
+#include <QDebug>
+
+#include <utils/pathutils.h>
+#include <utils/fileutils.h>
+
+using namespace vnotex;
+
+const QString ExportManifest::c_manifestFileName = QStringLiteral("vx_export_manifest.json");
+
+QJsonObject ExportManifest::Entry::toJson() const
+{
+    QJsonObject obj;
+    obj[QStringLiteral("content_hash")] = m_contentHash;
+    obj[QStringLiteral("resource_hash")] = m_resourceHash;
+    obj[QStringLiteral("output_file")] = m_outputFile;
+    obj[QStringLiteral("outputs")] = QJsonArray::fromStringList(m_outputs);
+    return obj;
+}
+
+ExportManifest::Entry ExportManifest::Entry::fromJson(const QJsonObject &p_obj)
+{
+    Entry entry;
+    entry.m_contentHash = p_obj[QStringLiteral("content_hash")].toString();
+    entry.m_resourceHash = p_obj[QStringLiteral("resource_hash")].toString();
+    entry.m_outputFile = p_obj[QStringLiteral("output_file")].toString();
+    const auto outputs = p_obj[QStringLiteral("outputs")].toArray();
+    for (const auto &output : outputs) {
+        entry.m_outputs << output.toString();
+    }
+    return entry;
+}
+
+ExportManifest::ExportManifest(const QString &p_rootFolder)
+    : m_rootFolder(p_rootFolder)
+{
+}
+
+QString ExportManifest::getManifestFilePath() const
+{
+    return PathUtils::concatenateFilePath(m_rootFolder, c_manifestFileName);
+}
+
+void ExportManifest::load()
+{
+    m_optionHash.clear();
+    m_entries.clear();
+
+    const auto filePath = getManifestFilePath();
+    if (!QFileInfo::exists(filePath)) {
+        return;
+    }
+
+    const auto obj = QJsonDocument::fromJson(FileUtils::readFile(filePath)).object();
+    m_optionHash = obj[QStringLiteral("option_hash")].toString();
+    const auto files = obj[QStringLiteral("files")].toObject();
+    for (auto it = files.constBegin(); it != files.constEnd(); ++it) {
+        m_entries.insert(it.key(), Entry::fromJson(it.value().toObject()));
+    }
+}
+
+bool ExportManifest::save() const
+{
+    QJsonObject files;
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        files[it.key()] = it.value().toJson();
+    }
+
+    QJsonObject obj;
+    obj[QStringLiteral("option_hash")] = m_optionHash;
+    obj[QStringLiteral("files")] = files;
+
+    QFile file(getManifestFilePath());
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "failed to write export manifest" << file.fileName() << file.errorString();
+        return false;
+    }
+
+    file.write(QJsonDocument(obj).toJson());
+    return true;
+}
+
+const QString &ExportManifest::getOptionHash() const
+{
+    return m_optionHash;
+}
+
+void ExportManifest::setOptionHash(const QString &p_hash)
+{
+    m_optionHash = p_hash;
+}
+
+const QHash<QString, ExportManifest::Entry> &ExportManifest::getEntries() const
+{
+    return m_entries;
+}
+
+void ExportManifest::setEntry(const QString &p_key, const Entry &p_entry)
+{
+    m_entries.insert(p_key, p_entry);
+}
+
+void ExportManifest::removeEntry(const QString &p_key)
+{
+    m_entries.remove(p_key);
+}
+
+void ExportManifest::removeOutputs(const Entry &p_entry) const
+{
+    for (const auto &output : p_entry.m_outputs) {
+        const auto path = getAbsolutePath(output);
+        if (path.isEmpty()) {
+            // The manifest lives in the output folder and may be edited or corrupted.
+            qWarning() << "skip removing export output outside the output folder" << output;
+            continue;
+        }
+
+        QFileInfo info(path);
+        if (info.isDir()) {
+            QDir(path).removeRecursively();
+        } else if (info.exists()) {
+            QFile::remove(path);
+        }
+    }
+}
+
+void ExportManifest::removeAllOutputs()
+{
+    // Each output is checked by removeOutputs() to be within the output folder.
+    for (const auto &entry : m_entries) {
+        removeOutputs(entry);
+    }
+    m_entries.clear();
+}
+
+QString ExportManifest::getAbsolutePath(const QString &p_relativePath) const
+{
+    if (m_rootFolder.isEmpty()) {
+        return QString();
+    }
+
+    const auto path = QDir::cleanPath(PathUtils::concatenateFilePath(m_rootFolder, p_relativePath));
+    if (!PathUtils::pathContains(m_rootFolder, path) || PathUtils::areSamePaths(m_rootFolder, path)) {
+        return QString();
+    }
+    return path;
+}
+
+QString ExportManifest::getRelativePath(const QString &p_path) const
+{
+    return PathUtils::relativePath(m_rootFolder, p_path);
+}
+
+QString ExportManifest::calculateFileHash(const QString &p_filePath)
+{
+    QFile file(p_filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&file);
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QString ExportManifest::calculateStatHash(const QStringList &p_filePaths)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (const auto &path : p_filePaths) {
+        QFileInfo info(path);
+        hash.addData(path.toUtf8());
+        hash.addData(QByteArray::number(info.exists() ? info.size() : -1));
+        hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+    }
+    return QString::fromLatin1(hash.result().toHex());
+}
@@ -0,0 +1,83 @@
+#ifndef EXPORTMANIFEST_H
+#define EXPORTMANIFEST_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+class QJsonObject;
+
+namespace vnotex
+{
+    // Manifest of incremental export saved in the output folder.
+    // It records the hashes of the source and resources of each exported note, so that
+    // unchanged notes could be skipped in next export to the same folder.
+    class ExportManifest
+    {
+    public:
+        struct Entry
+        {
+            QJsonObject toJson() const;
+
+            static Entry fromJson(const QJsonObject &p_obj);
+
+            QString m_contentHash;
+
+            // Hash of media and attachments.
+            QString m_resourceHash;
+
+            // Output file relative to the root folder.
+            QString m_outputFile;
+
+            // Files and folders to remove when the note is changed or deleted.
+            QStringList m_outputs;
+        };
+
+        explicit ExportManifest(const QString &p_rootFolder);
+
+        void load();
+
+        bool save() const;
+
+        const QString &getOptionHash() const;
+        void setOptionHash(const QString &p_hash);
+
+        // {key} -> Entry.
+        const QHash<QString, Entry> &getEntries() const;
+
+        void setEntry(const QString &p_key, const Entry &p_entry);
+
+        void removeEntry(const QString &p_key);
+
+        // Remove the outputs of @p_entry from disk.
+        void removeOutputs(const Entry &p_entry) const;
+
+        // Remove the outputs of all entries from disk and clear the entries.
+        void removeAllOutputs();
+
+        // Return an empty string if @p_relativePath is not strictly within the root folder,
+        // such as "..", "." or an empty path.
+        QString getAbsolutePath(const QString &p_relativePath) const;
+
+        QString getRelativePath(const QString &p_path) const;
+
+        static QString calculateFileHash(const QString &p_filePath);
+
+        // Hash of the paths, sizes and modified time of @p_filePaths.
+        // Much cheaper than reading the contents of media and attachments on each export.
+        static QString calculateStatHash(const QStringList &p_filePaths);
+
+    private:
+        QString getManifestFilePath() const;
+
+        QString m_rootFolder;
+
+        QString m_optionHash;
+
+        QHash<QString, Entry> m_entries;
+
+        static const QString c_manifestFileName;
+    };
+}
+
+#endif // EXPORTMANIFEST_H
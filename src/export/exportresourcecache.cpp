@@ -0,0 +1,68 @@
+#include "exportresourcecache.h"
+
+#include <QUrl>
+#include <QFileInfo>
+
+#include <utils/webutils.h>
+
+using namespace vnotex;
+
+// Limit of the total size in chars of cached data URIs.
+static const qint64 c_maxDataUrisSize = 64 * 1024 * 1024;
+
+QString ExportResourceCache::toDataUri(const QUrl &p_url, bool p_keepTitle)
+{
+    const auto key = QString("%1\n%2").arg(p_url.toString(), p_keepTitle ? "1" : "0");
+    auto it = m_dataUris.find(key);
+    if (it != m_dataUris.end()) {
+        return it.value();
+    }
+
+    const auto uri = WebUtils::toDataUri(p_url, p_keepTitle);
+    if (m_dataUrisSize + uri.size() <= c_maxDataUrisSize) {
+        // Failures are cached too to avoid downloading again.
+        m_dataUris.insert(key, uri);
+        m_dataUrisSize += uri.size();
+    }
+    return uri;
+}
+
+QString ExportResourceCache::copyResource(const QUrl &p_url, const QString &p_folder)
+{
+    const auto urlStr = p_url.toString();
+    const auto key = urlStr + QLatin1Char('\n') + p_folder;
+    auto it = m_copiedResources.find(key);
+    if (it != m_copiedResources.end() && QFileInfo::exists(it.value())) {
+        return it.value();
+    }
+
+    const bool isRemote = p_url.scheme() == QStringLiteral("https") || p_url.scheme() == QStringLiteral("http");
+    QString targetFile;
+    if (isRemote) {
+        // Copy the downloaded one instead of downloading it again.
+        auto downloadedIt = m_downloadedResources.find(urlStr);
+        if (downloadedIt != m_downloadedResources.end() && QFileInfo::exists(downloadedIt.value())) {
+            targetFile = WebUtils::copyResource(QUrl::fromLocalFile(downloadedIt.value()), p_folder);
+        } else {
+            targetFile = WebUtils::copyResource(p_url, p_folder);
+            if (!targetFile.isEmpty()) {
+                m_downloadedResources.insert(urlStr, targetFile);
+            }
+        }
+    } else {
+        targetFile = WebUtils::copyResource(p_url, p_folder);
+    }
+
+    if (!targetFile.isEmpty()) {
+        m_copiedResources.insert(key, targetFile);
+    }
+    return targetFile;
+}
+
+void ExportResourceCache::clear()
+{
+    m_dataUris.clear();
+    m_dataUrisSize = 0;
+    m_copiedResources.clear();
+    m_downloadedResources.clear();
+}
@@ -0,0 +1,43 @@
+#ifndef EXPORTRESOURCECACHE_H
+#define EXPORTRESOURCECACHE_H
+
+#include <QHash>
+#include <QString>
+
+class QUrl;
+
+namespace vnotex
+{
+    // Cache of resources embedded or copied during one export run, shared by all the
+    // exported notes, so that shared theme fonts and common images are read, downloaded
+    // and encoded only once.
+    class ExportResourceCache
+    {
+    public:
+        ExportResourceCache() = default;
+
+        // Return the data URI of @p_url, or an empty string if not supported.
+        QString toDataUri(const QUrl &p_url, bool p_keepTitle);
+
+        // Copy @p_url into @p_folder and return the target file path, or an empty string if failed.
+        // The same resource will be copied into one folder only once.
+        QString copyResource(const QUrl &p_url, const QString &p_folder);
+
+        void clear();
+
+    private:
+        // {url} -> data URI.
+        QHash<QString, QString> m_dataUris;
+
+        // Total size of cached data URIs.
+        qint64 m_dataUrisSize = 0;
+
+        // {url}\n{folder} -> target file path.
+        QHash<QString, QString> m_copiedResources;
+
+        // {remote url} -> local file path it is downloaded to.
+        QHash<QString, QString> m_downloadedResources;
+    };
+}
+
+#endif // EXPORTRESOURCECACHE_H
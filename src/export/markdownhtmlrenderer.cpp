@@ -0,0 +1,1233 @@
+#include "markdownhtmlrenderer.h"
+
+#include <QRegularExpression>
+#include <QUrl>
+#include <QVector>
+
+using namespace vnotex;
+
+static const QString c_asciiPunctuations = QStringLiteral("!\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~");
+
+static const QRegularExpression c_atxHeadingRegExp("^(#{1,6})(?:[ \\t]+(.*?))?(?:[ \\t]+#+)?[ \\t]*$");
+
+static const QRegularExpression c_setextH1RegExp("^=+[ \\t]*$");
+
+static const QRegularExpression c_setextH2RegExp("^-+[ \\t]*$");
+
+static const QRegularExpression c_thematicBreakRegExp("^([-*_])(?:[ \\t]*\\1){2,}[ \\t]*$");
+
+static const QRegularExpression c_fenceRegExp("^(`{3,}|~{3,})[ \\t]*([^`]*)$");
+
+static const QRegularExpression c_fenceEndRegExp("^(`{3,}|~{3,})[ \\t]*$");
+
+static const QRegularExpression c_listItemRegExp("^([-*+]|(\\d{1,9})([.)]))([ \\t]+|$)");
+
+static const QRegularExpression c_htmlBlockRegExp("^<(?:!--|/?(address|article|aside|audio|blockquote|center|details|div|dl|fieldset|figcaption|figure|footer|form|h[1-6]|header|hr|iframe|li|main|nav|ol|p|pre|script|section|style|summary|table|tbody|td|textarea|tfoot|th|thead|tr|ul|video)(?:[\\s/>]|$))",
+                                                  QRegularExpression::CaseInsensitiveOption);
+
+static const QRegularExpression c_htmlTagLineRegExp("^</?[A-Za-z][A-Za-z0-9\\-]*(?:\\s[^<>]*)?/?>[ \\t]*$");
+
+static const QRegularExpression c_tableDelimiterRegExp("^\\|?[ \\t]*:?-+:?[ \\t]*(?:\\|[ \\t]*:?-+:?[ \\t]*)*\\|?[ \\t]*$");
+
+static const QRegularExpression c_linkReferenceRegExp("^ {0,3}\\[([^\\]]+)\\]:[ \\t]*<?([^\\s>]+)>?(?:[ \\t]+(?:\"([^\"]*)\"|'([^']*)'|\\(([^)]*)\\)))?[ \\t]*$");
+
+static const QRegularExpression c_autolinkRegExp("<([A-Za-z][A-Za-z0-9+.\\-]{1,31}:[^<>\\s]*)>");
+
+static const QRegularExpression c_emailAutolinkRegExp("<([^\\s@<>]+@[^\\s@<>]+\\.[^\\s@<>]+)>");
+
+static const QRegularExpression c_htmlTagRegExp("</?[A-Za-z][A-Za-z0-9\\-]*(?:\\s+[^<>]*)?/?>|<!--[\\s\\S]*?-->");
+
+static const QRegularExpression c_entityRegExp("&(?:#[0-9]{1,7}|#[xX][0-9a-fA-F]{1,6}|[A-Za-z][A-Za-z0-9]{1,31});");
+
+static const QRegularExpression c_linkifyRegExp("(?:https?://|www\\.)[^\\s<>]*[^\\s<>?!.,:;*_~)\\]'\"]");
+
+static bool isBlank(const QString &p_line)
+{
+    for (const auto ch : p_line) {
+        if (!ch.isSpace()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Return the columns of leading whitespaces.
+static int indentOf(const QString &p_line)
+{
+    int col = 0;
+    for (const auto ch : p_line) {
+        if (ch == QLatin1Char(' ')) {
+            ++col;
+        } else if (ch == QLatin1Char('\t')) {
+            col += 4 - col % 4;
+        } else {
+            break;
+        }
+    }
+    return col;
+}
+
+// Remove up to @p_cols columns of leading whitespaces.
+static QString removeIndent(const QString &p_line, int p_cols)
+{
+    int col = 0;
+    int i = 0;
+    while (i < p_line.size() && col < p_cols) {
+        if (p_line[i] == QLatin1Char(' ')) {
+            ++col;
+        } else if (p_line[i] == QLatin1Char('\t')) {
+            const int width = 4 - col % 4;
+            if (col + width > p_cols) {
+                return QString(col + width - p_cols, QLatin1Char(' ')) + p_line.mid(i + 1);
+            }
+            col += width;
+        } else {
+            break;
+        }
+        ++i;
+    }
+    return p_line.mid(i);
+}
+
+static QString escape(const QString &p_text)
+{
+    return p_text.toHtmlEscaped();
+}
+
+static void appendEscaped(QString &p_html, QChar p_ch)
+{
+    switch (p_ch.unicode()) {
+    case '&':
+        p_html += QStringLiteral("&amp;");
+        break;
+
+    case '<':
+        p_html += QStringLiteral("&lt;");
+        break;
+
+    case '>':
+        p_html += QStringLiteral("&gt;");
+        break;
+
+    case '"':
+        p_html += QStringLiteral("&quot;");
+        break;
+
+    default:
+        p_html += p_ch;
+        break;
+    }
+}
+
+static QString unescapeBackslashes(const QString &p_text)
+{
+    if (!p_text.contains(QLatin1Char('\\'))) {
+        return p_text;
+    }
+
+    QString text;
+    text.reserve(p_text.size());
+    for (int i = 0; i < p_text.size(); ++i) {
+        if (p_text[i] == QLatin1Char('\\')
+            && i + 1 < p_text.size()
+            && c_asciiPunctuations.contains(p_text[i + 1])) {
+            ++i;
+        }
+        text += p_text[i];
+    }
+    return text;
+}
+
+// Get the plain text of rendered inline HTML.
+static QString plainText(const QString &p_html)
+{
+    static const QRegularExpression tagReg("<[^>]*>");
+    auto text = p_html;
+    text.remove(tagReg);
+    text.replace(QStringLiteral("&lt;"), QStringLiteral("<"))
+        .replace(QStringLiteral("&gt;"), QStringLiteral(">"))
+        .replace(QStringLiteral("&quot;"), QStringLiteral("\""))
+        .replace(QStringLiteral("&amp;"), QStringLiteral("&"));
+    return text;
+}
+
+// Percent-encode the link like markdown-it does, keeping existing escapes.
+static QString normalizeLink(const QString &p_url)
+{
+    return QString::fromLatin1(QUrl::toPercentEncoding(p_url, "!#$%&'()*+,-./:;=?@[]_~"));
+}
+
+static bool isValidLink(const QString &p_url)
+{
+    static const QRegularExpression badProtoReg("^(vbscript|javascript|data):", QRegularExpression::CaseInsensitiveOption);
+    static const QRegularExpression goodDataReg("^data:image/(gif|png|jpeg|webp);", QRegularExpression::CaseInsensitiveOption);
+    const auto url = p_url.trimmed();
+    return !badProtoReg.match(url).hasMatch() || goodDataReg.match(url).hasMatch();
+}
+
+static QString normalizeLabel(const QString &p_label)
+{
+    return p_label.simplified().toLower();
+}
+
+// Return the index after the code span starting at @p_idx, or -1 if it is not closed.
+static int findCodeSpanEnd(const QString &p_text, int p_idx, int *p_runLength = nullptr)
+{
+    int run = 0;
+    while (p_idx + run < p_text.size() && p_text[p_idx + run] == QLatin1Char('`')) {
+        ++run;
+    }
+
+    if (p_runLength) {
+        *p_runLength = run;
+    }
+
+    int i = p_idx + run;
+    while (i < p_text.size()) {
+        if (p_text[i] != QLatin1Char('`')) {
+            ++i;
+            continue;
+        }
+
+        int closeRun = 0;
+        while (i + closeRun < p_text.size() && p_text[i + closeRun] == QLatin1Char('`')) {
+            ++closeRun;
+        }
+
+        if (closeRun == run) {
+            return i + closeRun;
+        }
+        i += closeRun;
+    }
+
+    return -1;
+}
+
+// Parse the destination and title of an inline link starting with '(' at @p_idx.
+// Return the index after ')', or -1 on failure.
+static int parseLinkDestination(const QString &p_text, int p_idx, QString &p_url, QString &p_title)
+{
+    const int size = p_text.size();
+    int i = p_idx + 1;
+    while (i < size && p_text[i].isSpace()) {
+        ++i;
+    }
+
+    if (i < size && p_text[i] == QLatin1Char('<')) {
+        const int end = p_text.indexOf(QLatin1Char('>'), i);
+        if (end == -1) {
+            return -1;
+        }
+        p_url = p_text.mid(i + 1, end - i - 1);
+        i = end + 1;
+    } else {
+        const int start = i;
+        int depth = 0;
+        while (i < size) {
+            const auto ch = p_text[i];
+            if (ch == QLatin1Char('\\') && i + 1 < size) {
+                i += 2;
+                continue;
+            }
+
+            if (ch.isSpace()) {
+                break;
+            } else if (ch == QLatin1Char('(')) {
+                ++depth;
+            } else if (ch == QLatin1Char(')')) {
+                if (depth == 0) {
+                    break;
+                }
+                --depth;
+            }
+            ++i;
+        }
+        p_url = unescapeBackslashes(p_text.mid(start, i - start));
+    }
+
+    while (i < size && p_text[i].isSpace()) {
+        ++i;
+    }
+
+    if (i < size && (p_text[i] == QLatin1Char('"') || p_text[i] == QLatin1Char('\'') || p_text[i] == QLatin1Char('('))) {
+        const QChar closeCh = p_text[i] == QLatin1Char('(') ? QLatin1Char(')') : p_text[i];
+        const int end = p_text.indexOf(closeCh, i + 1);
+        if (end == -1) {
+            return -1;
+        }
+        p_title = unescapeBackslashes(p_text.mid(i + 1, end - i - 1));
+        i = end + 1;
+
+        while (i < size && p_text[i].isSpace()) {
+            ++i;
+        }
+    }
+
+    if (i < size && p_text[i] == QLatin1Char(')')) {
+        return i + 1;
+    }
+    return -1;
+}
+
+static QStringList splitTableRow(const QString &p_line)
+{
+    auto line = p_line.trimmed();
+    if (line.startsWith(QLatin1Char('|'))) {
+        line.remove(0, 1);
+    }
+    if (line.endsWith(QLatin1Char('|')) && !line.endsWith(QStringLiteral("\\|"))) {
+        line.chop(1);
+    }
+
+    QStringList cells;
+    QString cell;
+    for (int i = 0; i < line.size(); ++i) {
+        if (line[i] == QLatin1Char('\\') && i + 1 < line.size() && line[i + 1] == QLatin1Char('|')) {
+            cell += QLatin1Char('|');
+            ++i;
+        } else if (line[i] == QLatin1Char('|')) {
+            cells << cell.trimmed();
+            cell.clear();
+        } else {
+            cell += line[i];
+        }
+    }
+    cells << cell.trimmed();
+    return cells;
+}
+
+// Whether @p_text starts a block which could interrupt a paragraph.
+static bool isBlockStart(const QString &p_text, bool p_htmlTagEnabled)
+{
+    if (p_text.startsWith(QLatin1Char('>'))
+        || c_atxHeadingRegExp.match(p_text).hasMatch()
+        || c_thematicBreakRegExp.match(p_text).hasMatch()
+        || c_fenceRegExp.match(p_text).hasMatch()
+        || (p_htmlTagEnabled && c_htmlBlockRegExp.match(p_text).hasMatch())) {
+        return true;
+    }
+
+    // Only a non-empty list starting with 1 could interrupt a paragraph.
+    const auto match = c_listItemRegExp.match(p_text);
+    if (match.hasMatch() && !match.captured(4).isEmpty()) {
+        return match.captured(2).isEmpty() || match.captured(2).toInt() == 1;
+    }
+
+    return false;
+}
+
+MarkdownHtmlRenderer::MarkdownHtmlRenderer(const Options &p_options)
+    : m_options(p_options)
+{
+}
+
+bool MarkdownHtmlRenderer::isSupported(const QString &p_text)
+{
+    // Front matter.
+    if (p_text.startsWith(QStringLiteral("---"))) {
+        return false;
+    }
+
+    // Math, TOC, footnotes, emoji, sub and sup, containers and image size.
+    static const QRegularExpression unsupportedReg("\\$|\\\\begin\\{|^[ \\t]*\\[TOC\\][ \\t]*$|\\[\\^|:(?!-+:)[a-z0-9_+\\-]+:"
+                                                   "|(?<!~)~(?!~)|\\^[^\\s^]+\\^|^[ \\t]*:::|\\s=\\d*x\\d*\\)",
+                                                   QRegularExpression::MultilineOption);
+    if (unsupportedReg.match(p_text).hasMatch()) {
+        return false;
+    }
+
+    // Graphs.
+    static const QSet<QString> graphLangs = {
+        QStringLiteral("mermaid"),
+        QStringLiteral("flow"),
+        QStringLiteral("flowchart"),
+        QStringLiteral("wavedrom"),
+        QStringLiteral("wave"),
+        QStringLiteral("plantuml"),
+        QStringLiteral("puml"),
+        QStringLiteral("dot"),
+        QStringLiteral("graphviz"),
+        QStringLiteral("mathjax")
+    };
+    static const QRegularExpression fenceLangReg("^[ \\t]*(?:`{3,}|~{3,})[ \\t]*([^\\s`{]+)",
+                                                 QRegularExpression::MultilineOption);
+    auto it = fenceLangReg.globalMatch(p_text);
+    while (it.hasNext()) {
+        if (graphLangs.contains(it.next().captured(1).toLower())) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+QString MarkdownHtmlRenderer::render(const QString &p_text)
+{
+    m_linkReferences.clear();
+    m_headerIds.clear();
+
+    auto text = p_text;
+    text.replace(QStringLiteral("\r\n"), QStringLiteral("\n")).replace(QLatin1Char('\r'), QLatin1Char('\n'));
+    auto lines = text.split(QLatin1Char('\n'));
+
+    collectLinkReferences(lines);
+
+    QString html;
+    html.reserve(text.size() * 3 / 2);
+    renderBlocks(lines, html, false);
+    return html;
+}
+
+void MarkdownHtmlRenderer::collectLinkReferences(QStringList &p_lines)
+{
+    QString fence;
+    bool prevBlank = true;
+    for (auto &line : p_lines) {
+        if (indentOf(line) < 4) {
+            const auto text = line.trimmed();
+            if (!fence.isEmpty()) {
+                if (text.startsWith(fence) && c_fenceEndRegExp.match(text).hasMatch()) {
+                    fence.clear();
+                }
+                continue;
+            }
+
+            const auto fenceMatch = c_fenceRegExp.match(text);
+            if (fenceMatch.hasMatch()) {
+                fence = fenceMatch.captured(1);
+                prevBlank = false;
+                continue;
+            }
+        } else if (!fence.isEmpty()) {
+            continue;
+        }
+
+        if (prevBlank) {
+            const auto match = c_linkReferenceRegExp.match(line);
+            if (match.hasMatch()) {
+                const auto label = normalizeLabel(match.captured(1));
+                if (!m_linkReferences.contains(label)) {
+                    LinkReference ref;
+                    ref.m_url = unescapeBackslashes(match.captured(2));
+                    for (int i = 3; i <= 5; ++i) {
+                        if (!match.captured(i).isEmpty()) {
+                            ref.m_title = unescapeBackslashes(match.captured(i));
+                            break;
+                        }
+                    }
+                    m_linkReferences.insert(label, ref);
+                }
+
+                // Keep following definitions recognized.
+                line.clear();
+                continue;
+            }
+        }
+
+        prevBlank = isBlank(line);
+    }
+}
+
+void MarkdownHtmlRenderer::renderBlocks(const QStringList &p_lines, QString &p_html, bool p_tight)
+{
+    QStringList para;
+    // End of the last tight paragraph in @p_html.
+    int tightParaEnd = -1;
+    const auto flushPara = [this, &para, &p_html, p_tight, &tightParaEnd]() {
+        if (!para.isEmpty()) {
+            renderParagraph(para, p_html, p_tight);
+            para.clear();
+            if (p_tight) {
+                tightParaEnd = p_html.size();
+            }
+        }
+    };
+
+    const int size = p_lines.size();
+    int idx = 0;
+    while (idx < size) {
+        const auto &line = p_lines[idx];
+        if (isBlank(line)) {
+            flushPara();
+            ++idx;
+            continue;
+        }
+
+        const int indent = indentOf(line);
+        if (indent >= 4) {
+            if (!para.isEmpty()) {
+                // Paragraph continuation.
+                para << line;
+                ++idx;
+                continue;
+            }
+
+            // Indented code block.
+            QStringList codeLines;
+            while (idx < size && (isBlank(p_lines[idx]) || indentOf(p_lines[idx]) >= 4)) {
+                codeLines << removeIndent(p_lines[idx], 4);
+                ++idx;
+            }
+            while (!codeLines.isEmpty() && isBlank(codeLines.last())) {
+                codeLines.removeLast();
+            }
+            p_html += QStringLiteral("<pre><code>") + escape(codeLines.join(QLatin1Char('\n')))
+                      + QStringLiteral("\n</code></pre>\n");
+            continue;
+        }
+
+        const auto text = removeIndent(line, indent);
+
+        // Setext heading.
+        if (!para.isEmpty()) {
+            const bool isH1 = c_setextH1RegExp.match(text).hasMatch();
+            if (isH1 || c_setextH2RegExp.match(text).hasMatch()) {
+                for (auto &paraLine : para) {
+                    paraLine = paraLine.trimmed();
+                }
+                renderHeading(isH1 ? 1 : 2, para.join(QLatin1Char('\n')), p_html);
+                para.clear();
+                ++idx;
+                continue;
+            }
+        }
+
+        // ATX heading.
+        {
+            const auto match = c_atxHeadingRegExp.match(text);
+            if (match.hasMatch()) {
+                flushPara();
+                renderHeading(match.captured(1).size(), match.captured(2).trimmed(), p_html);
+                ++idx;
+                continue;
+            }
+        }
+
+        // Thematic break.
+        if (c_thematicBreakRegExp.match(text).hasMatch()) {
+            flushPara();
+            p_html += QStringLiteral("<hr>\n");
+            ++idx;
+            continue;
+        }
+
+        // Fenced code block.
+        {
+            const auto match = c_fenceRegExp.match(text);
+            if (match.hasMatch()) {
+                flushPara();
+
+                const auto fence = match.captured(1);
+                const auto lang = unescapeBackslashes(match.captured(2).trimmed().section(QLatin1Char(' '), 0, 0));
+                QStringList codeLines;
+                ++idx;
+                while (idx < size) {
+                    const auto &codeLine = p_lines[idx];
+                    ++idx;
+                    if (indentOf(codeLine) < 4) {
+                        const auto trimmed = codeLine.trimmed();
+                        if (trimmed.startsWith(fence) && c_fenceEndRegExp.match(trimmed).hasMatch()) {
+                            break;
+                        }
+                    }
+                    codeLines << removeIndent(codeLine, indent);
+                }
+
+                if (lang.isEmpty()) {
+                    p_html += QStringLiteral("<pre><code>");
+                } else {
+                    p_html += QStringLiteral("<pre><code class=\"lang-%1\">").arg(escape(lang));
+                }
+                for (const auto &codeLine : codeLines) {
+                    p_html += escape(codeLine);
+                    p_html += QLatin1Char('\n');
+                }
+                p_html += QStringLiteral("</code></pre>\n");
+                continue;
+            }
+        }
+
+        // Block quote.
+        if (text.startsWith(QLatin1Char('>'))) {
+            flushPara();
+
+            QStringList quoteLines;
+            while (idx < size) {
+                const auto &quoteLine = p_lines[idx];
+                const auto quoteText = quoteLine.trimmed();
+                if (indentOf(quoteLine) < 4 && quoteText.startsWith(QLatin1Char('>'))) {
+                    int start = 1;
+                    if (start < quoteText.size() && (quoteText[start] == QLatin1Char(' ') || quoteText[start] == QLatin1Char('\t'))) {
+                        ++start;
+                    }
+                    quoteLines << quoteText.mid(start);
+                } else if (!isBlank(quoteLine)
+                           && !isBlank(quoteLines.last())
+                           && !isBlockStart(quoteText, m_options.m_htmlTagEnabled)) {
+                    // Lazy continuation.
+                    quoteLines << quoteLine;
+                } else {
+                    break;
+                }
+                ++idx;
+            }
+
+            p_html += QStringLiteral("<blockquote>\n");
+            renderBlocks(quoteLines, p_html, false);
+            p_html += QStringLiteral("</blockquote>\n");
+            continue;
+        }
+
+        // List.
+        {
+            const auto match = c_listItemRegExp.match(text);
+            if (match.hasMatch() && (para.isEmpty() || isBlockStart(text, m_options.m_htmlTagEnabled))) {
+                flushPara();
+                idx = renderList(p_lines, idx, p_html);
+                continue;
+            }
+        }
+
+        // HTML block.
+        if (m_options.m_htmlTagEnabled) {
+            const auto match = c_htmlBlockRegExp.match(text);
+            if (match.hasMatch() || (para.isEmpty() && c_htmlTagLineRegExp.match(text).hasMatch())) {
+                flushPara();
+
+                // Raw text elements and comments end at their closing tag instead of a blank line.
+                QString endMark;
+                if (text.startsWith(QStringLiteral("<!--"))) {
+                    endMark = QStringLiteral("-->");
+                } else {
+                    const auto tag = match.captured(1).toLower();
+                    if (tag == QStringLiteral("pre")
+                        || tag == QStringLiteral("script")
+                        || tag == QStringLiteral("style")
+                        || tag == QStringLiteral("textarea")) {
+                        endMark = QStringLiteral("</%1>").arg(tag);
+                    }
+                }
+
+                while (idx < size) {
+                    const auto &htmlLine = p_lines[idx];
+                    if (endMark.isEmpty()) {
+                        if (isBlank(htmlLine)) {
+                            break;
+                        }
+                        p_html += htmlLine;
+                        p_html += QLatin1Char('\n');
+                        ++idx;
+                    } else {
+                        p_html += htmlLine;
+                        p_html += QLatin1Char('\n');
+                        ++idx;
+                        if (htmlLine.contains(endMark, Qt::CaseInsensitive)) {
+                            break;
+                        }
+                    }
+                }
+                continue;
+            }
+        }
+
+        // Table.
+        {
+            QString tableHtml;
+            const int nextIdx = renderTable(p_lines, idx, tableHtml);
+            if (nextIdx != idx) {
+                flushPara();
+                p_html += tableHtml;
+                idx = nextIdx;
+                continue;
+            }
+        }
+
+        para << line;
+        ++idx;
+    }
+
+    flushPara();
+
+    // Like markdown-it, a tight paragraph ending a list item is not followed by a new line.
+    if (tightParaEnd == p_html.size() && p_html.endsWith(QLatin1Char('\n'))) {
+        p_html.chop(1);
+    }
+}
+
+int MarkdownHtmlRenderer::renderList(const QStringList &p_lines, int p_idx, QString &p_html)
+{
+    const int size = p_lines.size();
+    int idx = p_idx;
+
+    const auto firstMatch = c_listItemRegExp.match(removeIndent(p_lines[idx], indentOf(p_lines[idx])));
+    Q_ASSERT(firstMatch.hasMatch());
+    const bool ordered = !firstMatch.captured(2).isEmpty();
+    const auto marker = ordered ? firstMatch.captured(3) : firstMatch.captured(1);
+    const int start = ordered ? firstMatch.captured(2).toInt() : 1;
+
+    QVector<QStringList> items;
+    int contentOffset = 0;
+    bool loose = false;
+    while (idx < size) {
+        const auto &line = p_lines[idx];
+        const int indent = indentOf(line);
+        const auto text = removeIndent(line, indent);
+
+        if (indent < 4 && (items.isEmpty() || indent < contentOffset)) {
+            if (!items.isEmpty() && c_thematicBreakRegExp.match(text).hasMatch()) {
+                break;
+            }
+
+            const auto match = c_listItemRegExp.match(text);
+            if (match.hasMatch()) {
+                const bool itemOrdered = !match.captured(2).isEmpty();
+                const auto itemMarker = itemOrdered ? match.captured(3) : match.captured(1);
+                if (itemOrdered != ordered || itemMarker != marker) {
+                    break;
+                }
+
+                if (!items.isEmpty() && isBlank(items.last().last())) {
+                    loose = true;
+                }
+
+                const int markerWidth = match.captured(1).size();
+                const int spaces = match.captured(4).size();
+                if (spaces == 0 || spaces > 4) {
+                    // Empty item or item starting with indented code.
+                    contentOffset = indent + markerWidth + 1;
+                    items.push_back(QStringList(removeIndent(text.mid(match.capturedEnd(1)), 1)));
+                } else {
+                    contentOffset = indent + markerWidth + spaces;
+                    items.push_back(QStringList(text.mid(match.capturedEnd(4))));
+                }
+                ++idx;
+                continue;
+            }
+        }
+
+        if (isBlank(line)) {
+            items.last() << QString();
+            ++idx;
+            continue;
+        }
+
+        if (indent >= contentOffset) {
+            items.last() << removeIndent(line, contentOffset);
+            ++idx;
+            continue;
+        }
+
+        if (!isBlank(items.last().last()) && !isBlockStart(text, m_options.m_htmlTagEnabled)) {
+            // Lazy continuation.
+            items.last() << text;
+            ++idx;
+            continue;
+        }
+
+        break;
+    }
+
+    // Drop trailing blank lines and check blank lines between blocks of an item.
+    for (auto &item : items) {
+        while (item.size() > 1 && isBlank(item.last())) {
+            item.removeLast();
+        }
+
+        for (int i = 1; i < item.size() - 1 && !loose; ++i) {
+            if (isBlank(item[i])) {
+                loose = true;
+            }
+        }
+    }
+
+    bool hasTask = false;
+    QString itemsHtml;
+    for (auto &item : items) {
+        // Task list item.
+        QString checkbox;
+        const auto &first = item.first();
+        if (first.startsWith(QStringLiteral("[ ] "))) {
+            checkbox = QStringLiteral("<input class=\"task-list-item-checkbox\" disabled=\"\" type=\"checkbox\">");
+        } else if (first.startsWith(QStringLiteral("[x] ")) || first.startsWith(QStringLiteral("[X] "))) {
+            checkbox = QStringLiteral("<input class=\"task-list-item-checkbox\" checked=\"\" disabled=\"\" type=\"checkbox\">");
+        }
+
+        if (checkbox.isEmpty()) {
+            itemsHtml += loose ? QStringLiteral("<li>\n") : QStringLiteral("<li>");
+            renderBlocks(item, itemsHtml, !loose);
+        } else {
+            hasTask = true;
+            item.first() = item.first().mid(3);
+
+            QString itemHtml;
+            renderBlocks(item, itemHtml, !loose);
+            checkbox += QLatin1Char(' ');
+            if (itemHtml.startsWith(QStringLiteral("<p>"))) {
+                itemHtml.insert(3, checkbox);
+            } else {
+                itemHtml.prepend(checkbox);
+            }
+
+            itemsHtml += loose ? QStringLiteral("<li class=\"task-list-item\">\n") : QStringLiteral("<li class=\"task-list-item\">");
+            itemsHtml += itemHtml;
+        }
+        itemsHtml += QStringLiteral("</li>\n");
+    }
+
+    const QString classAttr = hasTask ? QStringLiteral(" class=\"contains-task-list\"") : QString();
+    if (ordered) {
+        const QString startAttr = start != 1 ? QStringLiteral(" start=\"%1\"").arg(start) : QString();
+        p_html += QStringLiteral("<ol%1%2>\n").arg(startAttr, classAttr);
+        p_html += itemsHtml;
+        p_html += QStringLiteral("</ol>\n");
+    } else {
+        p_html += QStringLiteral("<ul%1>\n").arg(classAttr);
+        p_html += itemsHtml;
+        p_html += QStringLiteral("</ul>\n");
+    }
+
+    return idx;
+}
+
+int MarkdownHtmlRenderer::renderTable(const QStringList &p_lines, int p_idx, QString &p_html)
+{
+    if (p_idx + 1 >= p_lines.size()) {
+        return p_idx;
+    }
+
+    const auto &headerLine = p_lines[p_idx];
+    const auto &delimiterLine = p_lines[p_idx + 1];
+    if (!headerLine.contains(QLatin1Char('|'))
+        || indentOf(delimiterLine) >= 4
+        || !c_tableDelimiterRegExp.match(delimiterLine).hasMatch()) {
+        return p_idx;
+    }
+
+    const auto headerCells = splitTableRow(headerLine);
+    const auto delimiterCells = splitTableRow(delimiterLine);
+    if (headerCells.size() != delimiterCells.size()) {
+        return p_idx;
+    }
+
+    QStringList alignAttrs;
+    for (const auto &cell : delimiterCells) {
+        const bool left = cell.startsWith(QLatin1Char(':'));
+        const bool right = cell.endsWith(QLatin1Char(':'));
+        if (left && right) {
+            alignAttrs << QStringLiteral(" style=\"text-align:center\"");
+        } else if (right) {
+            alignAttrs << QStringLiteral(" style=\"text-align:right\"");
+        } else if (left) {
+            alignAttrs << QStringLiteral(" style=\"text-align:left\"");
+        } else {
+            alignAttrs << QString();
+        }
+    }
+
+    const auto renderRow = [this, &alignAttrs, &p_html](const QStringList &p_cells, const QString &p_tag) {
+        p_html += QStringLiteral("<tr>\n");
+        for (int i = 0; i < alignAttrs.size(); ++i) {
+            p_html += QStringLiteral("<%1%2>").arg(p_tag, alignAttrs[i]);
+            if (i < p_cells.size()) {
+                p_html += renderInline(p_cells[i]);
+            }
+            p_html += QStringLiteral("</%1>\n").arg(p_tag);
+        }
+        p_html += QStringLiteral("</tr>\n");
+    };
+
+    p_html += QStringLiteral("<table>\n<thead>\n");
+    renderRow(headerCells, QStringLiteral("th"));
+    p_html += QStringLiteral("</thead>\n");
+
+    int idx = p_idx + 2;
+    if (idx < p_lines.size() && !isBlank(p_lines[idx])) {
+        p_html += QStringLiteral("<tbody>\n");
+        while (idx < p_lines.size() && !isBlank(p_lines[idx])) {
+            renderRow(splitTableRow(p_lines[idx]), QStringLiteral("td"));
+            ++idx;
+        }
+        p_html += QStringLiteral("</tbody>\n");
+    }
+
+    p_html += QStringLiteral("</table>\n");
+    return idx;
+}
+
+void MarkdownHtmlRenderer::renderParagraph(const QStringList &p_lines, QString &p_html, bool p_tight)
+{
+    QStringList lines;
+    lines.reserve(p_lines.size());
+    for (const auto &line : p_lines) {
+        lines << removeIndent(line, indentOf(line));
+    }
+
+    auto text = lines.join(QLatin1Char('\n'));
+    while (!text.isEmpty() && text.at(text.size() - 1).isSpace()) {
+        text.chop(1);
+    }
+    const auto content = renderInline(text);
+
+    // An image alone in a paragraph is rendered as a figure with the alt moved to caption.
+    static const QRegularExpression figureReg("^<img [^>]*alt=\"([^\"]*)\"[^>]*>$");
+    const auto match = figureReg.match(content);
+    if (match.hasMatch()) {
+        auto img = content;
+        img.remove(match.capturedStart(1), match.capturedLength(1));
+        p_html += QStringLiteral("<figure>%1<figcaption>%2</figcaption></figure>\n").arg(img, match.captured(1));
+        return;
+    }
+
+    if (p_tight) {
+        p_html += content;
+        p_html += QLatin1Char('\n');
+    } else {
+        p_html += QStringLiteral("<p>");
+        p_html += content;
+        p_html += QStringLiteral("</p>\n");
+    }
+}
+
+void MarkdownHtmlRenderer::renderHeading(int p_level, const QString &p_text, QString &p_html)
+{
+    const auto content = renderInline(p_text);
+    // markdown-it-anchor joins the text of the heading without soft breaks.
+    const auto id = escape(generateHeaderId(plainText(content).remove(QLatin1Char('\n'))));
+    p_html += QStringLiteral("<h%1 id=\"%2\">%3<a class=\"vx-header-anchor\" href=\"#%2\" vx-data-anchor-icon=\"%4\"></a></h%1>\n")
+                .arg(QString::number(p_level), id, content, QString(QChar(0x00B6)));
+}
+
+QString MarkdownHtmlRenderer::generateHeaderId(const QString &p_text)
+{
+    static const QRegularExpression spaceReg("\\s");
+    auto idBase = p_text;
+    idBase = idBase.replace(spaceReg, QStringLiteral("-")).toLower();
+
+    auto id = idBase;
+    int idx = 1;
+    while (m_headerIds.contains(id)) {
+        id = QStringLiteral("%1-%2").arg(idBase).arg(idx);
+        ++idx;
+    }
+    m_headerIds.insert(id);
+    return id;
+}
+
+QString MarkdownHtmlRenderer::renderInline(const QString &p_text)
+{
+    QString html;
+    html.reserve(p_text.size() + p_text.size() / 4);
+
+    const int size = p_text.size();
+    int i = 0;
+    while (i < size) {
+        const auto ch = p_text[i];
+        switch (ch.unicode()) {
+        case '\\':
+            if (i + 1 < size && p_text[i + 1] == QLatin1Char('\n')) {
+                html += QStringLiteral("<br>\n");
+                i += 2;
+                continue;
+            } else if (i + 1 < size && c_asciiPunctuations.contains(p_text[i + 1])) {
+                appendEscaped(html, p_text[i + 1]);
+                i += 2;
+                continue;
+            }
+            break;
+
+        case '`':
+        {
+            int run = 0;
+            const int end = findCodeSpanEnd(p_text, i, &run);
+            if (end == -1) {
+                html += p_text.mid(i, run);
+                i += run;
+                continue;
+            }
+
+            auto code = p_text.mid(i + run, end - i - 2 * run);
+            code.replace(QLatin1Char('\n'), QLatin1Char(' '));
+            if (code.size() >= 2
+                && code.startsWith(QLatin1Char(' '))
+                && code.endsWith(QLatin1Char(' '))
+                && !isBlank(code)) {
+                code = code.mid(1, code.size() - 2);
+            }
+            html += QStringLiteral("<code>") + escape(code) + QStringLiteral("</code>");
+            i = end;
+            continue;
+        }
+
+        case '!':
+            if (i + 1 < size && p_text[i + 1] == QLatin1Char('[')) {
+                const int end = renderLink(p_text, i, true, html);
+                if (end != -1) {
+                    i = end;
+                    continue;
+                }
+            }
+            break;
+
+        case '[':
+        {
+            const int end = renderLink(p_text, i, false, html);
+            if (end != -1) {
+                i = end;
+                continue;
+            }
+            break;
+        }
+
+        case '<':
+        {
+            auto match = c_autolinkRegExp.match(p_text, i, QRegularExpression::NormalMatch, QRegularExpression::AnchoredMatchOption);
+            if (match.hasMatch() && isValidLink(match.captured(1))) {
+                html += QStringLiteral("<a href=\"%1\">%2</a>").arg(escape(normalizeLink(match.captured(1))),
+                                                                 escape(match.captured(1)));
+                i = match.capturedEnd();
+                continue;
+            }
+
+            match = c_emailAutolinkRegExp.match(p_text, i, QRegularExpression::NormalMatch, QRegularExpression::AnchoredMatchOption);
+            if (match.hasMatch()) {
+                html += QStringLiteral("<a href=\"mailto:%1\">%2</a>").arg(escape(normalizeLink(match.captured(1))),
+                                                                        escape(match.captured(1)));
+                i = match.capturedEnd();
+                continue;
+            }
+
+            if (m_options.m_htmlTagEnabled) {
+                match = c_htmlTagRegExp.match(p_text, i, QRegularExpression::NormalMatch, QRegularExpression::AnchoredMatchOption);
+                if (match.hasMatch()) {
+                    html += match.captured();
+                    i = match.capturedEnd();
+                    continue;
+                }
+            }
+            break;
+        }
+
+        case '&':
+        {
+            const auto match = c_entityRegExp.match(p_text, i, QRegularExpression::NormalMatch, QRegularExpression::AnchoredMatchOption);
+            if (match.hasMatch()) {
+                html += match.captured();
+                i = match.capturedEnd();
+                continue;
+            }
+            break;
+        }
+
+        case '*':
+        case '_':
+        case '~':
+        {
+            const int end = renderEmphasis(p_text, i, html);
+            if (end != -1) {
+                i = end;
+                continue;
+            }
+
+            // Output the whole delimiter run to avoid matching its tail.
+            int run = 0;
+            while (i + run < size && p_text[i + run] == ch) {
+                ++run;
+            }
+            html += p_text.mid(i, run);
+            i += run;
+            continue;
+        }
+
+        case '\n':
+        {
+            int spaces = 0;
+            while (html.endsWith(QLatin1Char(' '))) {
+                html.chop(1);
+                ++spaces;
+            }
+
+            if (spaces >= 2 || m_options.m_autoBreakEnabled) {
+                html += QStringLiteral("<br>\n");
+            } else {
+                html += QLatin1Char('\n');
+            }
+
+            ++i;
+            while (i < size && p_text[i] == QLatin1Char(' ')) {
+                ++i;
+            }
+            continue;
+        }
+
+        case 'h':
+        case 'w':
+            if (m_options.m_linkifyEnabled && (i == 0 || !p_text[i - 1].isLetterOrNumber())) {
+                const auto match = c_linkifyRegExp.match(p_text, i, QRegularExpression::NormalMatch, QRegularExpression::AnchoredMatchOption);
+                if (match.hasMatch()) {
+                    const auto url = match.captured();
+                    const auto href = url.startsWith(QLatin1Char('w')) ? QStringLiteral("http://") + url : url;
+                    html += QStringLiteral("<a href=\"%1\">%2</a>").arg(escape(normalizeLink(href)), escape(url));
+                    i = match.capturedEnd();
+                    continue;
+                }
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        appendEscaped(html, ch);
+        ++i;
+    }
+
+    return html;
+}
+
+int MarkdownHtmlRenderer::renderLink(const QString &p_text, int p_idx, bool p_isImage, QString &p_html)
+{
+    const int size = p_text.size();
+    const int labelStart = p_idx + (p_isImage ? 2 : 1);
+
+    // Find the matching bracket.
+    int depth = 1;
+    int i = labelStart;
+    while (i < size) {
+        const auto ch = p_text[i];
+        if (ch == QLatin1Char('\\')) {
+            i += 2;
+            continue;
+        } else if (ch == QLatin1Char('`')) {
+            int run = 0;
+            const int end = findCodeSpanEnd(p_text, i, &run);
+            i = end == -1 ? i + run : end;
+            continue;
+        } else if (ch == QLatin1Char('[')) {
+            ++depth;
+        } else if (ch == QLatin1Char(']')) {
+            if (--depth == 0) {
+                break;
+            }
+        }
+        ++i;
+    }
+
+    if (i >= size) {
+        return -1;
+    }
+
+    const auto label = p_text.mid(labelStart, i - labelStart);
+    int end = -1;
+    QString url;
+    QString title;
+    if (i + 1 < size && p_text[i + 1] == QLatin1Char('(')) {
+        end = parseLinkDestination(p_text, i + 1, url, title);
+    }
+
+    if (end == -1) {
+        // Reference link, in full, collapsed or shortcut form.
+        auto refLabel = label;
+        end = i + 1;
+        if (i + 1 < size && p_text[i + 1] == QLatin1Char('[')) {
+            const int close = p_text.indexOf(QLatin1Char(']'), i + 2);
+            if (close != -1) {
+                if (close > i + 2) {
+                    refLabel = p_text.mid(i + 2, close - i - 2);
+                }
+                end = close + 1;
+            }
+        }
+
+        auto it = m_linkReferences.constFind(normalizeLabel(refLabel));
+        if (it == m_linkReferences.constEnd()) {
+            return -1;
+        }
+        url = it->m_url;
+        title = it->m_title;
+    }
+
+    if (!isValidLink(url)) {
+        return -1;
+    }
+
+    const auto titleAttr = title.isEmpty() ? QString() : QStringLiteral(" title=\"%1\"").arg(escape(title));
+    if (p_isImage) {
+        p_html += QStringLiteral("<img src=\"%1\" alt=\"%2\"%3>").arg(escape(normalizeLink(url)),
+                                                                     escape(plainText(renderInline(label))),
+                                                                     titleAttr);
+    } else {
+        p_html += QStringLiteral("<a href=\"%1\"%2>%3</a>").arg(escape(normalizeLink(url)),
+                                                               titleAttr,
+                                                               renderInline(label));
+    }
+    return end;
+}
+
+int MarkdownHtmlRenderer::renderEmphasis(const QString &p_text, int p_idx, QString &p_html)
+{
+    const int size = p_text.size();
+    const auto ch = p_text[p_idx];
+    int run = 0;
+    while (p_idx + run < size && p_text[p_idx + run] == ch) {
+        ++run;
+    }
+
+    if (ch == QLatin1Char('~') ? run != 2 : run > 3) {
+        return -1;
+    }
+
+    // Must be left-flanking and not intraword for '_'.
+    const int contentStart = p_idx + run;
+    if (contentStart >= size || p_text[contentStart].isSpace()) {
+        return -1;
+    }
+    if (ch == QLatin1Char('_') && p_idx > 0 && p_text[p_idx - 1].isLetterOrNumber()) {
+        return -1;
+    }
+
+    // Find the closing delimiter run of the same length.
+    int i = contentStart;
+    while (i < size) {
+        const auto cur = p_text[i];
+        if (cur == QLatin1Char('\\')) {
+            i += 2;
+            continue;
+        } else if (cur == QLatin1Char('`')) {
+            int codeRun = 0;
+            const int end = findCodeSpanEnd(p_text, i, &codeRun);
+            i = end == -1 ? i + codeRun : end;
+            continue;
+        } else if (cur != ch) {
+            ++i;
+            continue;
+        }
+
+        int closeRun = 0;
+        while (i + closeRun < size && p_text[i + closeRun] == ch) {
+            ++closeRun;
+        }
+
+        if (closeRun == run
+            && !p_text[i - 1].isSpace()
+            && (ch != QLatin1Char('_') || i + closeRun >= size || !p_text[i + closeRun].isLetterOrNumber())) {
+            break;
+        }
+        i += closeRun;
+    }
+
+    if (i >= size) {
+        return -1;
+    }
+
+    const auto content = renderInline(p_text.mid(contentStart, i - contentStart));
+    if (ch == QLatin1Char('~')) {
+        p_html += QStringLiteral("<s>%1</s>").arg(content);
+    } else if (run == 1) {
+        p_html += QStringLiteral("<em>%1</em>").arg(content);
+    } else if (run == 2) {
+        p_html += QStringLiteral("<strong>%1</strong>").arg(content);
+    } else {
+        p_html += QStringLiteral("<em><strong>%1</strong></em>").arg(content);
+    }
+    return i + run;
+}
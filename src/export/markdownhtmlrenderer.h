@@ -0,0 +1,80 @@
+#ifndef MARKDOWNHTMLRENDERER_H
+#define MARKDOWNHTMLRENDERER_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+
+namespace vnotex
+{
+    // Render Markdown into HTML in-process, producing the same markup as the markdown-it
+    // based renderer of MarkdownViewer for common notes.
+    // Notes using features rendered only by JavaScript, such as diagrams, math and
+    // footnotes, are not supported and should be rendered by the web side.
+    class MarkdownHtmlRenderer
+    {
+    public:
+        struct Options
+        {
+            bool m_htmlTagEnabled = true;
+
+            bool m_autoBreakEnabled = false;
+
+            bool m_linkifyEnabled = true;
+        };
+
+        explicit MarkdownHtmlRenderer(const Options &p_options);
+
+        // Whether @p_text could be rendered natively.
+        static bool isSupported(const QString &p_text);
+
+        // Return the rendered HTML of @p_text without the content container.
+        QString render(const QString &p_text);
+
+    private:
+        struct LinkReference
+        {
+            QString m_url;
+
+            QString m_title;
+        };
+
+        void collectLinkReferences(QStringList &p_lines);
+
+        // Render block elements of @p_lines into @p_html.
+        // @p_tight: whether paragraphs are rendered without <p>, as in a tight list.
+        void renderBlocks(const QStringList &p_lines, QString &p_html, bool p_tight);
+
+        // Return the index of the line after the list.
+        int renderList(const QStringList &p_lines, int p_idx, QString &p_html);
+
+        // Return the index of the line after the table, or @p_idx if it is not a table.
+        int renderTable(const QStringList &p_lines, int p_idx, QString &p_html);
+
+        void renderParagraph(const QStringList &p_lines, QString &p_html, bool p_tight);
+
+        void renderHeading(int p_level, const QString &p_text, QString &p_html);
+
+        QString renderInline(const QString &p_text);
+
+        // Try to parse a link or image at @p_idx of @p_text. Return the end index on success
+        // or -1 on failure.
+        int renderLink(const QString &p_text, int p_idx, bool p_isImage, QString &p_html);
+
+        // Try to parse an emphasis at @p_idx of @p_text. Return the end index on success
+        // or -1 on failure.
+        int renderEmphasis(const QString &p_text, int p_idx, QString &p_html);
+
+        QString generateHeaderId(const QString &p_text);
+
+        Options m_options;
+
+        // {normalized label} -> LinkReference.
+        QHash<QString, LinkReference> m_linkReferences;
+
+        QSet<QString> m_headerIds;
+    };
+}
+
+#endif // MARKDOWNHTMLRENDERER_H
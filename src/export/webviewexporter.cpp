@@ -5,6 +5,10 @@
 #include <QFileInfo>
 #include <QTemporaryDir>
 #include <QProcess>
+#include <QEventLoop>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QRegularExpression>
 
 #include <widgets/editors/markdownviewer.h>
 #include <widgets/editors/editormarkdownvieweradapter.h>
@@ -15,20 +19,35 @@
 #include <utils/utils.h>
 #include <utils/pathutils.h>
 #include <utils/fileutils.h>
-#include <utils/webutils.h>
 #include <utils/processutils.h>
 #include <utils/htmlutils.h>
 #include <core/file.h>
+#include <core/exception.h>
+
+#include "exportresourcecache.h"
+#include "markdownhtmlrenderer.h"
 
 using namespace vnotex;
 
 static const QString c_imgRegExp = "<img ([^>]*)src=\"(?!data:)([^\"]+)\"([^>]*)>";
 
+// Time limit in ms for the web side to render one note.
+static const int c_renderTimeout = 120 * 1000;
+
+// Time limit in ms for the web side to output the content of one note.
+static const int c_outputTimeout = 60 * 1000;
+
 WebViewExporter::WebViewExporter(QWidget *p_parent)
-    : QObject(p_parent)
+    : QObject(p_parent),
+      m_resourceCache(new ExportResourceCache())
 {
 }
 
+void WebViewExporter::setResourceCache(const QSharedPointer<ExportResourceCache> &p_cache)
+{
+    m_resourceCache = p_cache;
+}
+
 WebViewExporter::~WebViewExporter()
 {
     clear();
@@ -44,6 +63,10 @@ void WebViewExporter::clear()
     m_htmlTemplate.clear();
     m_exportHtmlTemplate.clear();
 
+    m_nativeRenderer.clear();
+    m_nativeContent.clear();
+    m_nativeStyleContent.clear();
+
     m_exportOngoing = false;
 }
 
@@ -51,7 +74,12 @@ bool WebViewExporter::doExport(const ExportOption &p_option,
                                const File *p_file,
                                const QString &p_outputFile)
 {
-    bool ret = false;
+    load(p_option, p_file);
+    return finishExport(p_option, p_outputFile);
+}
+
+void WebViewExporter::load(const ExportOption &p_option, const File *p_file)
+{
     m_askedToStop = false;
 
     Q_ASSERT(p_file->getContentType().isMarkdown());
@@ -61,11 +89,29 @@ bool WebViewExporter::doExport(const ExportOption &p_option,
 
     m_webViewStates = WebViewState::Started;
 
-    auto baseUrl = PathUtils::pathToUrl(p_file->getContentPath());
-    m_viewer->adapter()->reset();
-    m_viewer->setHtml(m_htmlTemplate, baseUrl);
+    m_filePath = p_file->getFilePath();
+    m_baseUrl = PathUtils::pathToUrl(p_file->getContentPath());
 
     auto textContent = p_file->read();
+
+    m_nativeContent.clear();
+    if (m_nativeRenderer) {
+        if (MarkdownHtmlRenderer::isSupported(textContent)) {
+            m_nativeContent = QString("<div id=\"vx-content\" class=\"%1\">%2</div>").arg(m_nativeContentClassList,
+                                                                                        m_nativeRenderer->render(textContent));
+            return;
+        }
+
+        qDebug() << "render via web view for unsupported features" << m_filePath;
+    }
+
+    if (!m_viewer) {
+        setupViewer();
+    }
+
+    m_viewer->adapter()->reset();
+    m_viewer->setHtml(m_htmlTemplate, m_baseUrl);
+
     if (p_option.m_targetFormat == ExportFormat::PDF
         && p_option.m_pdfOption.m_addTableOfContents
         && !p_option.m_pdfOption.m_useWkhtmltopdf) {
@@ -74,35 +120,50 @@ bool WebViewExporter::doExport(const ExportOption &p_option,
     } else {
         m_viewer->adapter()->setText(textContent);
     }
+}
+
+bool WebViewExporter::finishExport(const ExportOption &p_option, const QString &p_outputFile)
+{
+    bool ret = false;
 
-    while (!isWebViewReady()) {
-        Utils::sleepWait(100);
+    Q_ASSERT(m_exportOngoing);
 
+    if (!m_nativeContent.isEmpty()) {
+        Q_ASSERT(p_option.m_targetFormat == ExportFormat::HTML);
+        ret = doExportNativeHtml(p_option.m_htmlOption, p_outputFile);
+        m_nativeContent.clear();
+        goto exit_export;
+    }
+
+    {
+        QElapsedTimer timer;
+        timer.start();
+        const bool done = waitFor([this]() {
+                                      return isWebViewReady() || isWebViewFailed();
+                                  },
+                                  c_renderTimeout);
         if (m_askedToStop) {
             goto exit_export;
         }
 
-        if (isWebViewFailed()) {
-            qWarning() << "WebView failed when exporting" << p_file->getFilePath();
+        if (!done || isWebViewFailed()) {
+            qWarning() << "WebView failed when exporting" << m_filePath << (done ? "" : "(timed out)");
             goto exit_export;
         }
-    }
 
-    qDebug() << "WebView is ready";
-
-    // Add extra wait to make sure Web side is really ready.
-    Utils::sleepWait(200);
+        qDebug() << "WebView is ready in" << timer.elapsed() << "ms";
+    }
 
     switch (p_option.m_targetFormat) {
     case ExportFormat::HTML:
         // TODO: MIME HTML format is not supported yet.
         Q_ASSERT(!p_option.m_htmlOption.m_useMimeHtmlFormat);
-        ret = doExportHtml(p_option.m_htmlOption, p_outputFile, baseUrl);
+        ret = doExportHtml(p_option.m_htmlOption, p_outputFile, m_baseUrl);
         break;
 
     case ExportFormat::PDF:
         if (p_option.m_pdfOption.m_useWkhtmltopdf) {
-            ret = doExportWkhtmltopdf(p_option.m_pdfOption, p_outputFile, baseUrl);
+            ret = doExportWkhtmltopdf(p_option.m_pdfOption, p_outputFile, m_baseUrl);
         } else {
             ret = doExportPdf(p_option.m_pdfOption, p_outputFile);
         }
@@ -120,6 +181,38 @@ exit_export:
 void WebViewExporter::stop()
 {
     m_askedToStop = true;
+    wakeUp();
+}
+
+bool WebViewExporter::waitFor(const std::function<bool()> &p_done, int p_timeout)
+{
+    if (p_done()) {
+        return true;
+    }
+
+    Q_ASSERT(!m_eventLoop);
+    QEventLoop loop;
+    m_eventLoop = &loop;
+
+    QTimer timer;
+    timer.setSingleShot(true);
+    connect(&timer, &QTimer::timeout,
+            &loop, &QEventLoop::quit);
+    timer.start(p_timeout);
+
+    while (!p_done() && !m_askedToStop && timer.isActive()) {
+        loop.exec();
+    }
+
+    m_eventLoop = nullptr;
+    return p_done();
+}
+
+void WebViewExporter::wakeUp()
+{
+    if (m_eventLoop) {
+        m_eventLoop->quit();
+    }
 }
 
 bool WebViewExporter::isWebViewReady() const
@@ -136,49 +229,63 @@ bool WebViewExporter::doExportHtml(const ExportHtmlOption &p_htmlOption,
                                    const QString &p_outputFile,
                                    const QUrl &p_baseUrl)
 {
-    ExportState state = ExportState::Busy;
+    auto state = QSharedPointer<ExportState>::create(ExportState::Busy);
 
     connect(m_viewer->adapter(), &MarkdownViewerAdapter::contentReady,
-            this, [&, this](const QString &p_headContent,
-                            const QString &p_styleContent,
-                            const QString &p_content,
-                            const QString &p_bodyClassList) {
+            this, [=](const QString &p_headContent,
+                      const QString &p_styleContent,
+                      const QString &p_content,
+                      const QString &p_bodyClassList) {
                 qDebug() << "doExportHtml contentReady";
                 // Maybe unnecessary. Just to avoid duplicated signal connections.
                 disconnect(m_viewer->adapter(), &MarkdownViewerAdapter::contentReady, this, 0);
 
                 if (p_content.isEmpty() || m_askedToStop) {
-                    state = ExportState::Failed;
-                    return;
-                }
-
-                if (!writeHtmlFile(p_outputFile,
-                                   p_baseUrl,
-                                   p_headContent,
-                                   p_styleContent,
-                                   p_content,
-                                   p_bodyClassList,
-                                   p_htmlOption.m_embedStyles,
-                                   p_htmlOption.m_completePage,
-                                   p_htmlOption.m_embedImages)) {
-                    state = ExportState::Failed;
-                    return;
+                    *state = ExportState::Failed;
+                } else if (!writeHtmlFile(p_outputFile,
+                                          p_baseUrl,
+                                          p_headContent,
+                                          p_styleContent,
+                                          p_content,
+                                          p_bodyClassList,
+                                          p_htmlOption.m_embedStyles,
+                                          p_htmlOption.m_completePage,
+                                          p_htmlOption.m_embedImages)) {
+                    *state = ExportState::Failed;
+                } else {
+                    *state = ExportState::Finished;
                 }
 
-                state = ExportState::Finished;
+                wakeUp();
             });
 
     m_viewer->adapter()->saveContent();
 
-    while (state == ExportState::Busy) {
-        Utils::sleepWait(100);
+    waitFor([state]() {
+                return *state != ExportState::Busy;
+            },
+            c_outputTimeout);
 
-        if (m_askedToStop) {
-            break;
-        }
+    disconnect(m_viewer->adapter(), &MarkdownViewerAdapter::contentReady, this, 0);
+
+    return *state == ExportState::Finished;
+}
+
+bool WebViewExporter::doExportNativeHtml(const ExportHtmlOption &p_htmlOption, const QString &p_outputFile)
+{
+    if (m_askedToStop) {
+        return false;
     }
 
-    return state == ExportState::Finished;
+    return writeHtmlFile(p_outputFile,
+                         m_baseUrl,
+                         QString(),
+                         m_nativeStyleContent,
+                         m_nativeContent,
+                         m_nativeBodyClassList,
+                         p_htmlOption.m_embedStyles,
+                         p_htmlOption.m_completePage,
+                         p_htmlOption.m_embedImages);
 }
 
 bool WebViewExporter::writeHtmlFile(const QString &p_file,
@@ -248,10 +355,92 @@ QSize WebViewExporter::pageLayoutSize(const QPageLayout &p_layout) const
     return QSize(rect.width() * m_viewer->logicalDpiX(), rect.height() * m_viewer->logicalDpiY());
 }
 
-void WebViewExporter::prepare(const ExportOption &p_option)
+// Make url() in @p_css absolute against @p_baseUrl like the web side does.
+static QString translateCssUrls(QString p_css, const QUrl &p_baseUrl)
 {
-    Q_ASSERT(!m_viewer && !m_exportOngoing);
-    Q_ASSERT(p_option.m_targetFormat == ExportFormat::PDF || p_option.m_targetFormat == ExportFormat::HTML);
+    static const QRegularExpression reg("\\burl\\(\\s*(['\"]?)([^'\"\\)]+)\\1\\s*\\)");
+
+    HtmlUtils::replaceAll(p_css, reg, [&p_baseUrl](const QRegularExpressionMatch &p_match) {
+        const auto url = p_match.captured(2).trimmed();
+        if (url.startsWith(QStringLiteral("data:")) || url.startsWith(QLatin1Char('#'))) {
+            return QString();
+        }
+
+        return QString("url(\"%1\")").arg(p_baseUrl.resolved(QUrl(url)).toString());
+    });
+    return p_css;
+}
+
+// Fetch the styles of the HTML template in document order, as the web side outputs.
+static QString fetchTemplateStyles(const QString &p_template)
+{
+    static const QRegularExpression reg("<style[^>]*>([\\s\\S]*?)</style>|<link rel=\"stylesheet\" type=\"text/css\" href=\"([^\"]+)\">");
+
+    QString styles;
+    auto it = reg.globalMatch(p_template);
+    while (it.hasNext()) {
+        const auto match = it.next();
+        if (match.captured(2).isEmpty()) {
+            styles += match.captured(1);
+            styles += QLatin1Char('\n');
+            continue;
+        }
+
+        const QUrl url(match.captured(2));
+        const auto styleFile = url.toLocalFile();
+        try {
+            styles += translateCssUrls(FileUtils::readTextFile(styleFile), url);
+            styles += QLatin1Char('\n');
+        } catch (Exception &p_e) {
+            qWarning() << "failed to read style sheet" << styleFile << p_e.what();
+        }
+    }
+
+    return styles;
+}
+
+void WebViewExporter::setupNativeRenderer(const ExportOption &p_option, bool p_scrollable)
+{
+    m_nativeRenderer.clear();
+    if (p_option.m_targetFormat != ExportFormat::HTML || !p_option.m_htmlOption.m_useNativeRenderer) {
+        return;
+    }
+
+    const auto &config = ConfigMgr::getInst().getEditorConfig().getMarkdownEditorConfig();
+    if (config.getSectionNumberMode() == MarkdownEditorConfig::SectionNumberMode::Read) {
+        // Section number depends on existing heading sequences checked by the web side.
+        qDebug() << "native renderer is disabled by section number";
+        return;
+    }
+
+    MarkdownHtmlRenderer::Options opts;
+    opts.m_htmlTagEnabled = config.getHtmlTagEnabled() && !config.getProtectFromXss();
+    opts.m_autoBreakEnabled = config.getAutoBreakEnabled();
+    opts.m_linkifyEnabled = config.getLinkifyEnabled();
+    m_nativeRenderer.reset(new MarkdownHtmlRenderer(opts));
+
+    // Keep consistent with the options set by the web side.
+    QStringList classes;
+    if (config.getConstrainImageWidthEnabled() || !p_scrollable) {
+        classes << QStringLiteral("vx-constrain-image-width");
+    }
+    if (config.getImageAlignCenterEnabled()) {
+        classes << QStringLiteral("vx-image-align-center");
+    }
+    if (config.getIndentFirstLineEnabled()) {
+        classes << QStringLiteral("vx-indent-first-line");
+    }
+    if (!p_scrollable) {
+        classes << QStringLiteral("vx-nonscrollable");
+    }
+    m_nativeContentClassList = classes.join(QLatin1Char(' '));
+
+    m_nativeBodyClassList = p_option.m_useTransparentBg ? QStringLiteral("vx-transparent-background") : QString();
+}
+
+void WebViewExporter::setupViewer()
+{
+    Q_ASSERT(!m_viewer);
 
     {
         // Adapter will be managed by MarkdownViewer.
@@ -259,14 +448,22 @@ void WebViewExporter::prepare(const ExportOption &p_option)
         m_viewer = new MarkdownViewer(adapter, QColor(), 1, static_cast<QWidget *>(parent()));
         m_viewer->hide();
         connect(m_viewer->page(), &QWebEnginePage::loadFinished,
-                this, [this]() {
-                    m_webViewStates |= WebViewState::LoadFinished;
+                this, [this](bool p_ok) {
+                    m_webViewStates |= p_ok ? WebViewState::LoadFinished : WebViewState::Failed;
+                    wakeUp();
                 });
         connect(adapter, &MarkdownViewerAdapter::workFinished,
                 this, [this]() {
                     m_webViewStates |= WebViewState::WorkFinished;
+                    wakeUp();
                 });
     }
+}
+
+void WebViewExporter::prepare(const ExportOption &p_option)
+{
+    Q_ASSERT(!m_viewer && !m_exportOngoing);
+    Q_ASSERT(p_option.m_targetFormat == ExportFormat::PDF || p_option.m_targetFormat == ExportFormat::HTML);
 
     bool scrollable = true;
     if (p_option.m_targetFormat == ExportFormat::PDF
@@ -275,6 +472,13 @@ void WebViewExporter::prepare(const ExportOption &p_option)
         scrollable = false;
     }
 
+    setupNativeRenderer(p_option, scrollable);
+
+    // The viewer will be set up on demand when rendering natively.
+    if (!m_nativeRenderer) {
+        setupViewer();
+    }
+
     const auto &config = ConfigMgr::getInst().getEditorConfig().getMarkdownEditorConfig();
     bool useWkhtmltopdf = false;
     QSize pageBodySize(1024, 768);
@@ -303,6 +507,10 @@ void WebViewExporter::prepare(const ExportOption &p_option)
         m_exportHtmlTemplate = HtmlTemplateHelper::generateExportTemplate(config, addOutlinePanel);
     }
 
+    if (m_nativeRenderer) {
+        m_nativeStyleContent = fetchTemplateStyles(m_htmlTemplate);
+    }
+
     if (useWkhtmltopdf) {
         prepareWkhtmltopdfArguments(p_option.m_pdfOption);
     }
@@ -355,68 +563,41 @@ void WebViewExporter::prepareWkhtmltopdfArguments(const ExportPdfOption &p_pdfOp
     }
 }
 
-bool WebViewExporter::embedStyleResources(QString &p_html) const
+bool WebViewExporter::embedStyleResources(QString &p_html)
 {
-    bool altered = false;
-    QRegExp reg("\\burl\\(\"((file|qrc):[^\"\\)]+)\"\\);");
-
-    int pos = 0;
-    while (pos < p_html.size()) {
-        int idx = p_html.indexOf(reg, pos);
-        if (idx == -1) {
-            break;
-        }
+    static const QRegularExpression reg("\\burl\\(\"((file|qrc):[^\"\\)]+)\"\\);");
 
-        QString dataURI = WebUtils::toDataUri(QUrl(reg.cap(1)), false);
+    return HtmlUtils::replaceAll(p_html, reg, [this](const QRegularExpressionMatch &p_match) {
+        const auto dataURI = m_resourceCache->toDataUri(QUrl(p_match.captured(1)), false);
         if (dataURI.isEmpty()) {
-            pos = idx + reg.matchedLength();
-        } else {
-            // Replace the url string in html.
-            QString newUrl = QString("url('%1');").arg(dataURI);
-            p_html.replace(idx, reg.matchedLength(), newUrl);
-            pos = idx + newUrl.size();
-            altered = true;
+            return QString();
         }
-    }
 
-    return altered;
+        return QString("url('%1');").arg(dataURI);
+    });
 }
 
 bool WebViewExporter::embedBodyResources(const QUrl &p_baseUrl, QString &p_html)
 {
-    bool altered = false;
     if (p_baseUrl.isEmpty()) {
-        return altered;
+        return false;
     }
 
-    QRegExp reg(c_imgRegExp);
-
-    int pos = 0;
-    while (pos < p_html.size()) {
-        int idx = p_html.indexOf(reg, pos);
-        if (idx == -1) {
-            break;
-        }
+    static const QRegularExpression reg(c_imgRegExp);
 
-        if (reg.cap(2).isEmpty()) {
-            pos = idx + reg.matchedLength();
-            continue;
+    return HtmlUtils::replaceAll(p_html, reg, [this, &p_baseUrl](const QRegularExpressionMatch &p_match) {
+        if (p_match.captured(2).isEmpty()) {
+            return QString();
         }
 
-        QUrl srcUrl(p_baseUrl.resolved(reg.cap(2)));
-        const auto dataURI = WebUtils::toDataUri(srcUrl, true);
+        QUrl srcUrl(p_baseUrl.resolved(p_match.captured(2)));
+        const auto dataURI = m_resourceCache->toDataUri(srcUrl, true);
         if (dataURI.isEmpty()) {
-            pos = idx + reg.matchedLength();
-        } else {
-            // Replace the url string in html.
-            QString newUrl = QString("<img %1src='%2'%3>").arg(reg.cap(1), dataURI, reg.cap(3));
-            p_html.replace(idx, reg.matchedLength(), newUrl);
-            pos = idx + newUrl.size();
-            altered = true;
+            return QString();
         }
-    }
 
-    return altered;
+        return QString("<img %1src='%2'%3>").arg(p_match.captured(1), dataURI, p_match.captured(3));
+    });
 }
 
 static QString getResourceRelativePath(const QString &p_file)
@@ -431,68 +612,61 @@ bool WebViewExporter::fixBodyResources(const QUrl &p_baseUrl,
                                        const QString &p_folder,
                                        QString &p_html)
 {
-    bool altered = false;
     if (p_baseUrl.isEmpty()) {
-        return altered;
+        return false;
     }
 
-    QRegExp reg(c_imgRegExp);
+    static const QRegularExpression reg(c_imgRegExp);
 
-    int pos = 0;
-    while (pos < p_html.size()) {
-        int idx = p_html.indexOf(reg, pos);
-        if (idx == -1) {
-            break;
+    return HtmlUtils::replaceAll(p_html, reg, [this, &p_baseUrl, &p_folder](const QRegularExpressionMatch &p_match) {
+        if (p_match.captured(2).isEmpty()) {
+            return QString();
         }
 
-        if (reg.cap(2).isEmpty()) {
-            pos = idx + reg.matchedLength();
-            continue;
-        }
-
-        QUrl srcUrl(p_baseUrl.resolved(reg.cap(2)));
-        QString targetFile = WebUtils::copyResource(srcUrl, p_folder);
+        QUrl srcUrl(p_baseUrl.resolved(p_match.captured(2)));
+        const auto targetFile = m_resourceCache->copyResource(srcUrl, p_folder);
         if (targetFile.isEmpty()) {
-            pos = idx + reg.matchedLength();
-        } else {
-            // Replace the url string in html.
-            QString newUrl = QString("<img %1src=\"%2\"%3>").arg(reg.cap(1), getResourceRelativePath(targetFile), reg.cap(3));
-            p_html.replace(idx, reg.matchedLength(), newUrl);
-            pos = idx + newUrl.size();
-            altered = true;
+            return QString();
         }
-    }
 
-    return altered;
+        return QString("<img %1src=\"%2\"%3>").arg(p_match.captured(1),
+                                                    getResourceRelativePath(targetFile),
+                                                    p_match.captured(3));
+    });
 }
 
 bool WebViewExporter::doExportPdf(const ExportPdfOption &p_pdfOption, const QString &p_outputFile)
 {
-    ExportState state = ExportState::Busy;
+    auto state = QSharedPointer<ExportState>::create(ExportState::Busy);
 
-    m_viewer->page()->printToPdf([&, this](const QByteArray &p_result) {
+    m_viewer->page()->printToPdf([=](const QByteArray &p_result) {
         qDebug() << "doExportPdf printToPdf ready";
-        if (p_result.isEmpty() || m_askedToStop) {
-            state = ExportState::Failed;
+        if (*state != ExportState::Busy) {
+            // Timed out or stopped.
             return;
         }
 
-        Q_ASSERT(!p_outputFile.isEmpty());
-
-        FileUtils::writeFile(p_outputFile, p_result);
+        if (p_result.isEmpty() || m_askedToStop) {
+            *state = ExportState::Failed;
+        } else {
+            Q_ASSERT(!p_outputFile.isEmpty());
+            FileUtils::writeFile(p_outputFile, p_result);
+            *state = ExportState::Finished;
+        }
 
-        state = ExportState::Finished;
+        wakeUp();
     }, *p_pdfOption.m_layout);
 
-    while (state == ExportState::Busy) {
-        Utils::sleepWait(100);
+    waitFor([state]() {
+                return *state != ExportState::Busy;
+            },
+            c_outputTimeout);
 
-        if (m_askedToStop) {
-            break;
-        }
+    if (*state == ExportState::Busy) {
+        *state = ExportState::Failed;
     }
 
-    return state == ExportState::Finished;
+    return *state == ExportState::Finished;
 }
 
 bool WebViewExporter::doExportWkhtmltopdf(const ExportPdfOption &p_pdfOption, const QString &p_outputFile, const QUrl &p_baseUrl)
@@ -502,26 +676,27 @@ bool WebViewExporter::doExportWkhtmltopdf(const ExportPdfOption &p_pdfOption, co
         return false;
     }
 
-    ExportState state = ExportState::Busy;
+    auto state = QSharedPointer<ExportState>::create(ExportState::Busy);
 
     connect(m_viewer->adapter(), &MarkdownViewerAdapter::contentReady,
-            this, [&, this](const QString &p_headContent,
-                            const QString &p_styleContent,
-                            const QString &p_content,
-                            const QString &p_bodyClassList) {
+            this, [=](const QString &p_headContent,
+                      const QString &p_styleContent,
+                      const QString &p_content,
+                      const QString &p_bodyClassList) {
                 qDebug() << "doExportWkhtmltopdf contentReady";
                 // Maybe unnecessary. Just to avoid duplicated signal connections.
                 disconnect(m_viewer->adapter(), &MarkdownViewerAdapter::contentReady, this, 0);
 
+                *state = ExportState::Failed;
                 if (p_content.isEmpty() || m_askedToStop) {
-                    state = ExportState::Failed;
+                    wakeUp();
                     return;
                 }
 
                 // Save HTML to a temp dir.
                 QTemporaryDir tmpDir;
                 if (!tmpDir.isValid()) {
-                    state = ExportState::Failed;
+                    wakeUp();
                     return;
                 }
 
@@ -535,29 +710,28 @@ bool WebViewExporter::doExportWkhtmltopdf(const ExportPdfOption &p_pdfOption, co
                                    true,
                                    true,
                                    false)) {
-                    state = ExportState::Failed;
+                    wakeUp();
                     return;
                 }
 
                 // Convert HTML to PDF via wkhtmltopdf.
                 if (htmlToPdfViaWkhtmltopdf(p_pdfOption, QStringList() << tmpHtmlFile, p_outputFile)) {
-                    state = ExportState::Finished;
-                } else {
-                    state = ExportState::Failed;
+                    *state = ExportState::Finished;
                 }
+
+                wakeUp();
             });
 
     m_viewer->adapter()->saveContent();
 
-    while (state == ExportState::Busy) {
-        Utils::sleepWait(100);
+    waitFor([state]() {
+                return *state != ExportState::Busy;
+            },
+            c_outputTimeout);
 
-        if (m_askedToStop) {
-            break;
-        }
-    }
+    disconnect(m_viewer->adapter(), &MarkdownViewerAdapter::contentReady, this, 0);
 
-    return state == ExportState::Finished;
+    return *state == ExportState::Finished;
 }
 
 bool WebViewExporter::htmlToPdfViaWkhtmltopdf(const ExportPdfOption &p_pdfOption, const QStringList &p_htmlFiles, const QString &p_outputFile)
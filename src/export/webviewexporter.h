@@ -2,15 +2,22 @@
 #define WEBVIEWEXPORTER_H
 
 #include <QObject>
+#include <QUrl>
+#include <QSharedPointer>
+
+#include <functional>
 
 #include "exportdata.h"
 
 class QWidget;
+class QEventLoop;
 
 namespace vnotex
 {
     class File;
     class MarkdownViewer;
+    class ExportResourceCache;
+    class MarkdownHtmlRenderer;
 
     class WebViewExporter : public QObject
     {
@@ -34,8 +41,18 @@ namespace vnotex
                       const File *p_file,
                       const QString &p_outputFile);
 
+        // Start to load and render @p_file without waiting.
+        // Must be followed by finishExport(), so several exporters could render concurrently.
+        void load(const ExportOption &p_option, const File *p_file);
+
+        // Wait for the file loaded via load() to be rendered and export it to @p_outputFile.
+        bool finishExport(const ExportOption &p_option, const QString &p_outputFile);
+
         void prepare(const ExportOption &p_option);
 
+        // Share @p_cache with other exporters of the same export run.
+        void setResourceCache(const QSharedPointer<ExportResourceCache> &p_cache);
+
         // Release resources after one batch of export.
         void clear();
 
@@ -54,10 +71,22 @@ namespace vnotex
             Failed
         };
 
+        void setupViewer();
+
+        // Set up the native renderer if @p_option allows.
+        void setupNativeRenderer(const ExportOption &p_option, bool p_scrollable);
+
         bool isWebViewReady() const;
 
         bool isWebViewFailed() const;
 
+        // Process events until @p_done returns true, asked to stop or @p_timeout ms elapsed.
+        // Return whether @p_done returns true.
+        bool waitFor(const std::function<bool()> &p_done, int p_timeout);
+
+        // Called on state transitions to let waitFor() re-check the state.
+        void wakeUp();
+
         bool doExportHtml(const ExportHtmlOption &p_htmlOption,
                           const QString &p_outputFile,
                           const QUrl &p_baseUrl);
@@ -72,7 +101,9 @@ namespace vnotex
                            bool p_completePage,
                            bool p_embedImages);
 
-        bool embedStyleResources(QString &p_html) const;
+        bool doExportNativeHtml(const ExportHtmlOption &p_htmlOption, const QString &p_outputFile);
+
+        bool embedStyleResources(QString &p_html);
 
         bool embedBodyResources(const QUrl &p_baseUrl, QString &p_html);
 
@@ -92,8 +123,16 @@ namespace vnotex
 
         bool m_exportOngoing = false;
 
+        // File path and base url of the file being exported.
+        QString m_filePath;
+
+        QUrl m_baseUrl;
+
         WebViewStates m_webViewStates = WebViewState::Started;
 
+        // Event loop of ongoing waitFor().
+        QEventLoop *m_eventLoop = nullptr;
+
         // Managed by QObject.
         MarkdownViewer *m_viewer = nullptr;
 
@@ -102,6 +141,21 @@ namespace vnotex
         QString m_exportHtmlTemplate;
 
         QStringList m_wkhtmltopdfArgs;
+
+        QSharedPointer<ExportResourceCache> m_resourceCache;
+
+        // Null if rendering natively is disabled.
+        QSharedPointer<MarkdownHtmlRenderer> m_nativeRenderer;
+
+        // Content of the file rendered natively via load(), or empty if rendered by web view.
+        QString m_nativeContent;
+
+        // Style content and class lists the web side would output.
+        QString m_nativeStyleContent;
+
+        QString m_nativeContentClassList;
+
+        QString m_nativeBodyClassList;
     };
 }
 
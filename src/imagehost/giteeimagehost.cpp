@@ -101,57 +101,71 @@ static bool isEmptyResponse(const QByteArray &p_data)
     return p_data == QByteArray("[]");
 }
 
-QString GiteeImageHost::create(const QByteArray &p_data, const QString &p_path, QString &p_msg)
+void GiteeImageHost::doCreateAsync(const QByteArray &p_data, const QString &p_path, const CreateCallback &p_callback)
 {
-    QString destUrl;
+    CreateResult result;
 
     if (p_path.isEmpty()) {
-        p_msg = tr("Failed to create image with empty path.");
-        return destUrl;
+        result.m_msg = tr("Failed to create image with empty path.");
+        finishCreateLater(p_callback, result);
+        return;
     }
 
     if (!ready()) {
-        p_msg = tr("Invalid Gitee image host configuration.");
-        return QString();
+        result.m_msg = tr("Invalid Gitee image host configuration.");
+        finishCreateLater(p_callback, result);
+        return;
     }
 
-    auto rawHeader = prepareCommonHeaders();
+    const auto rawHeader = prepareCommonHeaders();
     const auto urlStr = QString("%1/repos/%2/%3/contents/%4").arg(c_apiUrl, m_userName, m_repoName, p_path);
 
     // Check if @p_path already exists.
-    auto reply = vte::NetworkAccess::request(QUrl(addAccessToken(m_personalAccessToken, urlStr)), rawHeader);
-    if (reply.m_error == QNetworkReply::NoError) {
-        if (!isEmptyResponse(reply.m_data)) {
-            p_msg = tr("The resource already exists at the image host (%1).").arg(p_path);
-            return QString();
+    sendRequest("GET", QUrl(addAccessToken(m_personalAccessToken, urlStr)), rawHeader, QByteArray(),
+                [this, rawHeader, urlStr, p_data, p_path, p_callback](QNetworkReply::NetworkError p_error, const QByteArray &p_replyData) {
+        CreateResult result;
+        if (p_error == QNetworkReply::NoError) {
+            if (!isEmptyResponse(p_replyData)) {
+                result.m_msg = tr("The resource already exists at the image host (%1).").arg(p_path);
+                p_callback(result);
+                return;
+            }
+        } else if (p_error != QNetworkReply::ContentNotFoundError) {
+            result.m_msg = tr("Failed to query the resource at the image host (%1) (%2) (%3).")
+                             .arg(urlStr, vte::NetworkUtils::networkErrorStr(p_error), p_replyData);
+            result.m_retryable = isRetryableError(p_error);
+            p_callback(result);
+            return;
         }
-    } else if (reply.m_error != QNetworkReply::ContentNotFoundError) {
-        p_msg = tr("Failed to query the resource at the image host (%1) (%2) (%3).").arg(urlStr, reply.errorStr(), reply.m_data);
-        return QString();
-    }
 
-    // Create the content.
-    QJsonObject requestDataObj;
-    requestDataObj[QStringLiteral("access_token")] = m_personalAccessToken;
-    requestDataObj[QStringLiteral("message")] = QString("VX_ADD: %1").arg(p_path);
-    requestDataObj[QStringLiteral("content")] = QString::fromUtf8(p_data.toBase64());
-    auto requestData = Utils::toJsonString(requestDataObj);
-    reply = vte::NetworkAccess::post(QUrl(urlStr), rawHeader, requestData);
-    if (reply.m_error != QNetworkReply::NoError) {
-        p_msg = tr("Failed to create resource at the image host (%1) (%2) (%3).").arg(urlStr, reply.errorStr(), reply.m_data);
-        return QString();
-    } else {
-        auto replyObj = Utils::fromJsonString(reply.m_data);
-        Q_ASSERT(!replyObj.isEmpty());
-        auto targetUrl = replyObj[QStringLiteral("content")].toObject().value(QStringLiteral("download_url")).toString();
-        if (targetUrl.isEmpty()) {
-            p_msg = tr("Failed to create resource at the image host (%1) (%2) (%3).").arg(urlStr, reply.errorStr(), reply.m_data);
-        } else {
-            targetUrl = PathUtils::encodeSpacesInPath(targetUrl);
-            qDebug() << "created resource" << targetUrl;
-        }
-        return targetUrl;
-    }
+        // Create the content.
+        QJsonObject requestDataObj;
+        requestDataObj[QStringLiteral("access_token")] = m_personalAccessToken;
+        requestDataObj[QStringLiteral("message")] = QString("VX_ADD: %1").arg(p_path);
+        requestDataObj[QStringLiteral("content")] = QString::fromUtf8(p_data.toBase64());
+        auto requestData = Utils::toJsonString(requestDataObj);
+        sendRequest("POST", QUrl(urlStr), rawHeader, requestData,
+                    [urlStr, p_callback](QNetworkReply::NetworkError p_error, const QByteArray &p_replyData) {
+            CreateResult result;
+            if (p_error != QNetworkReply::NoError) {
+                result.m_msg = tr("Failed to create resource at the image host (%1) (%2) (%3).")
+                                 .arg(urlStr, vte::NetworkUtils::networkErrorStr(p_error), p_replyData);
+                result.m_retryable = isRetryableError(p_error);
+            } else {
+                auto replyObj = Utils::fromJsonString(p_replyData);
+                Q_ASSERT(!replyObj.isEmpty());
+                result.m_url = replyObj[QStringLiteral("content")].toObject().value(QStringLiteral("download_url")).toString();
+                if (result.m_url.isEmpty()) {
+                    result.m_msg = tr("Failed to create resource at the image host (%1) (%2) (%3).")
+                                     .arg(urlStr, vte::NetworkUtils::networkErrorStr(p_error), p_replyData);
+                } else {
+                    result.m_url = PathUtils::encodeSpacesInPath(result.m_url);
+                    qDebug() << "created resource" << result.m_url;
+                }
+            }
+            p_callback(result);
+        });
+    });
 }
 
 bool GiteeImageHost::ownsUrl(const QString &p_url) const
@@ -23,12 +23,15 @@ namespace vnotex
 
         bool testConfig(const QJsonObject &p_jobj, QString &p_msg) Q_DECL_OVERRIDE;
 
-        QString create(const QByteArray &p_data, const QString &p_path, QString &p_msg) Q_DECL_OVERRIDE;
-
         bool remove(const QString &p_url, QString &p_msg) Q_DECL_OVERRIDE;
 
         bool ownsUrl(const QString &p_url) const Q_DECL_OVERRIDE;
 
+    protected:
+        void doCreateAsync(const QByteArray &p_data,
+                           const QString &p_path,
+                           const CreateCallback &p_callback) Q_DECL_OVERRIDE;
+
     private:
         // Used to test.
         vte::NetworkReply getRepoInfo(const QString &p_token, const QString &p_userName, const QString &p_repoName) const;
@@ -99,53 +99,67 @@ void GitHubImageHost::parseConfig(const QJsonObject &p_jobj,
     p_repoName = p_jobj[QStringLiteral("repository_name")].toString();
 }
 
-QString GitHubImageHost::create(const QByteArray &p_data, const QString &p_path, QString &p_msg)
+void GitHubImageHost::doCreateAsync(const QByteArray &p_data, const QString &p_path, const CreateCallback &p_callback)
 {
-    QString destUrl;
+    CreateResult result;
 
     if (p_path.isEmpty()) {
-        p_msg = tr("Failed to create image with empty path.");
-        return destUrl;
+        result.m_msg = tr("Failed to create image with empty path.");
+        finishCreateLater(p_callback, result);
+        return;
     }
 
     if (!ready()) {
-        p_msg = tr("Invalid GitHub image host configuration.");
-        return QString();
+        result.m_msg = tr("Invalid GitHub image host configuration.");
+        finishCreateLater(p_callback, result);
+        return;
     }
 
-    auto rawHeader = prepareCommonHeaders(m_personalAccessToken);
+    const auto rawHeader = prepareCommonHeaders(m_personalAccessToken);
     const auto urlStr = QString("%1/repos/%2/%3/contents/%4").arg(c_apiUrl, m_userName, m_repoName, p_path);
 
     // Check if @p_path already exists.
-    auto reply = vte::NetworkAccess::request(QUrl(urlStr), rawHeader);
-    if (reply.m_error == QNetworkReply::NoError) {
-        p_msg = tr("The resource already exists at the image host (%1).").arg(p_path);
-        return QString();
-    } else if (reply.m_error != QNetworkReply::ContentNotFoundError) {
-        p_msg = tr("Failed to query the resource at the image host (%1) (%2) (%3).").arg(urlStr, reply.errorStr(), reply.m_data);
-        return QString();
-    }
-
-    // Create the content.
-    QJsonObject requestDataObj;
-    requestDataObj[QStringLiteral("message")] = QString("VX_ADD: %1").arg(p_path);
-    requestDataObj[QStringLiteral("content")] = QString::fromUtf8(p_data.toBase64());
-    auto requestData = Utils::toJsonString(requestDataObj);
-    reply = vte::NetworkAccess::put(QUrl(urlStr), rawHeader, requestData);
-    if (reply.m_error != QNetworkReply::NoError) {
-        p_msg = tr("Failed to create resource at the image host (%1) (%2) (%3).").arg(urlStr, reply.errorStr(), reply.m_data);
-        return QString();
-    } else {
-        auto replyObj = Utils::fromJsonString(reply.m_data);
-        Q_ASSERT(!replyObj.isEmpty());
-        auto targetUrl = replyObj[QStringLiteral("content")].toObject().value(QStringLiteral("download_url")).toString();
-        if (targetUrl.isEmpty()) {
-            p_msg = tr("Failed to create resource at the image host (%1) (%2) (%3).").arg(urlStr, reply.errorStr(), reply.m_data);
-        } else {
-            qDebug() << "created resource" << targetUrl;
+    sendRequest("GET", QUrl(urlStr), rawHeader, QByteArray(),
+                [this, rawHeader, urlStr, p_data, p_path, p_callback](QNetworkReply::NetworkError p_error, const QByteArray &p_replyData) {
+        CreateResult result;
+        if (p_error == QNetworkReply::NoError) {
+            result.m_msg = tr("The resource already exists at the image host (%1).").arg(p_path);
+            p_callback(result);
+            return;
+        } else if (p_error != QNetworkReply::ContentNotFoundError) {
+            result.m_msg = tr("Failed to query the resource at the image host (%1) (%2) (%3).")
+                             .arg(urlStr, vte::NetworkUtils::networkErrorStr(p_error), p_replyData);
+            result.m_retryable = isRetryableError(p_error);
+            p_callback(result);
+            return;
         }
-        return targetUrl;
-    }
+
+        // Create the content.
+        QJsonObject requestDataObj;
+        requestDataObj[QStringLiteral("message")] = QString("VX_ADD: %1").arg(p_path);
+        requestDataObj[QStringLiteral("content")] = QString::fromUtf8(p_data.toBase64());
+        auto requestData = Utils::toJsonString(requestDataObj);
+        sendRequest("PUT", QUrl(urlStr), rawHeader, requestData,
+                    [urlStr, p_callback](QNetworkReply::NetworkError p_error, const QByteArray &p_replyData) {
+            CreateResult result;
+            if (p_error != QNetworkReply::NoError) {
+                result.m_msg = tr("Failed to create resource at the image host (%1) (%2) (%3).")
+                                 .arg(urlStr, vte::NetworkUtils::networkErrorStr(p_error), p_replyData);
+                result.m_retryable = isRetryableError(p_error);
+            } else {
+                auto replyObj = Utils::fromJsonString(p_replyData);
+                Q_ASSERT(!replyObj.isEmpty());
+                result.m_url = replyObj[QStringLiteral("content")].toObject().value(QStringLiteral("download_url")).toString();
+                if (result.m_url.isEmpty()) {
+                    result.m_msg = tr("Failed to create resource at the image host (%1) (%2) (%3).")
+                                     .arg(urlStr, vte::NetworkUtils::networkErrorStr(p_error), p_replyData);
+                } else {
+                    qDebug() << "created resource" << result.m_url;
+                }
+            }
+            p_callback(result);
+        });
+    });
 }
 
 bool GitHubImageHost::ownsUrl(const QString &p_url) const
@@ -23,8 +23,6 @@ namespace vnotex
 
         bool testConfig(const QJsonObject &p_jobj, QString &p_msg) Q_DECL_OVERRIDE;
 
-        QString create(const QByteArray &p_data, const QString &p_path, QString &p_msg) Q_DECL_OVERRIDE;
-
         bool remove(const QString &p_url, QString &p_msg) Q_DECL_OVERRIDE;
 
         bool ownsUrl(const QString &p_url) const Q_DECL_OVERRIDE;
@@ -32,6 +30,10 @@ namespace vnotex
         static QString fetchResourcePath(const QString &p_prefix, const QString &p_url);
 
     protected:
+        void doCreateAsync(const QByteArray &p_data,
+                           const QString &p_path,
+                           const CreateCallback &p_callback) Q_DECL_OVERRIDE;
+
         QString m_personalAccessToken;
 
         QString m_userName;
@@ -1,7 +1,15 @@
 #include "imagehost.h"
 
+#include <QEventLoop>
+#include <QNetworkAccessManager>
+#include <QTimer>
+#include <QDebug>
+
 using namespace vnotex;
 
+// Abort a request if nothing is sent or received in this period.
+static const int c_idleTimeout = 30 * 1000;
+
 ImageHost::ImageHost(QObject *p_parent)
     : QObject(p_parent)
 {
@@ -17,6 +25,125 @@ void ImageHost::setName(const QString &p_name)
     m_name = p_name;
 }
 
+QString ImageHost::create(const QByteArray &p_data, const QString &p_path, QString &p_msg)
+{
+    QEventLoop loop;
+    CreateResult result;
+    createAsync(p_data, p_path, &loop, [&loop, &result](const CreateResult &p_result) {
+        result = p_result;
+        loop.quit();
+    });
+    loop.exec();
+
+    p_msg = result.m_msg;
+    return result.m_url;
+}
+
+void ImageHost::createAsync(const QByteArray &p_data,
+                            const QString &p_path,
+                            const QObject *p_owner,
+                            const CreateCallback &p_callback)
+{
+    const auto oldOwner = m_requestOwner;
+    m_requestOwner = p_owner;
+    doCreateAsync(p_data, p_path, p_callback);
+    m_requestOwner = oldOwner;
+}
+
+void ImageHost::sendRequest(const QByteArray &p_verb,
+                            const QUrl &p_url,
+                            const vte::NetworkAccess::RawHeaderPairs &p_rawHeader,
+                            const QByteArray &p_data,
+                            const ReplyCallback &p_callback)
+{
+    if (!m_netMgr) {
+        m_netMgr = new QNetworkAccessManager(this);
+    }
+
+    auto request = vte::NetworkUtils::networkRequest(p_url);
+    if (!p_data.isEmpty()) {
+        request.setHeader(QNetworkRequest::ContentTypeHeader, QByteArray("application/json"));
+    }
+    for (const auto &header : p_rawHeader) {
+        request.setRawHeader(header.first, header.second);
+    }
+
+    auto reply = m_netMgr->sendCustomRequest(request, p_verb, p_data);
+    m_replies.insert(reply, m_requestOwner);
+
+    // Restart the timer on any progress so that large images are not aborted.
+    auto timer = new QTimer(reply);
+    timer->setSingleShot(true);
+    timer->setInterval(c_idleTimeout);
+    connect(timer, &QTimer::timeout,
+            this, [this, reply]() {
+                if (m_replies.contains(reply)) {
+                    m_timedOutReplies.insert(reply);
+                    reply->abort();
+                }
+            });
+    connect(reply, &QNetworkReply::uploadProgress,
+            timer, static_cast<void (QTimer::*)()>(&QTimer::start));
+    connect(reply, &QNetworkReply::downloadProgress,
+            timer, static_cast<void (QTimer::*)()>(&QTimer::start));
+    connect(reply, &QNetworkReply::finished,
+            this, [this, reply, p_callback]() {
+                const auto owner = m_replies.take(reply);
+
+                auto error = reply->error();
+                if (m_timedOutReplies.remove(reply)) {
+                    qWarning() << "timed out requesting image host" << reply->url();
+                    error = QNetworkReply::TimeoutError;
+                }
+
+                // Requests sent by the callback belong to the same owner.
+                const auto oldOwner = m_requestOwner;
+                m_requestOwner = owner;
+                p_callback(error, reply->readAll());
+                m_requestOwner = oldOwner;
+                reply->deleteLater();
+            });
+    timer->start();
+}
+
+void ImageHost::abortRequests(const QObject *p_owner)
+{
+    // Aborting will finish the reply synchronously.
+    const auto replies = m_replies.keys(p_owner);
+    for (auto reply : replies) {
+        reply->abort();
+    }
+}
+
+void ImageHost::finishCreateLater(const CreateCallback &p_callback, const CreateResult &p_result)
+{
+    QMetaObject::invokeMethod(this, [p_callback, p_result]() {
+                                  p_callback(p_result);
+                              },
+                              Qt::QueuedConnection);
+}
+
+bool ImageHost::isRetryableError(QNetworkReply::NetworkError p_error)
+{
+    switch (p_error) {
+    case QNetworkReply::ConnectionRefusedError:
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+    case QNetworkReply::ProxyTimeoutError:
+    // Concurrent commits to the same branch may conflict.
+    case QNetworkReply::ContentConflictError:
+    case QNetworkReply::InternalServerError:
+    case QNetworkReply::ServiceUnavailableError:
+    case QNetworkReply::UnknownServerError:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
 QString ImageHost::typeString(ImageHost::Type p_type)
 {
     switch (p_type) {
@@ -3,10 +3,18 @@
 
 #include <QObject>
 #include <QJsonObject>
+#include <QNetworkReply>
+#include <QHash>
+#include <QSet>
+
+#include <functional>
+
+#include <vtextedit/networkutils.h>
 
 #include <core/global.h>
 
 class QByteArray;
+class QNetworkAccessManager;
 
 namespace vnotex
 {
@@ -22,6 +30,19 @@ namespace vnotex
             MaxHost
         };
 
+        struct CreateResult
+        {
+            // Target Url string on success.
+            QString m_url;
+
+            QString m_msg;
+
+            // Whether it failed due to a transient error so that it could be retried.
+            bool m_retryable = false;
+        };
+
+        typedef std::function<void(const CreateResult &)> CreateCallback;
+
         virtual ~ImageHost() = default;
 
         const QString &getName() const;
@@ -38,10 +59,23 @@ namespace vnotex
         virtual bool testConfig(const QJsonObject &p_jobj, QString &p_msg) = 0;
 
         // Upload @p_data to the host at path @p_path. Return the target Url string on success.
-        virtual QString create(const QByteArray &p_data, const QString &p_path, QString &p_msg) = 0;
+        // Block until done via createAsync(), which will not hang since requests time out.
+        QString create(const QByteArray &p_data, const QString &p_path, QString &p_msg);
+
+        // Upload @p_data to the host at path @p_path without blocking.
+        // @p_callback will always be called later in the event loop, even on immediate failure.
+        // @p_owner: owner of the requests, which could be aborted via abortRequests(@p_owner).
+        void createAsync(const QByteArray &p_data,
+                         const QString &p_path,
+                         const QObject *p_owner,
+                         const CreateCallback &p_callback);
 
         virtual bool remove(const QString &p_url, QString &p_msg) = 0;
 
+        // Abort ongoing requests of @p_owner, whose callbacks will be called with
+        // QNetworkReply::OperationCanceledError. Requests of others sharing this host are kept.
+        void abortRequests(const QObject *p_owner);
+
         // Test if @p_url is owned by this image host.
         virtual bool ownsUrl(const QString &p_url) const = 0;
 
@@ -50,8 +84,39 @@ namespace vnotex
     protected:
         explicit ImageHost(QObject *p_parent = nullptr);
 
+        typedef std::function<void(QNetworkReply::NetworkError p_error, const QByteArray &p_data)> ReplyCallback;
+
+        virtual void doCreateAsync(const QByteArray &p_data,
+                                   const QString &p_path,
+                                   const CreateCallback &p_callback) = 0;
+
+        // Send request with method @p_verb asynchronously and call @p_callback with the reply.
+        // The request is aborted with QNetworkReply::TimeoutError if there is no progress for a while.
+        // It belongs to the owner of the createAsync() call or of the reply whose callback sends it.
+        void sendRequest(const QByteArray &p_verb,
+                         const QUrl &p_url,
+                         const vte::NetworkAccess::RawHeaderPairs &p_rawHeader,
+                         const QByteArray &p_data,
+                         const ReplyCallback &p_callback);
+
+        // Call @p_callback with @p_result later in the event loop.
+        void finishCreateLater(const CreateCallback &p_callback, const CreateResult &p_result);
+
+        static bool isRetryableError(QNetworkReply::NetworkError p_error);
+
         // Name to identify one image host. One type of image host may have multiple instances.
         QString m_name;
+
+    private:
+        QNetworkAccessManager *m_netMgr = nullptr;
+
+        // Ongoing reply -> owner.
+        QHash<QNetworkReply *, const QObject *> m_replies;
+
+        // Owner of requests sent now.
+        const QObject *m_requestOwner = nullptr;
+
+        QSet<QNetworkReply *> m_timedOutReplies;
     };
 }
 
@@ -5,12 +5,14 @@ HEADERS += \
     $$PWD/githubimagehost.h \
     $$PWD/imagehost.h \
     $$PWD/imagehostmgr.h \
-    $$PWD/imagehostutils.h
+    $$PWD/imagehostutils.h \
+    $$PWD/imageuploadqueue.h
 
 SOURCES += \
     $$PWD/giteeimagehost.cpp \
     $$PWD/githubimagehost.cpp \
     $$PWD/imagehost.cpp \
     $$PWD/imagehostmgr.cpp \
-    $$PWD/imagehostutils.cpp
+    $$PWD/imagehostutils.cpp \
+    $$PWD/imageuploadqueue.cpp
 
@@ -0,0 +1,154 @@
+#include "imageuploadqueue.h"
+
+#include <QTimer>
+#include <QPointer>
+#include <QDebug>
+
+#include <utils/fileutils.h>
+#include <core/exception.h>
+
+using namespace vnotex;
+
+static const int c_maxRetries = 3;
+
+// Delay before the first retry, doubled on each retry.
+static const int c_retryDelay = 1000;
+
+ImageUploadQueue::ImageUploadQueue(ImageHost *p_host, int p_concurrency, QObject *p_parent)
+    : QObject(p_parent),
+      m_host(p_host),
+      m_concurrency(qMax(p_concurrency, 1))
+{
+    Q_ASSERT(m_host);
+}
+
+void ImageUploadQueue::addImage(const QString &p_filePath, const QString &p_destPath)
+{
+    Q_ASSERT(!m_started);
+
+    Task task;
+    task.m_filePath = p_filePath;
+    task.m_destPath = p_destPath;
+    m_pendingTasks.push_back(m_tasks.size());
+    m_tasks.push_back(task);
+}
+
+int ImageUploadQueue::getImageCount() const
+{
+    return m_tasks.size();
+}
+
+void ImageUploadQueue::start()
+{
+    Q_ASSERT(!m_started);
+    m_started = true;
+    schedule();
+}
+
+void ImageUploadQueue::schedule()
+{
+    while (!m_pendingTasks.isEmpty() && m_runningCount < m_concurrency) {
+        ++m_runningCount;
+        upload(m_pendingTasks.takeFirst());
+    }
+
+    if (m_runningCount == 0 && m_pendingTasks.isEmpty()) {
+        if (!m_finished) {
+            m_finished = true;
+            emit finished();
+        }
+    }
+}
+
+void ImageUploadQueue::upload(int p_idx)
+{
+    const auto &task = m_tasks[p_idx];
+
+    QByteArray data;
+    try {
+        data = FileUtils::readFile(task.m_filePath);
+    } catch (Exception &p_e) {
+        emit imageFailed(task.m_filePath,
+                         task.m_destPath,
+                         tr("Failed to read local image file (%1) (%2).").arg(task.m_filePath, p_e.what()));
+        finishTask(p_idx);
+        return;
+    }
+
+    if (data.isEmpty()) {
+        qWarning() << "Skipped uploading empty image" << task.m_filePath;
+        finishTask(p_idx);
+        return;
+    }
+
+    qDebug() << "uploading image" << task.m_filePath << task.m_destPath << "retries" << task.m_retries;
+
+    QPointer<ImageUploadQueue> queue(this);
+    m_host->createAsync(data, task.m_destPath, this, [queue, p_idx](const ImageHost::CreateResult &p_result) {
+        if (queue) {
+            queue->handleResult(p_idx, p_result);
+        }
+    });
+}
+
+void ImageUploadQueue::handleResult(int p_idx, const ImageHost::CreateResult &p_result)
+{
+    auto &task = m_tasks[p_idx];
+    if (!p_result.m_url.isEmpty()) {
+        emit imageUploaded(task.m_filePath, p_result.m_url);
+        finishTask(p_idx);
+        return;
+    }
+
+    if (p_result.m_retryable && task.m_retries < c_maxRetries && !m_aborted) {
+        const int delay = c_retryDelay << task.m_retries;
+        ++task.m_retries;
+        qWarning() << "retry uploading image in" << delay << "ms" << task.m_filePath << p_result.m_msg;
+
+        // Keep the slot occupied while waiting to retry.
+        QTimer::singleShot(delay, this, [this, p_idx]() {
+            if (m_aborted) {
+                const auto &task = m_tasks[p_idx];
+                emit imageFailed(task.m_filePath, task.m_destPath, tr("Aborted."));
+                finishTask(p_idx);
+            } else {
+                upload(p_idx);
+            }
+        });
+        return;
+    }
+
+    emit imageFailed(task.m_filePath, task.m_destPath, p_result.m_msg);
+    finishTask(p_idx);
+}
+
+void ImageUploadQueue::finishTask(int p_idx)
+{
+    --m_runningCount;
+    ++m_doneCount;
+    emit progressUpdated(m_doneCount, m_tasks.size(), m_tasks[p_idx].m_filePath);
+
+    schedule();
+}
+
+void ImageUploadQueue::abort()
+{
+    if (m_aborted || m_finished) {
+        return;
+    }
+
+    m_aborted = true;
+    m_doneCount += m_pendingTasks.size();
+    m_pendingTasks.clear();
+
+    // Callbacks of ongoing uploads are called synchronously.
+    m_host->abortRequests(this);
+
+    // Finish now if nothing is ongoing.
+    schedule();
+}
+
+bool ImageUploadQueue::isFinished() const
+{
+    return m_finished;
+}
@@ -0,0 +1,85 @@
+#ifndef IMAGEUPLOADQUEUE_H
+#define IMAGEUPLOADQUEUE_H
+
+#include <QObject>
+#include <QVector>
+#include <QList>
+
+#include "imagehost.h"
+
+namespace vnotex
+{
+    // Upload local images to an image host asynchronously with bounded concurrency.
+    // Images are read right before being uploaded. Transient failures are retried with
+    // exponential backoff.
+    class ImageUploadQueue : public QObject
+    {
+        Q_OBJECT
+    public:
+        // @p_concurrency: max number of uploads at the same time.
+        ImageUploadQueue(ImageHost *p_host, int p_concurrency, QObject *p_parent = nullptr);
+
+        // Upload local image @p_filePath to @p_destPath at the host.
+        void addImage(const QString &p_filePath, const QString &p_destPath);
+
+        int getImageCount() const;
+
+        // finished() will be emitted when all images are done or aborted.
+        void start();
+
+        // Drop pending images and abort ongoing uploads, which will be reported as failed.
+        void abort();
+
+        bool isFinished() const;
+
+    signals:
+        void imageUploaded(const QString &p_filePath, const QString &p_url);
+
+        void imageFailed(const QString &p_filePath, const QString &p_destPath, const QString &p_msg);
+
+        void progressUpdated(int p_done, int p_total, const QString &p_filePath);
+
+        void finished();
+
+    private:
+        struct Task
+        {
+            QString m_filePath;
+
+            QString m_destPath;
+
+            int m_retries = 0;
+        };
+
+        void schedule();
+
+        void upload(int p_idx);
+
+        void handleResult(int p_idx, const ImageHost::CreateResult &p_result);
+
+        // Mark task @p_idx done and schedule the rest.
+        void finishTask(int p_idx);
+
+        ImageHost *m_host = nullptr;
+
+        int m_concurrency = 1;
+
+        QVector<Task> m_tasks;
+
+        // Indexes of tasks not started yet in order.
+        QList<int> m_pendingTasks;
+
+        // Number of tasks uploading or waiting to retry.
+        int m_runningCount = 0;
+
+        int m_doneCount = 0;
+
+        bool m_started = false;
+
+        bool m_aborted = false;
+
+        bool m_finished = false;
+    };
+}
+
+#endif // IMAGEUPLOADQUEUE_H
@@ -5,6 +5,8 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QHash>
+#include <QVector>
+#include <QPair>
 
 #include <notebookbackend/inotebookbackend.h>
 #include <notebook/node.h>
@@ -59,6 +61,39 @@ void ContentMediaUtils::copyMediaFiles(const File *p_file,
     }
 }
 
+// Rename @p_path if it exists case-insensitively in its directory or is already planned.
+// @p_children: cache of lower-cased names of directories, updated with the result.
+static QString renameIfExistsCaseInsensitive(const QString &p_path, QHash<QString, QSet<QString>> &p_children)
+{
+    QFileInfo fi(p_path);
+    const auto dirPath = fi.absolutePath();
+    auto it = p_children.find(dirPath);
+    if (it == p_children.end()) {
+        QSet<QString> children;
+        const auto names = QDir(dirPath).entryList(QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+        for (const auto &name : names) {
+            children.insert(name.toLower());
+        }
+        it = p_children.insert(dirPath, children);
+    }
+
+    const auto baseName = fi.completeBaseName();
+    const auto suffix = fi.suffix();
+    auto name = fi.fileName();
+    int idx = 1;
+    while (it->contains(name.toLower())) {
+        name = QString("%1_%2").arg(baseName, QString::number(idx));
+        if (!suffix.isEmpty()) {
+            name += QStringLiteral(".") + suffix;
+        }
+
+        ++idx;
+    }
+
+    it->insert(name.toLower());
+    return PathUtils::concatenateFilePath(dirPath, name);
+}
+
 void ContentMediaUtils::copyMarkdownMediaFiles(const QString &p_content,
                                                const QString &p_basePath,
                                                INotebookBackend *p_backend,
@@ -75,6 +110,9 @@ void ContentMediaUtils::copyMarkdownMediaFiles(const QString &p_content,
     QDir destDir(PathUtils::parentDirPath(p_destFilePath));
     QSet<QString> handledImages;
     QHash<QString, QString> renamedImages;
+    // Copies are planned first and done in batch.
+    QVector<QPair<QString, QString>> copies;
+    QHash<QString, QSet<QString>> dirChildren;
     int lastPos = content.size();
     for (const auto &link : images) {
         Q_ASSERT(link.m_urlInLinkPos < lastPos);
@@ -100,9 +138,9 @@ void ContentMediaUtils::copyMarkdownMediaFiles(const QString &p_content,
         // Get the relative path of the image and apply it to the dest file path.
         const auto decodedUrlInLink = vte::TextUtils::decodeUrl(link.m_urlInLink);
         const auto oldDestFilePath = destDir.filePath(decodedUrlInLink);
-        destDir.mkpath(PathUtils::parentDirPath(oldDestFilePath));
-        auto destFilePath = p_backend ? p_backend->renameIfExistsCaseInsensitive(oldDestFilePath)
-                                      : FileUtils::renameIfExistsCaseInsensitive(oldDestFilePath);
+        const auto destFilePath =
+            renameIfExistsCaseInsensitive(p_backend ? p_backend->getFullPath(oldDestFilePath) : oldDestFilePath,
+                                          dirChildren);
         if (oldDestFilePath != destFilePath) {
             // Rename happens.
             const auto oldFileName = PathUtils::fileName(oldDestFilePath);
@@ -121,11 +159,13 @@ void ContentMediaUtils::copyMarkdownMediaFiles(const QString &p_content,
             renamedImages.insert(link.m_path, newUrlInLink);
         }
 
-        if (p_backend) {
-            p_backend->copyFile(link.m_path, destFilePath);
-        } else {
-            FileUtils::copyFile(link.m_path, destFilePath);
-        }
+        copies.push_back(qMakePair(link.m_path, destFilePath));
+    }
+
+    if (p_backend) {
+        p_backend->copyFiles(copies);
+    } else {
+        FileUtils::copyFiles(copies);
     }
 
     if (!renamedImages.isEmpty()) {
@@ -5,6 +5,28 @@
 #include <QDateTime>
 #include <QTemporaryFile>
 #include <QJsonDocument>
+#include <QSet>
+#include <QThread>
+#include <QEventLoop>
+#include <QCoreApplication>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QCryptographicHash>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <linux/fs.h>
+#endif
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#elif defined(Q_OS_UNIX)
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
 
 #include <core/exception.h>
 #include <core/global.h>
@@ -13,6 +35,9 @@
 
 using namespace vnotex;
 
+// Limit of threads to copy files concurrently.
+static const int c_maxCopyThreads = 8;
+
 QByteArray FileUtils::readFile(const QString &p_filePath)
 {
     QFile file(p_filePath);
@@ -107,6 +132,65 @@ bool FileUtils::existsCaseInsensitive(const QString &p_path)
     return childExistsCaseInsensitive(PathUtils::parentDirPath(p_path), PathUtils::fileName(p_path));
 }
 
+// Copy @p_filePath to new file @p_destPath without passing the data through user space.
+// The data is shared via reflink on copy-on-write file systems.
+// Return false with nothing left at @p_destPath if it is not supported.
+static bool copyFileInKernel(const QString &p_filePath, const QString &p_destPath)
+{
+#ifdef Q_OS_LINUX
+    const int srcFd = ::open(QFile::encodeName(p_filePath).constData(), O_RDONLY | O_CLOEXEC);
+    if (srcFd == -1) {
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(srcFd, &st) == -1 || !S_ISREG(st.st_mode)) {
+        ::close(srcFd);
+        return false;
+    }
+
+    const auto destName = QFile::encodeName(p_destPath);
+    const int destFd = ::open(destName.constData(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, st.st_mode & 0777);
+    if (destFd == -1) {
+        ::close(srcFd);
+        return false;
+    }
+
+    bool done = false;
+#ifdef FICLONE
+    done = ::ioctl(destFd, FICLONE, srcFd) == 0;
+#endif
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+    if (!done) {
+        off_t remaining = st.st_size;
+        while (remaining > 0) {
+            const auto copied = ::copy_file_range(srcFd, nullptr, destFd, nullptr, static_cast<size_t>(remaining), 0);
+            if (copied <= 0) {
+                break;
+            }
+            remaining -= copied;
+        }
+        done = remaining == 0;
+    }
+#endif
+
+    ::close(srcFd);
+    if (::close(destFd) == -1) {
+        done = false;
+    }
+
+    if (!done) {
+        ::unlink(destName.constData());
+    }
+    return done;
+#else
+    Q_UNUSED(p_filePath);
+    Q_UNUSED(p_destPath);
+    return false;
+#endif
+}
+
 void FileUtils::copyFile(const QString &p_filePath,
                          const QString &p_destPath,
                          bool p_move)
@@ -128,7 +212,7 @@ void FileUtils::copyFile(const QString &p_filePath,
             failed = true;
         }
     } else {
-        if (!QFile::copy(p_filePath, p_destPath)) {
+        if (!copyFileInKernel(p_filePath, p_destPath) && !QFile::copy(p_filePath, p_destPath)) {
             failed = true;
         }
     }
@@ -139,6 +223,34 @@ void FileUtils::copyFile(const QString &p_filePath,
     }
 }
 
+// Create the directory structure of @p_dirPath as @p_destPath and add files to copy to @p_files.
+static void planDirCopy(const QString &p_dirPath,
+                        const QString &p_destPath,
+                        QVector<QPair<QString, QString>> &p_files)
+{
+    QDir destDir(p_destPath);
+    if (!destDir.mkpath(p_destPath)) {
+        Exception::throwOne(Exception::Type::FailToCreateDir,
+            QString("failed to create directory: %1").arg(p_destPath));
+    }
+
+    QDir srcDir(p_dirPath);
+    auto nodes = srcDir.entryInfoList(QDir::Dirs
+                                      | QDir::Files
+                                      | QDir::Hidden
+                                      | QDir::NoSymLinks
+                                      | QDir::NoDotAndDotDot);
+    for (const auto &node : nodes) {
+        auto name = node.fileName();
+        if (node.isDir()) {
+            planDirCopy(srcDir.filePath(name), destDir.filePath(name), p_files);
+        } else {
+            Q_ASSERT(node.isFile());
+            p_files.push_back(qMakePair(srcDir.filePath(name), destDir.filePath(name)));
+        }
+    }
+}
+
 void FileUtils::copyDir(const QString &p_dirPath,
                         const QString &p_destPath,
                         bool p_move)
@@ -154,6 +266,14 @@ void FileUtils::copyDir(const QString &p_dirPath,
 
     // QDir.rename() could not move directory across dirves.
 
+    if (!p_move) {
+        // Plan all the copies first to copy them concurrently.
+        QVector<QPair<QString, QString>> files;
+        planDirCopy(p_dirPath, p_destPath, files);
+        copyFiles(files);
+        return;
+    }
+
     // Create target directory.
     QDir destDir(p_destPath);
     if (!destDir.mkpath(p_destPath)) {
@@ -186,6 +306,143 @@ void FileUtils::copyDir(const QString &p_dirPath,
     }
 }
 
+void FileUtils::copyFiles(const QVector<QPair<QString, QString>> &p_files)
+{
+    if (p_files.isEmpty()) {
+        return;
+    }
+
+    // Create target directories up front instead of racing on them.
+    QSet<QString> dirPaths;
+    for (const auto &file : p_files) {
+        dirPaths.insert(PathUtils::parentDirPath(file.second));
+    }
+
+    QDir dir;
+    for (const auto &dirPath : dirPaths) {
+        if (!dir.mkpath(dirPath)) {
+            Exception::throwOne(Exception::Type::FailToCreateDir,
+                                QString("failed to create directory: %1").arg(dirPath));
+        }
+    }
+
+    QAtomicInt nextIdx(0);
+    QMutex errorsMutex;
+    QStringList errors;
+    const auto copyFunc = [&p_files, &nextIdx, &errorsMutex, &errors]() {
+        while (true) {
+            const int idx = nextIdx.fetchAndAddRelaxed(1);
+            if (idx >= p_files.size()) {
+                break;
+            }
+
+            try {
+                copyFile(p_files[idx].first, p_files[idx].second);
+            } catch (Exception &p_e) {
+                QMutexLocker locker(&errorsMutex);
+                errors << QString::fromStdString(p_e.what());
+            }
+        }
+    };
+
+    // The GUI thread keeps processing events instead of copying.
+    const auto app = QCoreApplication::instance();
+    const bool isGuiThread = app && QThread::currentThread() == app->thread();
+
+    // Copying is mostly bound by IO, so the number of threads does not depend on cores.
+    const int numOfThreads = qMin(p_files.size(), c_maxCopyThreads);
+    QVector<QThread *> threads;
+    for (int i = isGuiThread ? 0 : 1; i < numOfThreads; ++i) {
+        threads.push_back(QThread::create(copyFunc));
+    }
+
+    if (isGuiThread) {
+        QEventLoop loop;
+        for (auto thread : threads) {
+            QObject::connect(thread, &QThread::finished,
+                             &loop, [&loop, &threads]() {
+                                 for (auto th : threads) {
+                                     if (!th->isFinished()) {
+                                         return;
+                                     }
+                                 }
+                                 loop.quit();
+                             });
+            thread->start();
+        }
+
+        // Exclude user input to avoid re-entering the caller.
+        loop.exec(QEventLoop::ExcludeUserInputEvents);
+    } else {
+        for (auto thread : threads) {
+            thread->start();
+        }
+
+        // The current thread works too.
+        copyFunc();
+    }
+
+    for (auto thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+
+    if (!errors.isEmpty()) {
+        Exception::throwOne(Exception::Type::FailToCopyFile,
+                            QString("failed to copy %1 of %2 files: %3").arg(QString::number(errors.size()),
+                                                                             QString::number(p_files.size()),
+                                                                             errors.join(QLatin1Char('\n'))));
+    }
+}
+
+bool FileUtils::linkFile(const QString &p_filePath, const QString &p_destPath)
+{
+    if (QFileInfo::exists(p_destPath)) {
+        return false;
+    }
+
+#if defined(Q_OS_WIN)
+    const auto src = QDir::toNativeSeparators(p_filePath);
+    const auto dest = QDir::toNativeSeparators(p_destPath);
+    return ::CreateHardLinkW(reinterpret_cast<const wchar_t *>(dest.utf16()),
+                             reinterpret_cast<const wchar_t *>(src.utf16()),
+                             nullptr) != 0;
+#elif defined(Q_OS_UNIX)
+    return ::link(QFile::encodeName(p_filePath).constData(), QFile::encodeName(p_destPath).constData()) == 0;
+#else
+    Q_UNUSED(p_filePath);
+    Q_UNUSED(p_destPath);
+    return false;
+#endif
+}
+
+bool FileUtils::isSameFile(const QString &p_filePath, const QString &p_otherFilePath)
+{
+#if defined(Q_OS_UNIX)
+    struct stat st;
+    struct stat otherSt;
+    if (::stat(QFile::encodeName(p_filePath).constData(), &st) == -1
+        || ::stat(QFile::encodeName(p_otherFilePath).constData(), &otherSt) == -1) {
+        return false;
+    }
+    return st.st_dev == otherSt.st_dev && st.st_ino == otherSt.st_ino;
+#else
+    return PathUtils::areSamePaths(p_filePath, p_otherFilePath);
+#endif
+}
+
+QString FileUtils::calculateFileHash(const QString &p_filePath)
+{
+    QFile file(p_filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&file);
+    return QString::fromLatin1(hash.result().toHex());
+}
+
 QString FileUtils::renameIfExistsCaseInsensitive(const QString &p_path)
 {
     QFileInfo fi(p_path);
@@ -7,6 +7,8 @@
 #include <QPixmap>
 #include <QJsonObject>
 #include <QDir>
+#include <QVector>
+#include <QPair>
 
 class QTemporaryFile;
 
@@ -44,6 +46,22 @@ namespace vnotex
                             const QString &p_destPath,
                             bool p_move = false);
 
+        // Copy @p_files, pairs of source and target file path, concurrently.
+        // Throw after all the copies are done if any of them failed.
+        // On the GUI thread, events except user input are processed until the copies are done.
+        static void copyFiles(const QVector<QPair<QString, QString>> &p_files);
+
+        // Create @p_destPath as a hard link to existing file @p_filePath.
+        // Return false with nothing created if it is not supported, such as across file systems.
+        static bool linkFile(const QString &p_filePath, const QString &p_destPath);
+
+        // Whether @p_filePath and @p_otherFilePath are hard links to the same file.
+        // Return false if it could not be told.
+        static bool isSameFile(const QString &p_filePath, const QString &p_otherFilePath);
+
+        // Return SHA1 of the content of @p_filePath in hex, or empty if failed to read.
+        static QString calculateFileHash(const QString &p_filePath);
+
         static void removeFile(const QString &p_filePath);
 
         // Return false if it is not deleted due to non-empty.
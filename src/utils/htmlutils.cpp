@@ -1,6 +1,8 @@
 #include "htmlutils.h"
 
 #include <QRegExp>
+#include <QRegularExpression>
+#include <QVector>
 
 using namespace vnotex;
 
@@ -30,3 +32,47 @@ QString HtmlUtils::unicodeEncode(const QString &p_text)
 
     return encodedStr;
 }
+
+bool HtmlUtils::replaceAll(QString &p_html,
+                           const QRegularExpression &p_reg,
+                           const std::function<QString(const QRegularExpressionMatch &)> &p_func)
+{
+    struct Replacement
+    {
+        int m_start;
+        int m_end;
+        QString m_text;
+    };
+
+    QVector<Replacement> replacements;
+    int newSize = p_html.size();
+    auto it = p_reg.globalMatch(p_html);
+    while (it.hasNext()) {
+        const auto match = it.next();
+        auto text = p_func(match);
+        if (text.isNull()) {
+            continue;
+        }
+
+        newSize += text.size() - match.capturedLength();
+        replacements.push_back(Replacement{match.capturedStart(), match.capturedEnd(), text});
+    }
+
+    if (replacements.isEmpty()) {
+        return false;
+    }
+
+    // Build the result in a pre-sized buffer instead of replacing in place.
+    QString result;
+    result.reserve(newSize);
+    int pos = 0;
+    for (const auto &rep : replacements) {
+        result.append(p_html.midRef(pos, rep.m_start - pos));
+        result.append(rep.m_text);
+        pos = rep.m_end;
+    }
+    result.append(p_html.midRef(pos));
+
+    p_html = result;
+    return true;
+}
@@ -3,6 +3,11 @@
 
 #include <QString>
 
+#include <functional>
+
+class QRegularExpression;
+class QRegularExpressionMatch;
+
 namespace vnotex
 {
     class HtmlUtils
@@ -15,6 +20,13 @@ namespace vnotex
         static QString escapeHtml(QString p_text);
 
         static QString unicodeEncode(const QString &p_text);
+
+        // Replace all the matches of @p_reg in @p_html in one pass.
+        // @p_func: return the replacement of the match, or a null string to keep it.
+        // Return true if @p_html is altered.
+        static bool replaceAll(QString &p_html,
+                               const QRegularExpression &p_reg,
+                               const std::function<QString(const QRegularExpressionMatch &)> &p_func);
     };
 }
 
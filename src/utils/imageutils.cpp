@@ -1,6 +1,12 @@
 #include "imageutils.h"
 
 #include <QMimeDatabase>
+#include <QBuffer>
+#include <QImageWriter>
+#include <QPainter>
+#include <QDebug>
+
+#include <core/imagetranscodeoption.h>
 
 using namespace vnotex;
 
@@ -16,3 +22,91 @@ QString ImageUtils::guessImageSuffix(const QByteArray &p_data)
     auto mimeType = mimeDb.mimeTypeForData(p_data);
     return mimeType.preferredSuffix();
 }
+
+bool ImageUtils::isOpaque(const QImage &p_image)
+{
+    if (!p_image.hasAlphaChannel()) {
+        return true;
+    }
+
+    const auto image = p_image.convertToFormat(QImage::Format_ARGB32);
+    for (int y = 0; y < image.height(); ++y) {
+        const auto line = reinterpret_cast<const QRgb *>(image.constScanLine(y));
+        for (int x = 0; x < image.width(); ++x) {
+            if (qAlpha(line[x]) != 255) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool ImageUtils::transcodeImage(const QImage &p_image,
+                                const ImageTranscodeOption &p_option,
+                                QByteArray &p_data,
+                                QString &p_suffix)
+{
+    QImage image(p_image);
+    QByteArray format("png");
+    int quality = -1;
+    bool recompress = false;
+
+    if (p_option.m_enabled) {
+        const int maxWidth = p_option.m_maxWidth > 0 ? p_option.m_maxWidth : image.width();
+        const int maxHeight = p_option.m_maxHeight > 0 ? p_option.m_maxHeight : image.height();
+        if (image.width() > maxWidth || image.height() > maxHeight) {
+            image = image.scaled(maxWidth, maxHeight, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        }
+
+        if (!p_option.m_format.isEmpty()) {
+            const auto targetFormat = p_option.m_format.toLower().toLatin1();
+            if (QImageWriter::supportedImageFormats().contains(targetFormat)) {
+                format = targetFormat;
+            } else {
+                qWarning() << "unsupported image format to transcode to, fall back to PNG" << targetFormat;
+            }
+        }
+
+        quality = p_option.m_quality;
+        recompress = p_option.m_losslessRecompress;
+    }
+
+    const bool isPng = format == "png";
+    if (format == "jpg" || format == "jpeg") {
+        // No alpha channel in JPEG. Blend on white instead of black.
+        if (image.hasAlphaChannel()) {
+            QImage opaqueImage(image.size(), QImage::Format_RGB32);
+            opaqueImage.fill(Qt::white);
+            QPainter painter(&opaqueImage);
+            painter.drawImage(0, 0, image);
+            painter.end();
+            image = opaqueImage;
+        }
+    } else if (isPng && recompress) {
+        // PNG of RGB32 is written without alpha channel.
+        if (image.hasAlphaChannel() && isOpaque(image)) {
+            image = image.convertToFormat(QImage::Format_RGB32);
+        }
+
+        // Quality of PNG is mapped to the compression level and 0 is the highest.
+        quality = 0;
+    }
+
+    p_data.clear();
+    QBuffer buffer(&p_data);
+    buffer.open(QIODevice::WriteOnly);
+    QImageWriter writer(&buffer, format);
+    if (quality >= 0) {
+        writer.setQuality(qMin(quality, 100));
+    }
+
+    if (!writer.write(image)) {
+        qWarning() << "failed to encode image" << format << writer.errorString();
+        p_data.clear();
+        return false;
+    }
+
+    p_suffix = format == "jpeg" ? QStringLiteral("jpg") : QString::fromLatin1(format);
+    return true;
+}
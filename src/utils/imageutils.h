@@ -5,6 +5,8 @@
 
 namespace vnotex
 {
+    struct ImageTranscodeOption;
+
     class ImageUtils
     {
     public:
@@ -13,6 +15,17 @@ namespace vnotex
         static QImage::Format guessImageFormat(const QByteArray &p_data);
 
         static QString guessImageSuffix(const QByteArray &p_data);
+
+        // Encode @p_image into @p_data according to @p_option. Could be called in any thread.
+        // @p_suffix: suffix of the encoded format.
+        // Return false if failed.
+        static bool transcodeImage(const QImage &p_image,
+                                   const ImageTranscodeOption &p_option,
+                                   QByteArray &p_data,
+                                   QString &p_suffix);
+
+        // Whether all pixels of @p_image are opaque.
+        static bool isOpaque(const QImage &p_image);
     };
 }
 
@@ -112,6 +112,28 @@ QPixmap Utils::svgToPixmap(const QByteArray &p_content,
     return pm;
 }
 
+QImage Utils::svgToImage(const QByteArray &p_content,
+                         QRgb p_background,
+                         qreal p_scaleFactor)
+{
+    QSvgRenderer renderer(p_content);
+    QSize deSz = renderer.defaultSize();
+    if (p_scaleFactor > 0) {
+        deSz *= p_scaleFactor;
+    }
+
+    QImage img(deSz, QImage::Format_ARGB32_Premultiplied);
+    if (p_background == 0x0) {
+        img.fill(Qt::transparent);
+    } else {
+        img.fill(p_background);
+    }
+
+    QPainter painter(&img);
+    renderer.render(&painter);
+    return img;
+}
+
 bool Utils::fuzzyEqual(qreal p_a, qreal p_b)
 {
     return std::abs(p_a - p_b) < std::pow(10, -6);
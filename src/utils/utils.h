@@ -5,6 +5,7 @@
 #include <QDateTime>
 #include <QCoreApplication>
 #include <QPixmap>
+#include <QImage>
 
 #if !defined(V_ASSERT)
     #define V_ASSERT(cond) ((!(cond)) ? qt_assert(#cond, __FILE__, __LINE__) : qt_noop())
@@ -48,6 +49,11 @@ namespace vnotex
                                    QRgb p_background,
                                    qreal p_scaleFactor);
 
+        // Thread-safe version of svgToPixmap().
+        static QImage svgToImage(const QByteArray &p_content,
+                                 QRgb p_background,
+                                 qreal p_scaleFactor);
+
         static bool fuzzyEqual(qreal p_a, qreal p_b);
 
         static QString boolToString(bool p_val);
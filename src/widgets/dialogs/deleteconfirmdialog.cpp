@@ -8,13 +8,18 @@
 #include <QCheckBox>
 #include <QUrl>
 #include <QScrollArea>
+#include <QFileInfo>
 
 #include "global.h"
 #include <utils/widgetutils.h>
+#include <widgets/editors/imagepreviewservice.h>
 #include "selectionitemwidget.h"
 
 using namespace vnotex;
 
+// Images are downscaled to fit in this size for preview.
+static const QSize c_previewSize(512, 512);
+
 DeleteConfirmDialog::DeleteConfirmDialog(const QString &p_title,
                                          const QString &p_text,
                                          const QString &p_info,
@@ -110,6 +115,9 @@ void DeleteConfirmDialog::setupUI(const QString &p_title,
             m_previewArea->setMinimumSize(256, 256);
 
             listLayout->addWidget(m_previewArea);
+
+            connect(&ImagePreviewService::getInst(), &ImagePreviewService::imageReady,
+                    this, &DeleteConfirmDialog::handlePreviewImageReady);
         }
 
         mainLayout->addLayout(listLayout);
@@ -167,28 +175,57 @@ bool DeleteConfirmDialog::isNoAskChecked() const
 void DeleteConfirmDialog::currentFileChanged(int p_row)
 {
     if (m_previewer) {
-        bool succeed = false;
+        m_previewPath.clear();
         if (p_row > -1) {
             SelectionItemWidget *widget = getItemWidget(m_listWidget->item(p_row));
             if (widget) {
                 int idx = widget->getData().toInt();
                 Q_ASSERT(idx < m_items.size());
-                QPixmap image(m_items[idx].m_path);
-                if (!image.isNull()) {
-                    m_previewer->setPixmap(image);
-                    m_previewer->adjustSize();
-                    succeed = true;
+                if (QFileInfo(m_items[idx].m_path).isFile()) {
+                    m_previewPath = m_items[idx].m_path;
                 }
             }
         }
 
-        m_previewArea->setVisible(succeed);
-        if (succeed) {
-            resizeToHideScrollBarLater(true, true);
+        if (m_previewPath.isEmpty()) {
+            m_previewArea->setVisible(false);
+            return;
+        }
+
+        const auto image = ImagePreviewService::getInst().request(m_previewPath, c_previewSize);
+        if (image.isNull()) {
+            // Show a placeholder until the image is decoded.
+            m_previewer->setText(tr("Loading..."));
+            m_previewer->adjustSize();
+        } else {
+            setPreviewImage(image);
         }
     }
 }
 
+void DeleteConfirmDialog::handlePreviewImageReady(const QString &p_filePath, const QSize &p_size, const QImage &p_image)
+{
+    if (p_size != c_previewSize || p_filePath != m_previewPath) {
+        return;
+    }
+
+    setPreviewImage(p_image);
+}
+
+void DeleteConfirmDialog::setPreviewImage(const QImage &p_image)
+{
+    bool succeed = !p_image.isNull();
+    if (succeed) {
+        m_previewer->setPixmap(QPixmap::fromImage(p_image));
+        m_previewer->adjustSize();
+    }
+
+    m_previewArea->setVisible(succeed);
+    if (succeed) {
+        resizeToHideScrollBarLater(true, true);
+    }
+}
+
 SelectionItemWidget *DeleteConfirmDialog::getItemWidget(QListWidgetItem *p_item) const
 {
     QWidget *wid = m_listWidget->itemWidget(p_item);
@@ -4,6 +4,7 @@
 #include "scrolldialog.h"
 
 #include <QIcon>
+#include <QImage>
 
 class QLabel;
 class QListWidget;
@@ -80,6 +81,8 @@ namespace vnotex
     private slots:
         void currentFileChanged(int p_row);
 
+        void handlePreviewImageReady(const QString &p_filePath, const QSize &p_size, const QImage &p_image);
+
         void updateCountLabel();
 
     private:
@@ -93,6 +96,9 @@ namespace vnotex
 
         SelectionItemWidget *getItemWidget(QListWidgetItem *p_item) const;
 
+        // Hide the preview if @p_image is null.
+        void setPreviewImage(const QImage &p_image);
+
         QVector<ConfirmItemInfo> m_items;
 
         QLabel *m_countLabel = nullptr;
@@ -102,6 +108,9 @@ namespace vnotex
 
         QScrollArea *m_previewArea = nullptr;
 
+        // File being previewed.
+        QString m_previewPath;
+
         QCheckBox *m_noAskCB = nullptr;
     };
 
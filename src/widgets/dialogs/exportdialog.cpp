@@ -143,6 +143,8 @@ QGroupBox *ExportDialog::setupTargetGroup(QWidget *p_parent)
                                         static_cast<int>(ExportFormat::PDF));
         m_targetFormatComboBox->addItem(tr("Custom"),
                                         static_cast<int>(ExportFormat::Custom));
+        m_targetFormatComboBox->addItem(tr("Archive (ZIP)"),
+                                        static_cast<int>(ExportFormat::Archive));
         connect(m_targetFormatComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
                 this, [this]() {
                     AdvancedSettings settings = AdvancedSettings::Max;
@@ -243,6 +245,12 @@ QWidget *ExportDialog::setupGeneralAdvancedSettings(QWidget *p_parent)
         layout->addRow(m_exportAttachmentsCheckBox);
     }
 
+    {
+        m_incrementalCheckBox = WidgetsFactory::createCheckBox(tr("Skip unchanged notes"), widget);
+        m_incrementalCheckBox->setToolTip(tr("Skip notes unchanged since last export to the same output folder"));
+        layout->addRow(m_incrementalCheckBox);
+    }
+
     return widget;
 }
 
@@ -343,6 +351,8 @@ void ExportDialog::restoreFields(const ExportOption &p_option)
     m_recursiveCheckBox->setChecked(p_option.m_recursive);
 
     m_exportAttachmentsCheckBox->setChecked(p_option.m_exportAttachments);
+
+    m_incrementalCheckBox->setChecked(p_option.m_incremental);
 }
 
 void ExportDialog::saveFields(ExportOption &p_option)
@@ -355,6 +365,7 @@ void ExportDialog::saveFields(ExportOption &p_option)
     p_option.m_outputDir = getOutputDir();
     p_option.m_recursive = m_recursiveCheckBox->isChecked();
     p_option.m_exportAttachments = m_exportAttachmentsCheckBox->isChecked();
+    p_option.m_incremental = m_incrementalCheckBox->isChecked();
 
     if (m_advancedSettings[AdvancedSettings::HTML]) {
         saveFields(p_option.m_htmlOption);
@@ -562,6 +573,14 @@ QWidget *ExportDialog::getHtmlAdvancedSettings()
             layout->addRow(m_addOutlinePanelCheckBox);
         }
 
+        {
+            m_useNativeRendererCheckBox = WidgetsFactory::createCheckBox(tr("Render without web engine if possible"), widget);
+            m_useNativeRendererCheckBox->setToolTip(tr("Render notes without diagrams, math or other script-only features "
+                                                       "much faster without web engine. "
+                                                       "Code blocks are not syntax highlighted in this way."));
+            layout->addRow(m_useNativeRendererCheckBox);
+        }
+
         m_advancedGroupBox->layout()->addWidget(widget);
 
         m_advancedSettings[AdvancedSettings::HTML] = widget;
@@ -610,6 +629,7 @@ void ExportDialog::restoreFields(const ExportHtmlOption &p_option)
     m_completePageCheckBox->setChecked(p_option.m_completePage);
     m_useMimeHtmlFormatCheckBox->setChecked(p_option.m_useMimeHtmlFormat);
     m_addOutlinePanelCheckBox->setChecked(p_option.m_addOutlinePanel);
+    m_useNativeRendererCheckBox->setChecked(p_option.m_useNativeRenderer);
 }
 
 void ExportDialog::saveFields(ExportHtmlOption &p_option)
@@ -619,6 +639,7 @@ void ExportDialog::saveFields(ExportHtmlOption &p_option)
     p_option.m_completePage = m_completePageCheckBox->isChecked();
     p_option.m_useMimeHtmlFormat = m_useMimeHtmlFormatCheckBox->isChecked();
     p_option.m_addOutlinePanel = m_addOutlinePanelCheckBox->isChecked();
+    p_option.m_useNativeRenderer = m_useNativeRendererCheckBox->isChecked();
 }
 
 QWidget *ExportDialog::getPdfAdvancedSettings()
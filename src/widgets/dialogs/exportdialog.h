@@ -159,6 +159,8 @@ namespace vnotex
 
         QCheckBox *m_exportAttachmentsCheckBox = nullptr;
 
+        QCheckBox *m_incrementalCheckBox = nullptr;
+
         // HTML settings.
         QCheckBox *m_embedStylesCheckBox = nullptr;
 
@@ -170,6 +172,8 @@ namespace vnotex
 
         QCheckBox *m_addOutlinePanelCheckBox = nullptr;
 
+        QCheckBox *m_useNativeRendererCheckBox = nullptr;
+
         // PDF settings.
         QPushButton *m_pageLayoutBtn = nullptr;
 
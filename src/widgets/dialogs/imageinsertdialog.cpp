@@ -22,6 +22,7 @@
 
 #include <widgets/widgetsfactory.h>
 #include <widgets/lineedit.h>
+#include <widgets/editors/imagepreviewservice.h>
 #include <utils/fileutils.h>
 #include <utils/pathutils.h>
 
@@ -48,6 +49,9 @@ ImageInsertDialog::ImageInsertDialog(const QString &p_title,
     connect(m_imagePathCheckTimer, &QTimer::timeout,
             this, &ImageInsertDialog::checkImagePathInput);
 
+    connect(&ImagePreviewService::getInst(), &ImagePreviewService::imageReady,
+            this, &ImageInsertDialog::handleImageReady);
+
     setupUI(p_title, p_imageTitle, p_imageAlt, p_imagePath);
 
     checkInput();
@@ -193,7 +197,15 @@ void ImageInsertDialog::checkImagePathInput()
     if (url.isLocalFile()) {
         const auto localFile = url.toLocalFile();
         if (QFileInfo::exists(localFile)) {
-            setImage(FileUtils::imageFromFile(localFile));
+            // Decode it off the GUI thread.
+            const auto image = ImagePreviewService::getInst().request(localFile, QSize());
+            setImage(image);
+            if (image.isNull()) {
+                m_pendingImagePath = localFile;
+                m_imageLabel->setText(tr("Loading..."));
+                m_imageLabel->adjustSize();
+                m_previewArea->setVisible(true);
+            }
         } else {
             setImage(QImage());
         }
@@ -217,6 +229,15 @@ void ImageInsertDialog::checkImagePathInput()
     checkInput();
 }
 
+void ImageInsertDialog::handleImageReady(const QString &p_filePath, const QSize &p_size, const QImage &p_image)
+{
+    if (p_size.isValid() || p_filePath != m_pendingImagePath) {
+        return;
+    }
+
+    setImage(p_image);
+}
+
 void ImageInsertDialog::checkInput()
 {
     setButtonEnabled(QDialogButtonBox::Ok, !m_image.isNull());
@@ -277,6 +298,8 @@ const QImage &ImageInsertDialog::getImage() const
 
 void ImageInsertDialog::setImage(const QImage &p_image)
 {
+    m_pendingImagePath.clear();
+
     m_image = p_image;
     if (m_image.isNull()) {
         m_imageLabel->clear();
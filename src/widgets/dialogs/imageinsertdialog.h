@@ -68,6 +68,8 @@ namespace vnotex
 
         void handleImageDownloaded(const vte::NetworkReply &p_data, const QString &p_url);
 
+        void handleImageReady(const QString &p_filePath, const QSize &p_size, const QImage &p_image);
+
         void handleScaleSliderValueChanged(int p_val);
 
     private:
@@ -102,6 +104,9 @@ namespace vnotex
 
         QImage m_image;
 
+        // Local image being decoded.
+        QString m_pendingImagePath;
+
         // Managed by QObject.
         vte::NetworkAccess *m_downloader = nullptr;
 
@@ -24,6 +24,7 @@
 #include <widgets/messageboxhelper.h>
 #include <widgets/editors/plantumlhelper.h>
 #include <widgets/editors/graphvizhelper.h>
+#include <widgets/editors/previewimagecache.h>
 
 using namespace vnotex;
 
@@ -80,8 +81,25 @@ void MarkdownEditorPage::loadInternal()
         m_inplacePreviewSourceMathCheckBox->setChecked(srcs & MarkdownEditorConfig::InplacePreviewSource::Math);
     }
 
+    {
+        m_previewImageCacheSizeSpinBox->setValue(markdownConfig.getPreviewImageCacheSize());
+
+        const auto usage = PreviewImageCache::getInst().getUsage();
+        const qint64 mib = 1024 * 1024;
+        m_previewImageCacheSizeSpinBox->setToolTip(
+            tr("Memory budget of in-place preview images shared by all editors\n"
+               "Current usage: %1 entries, %2 MiB of images, %3 MiB of source data, "
+               "%4 MiB of images in use by editors")
+                .arg(usage.m_numOfEntries)
+                .arg(usage.m_imageBytes / mib)
+                .arg(usage.m_dataBytes / mib)
+                .arg(usage.m_sharedImageBytes / mib));
+    }
+
     m_fetchImagesToLocalCheckBox->setChecked(markdownConfig.getFetchImagesInParseAndPaste());
 
+    m_linkIdenticalImagesCheckBox->setChecked(markdownConfig.getLinkIdenticalImagesEnabled());
+
     m_htmlTagCheckBox->setChecked(markdownConfig.getHtmlTagEnabled());
 
     m_autoBreakCheckBox->setChecked(markdownConfig.getAutoBreakEnabled());
@@ -162,6 +180,8 @@ bool MarkdownEditorPage::saveInternal()
         markdownConfig.setInplacePreviewSources(srcs);
     }
 
+    markdownConfig.setPreviewImageCacheSize(m_previewImageCacheSizeSpinBox->value());
+
     markdownConfig.setFetchImagesInParseAndPaste(m_fetchImagesToLocalCheckBox->isChecked());
 
     markdownConfig.setHtmlTagEnabled(m_htmlTagCheckBox->isChecked());
@@ -174,6 +194,8 @@ bool MarkdownEditorPage::saveInternal()
 
     markdownConfig.setSmartTableEnabled(m_smartTableCheckBox->isChecked());
 
+    markdownConfig.setLinkIdenticalImagesEnabled(m_linkIdenticalImagesCheckBox->isChecked());
+
     markdownConfig.setSpellCheckEnabled(m_spellCheckCheckBox->isChecked());
 
     markdownConfig.setWebPlantUml(m_plantUmlModeComboBox->currentData().toInt() == 0);
@@ -326,6 +348,21 @@ QGroupBox *MarkdownEditorPage::setupEditGroup()
                 this, &MarkdownEditorPage::pageIsChanged);
     }
 
+    {
+        m_previewImageCacheSizeSpinBox = WidgetsFactory::createSpinBox(box);
+        m_previewImageCacheSizeSpinBox->setToolTip(tr("Memory budget of in-place preview images shared by all editors"));
+
+        m_previewImageCacheSizeSpinBox->setRange(16, 4096);
+        m_previewImageCacheSizeSpinBox->setSingleStep(16);
+        m_previewImageCacheSizeSpinBox->setSuffix(tr(" MiB"));
+
+        const QString label(tr("In-place preview cache size:"));
+        layout->addRow(label, m_previewImageCacheSizeSpinBox);
+        addSearchItem(label, m_previewImageCacheSizeSpinBox->toolTip(), m_previewImageCacheSizeSpinBox);
+        connect(m_previewImageCacheSizeSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+                this, &MarkdownEditorPage::pageIsChanged);
+    }
+
     {
         const QString label(tr("Fetch images to local in Parse And Paste"));
         m_fetchImagesToLocalCheckBox = WidgetsFactory::createCheckBox(label, box);
@@ -336,6 +373,17 @@ QGroupBox *MarkdownEditorPage::setupEditGroup()
                 this, &MarkdownEditorPage::pageIsChanged);
     }
 
+    {
+        const QString label(tr("Hard link identical images"));
+        m_linkIdenticalImagesCheckBox = WidgetsFactory::createCheckBox(label, box);
+        m_linkIdenticalImagesCheckBox->setToolTip(tr("Hard link an inserted image to an identical image of other notes to save space. "
+                                                     "Editing one of them in place will change all of them."));
+        layout->addRow(m_linkIdenticalImagesCheckBox);
+        addSearchItem(label, m_linkIdenticalImagesCheckBox->toolTip(), m_linkIdenticalImagesCheckBox);
+        connect(m_linkIdenticalImagesCheckBox, &QCheckBox::stateChanged,
+                this, &MarkdownEditorPage::pageIsChanged);
+    }
+
     {
         const QString label(tr("Smart table"));
         m_smartTableCheckBox = WidgetsFactory::createCheckBox(label, box);
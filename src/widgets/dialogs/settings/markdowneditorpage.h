@@ -50,6 +50,8 @@ namespace vnotex
 
         QCheckBox *m_inplacePreviewSourceMathCheckBox = nullptr;
 
+        QSpinBox *m_previewImageCacheSizeSpinBox = nullptr;
+
         QCheckBox *m_fetchImagesToLocalCheckBox = nullptr;
 
         QCheckBox *m_htmlTagCheckBox = nullptr;
@@ -70,6 +72,8 @@ namespace vnotex
 
         QCheckBox *m_smartTableCheckBox = nullptr;
 
+        QCheckBox *m_linkIdenticalImagesCheckBox = nullptr;
+
         QCheckBox *m_spellCheckCheckBox = nullptr;
 
         QComboBox *m_plantUmlModeComboBox = nullptr;
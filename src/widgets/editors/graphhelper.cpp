@@ -2,16 +2,23 @@
 
 #include <QDebug>
 #include <QFileInfo>
+#include <QThread>
+#include <QTimer>
+#include <QDateTime>
 
 #include <utils/processutils.h>
+#include <core/graphcache.h>
 
 using namespace vnotex;
 
 #define TaskIdProperty "GraphTaskId"
 #define TaskTimeStampProperty "GraphTaskTimeStamp"
+#define TaskFormatProperty "GraphTaskFormat"
+#define TaskTextProperty "GraphTaskText"
 
 GraphHelper::GraphHelper()
-    : m_cache(100, CacheItem())
+    : m_maxConcurrency(qMax(1, QThread::idealThreadCount())),
+      m_cache(100, CacheItem())
 {
 }
 
@@ -51,93 +58,192 @@ void GraphHelper::process(quint64 p_id,
     task.m_format = p_format;
     task.m_text = p_text;
     task.m_owner = p_owner;
+    task.m_ownerKey = p_owner;
     task.m_callback = p_callback;
 
-    m_tasks.enqueue(task);
+    // Look up the persistent cache once on submission instead of on each scheduling pass,
+    // which reads the disk.
+    if (m_programValid) {
+        const auto &cachedData = m_cache.get(task.m_text);
+        if (cachedData.isNull() || cachedData.m_format != task.m_format) {
+            const auto data = GraphCache::getInst().get(persistentCacheKey(task.m_format, task.m_text));
+            if (!data.isNull()) {
+                qDebug() << "Graph task" << task.m_id << task.m_timeStamp << "finished by persistent cache" << data.size();
+                CacheItem item;
+                item.m_format = task.m_format;
+                item.m_data = data;
+                m_cache.set(task.m_text, item);
+
+                task.m_state = TaskState::Finished;
+                task.m_data = data;
+            }
+        }
+    }
+
+    m_tasks.append(task);
+
+    processTasks();
 
-    processOneTask();
+    if (task.m_state == TaskState::Finished) {
+        callbackFinishedTasks();
+    }
 }
 
-void GraphHelper::processOneTask()
+void GraphHelper::cancel(const QObject *p_owner, TimeStamp p_timeStamp)
 {
-    if (m_taskOngoing || m_tasks.isEmpty()) {
-        return;
+    // Keys of running tasks cancelled.
+    QSet<QString> keys;
+    for (auto it = m_tasks.begin(); it != m_tasks.end();) {
+        if (it->m_ownerKey == p_owner && it->m_timeStamp < p_timeStamp) {
+            if (it->m_state == TaskState::Running) {
+                keys.insert(taskKey(it->m_format, it->m_text));
+            }
+            it = m_tasks.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (!keys.isEmpty()) {
+        // Owner may submit tasks with the same text right after cancellation, which
+        // could share the running processes. Check it later.
+        QTimer::singleShot(0, [this, keys]() {
+            killObsoleteProcesses(keys);
+        });
+    }
+
+    // Cancelled tasks may block tasks of the same owner.
+    callbackFinishedTasks();
+}
+
+void GraphHelper::killObsoleteProcesses(QSet<QString> p_keys)
+{
+    // Results shared by other tasks are still needed.
+    for (const auto &task : m_tasks) {
+        if (task.m_state == TaskState::Running) {
+            p_keys.remove(taskKey(task.m_format, task.m_text));
+        }
     }
 
-    m_taskOngoing = true;
+    for (const auto &key : p_keys) {
+        auto process = m_processes.value(key, nullptr);
+        if (process) {
+            qDebug() << "kill obsolete graph task" << process->property(TaskIdProperty).toULongLong();
+            process->kill();
+        }
+    }
+}
 
-    const auto &task = m_tasks.head();
+QString GraphHelper::taskKey(const QString &p_format, const QString &p_text)
+{
+    return p_format + QLatin1Char('\n') + p_text;
+}
 
-    const auto &cachedData = m_cache.get(task.m_text);
-    if (!cachedData.isNull() && cachedData.m_format == task.m_format) {
-        finishOneTask(cachedData.m_data);
-        return;
+void GraphHelper::processTasks()
+{
+    bool hasFinished = false;
+    for (auto &task : m_tasks) {
+        if (task.m_state != TaskState::Pending) {
+            continue;
+        }
+
+        const auto &cachedData = m_cache.get(task.m_text);
+        if (!cachedData.isNull() && cachedData.m_format == task.m_format) {
+            qDebug() << "Graph task" << task.m_id << task.m_timeStamp << "finished by cache" << cachedData.m_data.size();
+            task.m_state = TaskState::Finished;
+            task.m_data = cachedData.m_data;
+            hasFinished = true;
+            continue;
+        }
+
+        if (!m_programValid) {
+            qWarning() << "program to execute for rendering is not valid" << m_program;
+            task.m_state = TaskState::Finished;
+            task.m_data.clear();
+            hasFinished = true;
+            continue;
+        }
+
+        const auto key = taskKey(task.m_format, task.m_text);
+        if (m_runningKeys.contains(key)) {
+            // Share the result of the running one.
+            task.m_state = TaskState::Running;
+            continue;
+        }
+
+        if (m_runningKeys.size() >= m_maxConcurrency) {
+            continue;
+        }
+
+        task.m_state = TaskState::Running;
+        m_runningKeys.insert(key);
+        if (!renderByDaemon(task.m_format, task.m_text)) {
+            startProcess(task);
+        }
     }
 
-    if (!m_programValid) {
-        qWarning() << "program to execute for rendering is not valid" << m_program;
-        finishOneTask(QString());
-        return;
+    if (hasFinished) {
+        callbackFinishedTasks();
     }
+}
 
-    // Will be released in finishOneTask.
+void GraphHelper::startProcess(const Task &p_task)
+{
+    // Will be released in finishProcess.
     QProcess *process = new QProcess();
-    process->setProperty(TaskIdProperty, task.m_id);
-    process->setProperty(TaskTimeStampProperty, task.m_timeStamp);
+    process->setProperty(TaskIdProperty, p_task.m_id);
+    process->setProperty(TaskTimeStampProperty, p_task.m_timeStamp);
+    process->setProperty(TaskFormatProperty, p_task.m_format);
+    process->setProperty(TaskTextProperty, p_task.m_text);
     QObject::connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
                      [this, process](int exitCode, QProcess::ExitStatus exitStatus) {
-                         finishOneTask(process, exitCode, exitStatus);
+                         finishProcess(process, exitCode, exitStatus);
                      });
+    // finished() will not be emitted if it fails to start.
+    QObject::connect(process, &QProcess::errorOccurred,
+                     process, [this, process](QProcess::ProcessError error) {
+                         if (error == QProcess::FailedToStart) {
+                             finishProcess(process, -1, QProcess::CrashExit);
+                         }
+                     },
+                     Qt::QueuedConnection);
+
+    m_processes.insert(taskKey(p_task.m_format, p_task.m_text), process);
 
     if (m_overriddenCommand.isEmpty()) {
         Q_ASSERT(!m_program.isEmpty());
         QStringList args(m_args);
-        args << getFormatArgs(task.m_format);
+        args << getFormatArgs(p_task.m_format);
         process->start(m_program, getArgsToUse(args));
     } else {
-        auto cmd = getCommandToUse(m_overriddenCommand, task.m_format);
+        auto cmd = getCommandToUse(m_overriddenCommand, p_task.m_format);
         process->start(cmd);
     }
 
-    if (process->write(task.m_text.toUtf8()) == -1) {
-        qWarning() << "Graph task" << task.m_id << "failed to write to process stdin:" << process->errorString();
+    if (process->write(p_task.m_text.toUtf8()) == -1) {
+        qWarning() << "Graph task" << p_task.m_id << "failed to write to process stdin:" << process->errorString();
     }
 
     process->closeWriteChannel();
 }
 
-void GraphHelper::finishOneTask(QProcess *p_process, int p_exitCode, QProcess::ExitStatus p_exitStatus)
+void GraphHelper::finishProcess(QProcess *p_process, int p_exitCode, QProcess::ExitStatus p_exitStatus)
 {
-    Q_ASSERT(m_taskOngoing && !m_tasks.isEmpty());
-
-    const auto task = m_tasks.dequeue();
-
     const quint64 id = p_process->property(TaskIdProperty).toULongLong();
     const quint64 timeStamp = p_process->property(TaskTimeStampProperty).toULongLong();
-    Q_ASSERT(task.m_id == id && task.m_timeStamp == timeStamp);
+    const auto format = p_process->property(TaskFormatProperty).toString();
+    const auto text = p_process->property(TaskTextProperty).toString();
 
     qDebug() << "Graph task" << id << timeStamp << "finished";
 
     bool failed = true;
+    QByteArray outBa;
     if (p_exitStatus == QProcess::NormalExit) {
         if (p_exitCode < 0) {
             qWarning() << "Graph task" << id << "failed:" << p_exitCode;
         } else {
             failed = false;
-            const auto outBa = p_process->readAllStandardOutput();
-            QString data;
-            if (task.m_format == QStringLiteral("svg")) {
-                data = QString::fromLocal8Bit(outBa);
-                callbackOneTask(task, id, timeStamp, task.m_format, data);
-            } else {
-                data = QString::fromLocal8Bit(outBa.toBase64());
-                callbackOneTask(task, id, timeStamp, task.m_format, data);
-            }
-
-            CacheItem item;
-            item.m_format = task.m_format;
-            item.m_data = data;
-            m_cache.set(task.m_text, item);
+            outBa = p_process->readAllStandardOutput();
         }
     } else {
         qWarning() << "Graph task" << id << "failed to start" << p_exitCode << p_exitStatus;
@@ -153,28 +259,77 @@ void GraphHelper::finishOneTask(QProcess *p_process, int p_exitCode, QProcess::E
         }
     }
 
-    if (failed) {
-        callbackOneTask(task, id, task.m_timeStamp, task.m_format, QString());
-    }
-
     p_process->deleteLater();
+    m_processes.remove(taskKey(format, text));
 
-    m_taskOngoing = false;
-    processOneTask();
+    finishRendering(format, text, !failed, outBa);
 }
 
-void GraphHelper::finishOneTask(const QString &p_data)
+bool GraphHelper::renderByDaemon(const QString &p_format, const QString &p_text)
 {
-    Q_ASSERT(m_taskOngoing && !m_tasks.isEmpty());
+    Q_UNUSED(p_format);
+    Q_UNUSED(p_text);
+    return false;
+}
+
+void GraphHelper::finishRendering(const QString &p_format,
+                                  const QString &p_text,
+                                  bool p_succeeded,
+                                  const QByteArray &p_output)
+{
+    QString data;
+    if (p_succeeded) {
+        if (p_format == QStringLiteral("svg")) {
+            data = QString::fromLocal8Bit(p_output);
+        } else {
+            data = QString::fromLocal8Bit(p_output.toBase64());
+        }
+
+        CacheItem item;
+        item.m_format = p_format;
+        item.m_data = data;
+        m_cache.set(p_text, item);
+
+        GraphCache::getInst().set(persistentCacheKey(p_format, p_text), data);
+    }
 
-    const auto task = m_tasks.dequeue();
+    m_runningKeys.remove(taskKey(p_format, p_text));
+    finishTasks(p_format, p_text, data);
 
-    qDebug() << "Graph task" << task.m_id << task.m_timeStamp << "finished by cache" << p_data.size();
+    processTasks();
+}
 
-    callbackOneTask(task, task.m_id, task.m_timeStamp, task.m_format, p_data);
+void GraphHelper::finishTasks(const QString &p_format, const QString &p_text, const QString &p_data)
+{
+    for (auto &task : m_tasks) {
+        if (task.m_state == TaskState::Running && task.m_format == p_format && task.m_text == p_text) {
+            task.m_state = TaskState::Finished;
+            task.m_data = p_data;
+        }
+    }
 
-    m_taskOngoing = false;
-    processOneTask();
+    callbackFinishedTasks();
+}
+
+void GraphHelper::callbackFinishedTasks()
+{
+    // A finished task could be called back only after all previous tasks of the same owner.
+    QVector<Task> tasksToCallback;
+    QSet<const QObject *> blockedOwners;
+    for (auto it = m_tasks.begin(); it != m_tasks.end();) {
+        if (it->m_state == TaskState::Finished && !blockedOwners.contains(it->m_ownerKey)) {
+            tasksToCallback.push_back(*it);
+            it = m_tasks.erase(it);
+        } else {
+            blockedOwners.insert(it->m_ownerKey);
+            ++it;
+        }
+    }
+
+    // Callbacks may submit new tasks.
+    for (const auto &task : tasksToCallback) {
+        callbackOneTask(task);
+    }
 }
 
 QString GraphHelper::getCommandToUse(const QString &p_command, const QString &p_format)
@@ -200,11 +355,25 @@ void GraphHelper::checkValidProgram()
             m_programValid = !finfo.isAbsolute() || finfo.isExecutable();
         }
     }
+    // Files involved, such as the PlantUML JAR, may be updated to a new version.
+    m_rendererSignature.clear();
+    m_rendererSignature << m_program << m_args << m_overriddenCommand;
+    for (const auto &arg : QStringList(m_args) << m_program) {
+        QFileInfo finfo(arg);
+        if (finfo.isAbsolute() && finfo.isFile()) {
+            m_rendererSignature << QString::number(finfo.lastModified().toMSecsSinceEpoch());
+        }
+    }
+}
+
+QByteArray GraphHelper::persistentCacheKey(const QString &p_format, const QString &p_text) const
+{
+    return GraphCache::calculateKey(QStringList(m_rendererSignature) << p_format << p_text);
 }
 
-void GraphHelper::callbackOneTask(const Task &p_task, quint64 p_id, TimeStamp p_timeStamp, const QString &p_format, const QString &p_data) const
+void GraphHelper::callbackOneTask(const Task &p_task) const
 {
     if (p_task.m_owner) {
-        p_task.m_callback(p_id, p_timeStamp, p_format, p_data);
+        p_task.m_callback(p_task.m_id, p_task.m_timeStamp, p_task.m_format, p_task.m_data);
     }
 }
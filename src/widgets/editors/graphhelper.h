@@ -4,7 +4,9 @@
 #include <QProcess>
 #include <QStringList>
 #include <QPair>
-#include <QQueue>
+#include <QList>
+#include <QSet>
+#include <QHash>
 #include <QPointer>
 
 #include <core/noncopyable.h>
@@ -27,9 +29,24 @@ namespace vnotex
                      QObject *p_owner,
                      const ResultCallback &p_callback);
 
+        // Cancel tasks of @p_owner with time stamp older than @p_timeStamp.
+        // Their callbacks will not be called. Processes needed only by them will be killed.
+        void cancel(const QObject *p_owner, TimeStamp p_timeStamp);
+
     protected:
         virtual QStringList getFormatArgs(const QString &p_format) = 0;
 
+        // Render @p_text in @p_format by a long-lived renderer instead of starting a new process.
+        // Return false if not supported.
+        // Should call finishRendering() later, but not within this call.
+        virtual bool renderByDaemon(const QString &p_format, const QString &p_text);
+
+        // Called when rendering of @p_text in @p_format finished with output @p_output.
+        void finishRendering(const QString &p_format,
+                             const QString &p_text,
+                             bool p_succeeded,
+                             const QByteArray &p_output);
+
         void clearCache();
 
         void checkValidProgram();
@@ -47,6 +64,13 @@ namespace vnotex
         QString m_overriddenCommand;
 
     private:
+        enum class TaskState
+        {
+            Pending,
+            Running,
+            Finished
+        };
+
         struct Task
         {
             quint64 m_id = 0;
@@ -59,7 +83,16 @@ namespace vnotex
 
             QPointer<QObject> m_owner;
 
+            // Owner at the time of submission. Callbacks of the same owner are
+            // called in the order of submission.
+            const QObject *m_ownerKey = nullptr;
+
             ResultCallback m_callback;
+
+            TaskState m_state = TaskState::Pending;
+
+            // Result data when finished.
+            QString m_data;
         };
 
         struct CacheItem
@@ -74,23 +107,49 @@ namespace vnotex
             QString m_data;
         };
 
-        void processOneTask();
+        // Start pending tasks as many as allowed.
+        void processTasks();
+
+        void startProcess(const Task &p_task);
+
+        void finishProcess(QProcess *p_process, int p_exitCode, QProcess::ExitStatus p_exitStatus);
+
+        // Finish all running tasks with the same format and text as @p_format and @p_text.
+        void finishTasks(const QString &p_format, const QString &p_text, const QString &p_data);
+
+        // Kill processes of @p_keys if no task needs them.
+        void killObsoleteProcesses(QSet<QString> p_keys);
 
-        void finishOneTask(QProcess *p_process, int p_exitCode, QProcess::ExitStatus p_exitStatus);
+        // Call callbacks of finished tasks and remove them.
+        void callbackFinishedTasks();
 
-        void finishOneTask(const QString &p_data);
+        void callbackOneTask(const Task &p_task) const;
 
-        void callbackOneTask(const Task &p_task, quint64 p_id, TimeStamp p_timeStamp, const QString &p_format, const QString &p_data) const;
+        static QString taskKey(const QString &p_format, const QString &p_text);
 
-        QQueue<Task> m_tasks;
+        QByteArray persistentCacheKey(const QString &p_format, const QString &p_text) const;
 
-        bool m_taskOngoing = false;
+        // Tasks in the order of submission.
+        QList<Task> m_tasks;
+
+        // Keys of tasks having a process running.
+        // Tasks with the same key submitted meanwhile will share the result.
+        QSet<QString> m_runningKeys;
+
+        // {task key} -> running process.
+        QHash<QString, QProcess *> m_processes;
+
+        // Max number of processes running at the same time.
+        int m_maxConcurrency = 1;
 
         // {text} -> CacheItem.
         vte::LruCache<QString, CacheItem> m_cache;
 
         // Whether @m_program is valid.
         bool m_programValid = false;
+
+        // Identify the renderer in the persistent cache.
+        QStringList m_rendererSignature;
     };
 }
 
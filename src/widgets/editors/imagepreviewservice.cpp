@@ -0,0 +1,145 @@
+#include "imagepreviewservice.h"
+
+#include <QThreadPool>
+#include <QRunnable>
+#include <QThread>
+#include <QImageReader>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDebug>
+
+#include <functional>
+
+#include <core/exception.h>
+#include <utils/fileutils.h>
+#include <utils/pathutils.h>
+
+using namespace vnotex;
+
+// Memory budget in KiB of decoded images.
+static const int c_maxCacheCost = 64 * 1024;
+
+namespace
+{
+    class FunctionRunnable : public QRunnable
+    {
+    public:
+        explicit FunctionRunnable(const std::function<void()> &p_func)
+            : m_func(p_func)
+        {
+        }
+
+        void run() Q_DECL_OVERRIDE
+        {
+            m_func();
+        }
+
+    private:
+        std::function<void()> m_func;
+    };
+}
+
+ImagePreviewService &ImagePreviewService::getInst()
+{
+    static ImagePreviewService inst;
+    return inst;
+}
+
+ImagePreviewService::ImagePreviewService(QObject *p_parent)
+    : QObject(p_parent)
+{
+    m_images.setMaxCost(c_maxCacheCost);
+
+    m_threadPool = new QThreadPool(this);
+    // Leave some cores to the GUI thread and other work.
+    m_threadPool->setMaxThreadCount(qMax(QThread::idealThreadCount() / 2, 1));
+}
+
+QString ImagePreviewService::calculateKey(const QString &p_filePath, const QSize &p_size)
+{
+    const QFileInfo info(p_filePath);
+    return QStringLiteral("%1|%2|%3|%4x%5").arg(PathUtils::normalizePath(p_filePath),
+                                                QString::number(info.lastModified().toMSecsSinceEpoch()),
+                                                QString::number(info.size()),
+                                                QString::number(p_size.width()),
+                                                QString::number(p_size.height()));
+}
+
+QImage ImagePreviewService::request(const QString &p_filePath, const QSize &p_size)
+{
+    const auto key = calculateKey(p_filePath, p_size);
+    auto img = m_images.object(key);
+    if (img) {
+        return *img;
+    }
+
+    if (m_pendingKeys.contains(key)) {
+        return QImage();
+    }
+
+    m_pendingKeys.insert(key);
+
+    m_threadPool->start(new FunctionRunnable([this, key, p_filePath, p_size]() {
+        const auto image = decodeImage(p_filePath, p_size);
+        QMetaObject::invokeMethod(this,
+                                  [this, key, p_filePath, p_size, image]() {
+                                      handleImageDecoded(key, p_filePath, p_size, image);
+                                  },
+                                  Qt::QueuedConnection);
+    }));
+
+    return QImage();
+}
+
+void ImagePreviewService::handleImageDecoded(const QString &p_key,
+                                             const QString &p_filePath,
+                                             const QSize &p_size,
+                                             const QImage &p_image)
+{
+    m_pendingKeys.remove(p_key);
+
+    if (!p_image.isNull()) {
+        // QCache will drop it right away if it exceeds the budget.
+        const int cost = qMax(static_cast<int>(p_image.sizeInBytes() / 1024), 1);
+        m_images.insert(p_key, new QImage(p_image), cost);
+    }
+
+    emit imageReady(p_filePath, p_size, p_image);
+}
+
+QImage ImagePreviewService::decodeImage(const QString &p_filePath, const QSize &p_size)
+{
+    QImageReader reader(p_filePath);
+    reader.setAutoTransform(true);
+    if (p_size.isValid()) {
+        // Let the decoder skip pixels, which is much cheaper than scaling a full decoded image.
+        const auto originalSize = reader.size();
+        auto bound = p_size;
+        if (reader.transformation() & QImageIOHandler::TransformationRotate90) {
+            bound.transpose();
+        }
+
+        if (originalSize.isValid()
+            && (originalSize.width() > bound.width() || originalSize.height() > bound.height())) {
+            reader.setScaledSize(originalSize.scaled(bound, Qt::KeepAspectRatio));
+        }
+    }
+
+    auto img = reader.read();
+    if (img.isNull()) {
+        // @p_filePath may has a wrong suffix which indicates a wrong image format.
+        try {
+            img = FileUtils::imageFromFile(p_filePath);
+        } catch (Exception &p_e) {
+            qWarning() << "failed to decode image for preview" << p_filePath << p_e.what();
+            return QImage();
+        }
+
+        if (!img.isNull() && p_size.isValid()
+            && (img.width() > p_size.width() || img.height() > p_size.height())) {
+            img = img.scaled(p_size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        }
+    }
+
+    return img;
+}
@@ -0,0 +1,57 @@
+#ifndef IMAGEPREVIEWSERVICE_H
+#define IMAGEPREVIEWSERVICE_H
+
+#include <QObject>
+#include <QCache>
+#include <QSet>
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+class QThreadPool;
+
+namespace vnotex
+{
+    // Decode local images for previews of dialogs off the GUI thread.
+    // Images are decoded by QImageReader with scaled size hints in a thread pool and kept in
+    // a small memory cache keyed by (path, modified time, target size).
+    class ImagePreviewService : public QObject
+    {
+        Q_OBJECT
+    public:
+        static ImagePreviewService &getInst();
+
+        // Request image @p_filePath scaled down to fit in @p_size keeping the aspect ratio.
+        // @p_size: invalid for the original size.
+        // Return the image if cached. Otherwise, return a null image and imageReady() will be
+        // emitted once it is decoded. Callers should show a placeholder in the meantime.
+        QImage request(const QString &p_filePath, const QSize &p_size);
+
+    signals:
+        // @p_image is null if failed to decode.
+        void imageReady(const QString &p_filePath, const QSize &p_size, const QImage &p_image);
+
+    private:
+        explicit ImagePreviewService(QObject *p_parent = nullptr);
+
+        void handleImageDecoded(const QString &p_key,
+                                const QString &p_filePath,
+                                const QSize &p_size,
+                                const QImage &p_image);
+
+        static QString calculateKey(const QString &p_filePath, const QSize &p_size);
+
+        // Thread-safe.
+        static QImage decodeImage(const QString &p_filePath, const QSize &p_size);
+
+        QThreadPool *m_threadPool = nullptr;
+
+        // Key -> decoded image. Cost in KiB.
+        QCache<QString, QImage> m_images;
+
+        // Keys of images being decoded.
+        QSet<QString> m_pendingKeys;
+    };
+}
+
+#endif // IMAGEPREVIEWSERVICE_H
@@ -12,11 +12,16 @@
 #include <QAction>
 #include <QShortcut>
 #include <QProgressDialog>
-#include <QTemporaryFile>
 #include <QTimer>
 #include <QBuffer>
 #include <QPainter>
 #include <QHash>
+#include <QSet>
+#include <QEventLoop>
+#include <QThread>
+#include <QPointer>
+#include <QTemporaryFile>
+#include <QScopedPointer>
 
 #include <vtextedit/markdowneditorconfig.h>
 #include <vtextedit/previewmgr.h>
@@ -52,9 +57,14 @@
 #include <core/editorconfig.h>
 #include <core/vnotex.h>
 #include <core/fileopenparameters.h>
+#include <core/imagefetcher.h>
+#include <core/imagetranscodeoption.h>
+#include <notebook/node.h>
+#include <notebook/notebook.h>
 #include <imagehost/imagehostutils.h>
 #include <imagehost/imagehost.h>
 #include <imagehost/imagehostmgr.h>
+#include <imagehost/imageuploadqueue.h>
 
 #include "previewhelper.h"
 #include "../outlineprovider.h"
@@ -411,26 +421,77 @@ bool MarkdownEditor::insertImageToBufferFromData(const QString &p_title,
                                                  int p_scaledWidth,
                                                  int p_scaledHeight)
 {
-    // Save as PNG by default.
-    const QString format("png");
-    const auto destFileName = generateImageFileNameToInsertAs(p_title, format);
+    // Encoding large images takes time, so do it in a worker thread and return immediately.
+    // The link will be inserted at current position, which is tracked by the cursor across edits.
+    auto cursor = m_textEdit->textCursor();
+    if (cursor.hasSelection()) {
+        cursor.removeSelectedText();
+        m_textEdit->setTextCursor(cursor);
+    }
+    cursor.setKeepPositionOnInsert(true);
+
+    const QImage image(p_image);
+    const auto option = getImageTranscodeOption();
+    auto data = QSharedPointer<QByteArray>::create();
+    auto suffix = QSharedPointer<QString>::create();
+    auto thread = QThread::create([image, option, data, suffix]() {
+        ImageUtils::transcodeImage(image, option, *data, *suffix);
+    });
+
+    QPointer<Buffer> buffer(m_buffer);
+    connect(thread, &QThread::finished,
+            this, [this, buffer, cursor, data, suffix, p_title, p_altText, p_scaledWidth, p_scaledHeight]() {
+                if (!buffer || buffer != m_buffer) {
+                    qWarning() << "buffer changed before inserting image" << p_title;
+                    return;
+                }
+
+                insertEncodedImageToBuffer(p_title, p_altText, *data, *suffix, cursor, p_scaledWidth, p_scaledHeight);
+            });
+    connect(thread, &QThread::finished,
+            thread, &QObject::deleteLater);
+    thread->start();
+    return true;
+}
+
+bool MarkdownEditor::insertEncodedImageToBuffer(const QString &p_title,
+                                                const QString &p_altText,
+                                                const QByteArray &p_data,
+                                                const QString &p_suffix,
+                                                const QTextCursor &p_cursor,
+                                                int p_scaledWidth,
+                                                int p_scaledHeight)
+{
+    if (p_data.isEmpty()) {
+        MessageBoxHelper::notify(MessageBoxHelper::Warning,
+                                 QString("Failed to encode image data (%1).").arg(p_title),
+                                 this);
+        return false;
+    }
+
+    const auto destFileName = generateImageFileNameToInsertAs(p_title, p_suffix);
 
     QString destFilePath;
 
     if (m_imageHost) {
         // Save to image host.
-        QByteArray ba;
-        QBuffer buffer(&ba);
-        buffer.open(QIODevice::WriteOnly);
-        p_image.save(&buffer, format.toStdString().c_str());
-
-        destFilePath = saveToImageHost(ba, destFileName);
+        destFilePath = saveToImageHost(p_data, destFileName);
         if (destFilePath.isEmpty()) {
             return false;
         }
     } else {
+        // Insert it as a local file, which could be deduplicated.
+        QScopedPointer<QTemporaryFile> file(FileUtils::createTemporaryFile(p_suffix));
+        if (!file->open() || file->write(p_data) != p_data.size()) {
+            MessageBoxHelper::notify(MessageBoxHelper::Warning,
+                                     QString("Failed to write image data (%1).").arg(file->errorString()),
+                                     this);
+            return false;
+        }
+        file->close();
+
         try {
-            destFilePath = m_buffer->insertImage(p_image, destFileName);
+            destFilePath = m_buffer->insertImage(file->fileName(), destFileName);
         } catch (Exception &e) {
             MessageBoxHelper::notify(MessageBoxHelper::Warning,
                                      QString("Failed to insert image from data (%1).").arg(e.what()),
@@ -439,10 +500,31 @@ bool MarkdownEditor::insertImageToBufferFromData(const QString &p_title,
         }
     }
 
+    // Insert at the position where it is requested and keep user's cursor.
+    const auto userCursor = m_textEdit->textCursor();
+    auto cursor = p_cursor;
+    cursor.setKeepPositionOnInsert(false);
+    m_textEdit->setTextCursor(cursor);
     insertImageLink(p_title, p_altText, destFilePath, p_scaledWidth, p_scaledHeight);
+    m_textEdit->setTextCursor(userCursor);
     return true;
 }
 
+ImageTranscodeOption MarkdownEditor::getImageTranscodeOption() const
+{
+    auto node = m_buffer ? m_buffer->getNode() : nullptr;
+    if (node) {
+        const auto obj = node->getNotebook()->getExtraConfig(QStringLiteral("image_transcode"));
+        if (!obj.isEmpty()) {
+            ImageTranscodeOption option;
+            option.init(obj);
+            return option;
+        }
+    }
+
+    return m_config.getImageTranscodeOption();
+}
+
 void MarkdownEditor::insertImageLink(const QString &p_title,
                                     const QString &p_altText,
                                     const QString &p_destImagePath,
@@ -1086,23 +1168,34 @@ void MarkdownEditor::fetchImagesToLocalAndReplace(QString &p_text)
     // Sort it in ascending order.
     std::sort(regs.begin(), regs.end());
 
-    QProgressDialog proDlg(tr("Fetching images to local..."),
-                           tr("Abort"),
-                           0,
-                           regs.size(),
-                           this);
-    proDlg.setWindowModality(Qt::WindowModal);
-    proDlg.setWindowTitle(tr("Fetch Images To Local"));
+    struct ImageLink
+    {
+        int m_regIdx = -1;
+
+        QString m_title;
+
+        // Captured texts after the URL in link.
+        QString m_cap3;
+
+        QString m_cap6;
+
+        // Absolute local path or network URL.
+        QString m_srcImagePath;
+
+        QUrl m_url;
+
+        // Text to replace with directly.
+        QString m_replacement;
+    };
+
+    // Collect links first and fetch all the network images concurrently.
+    QVector<ImageLink> links;
+    ImageFetcher fetcher;
 
     QRegExp zhihuRegExp("^https?://www\\.zhihu\\.com/equation\\?tex=(.+)$");
 
     QRegExp regExp(vte::MarkdownUtils::c_imageLinkRegExp);
-    for (int i = regs.size() - 1; i >= 0; --i) {
-        proDlg.setValue(regs.size() - 1 - i);
-        if (proDlg.wasCanceled()) {
-            break;
-        }
-
+    for (int i = 0; i < regs.size(); ++i) {
         const auto &reg = regs[i];
         QString linkText = p_text.mid(reg.m_startPos, reg.m_endPos - reg.m_startPos);
         if (regExp.indexIn(linkText) == -1) {
@@ -1111,16 +1204,13 @@ void MarkdownEditor::fetchImagesToLocalAndReplace(QString &p_text)
 
         qDebug() << "fetching image link" << linkText;
 
-        const QString imageTitle = purifyImageTitle(regExp.cap(1).trimmed());
+        ImageLink link;
+        link.m_regIdx = i;
+        link.m_title = purifyImageTitle(regExp.cap(1).trimmed());
+        link.m_cap3 = regExp.cap(3);
+        link.m_cap6 = regExp.cap(6);
         QString imageUrl = regExp.cap(2).trimmed();
 
-        const int maxUrlLength = 100;
-        QString urlToDisplay(imageUrl);
-        if (urlToDisplay.size() > maxUrlLength) {
-            urlToDisplay = urlToDisplay.left(maxUrlLength) + "...";
-        }
-        proDlg.setLabelText(tr("Fetching image (%1)").arg(urlToDisplay));
-
         // Handle equation from zhihu.com like http://www.zhihu.com/equation?tex=P.
         if (zhihuRegExp.indexIn(imageUrl) != -1) {
             QString tex = zhihuRegExp.cap(1).trimmed();
@@ -1133,24 +1223,18 @@ void MarkdownEditor::fetchImagesToLocalAndReplace(QString &p_text)
                 continue;
             }
 
-            tex = "$" + tex + "$";
-            p_text.replace(reg.m_startPos,
-                           reg.m_endPos - reg.m_startPos,
-                           tex);
+            link.m_replacement = "$" + tex + "$";
+            links.push_back(link);
             continue;
         }
 
         // Only handle absolute file path or network path.
-        QString srcImagePath;
         QFileInfo info(WebUtils::purifyUrl(imageUrl));
-
-        // For network image.
-        QScopedPointer<QTemporaryFile> tmpFile;
-
         if (info.exists()) {
             if (info.isAbsolute()) {
                 // Absolute local path.
-                srcImagePath = info.absoluteFilePath();
+                link.m_srcImagePath = info.absoluteFilePath();
+                links.push_back(link);
             }
         } else {
             // Network path.
@@ -1158,51 +1242,90 @@ void MarkdownEditor::fetchImagesToLocalAndReplace(QString &p_text)
             if (imageUrl.startsWith(QStringLiteral("//"))) {
                 imageUrl.prepend(QStringLiteral("https:"));
             }
-            QByteArray data = vte::NetworkAccess::request(QUrl(imageUrl)).m_data;
-            if (!data.isEmpty()) {
-                // Prefer the suffix from the real data.
-                auto suffix = ImageUtils::guessImageSuffix(data);
-                if (suffix.isEmpty()) {
-                    suffix = info.suffix();
-                } else if (info.suffix() != suffix) {
-                    qWarning() << "guess a different suffix from image data" << info.suffix() << suffix;
-                }
-                tmpFile.reset(FileUtils::createTemporaryFile(suffix));
-                if (tmpFile->open() && tmpFile->write(data) > -1) {
-                    srcImagePath = tmpFile->fileName();
-                }
-
-                // Need to close it explicitly to flush cache of small file.
-                tmpFile->close();
-            }
+            link.m_url = QUrl(imageUrl);
+            fetcher.addUrl(link.m_url, info.suffix());
+            links.push_back(link);
         }
+    }
 
-        if (srcImagePath.isEmpty()) {
-            continue;
+    if (fetcher.getUrlCount() > 0) {
+        QProgressDialog proDlg(tr("Fetching images to local..."),
+                               tr("Abort"),
+                               0,
+                               fetcher.getUrlCount(),
+                               this);
+        proDlg.setWindowModality(Qt::WindowModal);
+        proDlg.setWindowTitle(tr("Fetch Images To Local"));
+
+        QEventLoop loop;
+        connect(&fetcher, &ImageFetcher::progressUpdated,
+                &proDlg, [&proDlg](int p_done, int p_total, const QUrl &p_url) {
+                    const int maxUrlLength = 100;
+                    QString urlToDisplay(p_url.toString());
+                    if (urlToDisplay.size() > maxUrlLength) {
+                        urlToDisplay = urlToDisplay.left(maxUrlLength) + "...";
+                    }
+                    proDlg.setLabelText(tr("Fetched image (%1) (%2/%3)").arg(urlToDisplay,
+                                                                             QString::number(p_done),
+                                                                             QString::number(p_total)));
+                    proDlg.setValue(p_done);
+                });
+        connect(&proDlg, &QProgressDialog::canceled,
+                &fetcher, &ImageFetcher::abort);
+        connect(&fetcher, &ImageFetcher::finished,
+                &loop, &QEventLoop::quit);
+        fetcher.start();
+        if (!fetcher.isFinished()) {
+            loop.exec();
         }
 
-        // Insert image without inserting text.
-        QString urlInLink;
-        bool ret = insertImageToBufferFromLocalFile(imageTitle,
-                                                    QString(),
-                                                    srcImagePath,
-                                                    0,
-                                                    0,
-                                                    false,
-                                                    &urlInLink);
-        if (!ret || urlInLink.isEmpty()) {
-            continue;
+        proDlg.setValue(fetcher.getUrlCount());
+    }
+
+    // Insert images and replace all the links in one pass.
+    // {source image path} -> URL in link of the inserted image.
+    QHash<QString, QString> insertedImages;
+    QString text;
+    text.reserve(p_text.size());
+    int lastPos = 0;
+    for (const auto &link : links) {
+        QString replacement = link.m_replacement;
+        if (replacement.isEmpty()) {
+            const auto srcImagePath = link.m_url.isEmpty() ? link.m_srcImagePath : fetcher.getFilePath(link.m_url);
+            if (srcImagePath.isEmpty()) {
+                continue;
+            }
+
+            auto it = insertedImages.find(srcImagePath);
+            if (it == insertedImages.end()) {
+                // Insert image without inserting text.
+                QString urlInLink;
+                bool ret = insertImageToBufferFromLocalFile(link.m_title,
+                                                            QString(),
+                                                            srcImagePath,
+                                                            0,
+                                                            0,
+                                                            false,
+                                                            &urlInLink);
+                if (!ret || urlInLink.isEmpty()) {
+                    continue;
+                }
+
+                it = insertedImages.insert(srcImagePath, urlInLink);
+            }
+
+            // Replace URL in link.
+            replacement = QString("![%1](%2%3%4)").arg(link.m_title, it.value(), link.m_cap3, link.m_cap6);
         }
 
-        // Replace URL in link.
-        QString newLink = QString("![%1](%2%3%4)")
-                                 .arg(imageTitle, urlInLink, regExp.cap(3), regExp.cap(6));
-        p_text.replace(reg.m_startPos,
-                       reg.m_endPos - reg.m_startPos,
-                       newLink);
+        const auto &reg = regs[link.m_regIdx];
+        text += p_text.midRef(lastPos, reg.m_startPos - lastPos);
+        text += replacement;
+        lastPos = reg.m_endPos;
     }
 
-    proDlg.setValue(regs.size());
+    text += p_text.midRef(lastPos);
+    p_text = text;
 }
 
 static bool updateHeadingSectionNumber(QTextCursor &p_cursor,
@@ -1389,82 +1512,91 @@ void MarkdownEditor::uploadImagesToImageHost()
         return;
     }
 
+    const auto &editorConfig = ConfigMgr::getInst().getEditorConfig();
+    ImageUploadQueue queue(host, editorConfig.getImageHostUploadConcurrency());
+    {
+        QSet<QString> addedImages;
+        for (const auto &link : images) {
+            if (addedImages.contains(link.m_path)) {
+                continue;
+            }
+
+            addedImages.insert(link.m_path);
+            queue.addImage(link.m_path, generateImageHostFileName(m_buffer, PathUtils::fileName(link.m_path)));
+        }
+    }
+
     QProgressDialog proDlg(tr("Uploading local images..."),
                            tr("Abort"),
                            0,
-                           images.size(),
+                           queue.getImageCount(),
                            this);
     proDlg.setWindowModality(Qt::WindowModal);
     proDlg.setWindowTitle(tr("Upload Images To Image Host"));
 
+    // Filled as uploads complete.
     QHash<QString, QString> uploadedImages;
+    QStringList errors;
 
+    QEventLoop loop;
+    connect(&queue, &ImageUploadQueue::imageUploaded,
+            this, [&uploadedImages](const QString &p_filePath, const QString &p_url) {
+                uploadedImages.insert(p_filePath, p_url);
+            });
+    connect(&queue, &ImageUploadQueue::imageFailed,
+            this, [&errors](const QString &p_filePath, const QString &p_destPath, const QString &p_msg) {
+                errors << QString("%1 -> %2: %3").arg(p_filePath, p_destPath, p_msg);
+            });
+    connect(&queue, &ImageUploadQueue::progressUpdated,
+            &proDlg, [&proDlg](int p_done, int p_total, const QString &p_filePath) {
+                proDlg.setLabelText(tr("Uploaded image (%1) (%2/%3)").arg(p_filePath,
+                                                                          QString::number(p_done),
+                                                                          QString::number(p_total)));
+                proDlg.setValue(p_done);
+            });
+    connect(&proDlg, &QProgressDialog::canceled,
+            &queue, &ImageUploadQueue::abort);
+    connect(&queue, &ImageUploadQueue::finished,
+            &loop, &QEventLoop::quit);
+    queue.start();
+    if (!queue.isFinished()) {
+        loop.exec();
+    }
+
+    proDlg.setValue(queue.getImageCount());
+
+    // Update the link URLs in one edit block.
     int cnt = 0;
     auto cursor = m_textEdit->textCursor();
     cursor.beginEditBlock();
     for (int i = 0; i < images.size(); ++i) {
         const auto &link = images[i];
-
-        auto it = uploadedImages.find(link.m_path);
-        if (it != uploadedImages.end()) {
-            cursor.setPosition(link.m_urlInLinkPos);
-            cursor.setPosition(link.m_urlInLinkPos + link.m_urlInLink.size(), QTextCursor::KeepAnchor);
-            cursor.insertText(it.value());
-            continue;
-        }
-
-        proDlg.setValue(i + 1);
-        if (proDlg.wasCanceled()) {
-            break;
-        }
-        proDlg.setLabelText(tr("Upload image (%1)").arg(link.m_path));
-
         Q_ASSERT(i == 0 || link.m_urlInLinkPos < images[i - 1].m_urlInLinkPos);
 
-        QByteArray ba;
-        try {
-            ba = FileUtils::readFile(link.m_path);
-        } catch (Exception &e) {
-            MessageBoxHelper::notify(MessageBoxHelper::Warning,
-                                     QString("Failed to read local image file (%1) (%2).").arg(link.m_path, e.what()),
-                                     this);
-            continue;
-        }
-
-        if (ba.isEmpty()) {
-            qWarning() << "Skipped uploading empty image" << link.m_path;
-            continue;
-        }
-
-        const auto destPath = generateImageHostFileName(m_buffer, PathUtils::fileName(link.m_path));
-        QString errMsg;
-        QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-        const auto targetUrl = host->create(ba, destPath, errMsg);
-        QApplication::restoreOverrideCursor();
-
-        if (targetUrl.isEmpty()) {
-            MessageBoxHelper::notify(MessageBoxHelper::Warning,
-                                     QString("Failed to upload image to image host (%1) as (%2).").arg(host->getName(), destPath),
-                                     QString(),
-                                     errMsg,
-                                     this);
+        auto it = uploadedImages.find(link.m_path);
+        if (it == uploadedImages.end()) {
             continue;
         }
 
-        // Update the link URL.
         cursor.setPosition(link.m_urlInLinkPos);
         cursor.setPosition(link.m_urlInLinkPos + link.m_urlInLink.size(), QTextCursor::KeepAnchor);
-        cursor.insertText(targetUrl);
-        uploadedImages.insert(link.m_path, targetUrl);
+        cursor.insertText(it.value());
         ++cnt;
     }
     cursor.endEditBlock();
 
-    proDlg.setValue(images.size());
-
     if (cnt > 0) {
         m_textEdit->setTextCursor(cursor);
     }
+
+    if (!errors.isEmpty()) {
+        MessageBoxHelper::notify(MessageBoxHelper::Warning,
+                                 QString("Failed to upload %1 image(s) to image host (%2).").arg(QString::number(errors.size()),
+                                                                                                host->getName()),
+                                 QString(),
+                                 errors.join(QLatin1Char('\n')),
+                                 this);
+    }
 }
 
 void MarkdownEditor::prependContextSensitiveMenu(QMenu *p_menu, const QPoint &p_pos)
@@ -11,6 +11,7 @@
 class QMimeData;
 class QMenu;
 class QTimer;
+class QTextCursor;
 
 namespace vte
 {
@@ -24,6 +25,7 @@ namespace vnotex
     class MarkdownEditorConfig;
     class MarkdownTableHelper;
     class ImageHost;
+    struct ImageTranscodeOption;
 
     class MarkdownEditor : public vte::VMarkdownEditor
     {
@@ -142,12 +144,25 @@ namespace vnotex
                                               bool p_insertText = true,
                                               QString *p_urlInLink = nullptr);
 
+        // Image is encoded asynchronously and the link will be inserted at current position later.
         bool insertImageToBufferFromData(const QString &p_title,
                                          const QString &p_altText,
                                          const QImage &p_image,
                                          int p_scaledWidth = 0,
                                          int p_scaledHeight = 0);
 
+        // Insert encoded image @p_data and its link at @p_cursor.
+        bool insertEncodedImageToBuffer(const QString &p_title,
+                                        const QString &p_altText,
+                                        const QByteArray &p_data,
+                                        const QString &p_suffix,
+                                        const QTextCursor &p_cursor,
+                                        int p_scaledWidth,
+                                        int p_scaledHeight);
+
+        // Notebook's config overrides the global one.
+        ImageTranscodeOption getImageTranscodeOption() const;
+
         void insertImageLink(const QString &p_title,
                              const QString &p_altText,
                              const QString &p_destImagePath,
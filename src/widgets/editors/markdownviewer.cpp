@@ -54,6 +54,9 @@ MarkdownViewer::MarkdownViewer(MarkdownViewerAdapter *p_adapter,
     connect(QApplication::clipboard(), &QClipboard::changed,
             this, &MarkdownViewer::handleClipboardChanged);
 
+    connect(this, &QWebEngineView::loadFinished,
+            m_adapter, &MarkdownViewerAdapter::handleLoadFinished);
+
     connect(m_adapter, &MarkdownViewerAdapter::keyPressed,
             this, &MarkdownViewer::handleWebKeyPress);
 
@@ -91,13 +94,11 @@ void MarkdownViewer::setPreviewHelper(PreviewHelper *p_previewHelper)
                 }
             });
     connect(p_previewHelper, &PreviewHelper::mathPreviewRequested,
-            this, [this, p_previewHelper](quint64 p_id,
-                                          TimeStamp p_timeStamp,
-                                          const QString &p_text) {
+            this, [this, p_previewHelper](TimeStamp p_timeStamp, const QJsonArray &p_items) {
                 if (m_adapter->isViewerReady()) {
-                    m_adapter->mathPreviewRequested(p_id, p_timeStamp, p_text);
+                    m_adapter->mathPreviewRequested(p_timeStamp, p_items);
                 } else {
-                    p_previewHelper->handleMathPreviewData(MarkdownViewerAdapter::PreviewData());
+                    p_previewHelper->handleMathPreviewData(p_timeStamp, QVector<MarkdownViewerAdapter::PreviewData>());
                 }
             });
     connect(m_adapter, &MarkdownViewerAdapter::graphPreviewDataReady,
@@ -2,6 +2,7 @@
 
 #include <QDebug>
 #include <QMap>
+#include <QTimer>
 
 #include "../outlineprovider.h"
 #include "plantumlhelper.h"
@@ -10,6 +11,9 @@
 
 using namespace vnotex;
 
+// Minimum time in ms to wait for web side to finish a render before resending the full text.
+static const int c_renderTimeout = 10000;
+
 MarkdownViewerAdapter::Position::Position(int p_lineNumber, const QString &p_anchor)
     : m_lineNumber(p_lineNumber),
       m_anchor(p_anchor)
@@ -64,6 +68,13 @@ QJsonObject MarkdownViewerAdapter::FindOption::toJson() const
 MarkdownViewerAdapter::MarkdownViewerAdapter(QObject *p_parent)
     : QObject(p_parent)
 {
+    m_renderWatchdogTimer = new QTimer(this);
+    m_renderWatchdogTimer->setSingleShot(true);
+    connect(m_renderWatchdogTimer, &QTimer::timeout,
+            this, [this]() {
+                qWarning() << "preview render timed out, resend the full text";
+                resendFullText();
+            });
 }
 
 MarkdownViewerAdapter::~MarkdownViewerAdapter()
@@ -82,16 +93,88 @@ void MarkdownViewerAdapter::setText(int p_revision,
 
     m_revision = p_revision;
     if (m_viewerReady) {
-        emit textUpdated(p_text);
+        updateText(p_text);
         scrollToPosition(Position(p_lineNumber, ""));
     } else {
         m_pendingActions.append([this, p_text, p_lineNumber]() {
-            emit textUpdated(p_text);
+            updateText(p_text);
             scrollToPosition(Position(p_lineNumber, ""));
         });
     }
 }
 
+void MarkdownViewerAdapter::updateText(const QString &p_text)
+{
+    if (m_renderOngoing) {
+        // Only the latest text matters.
+        m_pendingText = p_text;
+        m_hasPendingText = true;
+        return;
+    }
+
+    auto lines = p_text.split(QLatin1Char('\n'));
+    if (m_lines.isEmpty()) {
+        m_lines = lines;
+        startRender();
+        emit textUpdated(p_text);
+        return;
+    }
+
+    // Lines changed lie between the common prefix and the common suffix.
+    const int minSize = qMin(m_lines.size(), lines.size());
+    int prefix = 0;
+    while (prefix < minSize && m_lines[prefix] == lines[prefix]) {
+        ++prefix;
+    }
+
+    int suffix = 0;
+    while (suffix < minSize - prefix
+           && m_lines[m_lines.size() - 1 - suffix] == lines[lines.size() - 1 - suffix]) {
+        ++suffix;
+    }
+
+    const int removedLines = m_lines.size() - prefix - suffix;
+    const int addedLines = lines.size() - prefix - suffix;
+    if (removedLines == 0 && addedLines == 0) {
+        return;
+    }
+
+    if (addedLines >= lines.size() / 2) {
+        // Not worth a patch.
+        m_lines = lines;
+        startRender();
+        emit textUpdated(p_text);
+        return;
+    }
+
+    startRender();
+    emit textPatched(prefix, removedLines, lines.mid(prefix, addedLines));
+    m_lines = lines;
+}
+
+void MarkdownViewerAdapter::startRender()
+{
+    m_renderOngoing = true;
+    m_renderWatchdogTimer->start(qMax(c_renderTimeout, m_renderTime * 4));
+}
+
+void MarkdownViewerAdapter::resendFullText()
+{
+    QString text;
+    if (m_hasPendingText) {
+        text = m_pendingText;
+        m_pendingText.clear();
+        m_hasPendingText = false;
+    } else {
+        text = m_lines.join(QLatin1Char('\n'));
+    }
+
+    m_lines.clear();
+    m_renderOngoing = false;
+    m_renderWatchdogTimer->stop();
+    updateText(text);
+}
+
 void MarkdownViewerAdapter::setText(const QString &p_text, int p_lineNumber)
 {
     setText(0, p_text, p_lineNumber);
@@ -173,18 +256,23 @@ bool MarkdownViewerAdapter::isViewerReady() const
     return m_viewerReady;
 }
 
-void MarkdownViewerAdapter::setMathPreviewData(quint64 p_id,
-                                               quint64 p_timeStamp,
-                                               const QString &p_format,
-                                               const QString &p_data,
-                                               bool p_base64,
-                                               bool p_needScale)
+void MarkdownViewerAdapter::setMathPreviewData(quint64 p_timeStamp, const QJsonArray &p_data)
 {
-    auto ba = p_data.toUtf8();
-    if (p_base64 && !ba.isEmpty()) {
-        ba = QByteArray::fromBase64(ba);
+    QVector<PreviewData> data;
+    data.reserve(p_data.size());
+    for (const auto &ele : p_data) {
+        const auto obj = ele.toObject();
+        auto ba = obj[QStringLiteral("data")].toString().toUtf8();
+        if (obj[QStringLiteral("base64")].toBool() && !ba.isEmpty()) {
+            ba = QByteArray::fromBase64(ba);
+        }
+        data.push_back(PreviewData(static_cast<quint64>(obj[QStringLiteral("id")].toDouble()),
+                                   p_timeStamp,
+                                   obj[QStringLiteral("format")].toString(),
+                                   ba,
+                                   obj[QStringLiteral("needScale")].toBool()));
     }
-    emit mathPreviewDataReady(PreviewData(p_id, p_timeStamp, p_format, ba, p_needScale));
+    emit mathPreviewDataReady(p_timeStamp, data);
 }
 
 void MarkdownViewerAdapter::setHeadings(const QJsonArray &p_headings)
@@ -339,9 +427,35 @@ void MarkdownViewerAdapter::setFindText(const QStringList &p_texts, int p_totalM
     emit findTextReady(p_texts, p_totalMatches, p_currentMatchIndex);
 }
 
-void MarkdownViewerAdapter::setWorkFinished()
+void MarkdownViewerAdapter::setWorkFinished(int p_renderTime)
 {
+    if (p_renderTime < 0) {
+        qWarning() << "web side failed to handle the text update, resend the full text";
+        resendFullText();
+        return;
+    }
+
+    if (m_renderOngoing) {
+        m_renderOngoing = false;
+        m_renderWatchdogTimer->stop();
+
+        // Exponential moving average to smooth out the spikes.
+        m_renderTime = m_renderTime < 0 ? p_renderTime : (m_renderTime * 3 + p_renderTime) / 4;
+    }
+
     emit workFinished();
+
+    if (m_hasPendingText) {
+        m_hasPendingText = false;
+        auto text = m_pendingText;
+        m_pendingText.clear();
+        updateText(text);
+    }
+}
+
+int MarkdownViewerAdapter::getRenderTime() const
+{
+    return m_renderTime;
 }
 
 void MarkdownViewerAdapter::saveContent()
@@ -357,9 +471,35 @@ void MarkdownViewerAdapter::setSavedContent(const QString &p_headContent,
     emit contentReady(p_headContent, p_styleContent, p_content, p_bodyClassList);
 }
 
+void MarkdownViewerAdapter::showSnapshot(const QString &p_html)
+{
+    if (m_viewerReady) {
+        emit snapshotShowRequested(p_html);
+    } else {
+        m_pendingActions.append([this, p_html]() {
+            emit snapshotShowRequested(p_html);
+        });
+    }
+}
+
+void MarkdownViewerAdapter::requestSnapshot()
+{
+    emit snapshotRequested();
+}
+
+void MarkdownViewerAdapter::setSnapshot(const QString &p_html)
+{
+    emit snapshotReady(p_html);
+}
+
 void MarkdownViewerAdapter::reset()
 {
     m_revision = 0;
+    m_lines.clear();
+    m_renderOngoing = false;
+    m_renderWatchdogTimer->stop();
+    m_pendingText.clear();
+    m_hasPendingText = false;
     m_viewerReady = false;
     m_pendingActions.clear();
     m_topLineNumber = -1;
@@ -368,6 +508,23 @@ void MarkdownViewerAdapter::reset()
     m_crossCopyTargets.clear();
 }
 
+void MarkdownViewerAdapter::handleLoadFinished()
+{
+    if (!m_renderOngoing) {
+        return;
+    }
+
+    // The render in flight is lost with the old page.
+    m_renderOngoing = false;
+    m_renderWatchdogTimer->stop();
+    if (m_viewerReady && m_hasPendingText) {
+        m_hasPendingText = false;
+        auto text = m_pendingText;
+        m_pendingText.clear();
+        updateText(text);
+    }
+}
+
 void MarkdownViewerAdapter::renderGraph(quint64 p_id,
                                         quint64 p_index,
                                         const QString &p_format,
@@ -6,9 +6,12 @@
 #include <QJsonObject>
 #include <QScopedPointer>
 #include <QJsonArray>
+#include <QStringList>
 
 #include <core/global.h>
 
+class QTimer;
+
 namespace vnotex
 {
     // Adapter and interface between CPP and JS.
@@ -96,6 +99,9 @@ namespace vnotex
 
         bool isViewerReady() const;
 
+        // Smoothed time in ms web side takes to render a text update. -1 if unknown.
+        int getRenderTime() const;
+
         const QVector<MarkdownViewerAdapter::Heading> &getHeadings() const;
         int getCurrentHeadingIndex() const;
 
@@ -111,14 +117,26 @@ namespace vnotex
 
         void saveContent();
 
+        // Show @p_html rendered before until the first render round finishes.
+        // Should be called before setText().
+        void showSnapshot(const QString &p_html);
+
+        // Fetch the rendered HTML of the content. snapshotReady() will be emitted.
+        void requestSnapshot();
+
         // Should be called before WebViewer.setHtml().
         void reset();
 
+        // Called once the page finishes loading, which drops any render in flight.
+        void handleLoadFinished();
+
         // Functions to be called from web side.
     public slots:
         void setReady(bool p_ready);
 
-        void setWorkFinished();
+        // @p_renderTime: time in ms taken by web side to finish the render round.
+        // -1 if web side fails to handle the text update and needs the full text.
+        void setWorkFinished(int p_renderTime);
 
         // The line number at the top.
         void setTopLineNumber(int p_lineNumber);
@@ -131,13 +149,9 @@ namespace vnotex
                                  bool p_base64 = false,
                                  bool p_needScale = false);
 
-        // Web sets back the preview result.
-        void setMathPreviewData(quint64 p_id,
-                                quint64 p_timeStamp,
-                                const QString &p_format,
-                                const QString &p_data,
-                                bool p_base64 = false,
-                                bool p_needScale = false);
+        // Web sets back the preview results of a batch of math.
+        // @p_data: array of {id, format, data, base64, needScale}.
+        void setMathPreviewData(quint64 p_timeStamp, const QJsonArray &p_data);
 
         // Set the headings.
         void setHeadings(const QJsonArray &p_headings);
@@ -160,6 +174,8 @@ namespace vnotex
 
         void setSavedContent(const QString &p_headContent, const QString &p_styleContent, const QString &p_content, const QString &p_bodyClassList);
 
+        void setSnapshot(const QString &p_html);
+
         // Call local CPP code to render graph.
         void renderGraph(quint64 p_id,
                          quint64 p_index,
@@ -172,6 +188,11 @@ namespace vnotex
         // Current Markdown text is updated.
         void textUpdated(const QString &p_text);
 
+        // Current Markdown text is updated by replacing @p_removedLines lines starting
+        // from line @p_lineNumber (0-based) with @p_lines.
+        // Sent instead of textUpdated() when only part of the text changed.
+        void textPatched(int p_lineNumber, int p_removedLines, const QStringList &p_lines);
+
         // Current editor line number is updated.
         void editLineNumberUpdated(int p_lineNumber);
 
@@ -181,10 +202,9 @@ namespace vnotex
                                    const QString &p_lang,
                                    const QString &p_text);
 
-        // Request to preview math.
-        void mathPreviewRequested(quint64 p_id,
-                                  quint64 p_timeStamp,
-                                  const QString &p_text);
+        // Request to preview a batch of math in one round trip.
+        // @p_items: array of {id, text}.
+        void mathPreviewRequested(quint64 p_timeStamp, const QJsonArray &p_items);
 
         void anchorScrollRequested(const QString &p_anchor);
 
@@ -203,6 +223,12 @@ namespace vnotex
         // Request to get the whole HTML content.
         void contentRequested();
 
+        // Request to show a snapshot of the rendered HTML until the first render finishes.
+        void snapshotShowRequested(const QString &p_html);
+
+        // Request to get the rendered HTML of the content.
+        void snapshotRequested();
+
         void graphRenderDataReady(quint64 p_id,
                                   quint64 p_index,
                                   const QString &p_format,
@@ -212,7 +238,7 @@ namespace vnotex
     signals:
         void graphPreviewDataReady(const PreviewData &p_data);
 
-        void mathPreviewDataReady(const PreviewData &p_data);
+        void mathPreviewDataReady(quint64 p_timeStamp, const QVector<PreviewData> &p_data);
 
         void viewerReady();
 
@@ -238,13 +264,40 @@ namespace vnotex
                           const QString &p_content,
                           const QString &p_bodyClassList);
 
+        void snapshotReady(const QString &p_html);
+
     private:
         void scrollToLine(int p_lineNumber);
 
         void scrollToAnchor(const QString &p_anchor);
 
+        // Send @p_text to web side as a whole or as a patch against the last sent text.
+        void updateText(const QString &p_text);
+
+        void startRender();
+
+        // Send the latest text as a whole since web side may lose track of it.
+        void resendFullText();
+
         int m_revision = 0;
 
+        // Lines of the text last sent to web side. Empty if web side has no text yet.
+        QStringList m_lines;
+
+        // Whether web side is rendering a text update.
+        // Text updates are held back until it finishes.
+        bool m_renderOngoing = false;
+
+        // Latest text held back by an ongoing render.
+        QString m_pendingText;
+
+        bool m_hasPendingText = false;
+
+        // Fire if web side does not finish a render in time, such as when it is lost.
+        QTimer *m_renderWatchdogTimer = nullptr;
+
+        int m_renderTime = -1;
+
         // Whether web side viewer is ready to handle text update.
         bool m_viewerReady = false;
 
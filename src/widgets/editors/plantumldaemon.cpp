@@ -0,0 +1,277 @@
+#include "plantumldaemon.h"
+
+#include <QDebug>
+#include <QTimer>
+#include <QCoreApplication>
+
+using namespace vnotex;
+
+const QByteArray PlantUmlDaemon::c_delimiter = "VNOTE_PLANTUML_DAEMON_DELIMITER";
+
+// Stop the process after being idle for 5 minutes.
+static const int c_idleTimeout = 5 * 60 * 1000;
+
+// Time limit of one request, including the JVM startup.
+static const int c_requestTimeout = 60 * 1000;
+
+// Time to wait for the process to exit on quit.
+static const int c_shutdownTimeout = 3000;
+
+PlantUmlDaemon::PlantUmlDaemon(const QString &p_program,
+                               const QStringList &p_args,
+                               QObject *p_parent)
+    : QObject(p_parent),
+      m_program(p_program),
+      m_args(p_args)
+{
+    m_idleTimer = new QTimer(this);
+    m_idleTimer->setSingleShot(true);
+    m_idleTimer->setInterval(c_idleTimeout);
+    connect(m_idleTimer, &QTimer::timeout,
+            this, [this]() {
+                qDebug() << "stop idle PlantUML daemon";
+                stop();
+            });
+
+    m_requestTimer = new QTimer(this);
+    m_requestTimer->setSingleShot(true);
+    m_requestTimer->setInterval(c_requestTimeout);
+    connect(m_requestTimer, &QTimer::timeout,
+            this, [this]() {
+                qWarning() << "PlantUML daemon timed out with pending requests" << m_requests.size();
+                killAndFail();
+            });
+
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
+                this, &PlantUmlDaemon::shutdown);
+    }
+}
+
+PlantUmlDaemon::~PlantUmlDaemon()
+{
+    shutdown();
+}
+
+QStringList PlantUmlDaemon::getDelimiterArgs()
+{
+    return QStringList() << "-pipedelimitor" << QString::fromLatin1(c_delimiter);
+}
+
+void PlantUmlDaemon::render(const QString &p_text, const ResultCallback &p_callback)
+{
+    m_idleTimer->stop();
+
+    if (!m_process) {
+        start();
+    }
+
+    Request req;
+    req.m_data = wrapText(p_text);
+    req.m_callback = p_callback;
+    if (m_requests.isEmpty()) {
+        m_requestTimer->start();
+    }
+    m_requests.enqueue(req);
+    send(req);
+}
+
+void PlantUmlDaemon::start()
+{
+    Q_ASSERT(!m_process);
+    qDebug() << "start PlantUML daemon" << m_program << m_args;
+
+    m_output.clear();
+
+    m_process = new QProcess(this);
+    connect(m_process, &QProcess::readyReadStandardOutput,
+            this, &PlantUmlDaemon::handleOutput);
+    connect(m_process, &QProcess::readyReadStandardError,
+            this, [this]() {
+                qDebug() << "PlantUML daemon stderr:" << QString::fromLocal8Bit(m_process->readAllStandardError());
+            });
+    connect(m_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, &PlantUmlDaemon::handleFinished);
+    // finished() will not be emitted if it fails to start.
+    connect(m_process, &QProcess::errorOccurred,
+            this, [this](QProcess::ProcessError p_error) {
+                if (p_error == QProcess::FailedToStart) {
+                    handleFinished(-1, QProcess::CrashExit);
+                }
+            },
+            Qt::QueuedConnection);
+
+    m_process->start(m_program, m_args);
+}
+
+void PlantUmlDaemon::stop()
+{
+    m_idleTimer->stop();
+
+    if (!m_process) {
+        return;
+    }
+
+    // Let it exit on EOF of stdin.
+    m_process->disconnect(this);
+    connect(m_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            m_process, &QObject::deleteLater);
+    m_process->closeWriteChannel();
+    m_process = nullptr;
+    m_output.clear();
+}
+
+void PlantUmlDaemon::shutdown()
+{
+    m_idleTimer->stop();
+    m_requestTimer->stop();
+    m_requests.clear();
+
+    if (!m_process) {
+        return;
+    }
+
+    m_process->disconnect(this);
+    m_process->closeWriteChannel();
+    if (!m_process->waitForFinished(c_shutdownTimeout)) {
+        qWarning() << "kill PlantUML daemon which does not exit in time";
+        m_process->kill();
+        m_process->waitForFinished(c_shutdownTimeout);
+    }
+
+    delete m_process;
+    m_process = nullptr;
+    m_output.clear();
+}
+
+void PlantUmlDaemon::killAndFail()
+{
+    if (m_process) {
+        m_process->disconnect(this);
+        connect(m_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+                m_process, &QObject::deleteLater);
+        m_process->kill();
+        m_process = nullptr;
+        m_output.clear();
+    }
+
+    abort();
+}
+
+void PlantUmlDaemon::abort()
+{
+    stop();
+    m_requestTimer->stop();
+
+    auto requests = m_requests;
+    m_requests.clear();
+    for (const auto &req : requests) {
+        req.m_callback(false, QByteArray());
+    }
+}
+
+void PlantUmlDaemon::send(const Request &p_request)
+{
+    if (m_process->write(p_request.m_data) == -1) {
+        qWarning() << "failed to write to PlantUML daemon:" << m_process->errorString();
+    }
+}
+
+void PlantUmlDaemon::handleOutput()
+{
+    m_output += m_process->readAllStandardOutput();
+
+    while (true) {
+        int idx = m_output.indexOf(c_delimiter);
+        if (idx == -1) {
+            break;
+        }
+
+        auto data = m_output.left(idx);
+
+        // Skip the delimiter line.
+        idx += c_delimiter.size();
+        while (idx < m_output.size() && (m_output[idx] == '\r' || m_output[idx] == '\n')) {
+            ++idx;
+        }
+        m_output.remove(0, idx);
+
+        finishHeadRequest(true, data);
+    }
+}
+
+void PlantUmlDaemon::finishHeadRequest(bool p_succeeded, const QByteArray &p_output)
+{
+    if (m_requests.isEmpty()) {
+        qWarning() << "PlantUML daemon has output without request" << p_output.size();
+        return;
+    }
+
+    const auto req = m_requests.dequeue();
+    if (m_requests.isEmpty()) {
+        m_requestTimer->stop();
+        m_idleTimer->start();
+    } else {
+        m_requestTimer->start();
+    }
+
+    // Callback may send new requests.
+    req.m_callback(p_succeeded, p_output);
+}
+
+void PlantUmlDaemon::handleFinished(int p_exitCode, QProcess::ExitStatus p_exitStatus)
+{
+    if (!m_process) {
+        return;
+    }
+
+    handleOutput();
+
+    qWarning() << "PlantUML daemon exited" << p_exitCode << p_exitStatus << "with pending requests" << m_requests.size();
+
+    m_process->deleteLater();
+    m_process = nullptr;
+    m_output.clear();
+    m_requestTimer->stop();
+
+    if (m_requests.isEmpty()) {
+        return;
+    }
+
+    // The head one may crash the process. Fail it and restart for the others once.
+    QVector<Request> failedRequests;
+    QQueue<Request> requestsToResend;
+    for (int i = 0; i < m_requests.size(); ++i) {
+        auto req = m_requests[i];
+        if (i == 0 || req.m_resent) {
+            failedRequests.push_back(req);
+        } else {
+            req.m_resent = true;
+            requestsToResend.enqueue(req);
+        }
+    }
+    m_requests.clear();
+
+    if (!requestsToResend.isEmpty()) {
+        start();
+        m_requestTimer->start();
+        for (const auto &req : requestsToResend) {
+            m_requests.enqueue(req);
+            send(req);
+        }
+    }
+
+    for (const auto &req : failedRequests) {
+        req.m_callback(false, QByteArray());
+    }
+}
+
+QByteArray PlantUmlDaemon::wrapText(const QString &p_text)
+{
+    auto text = p_text.trimmed();
+    if (!text.startsWith(QStringLiteral("@start"))) {
+        text = QStringLiteral("@startuml\n") + text + QStringLiteral("\n@enduml");
+    }
+    text += QLatin1Char('\n');
+    return text.toUtf8();
+}
@@ -0,0 +1,97 @@
+#ifndef PLANTUMLDAEMON_H
+#define PLANTUMLDAEMON_H
+
+#include <QObject>
+#include <QProcess>
+#include <QQueue>
+#include <QStringList>
+#include <QByteArray>
+
+#include <functional>
+
+class QTimer;
+
+namespace vnotex
+{
+    // A long-lived PlantUML process in pipe mode rendering diagrams in one format.
+    // Diagrams are fed via stdin one after another and results are separated by a delimiter
+    // in stdout, so that the JVM startup is paid only once.
+    class PlantUmlDaemon : public QObject
+    {
+        Q_OBJECT
+    public:
+        typedef std::function<void(bool, const QByteArray &)> ResultCallback;
+
+        // @p_program and @p_args: command to start PlantUML in pipe mode, including
+        // the format and getDelimiterArgs().
+        PlantUmlDaemon(const QString &p_program,
+                       const QStringList &p_args,
+                       QObject *p_parent = nullptr);
+
+        ~PlantUmlDaemon();
+
+        // Render @p_text. @p_callback will be called later with the result.
+        void render(const QString &p_text, const ResultCallback &p_callback);
+
+        // Stop the process and fail all the requests.
+        void abort();
+
+        // Arguments to let PlantUML output the delimiter after each diagram.
+        static QStringList getDelimiterArgs();
+
+    private:
+        struct Request
+        {
+            QByteArray m_data;
+
+            ResultCallback m_callback;
+
+            // Whether it has been re-sent after a crash.
+            bool m_resent = false;
+        };
+
+        void start();
+
+        // Stop the process. It will be started again on next request.
+        void stop();
+
+        // Stop the process and wait for it to exit, dropping all the requests.
+        // Used on quit to avoid leaving the JVM behind.
+        void shutdown();
+
+        // Kill the process and fail all the requests, such as when it hangs.
+        void killAndFail();
+
+        void send(const Request &p_request);
+
+        void handleOutput();
+
+        void handleFinished(int p_exitCode, QProcess::ExitStatus p_exitStatus);
+
+        void finishHeadRequest(bool p_succeeded, const QByteArray &p_output);
+
+        static QByteArray wrapText(const QString &p_text);
+
+        QString m_program;
+
+        QStringList m_args;
+
+        QProcess *m_process = nullptr;
+
+        // Requests sent and waiting for output, in the order of sending.
+        QQueue<Request> m_requests;
+
+        // Output read but not consumed yet.
+        QByteArray m_output;
+
+        // Stop the process when there is no request for a while.
+        QTimer *m_idleTimer = nullptr;
+
+        // Kill the process if the head request is not finished in time.
+        QTimer *m_requestTimer = nullptr;
+
+        static const QByteArray c_delimiter;
+    };
+}
+
+#endif // PLANTUMLDAEMON_H
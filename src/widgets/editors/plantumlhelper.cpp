@@ -2,6 +2,7 @@
 
 #include <QDebug>
 #include <QDir>
+#include <QRegularExpression>
 
 #include <utils/processutils.h>
 #include <utils/pathutils.h>
@@ -9,6 +10,8 @@
 #include <core/editorconfig.h>
 #include <core/markdowneditorconfig.h>
 
+#include "plantumldaemon.h"
+
 using namespace vnotex;
 
 PlantUmlHelper &PlantUmlHelper::getInst()
@@ -29,6 +32,10 @@ void PlantUmlHelper::update(const QString &p_plantUmlJarFile,
                             const QString &p_graphvizFile,
                             const QString &p_overriddenCommand)
 {
+    const auto oldProgram = m_program;
+    const auto oldArgs = m_args;
+    const auto oldOverriddenCommand = m_overriddenCommand;
+
     m_overriddenCommand = p_overriddenCommand;
     if (m_overriddenCommand.isEmpty()) {
         prepareProgramAndArgs(p_plantUmlJarFile, p_graphvizFile, m_program, m_args);
@@ -40,6 +47,18 @@ void PlantUmlHelper::update(const QString &p_plantUmlJarFile,
     checkValidProgram();
 
     clearCache();
+
+    // Called on any change of editor config. Keep the warm daemons unless the command changes.
+    if (m_program == oldProgram && m_args == oldArgs && m_overriddenCommand == oldOverriddenCommand) {
+        return;
+    }
+
+    // Fail requests of daemons with the old command.
+    auto daemons = m_daemons;
+    m_daemons.clear();
+    for (auto &daemon : daemons) {
+        daemon->abort();
+    }
 }
 
 void PlantUmlHelper::prepareProgramAndArgs(const QString &p_plantUmlJarFile,
@@ -109,3 +128,46 @@ QStringList PlantUmlHelper::getFormatArgs(const QString &p_format)
     args << ("-t" + p_format);
     return args;
 }
+
+bool PlantUmlHelper::renderByDaemon(const QString &p_format, const QString &p_text)
+{
+    // Overridden command may not support pipe delimiter.
+    if (!m_overriddenCommand.isEmpty() || !isSingleDiagram(p_text)) {
+        return false;
+    }
+
+    auto &daemon = m_daemons[p_format];
+    if (!daemon) {
+        QStringList args(m_args);
+        args << getFormatArgs(p_format) << PlantUmlDaemon::getDelimiterArgs();
+        daemon.reset(new PlantUmlDaemon(m_program, getArgsToUse(args)));
+    }
+
+    daemon->render(p_text, [this, p_format, p_text](bool p_succeeded, const QByteArray &p_output) {
+        finishRendering(p_format, p_text, p_succeeded, p_output);
+    });
+    return true;
+}
+
+bool PlantUmlHelper::isSingleDiagram(const QString &p_text)
+{
+    static const QRegularExpression startRegExp(QStringLiteral("^\\s*@start"), QRegularExpression::MultilineOption);
+    static const QRegularExpression endRegExp(QStringLiteral("^\\s*@end"), QRegularExpression::MultilineOption);
+
+    int numOfStart = 0;
+    auto it = startRegExp.globalMatch(p_text);
+    while (it.hasNext()) {
+        it.next();
+        ++numOfStart;
+    }
+
+    int numOfEnd = 0;
+    it = endRegExp.globalMatch(p_text);
+    while (it.hasNext()) {
+        it.next();
+        ++numOfEnd;
+    }
+
+    // Text without @start will be wrapped by daemon.
+    return numOfStart == numOfEnd && numOfStart <= 1;
+}
@@ -3,8 +3,13 @@
 
 #include "graphhelper.h"
 
+#include <QMap>
+#include <QSharedPointer>
+
 namespace vnotex
 {
+    class PlantUmlDaemon;
+
     class PlantUmlHelper : public GraphHelper
     {
     public:
@@ -21,10 +26,18 @@ namespace vnotex
 
         QStringList getFormatArgs(const QString &p_format) Q_DECL_OVERRIDE;
 
+        bool renderByDaemon(const QString &p_format, const QString &p_text) Q_DECL_OVERRIDE;
+
         static void prepareProgramAndArgs(const QString &p_plantUmlJarFile,
                                           const QString &p_graphvizFile,
                                           QString &p_program,
                                           QStringList &p_args);
+
+        // Whether @p_text contains exactly one diagram, which is required by daemon.
+        static bool isSingleDiagram(const QString &p_text);
+
+        // {format} -> daemon.
+        QMap<QString, QSharedPointer<PlantUmlDaemon>> m_daemons;
     };
 }
 
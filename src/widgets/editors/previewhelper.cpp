@@ -4,16 +4,17 @@
 #include <QTextDocument>
 #include <QTextBlock>
 #include <QTimer>
+#include <QJsonArray>
+#include <QJsonObject>
 
 #include <vtextedit/texteditorconfig.h>
 #include <vtextedit/previewmgr.h>
 #include <vtextedit/textutils.h>
 
-#include <utils/utils.h>
-
 #include "markdowneditor.h"
 #include "plantumlhelper.h"
 #include "graphvizhelper.h"
+#include "previewimagecache.h"
 
 using namespace vnotex;
 
@@ -76,41 +77,6 @@ void PreviewHelper::MathBlockPreviewData::updateInplacePreview(QTextDocument *p_
     }
 }
 
-int PreviewHelper::GraphPreviewData::s_imageIndex = 0;
-
-PreviewHelper::GraphPreviewData::GraphPreviewData(TimeStamp p_timeStamp,
-                                                  const QString &p_format,
-                                                  const QByteArray &p_data,
-                                                  QRgb p_background,
-                                                  qreal p_scaleFactor)
-    : m_timeStamp(p_timeStamp),
-      m_background(p_background)
-{
-    if (p_data.isEmpty()) {
-        return;
-    }
-
-    m_name = QString::number(++s_imageIndex);
-
-    bool needScale = p_scaleFactor > 1.01;
-    if (needScale) {
-        if (p_format == QStringLiteral("svg")) {
-            m_image = Utils::svgToPixmap(p_data, p_background, p_scaleFactor);
-        } else {
-            QPixmap tmpImg;
-            tmpImg.loadFromData(p_data, p_format.toLocal8Bit().data());
-            m_image = tmpImg.scaledToWidth(tmpImg.width() * p_scaleFactor, Qt::SmoothTransformation);
-        }
-    } else {
-        m_image.loadFromData(p_data, p_format.toLocal8Bit().data());
-    }
-}
-
-bool PreviewHelper::GraphPreviewData::isNull() const
-{
-    return m_timeStamp == 0;
-}
-
 PreviewHelper::PreviewHelper(MarkdownEditor *p_editor, QObject *p_parent)
     : QObject(p_parent),
       m_inplacePreviewSources(SourceFlag::FlowChart
@@ -118,9 +84,7 @@ PreviewHelper::PreviewHelper(MarkdownEditor *p_editor, QObject *p_parent)
                               | SourceFlag::WaveDrom
                               | SourceFlag::PlantUml
                               | SourceFlag::Graphviz
-                              | SourceFlag::Math),
-      m_codeBlockCache(100, nullptr),
-      m_mathBlockCache(100, nullptr)
+                              | SourceFlag::Math)
 {
     setMarkdownEditor(p_editor);
 
@@ -155,6 +119,14 @@ void PreviewHelper::handleCodeBlocksUpdate()
     ++m_codeBlockTimeStamp;
     m_codeBlocksData.clear();
 
+    // Local renderings of previous code blocks are obsolete.
+    if (!m_webPlantUmlEnabled) {
+        PlantUmlHelper::getInst().cancel(this, m_codeBlockTimeStamp);
+    }
+    if (!m_webGraphvizEnabled) {
+        GraphvizHelper::getInst().cancel(this, m_codeBlockTimeStamp);
+    }
+
     QVector<int> needPreviewBlocks;
 
     for (int i = 0; i < m_pendingCodeBlocks.size(); ++i) {
@@ -169,14 +141,16 @@ void PreviewHelper::handleCodeBlocksUpdate()
         const int blockPreviewIdx = m_codeBlocksData.size() - 1;
 
         bool cacheHit = false;
-        auto &cachedData = m_codeBlockCache.get(cb.m_text);
-        if (cachedData) {
+        const auto background = getCodeBlockBackground(cb.m_lang);
+        const auto cachedImage = PreviewImageCache::getInst().get(codeBlockCacheKey(cb.m_text),
+                                                                  background,
+                                                                  getEditorScaleFactor());
+        if (!cachedImage.isNull()) {
             cacheHit = true;
-            cachedData->m_timeStamp = m_codeBlockTimeStamp;
             m_codeBlocksData[blockPreviewIdx].updateInplacePreview(m_document,
-                                                                   cachedData->m_image,
-                                                                   cachedData->m_name,
-                                                                   cachedData->m_background,
+                                                                   cachedImage.m_image,
+                                                                   cachedImage.m_name,
+                                                                   background,
                                                                    m_tabStopWidth);
         }
 
@@ -294,19 +268,19 @@ void PreviewHelper::handleGraphPreviewData(const MarkdownViewerAdapter::PreviewD
     }
 
     auto &blockData = m_codeBlocksData[p_data.m_id];
-    const bool forcedBackground = needForcedBackground(blockData.m_lang);
-    auto previewData = QSharedPointer<GraphPreviewData>::create(p_data.m_timeStamp,
-                                                                p_data.m_format,
-                                                                p_data.m_data,
-                                                                forcedBackground ? m_editor->getPreviewBackground() : 0,
-                                                                p_data.m_needScale ? getEditorScaleFactor() : 1);
-    m_codeBlockCache.set(blockData.m_text, previewData);
+    const auto background = getCodeBlockBackground(blockData.m_lang);
+    const auto image = PreviewImageCache::getInst().set(codeBlockCacheKey(blockData.m_text),
+                                                        p_data.m_format,
+                                                        p_data.m_data,
+                                                        p_data.m_needScale,
+                                                        background,
+                                                        getEditorScaleFactor());
     blockData.m_text.clear();
 
     blockData.updateInplacePreview(m_document,
-                                   previewData->m_image,
-                                   previewData->m_name,
-                                   previewData->m_background,
+                                   image.m_image,
+                                   image.m_name,
+                                   background,
                                    m_tabStopWidth);
 
     updateEditorInplacePreviewCodeBlock();
@@ -340,8 +314,6 @@ void PreviewHelper::updateEditorInplacePreviewCodeBlock()
     if (!obsoleteBlocks.isEmpty()) {
         emit potentialObsoletePreviewBlocksUpdated(obsoleteBlocks.toList());
     }
-
-    m_codeBlockCache.setCapacityHint(m_codeBlocksData.size());
 }
 
 void PreviewHelper::setMarkdownEditor(MarkdownEditor *p_editor)
@@ -370,44 +342,44 @@ void PreviewHelper::handleMathBlocksUpdate()
     m_mathBlocksData.clear();
     m_mathBlocksData.reserve(m_pendingMathBlocks.size());
 
-    bool needUpdateEditorInplacePreview = true;
+    // Blocks missing in cache will be requested in one batch.
+    QJsonArray requestItems;
 
     for (const auto &mb : m_pendingMathBlocks) {
         m_mathBlocksData.append(MathBlockPreviewData(mb));
         const int blockPreviewIdx = m_mathBlocksData.size() - 1;
 
         bool cacheHit = false;
-        auto &cachedData = m_mathBlockCache.get(mb.m_text);
-        if (cachedData) {
+        const auto cachedImage = PreviewImageCache::getInst().get(mathBlockCacheKey(mb.m_text),
+                                                                  0,
+                                                                  getEditorScaleFactor());
+        if (!cachedImage.isNull()) {
             cacheHit = true;
-            cachedData->m_timeStamp = m_mathBlockTimeStamp;
             m_mathBlocksData[blockPreviewIdx].updateInplacePreview(m_document,
-                                                                   cachedData->m_image,
-                                                                   cachedData->m_name,
+                                                                   cachedImage.m_image,
+                                                                   cachedImage.m_name,
                                                                    m_tabStopWidth);
         }
 
         if (!cacheHit) {
-            needUpdateEditorInplacePreview = false;
             m_mathBlocksData[blockPreviewIdx].m_text = mb.m_text;
-            inplacePreviewMathBlock(blockPreviewIdx);
+
+            QJsonObject item;
+            item[QStringLiteral("id")] = blockPreviewIdx;
+            item[QStringLiteral("text")] = mb.m_text;
+            requestItems.append(item);
         }
     }
 
-    if (needUpdateEditorInplacePreview) {
+    if (requestItems.isEmpty()) {
         updateEditorInplacePreviewMathBlock();
+    } else {
+        emit mathPreviewRequested(m_mathBlockTimeStamp, requestItems);
     }
 
     m_pendingMathBlocks.clear();
 }
 
-void PreviewHelper::inplacePreviewMathBlock(int p_blockPreviewIdx)
-{
-    const auto &blockData = m_mathBlocksData[p_blockPreviewIdx];
-    Q_ASSERT(!blockData.m_text.isEmpty());
-    emit mathPreviewRequested(p_blockPreviewIdx, m_mathBlockTimeStamp, blockData.m_text);
-}
-
 void PreviewHelper::updateEditorInplacePreviewMathBlock()
 {
     QSet<int> obsoleteBlocks;
@@ -436,35 +408,81 @@ void PreviewHelper::updateEditorInplacePreviewMathBlock()
     if (!obsoleteBlocks.isEmpty()) {
         emit potentialObsoletePreviewBlocksUpdated(obsoleteBlocks.toList());
     }
-
-    m_mathBlockCache.setCapacityHint(m_mathBlocksData.size());
 }
 
-void PreviewHelper::handleMathPreviewData(const MarkdownViewerAdapter::PreviewData &p_data)
+void PreviewHelper::handleMathPreviewData(TimeStamp p_timeStamp,
+                                          const QVector<MarkdownViewerAdapter::PreviewData> &p_data)
 {
-    if (p_data.m_timeStamp != m_mathBlockTimeStamp) {
+    if (p_timeStamp != m_mathBlockTimeStamp) {
         return;
     }
-    if (p_data.m_id >= static_cast<quint64>(m_mathBlocksData.size()) || p_data.m_data.isEmpty()) {
+
+    QVector<PreviewImageDecoder::Item> items;
+    items.reserve(p_data.size());
+    const auto scaleFactor = getEditorScaleFactor();
+    for (const auto &data : p_data) {
+        if (data.m_id >= static_cast<quint64>(m_mathBlocksData.size()) || data.m_data.isEmpty()) {
+            continue;
+        }
+
+        const auto &blockData = m_mathBlocksData[data.m_id];
+        if (blockData.m_text.isEmpty()) {
+            continue;
+        }
+
+        PreviewImageDecoder::Item item;
+        item.m_id = data.m_id;
+        item.m_key = mathBlockCacheKey(blockData.m_text);
+        item.m_format = data.m_format;
+        item.m_data = data.m_data;
+        item.m_needScale = data.m_needScale;
+        item.m_scaleFactor = scaleFactor;
+        items.push_back(item);
+    }
+
+    if (items.isEmpty()) {
         updateEditorInplacePreviewMathBlock();
         return;
     }
 
-    auto &blockData = m_mathBlocksData[p_data.m_id];
-    auto previewData = QSharedPointer<GraphPreviewData>::create(p_data.m_timeStamp,
-                                                                p_data.m_format,
-                                                                p_data.m_data,
-                                                                0,
-                                                                p_data.m_needScale ? getEditorScaleFactor() : 1);
-    m_mathBlockCache.set(blockData.m_text, previewData);
-    blockData.m_text.clear();
+    // Decode the images off the GUI thread.
+    auto decoder = new PreviewImageDecoder(items, this);
+    connect(decoder, &QThread::finished,
+            this, [this, decoder, p_timeStamp]() {
+                handleDecodedMathPreviewData(p_timeStamp, decoder->getItems());
+                decoder->deleteLater();
+            });
+    decoder->start();
+}
 
-    blockData.updateInplacePreview(m_document,
-                                   previewData->m_image,
-                                   previewData->m_name,
-                                   m_tabStopWidth);
+void PreviewHelper::handleDecodedMathPreviewData(TimeStamp p_timeStamp,
+                                                 const QVector<PreviewImageDecoder::Item> &p_items)
+{
+    // Fill the cache even if it is obsolete since the blocks are likely to come back.
+    const bool obsolete = p_timeStamp != m_mathBlockTimeStamp;
+    for (const auto &item : p_items) {
+        const auto image = PreviewImageCache::getInst().set(item.m_key,
+                                                            item.m_format,
+                                                            item.m_data,
+                                                            item.m_needScale,
+                                                            item.m_background,
+                                                            item.m_scaleFactor,
+                                                            item.m_image);
+        if (obsolete) {
+            continue;
+        }
+
+        auto &blockData = m_mathBlocksData[item.m_id];
+        blockData.m_text.clear();
+        blockData.updateInplacePreview(m_document,
+                                       image.m_image,
+                                       image.m_name,
+                                       m_tabStopWidth);
+    }
 
-    updateEditorInplacePreviewMathBlock();
+    if (!obsolete) {
+        updateEditorInplacePreviewMathBlock();
+    }
 }
 
 qreal PreviewHelper::getEditorScaleFactor() const
@@ -505,18 +523,19 @@ void PreviewHelper::handleLocalData(quint64 p_id,
     }
 
     auto &blockData = m_codeBlocksData[p_id];
-    auto previewData = QSharedPointer<GraphPreviewData>::create(p_timeStamp,
-                                                                p_format,
-                                                                p_data.toUtf8(),
-                                                                p_forcedBackground ? m_editor->getPreviewBackground() : 0,
-                                                                getEditorScaleFactor());
-    m_codeBlockCache.set(blockData.m_text, previewData);
+    const QRgb background = p_forcedBackground ? m_editor->getPreviewBackground() : 0;
+    const auto image = PreviewImageCache::getInst().set(codeBlockCacheKey(blockData.m_text),
+                                                        p_format,
+                                                        p_data.toUtf8(),
+                                                        true,
+                                                        background,
+                                                        getEditorScaleFactor());
     blockData.m_text.clear();
 
     blockData.updateInplacePreview(m_document,
-                                   previewData->m_image,
-                                   previewData->m_name,
-                                   previewData->m_background,
+                                   image.m_image,
+                                   image.m_name,
+                                   background,
                                    m_tabStopWidth);
 
     updateEditorInplacePreviewCodeBlock();
@@ -531,6 +550,21 @@ bool PreviewHelper::needForcedBackground(const QString &p_lang) const
     return false;
 }
 
+QRgb PreviewHelper::getCodeBlockBackground(const QString &p_lang) const
+{
+    return needForcedBackground(p_lang) ? m_editor->getPreviewBackground() : 0;
+}
+
+QString PreviewHelper::codeBlockCacheKey(const QString &p_text)
+{
+    return QStringLiteral("code:") + p_text;
+}
+
+QString PreviewHelper::mathBlockCacheKey(const QString &p_text)
+{
+    return QStringLiteral("math:") + p_text;
+}
+
 void PreviewHelper::setInplacePreviewSources(SourceFlags p_srcs)
 {
     m_inplacePreviewSources = p_srcs;
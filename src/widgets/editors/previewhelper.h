@@ -5,11 +5,11 @@
 #include <QPixmap>
 
 #include <vtextedit/global.h>
-#include <vtextedit/lrucache.h>
 #include <vtextedit/pegmarkdownhighlighterdata.h>
 
 #include <core/global.h>
 #include "markdownvieweradapter.h"
+#include "previewimagedecoder.h"
 
 class QTimer;
 class QTextDocument;
@@ -61,7 +61,8 @@ namespace vnotex
 
         void handleGraphPreviewData(const MarkdownViewerAdapter::PreviewData &p_data);
 
-        void handleMathPreviewData(const MarkdownViewerAdapter::PreviewData &p_data);
+        void handleMathPreviewData(TimeStamp p_timeStamp,
+                                   const QVector<MarkdownViewerAdapter::PreviewData> &p_data);
 
     signals:
         // Request to preview graph.
@@ -71,11 +72,10 @@ namespace vnotex
                                    const QString &p_lang,
                                    const QString &p_text);
 
-        // Request to preview math.
+        // Request to preview a batch of math.
+        // @p_items: array of {id, text}.
         // There must be a corresponding call to handleMathPreviewData().
-        void mathPreviewRequested(quint64 p_id,
-                                  TimeStamp p_timeStamp,
-                                  const QString &p_text);
+        void mathPreviewRequested(TimeStamp p_timeStamp, const QJsonArray &p_items);
 
         // Request to do in-place preview for @p_previewItems.
         void inplacePreviewCodeBlockUpdated(const QVector<QSharedPointer<vte::PreviewItem>> &p_previewItems);
@@ -142,34 +142,6 @@ namespace vnotex
             QSharedPointer<vte::PreviewItem> m_inplacePreview;
         };
 
-        // Data of the preview result.
-        struct GraphPreviewData
-        {
-            GraphPreviewData() = default;
-
-            GraphPreviewData(TimeStamp p_timeStamp,
-                             const QString &p_format,
-                             const QByteArray &p_data,
-                             QRgb p_background = 0x0,
-                             qreal p_scaleFactor = 1);
-
-            bool isNull() const;
-
-            TimeStamp m_timeStamp = 0;
-
-            QPixmap m_image;
-
-            // Name of the image for identification in resource manager.
-            QString m_name;
-
-            // Background color to override.
-            // 0x0 indicates it is not specified.
-            QRgb m_background = 0x0;
-
-            // An increasing index to used as the image name.
-            static int s_imageIndex;
-        };
-
         // Return <InplacePreview, FocusPreview>.
         QPair<bool, bool> isLangNeedPreview(const QString &p_lang) const;
 
@@ -180,7 +152,9 @@ namespace vnotex
         // Inplace preview code block m_codeBlocksData[@p_blockPreviewIdx].
         void inplacePreviewCodeBlock(int p_blockPreviewIdx);
 
-        void inplacePreviewMathBlock(int p_blockPreviewIdx);
+        // Called when images of math blocks are decoded off the GUI thread.
+        void handleDecodedMathPreviewData(TimeStamp p_timeStamp,
+                                          const QVector<PreviewImageDecoder::Item> &p_items);
 
         void updateEditorInplacePreviewCodeBlock();
 
@@ -200,6 +174,13 @@ namespace vnotex
 
         void handleMathBlocksUpdate();
 
+        // Key in PreviewImageCache.
+        static QString codeBlockCacheKey(const QString &p_text);
+
+        static QString mathBlockCacheKey(const QString &p_text);
+
+        QRgb getCodeBlockBackground(const QString &p_lang) const;
+
         MarkdownEditor *m_editor = nullptr;
 
         QTextDocument *m_document = nullptr;
@@ -229,11 +210,6 @@ namespace vnotex
         // To record the size of previous inplace preview of math block.
         int m_previousInplacePreviewMathBlockSize = 0;
 
-        // {text} -> GraphPreviewData.
-        vte::LruCache<QString, QSharedPointer<GraphPreviewData>> m_codeBlockCache;
-
-        vte::LruCache<QString, QSharedPointer<GraphPreviewData>> m_mathBlockCache;
-
         bool m_webPlantUmlEnabled = true;
 
         bool m_webGraphvizEnabled = true;
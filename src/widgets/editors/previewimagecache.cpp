@@ -0,0 +1,275 @@
+#include "previewimagecache.h"
+
+#include <QVector>
+
+#include <algorithm>
+
+#include <core/configmgr.h>
+#include <core/editorconfig.h>
+#include <core/markdowneditorconfig.h>
+#include <utils/utils.h>
+
+using namespace vnotex;
+
+// Check images shared with editors at least once every so many evict() calls.
+static const int c_sharedCheckInterval = 64;
+
+bool PreviewImageCache::Image::isNull() const
+{
+    return m_image.isNull();
+}
+
+PreviewImageCache &PreviewImageCache::getInst()
+{
+    static PreviewImageCache inst;
+    return inst;
+}
+
+PreviewImageCache::PreviewImageCache()
+{
+    const auto &markdownEditorConfig = ConfigMgr::getInst().getEditorConfig().getMarkdownEditorConfig();
+    setBudget(static_cast<qint64>(markdownEditorConfig.getPreviewImageCacheSize()) * 1024 * 1024);
+}
+
+PreviewImageCache::Image PreviewImageCache::get(const QString &p_key, QRgb p_background, qreal p_scaleFactor)
+{
+    auto it = m_entries.find(p_key);
+    if (it == m_entries.end()) {
+        return Image();
+    }
+
+    rasterize(*it, p_background, p_scaleFactor);
+    it->m_lastAccessed = ++m_tick;
+
+    // Evicting may drop it from the cache.
+    auto image = it->m_image;
+    evict();
+    return image;
+}
+
+PreviewImageCache::Image PreviewImageCache::set(const QString &p_key,
+                                                const QString &p_format,
+                                                const QByteArray &p_data,
+                                                bool p_needScale,
+                                                QRgb p_background,
+                                                qreal p_scaleFactor)
+{
+    auto entry = createEntry(p_format, p_data, p_needScale);
+    rasterize(entry, p_background, p_scaleFactor);
+    return insert(p_key, entry);
+}
+
+PreviewImageCache::Image PreviewImageCache::set(const QString &p_key,
+                                                const QString &p_format,
+                                                const QByteArray &p_data,
+                                                bool p_needScale,
+                                                QRgb p_background,
+                                                qreal p_scaleFactor,
+                                                const QImage &p_image)
+{
+    auto entry = createEntry(p_format, p_data, p_needScale);
+    entry.m_background = p_background;
+    entry.m_scaleFactor = p_needScale ? p_scaleFactor : 1;
+    if (!p_data.isEmpty()) {
+        setImage(entry, QPixmap::fromImage(p_image));
+    }
+    return insert(p_key, entry);
+}
+
+PreviewImageCache::Entry PreviewImageCache::createEntry(const QString &p_format,
+                                                        const QByteArray &p_data,
+                                                        bool p_needScale)
+{
+    Entry entry;
+    entry.m_format = p_format;
+    entry.m_data = p_data;
+    entry.m_needScale = p_needScale;
+    return entry;
+}
+
+PreviewImageCache::Image PreviewImageCache::insert(const QString &p_key, const Entry &p_entry)
+{
+    auto it = m_entries.find(p_key);
+    if (it != m_entries.end()) {
+        m_imageBytes -= imageBytes(it->m_image.m_image);
+        m_dataBytes -= it->m_data.size();
+        m_entries.erase(it);
+    }
+
+    it = m_entries.insert(p_key, p_entry);
+    it->m_lastAccessed = ++m_tick;
+    m_dataBytes += it->m_data.size();
+
+    // Evicting may drop it from the cache.
+    auto image = it->m_image;
+    evict();
+    return image;
+}
+
+void PreviewImageCache::rasterize(Entry &p_entry, QRgb p_background, qreal p_scaleFactor)
+{
+    const qreal scaleFactor = p_entry.m_needScale ? p_scaleFactor : 1;
+    if (!p_entry.m_image.isNull()
+        && p_entry.m_background == p_background
+        && qFuzzyCompare(p_entry.m_scaleFactor, scaleFactor)) {
+        return;
+    }
+
+    m_imageBytes -= imageBytes(p_entry.m_image.m_image);
+    p_entry.m_image = Image();
+    p_entry.m_background = p_background;
+    p_entry.m_scaleFactor = scaleFactor;
+    if (p_entry.m_data.isEmpty()) {
+        return;
+    }
+
+    setImage(p_entry, QPixmap::fromImage(rasterizeImage(p_entry.m_format,
+                                                        p_entry.m_data,
+                                                        p_background,
+                                                        scaleFactor)));
+}
+
+void PreviewImageCache::setImage(Entry &p_entry, const QPixmap &p_image)
+{
+    p_entry.m_image.m_image = p_image;
+    p_entry.m_image.m_name = QString::number(++m_imageIndex);
+    m_imageBytes += imageBytes(p_image);
+}
+
+QImage PreviewImageCache::rasterizeImage(const QString &p_format,
+                                         const QByteArray &p_data,
+                                         QRgb p_background,
+                                         qreal p_scaleFactor)
+{
+    if (p_scaleFactor > 1.01) {
+        if (p_format == QStringLiteral("svg")) {
+            return Utils::svgToImage(p_data, p_background, p_scaleFactor);
+        } else {
+            QImage tmpImg;
+            tmpImg.loadFromData(p_data, p_format.toLocal8Bit().data());
+            return tmpImg.scaledToWidth(tmpImg.width() * p_scaleFactor, Qt::SmoothTransformation);
+        }
+    }
+
+    QImage image;
+    image.loadFromData(p_data, p_format.toLocal8Bit().data());
+    return image;
+}
+
+qint64 PreviewImageCache::imageBytes(const QPixmap &p_image)
+{
+    if (p_image.isNull()) {
+        return 0;
+    }
+    return static_cast<qint64>(p_image.width()) * p_image.height() * p_image.depth() / 8;
+}
+
+void PreviewImageCache::evict()
+{
+    if (m_imageBytes + m_dataBytes <= m_budget) {
+        return;
+    }
+
+    // Images shared with editors are not counted since dropping them frees nothing.
+    // Skip the scan of all entries if nothing is evictable per last check.
+    const qint64 sharedBytes = qMin(m_sharedImageBytes, m_imageBytes);
+    if (m_imageBytes - sharedBytes + m_dataBytes <= m_budget
+        && ++m_skippedSharedChecks < c_sharedCheckInterval) {
+        return;
+    }
+
+    m_skippedSharedChecks = 0;
+    qint64 usedBytes = detachedImageBytes() + m_dataBytes;
+    m_sharedImageBytes = m_imageBytes + m_dataBytes - usedBytes;
+    if (usedBytes <= m_budget) {
+        return;
+    }
+
+    QVector<QPair<quint64, QString>> entries;
+    entries.reserve(m_entries.size());
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        entries.push_back(qMakePair(it->m_lastAccessed, it.key()));
+    }
+    std::sort(entries.begin(), entries.end());
+
+    // Drop images first since they could be re-rasterized from source data.
+    for (const auto &ent : entries) {
+        if (usedBytes <= m_budget) {
+            break;
+        }
+
+        auto &entry = m_entries[ent.second];
+        if (entry.m_image.isNull() || !entry.m_image.m_image.isDetached()) {
+            continue;
+        }
+
+        const auto bytes = imageBytes(entry.m_image.m_image);
+        m_imageBytes -= bytes;
+        usedBytes -= bytes;
+        entry.m_image = Image();
+    }
+
+    for (const auto &ent : entries) {
+        if (usedBytes <= m_budget) {
+            break;
+        }
+
+        auto it = m_entries.find(ent.second);
+        const auto &image = it->m_image.m_image;
+        if (!image.isNull()) {
+            const auto bytes = imageBytes(image);
+            m_imageBytes -= bytes;
+            if (image.isDetached()) {
+                usedBytes -= bytes;
+            }
+        }
+
+        usedBytes -= it->m_data.size();
+        m_dataBytes -= it->m_data.size();
+        m_entries.erase(it);
+    }
+
+    m_sharedImageBytes = m_imageBytes + m_dataBytes - usedBytes;
+}
+
+qint64 PreviewImageCache::detachedImageBytes() const
+{
+    qint64 bytes = 0;
+    for (const auto &entry : m_entries) {
+        if (!entry.m_image.isNull() && entry.m_image.m_image.isDetached()) {
+            bytes += imageBytes(entry.m_image.m_image);
+        }
+    }
+    return bytes;
+}
+
+void PreviewImageCache::setBudget(qint64 p_bytes)
+{
+    if (m_budget == p_bytes) {
+        return;
+    }
+
+    m_budget = p_bytes;
+    evict();
+}
+
+PreviewImageCache::Usage PreviewImageCache::getUsage() const
+{
+    Usage usage;
+    usage.m_numOfEntries = m_entries.size();
+    for (const auto &entry : m_entries) {
+        if (entry.m_image.isNull()) {
+            continue;
+        }
+
+        ++usage.m_numOfImages;
+        if (entry.m_image.m_image.isDetached()) {
+            usage.m_imageBytes += imageBytes(entry.m_image.m_image);
+        } else {
+            usage.m_sharedImageBytes += imageBytes(entry.m_image.m_image);
+        }
+    }
+    usage.m_dataBytes = m_dataBytes;
+    usage.m_budget = m_budget;
+    return usage;
+}
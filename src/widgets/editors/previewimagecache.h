@@ -0,0 +1,150 @@
+#ifndef PREVIEWIMAGECACHE_H
+#define PREVIEWIMAGECACHE_H
+
+#include <QHash>
+#include <QPixmap>
+#include <QImage>
+#include <QString>
+#include <QByteArray>
+
+#include <core/noncopyable.h>
+
+namespace vnotex
+{
+    // Cache of in-place preview images shared by all editors, bounded by a memory budget.
+    // Source data is kept with the rasterized image, so that the image could be dropped
+    // under memory pressure and re-rasterized cheaply on demand.
+    class PreviewImageCache : private Noncopyable
+    {
+    public:
+        struct Image
+        {
+            bool isNull() const;
+
+            QPixmap m_image;
+
+            // Name of the image for identification in resource manager.
+            QString m_name;
+        };
+
+        struct Usage
+        {
+            int m_numOfEntries = 0;
+
+            int m_numOfImages = 0;
+
+            // Bytes of rasterized images held only by the cache, which count against the budget.
+            qint64 m_imageBytes = 0;
+
+            // Bytes of rasterized images shared with editors, which dropping would not free.
+            qint64 m_sharedImageBytes = 0;
+
+            // Bytes of source data.
+            qint64 m_dataBytes = 0;
+
+            qint64 m_budget = 0;
+        };
+
+        static PreviewImageCache &getInst();
+
+        // Return a null image if not found.
+        // @p_background: background color to override, 0x0 for none.
+        // @p_scaleFactor: scale factor to apply if the entry needs scale.
+        Image get(const QString &p_key, QRgb p_background, qreal p_scaleFactor);
+
+        // Add source data @p_data in @p_format and return its image.
+        // @p_needScale: whether @p_scaleFactor should be applied to this image.
+        Image set(const QString &p_key,
+                  const QString &p_format,
+                  const QByteArray &p_data,
+                  bool p_needScale,
+                  QRgb p_background,
+                  qreal p_scaleFactor);
+
+        // Add source data with its image @p_image already rasterized via rasterizeImage()
+        // with the same parameters.
+        Image set(const QString &p_key,
+                  const QString &p_format,
+                  const QByteArray &p_data,
+                  bool p_needScale,
+                  QRgb p_background,
+                  qreal p_scaleFactor,
+                  const QImage &p_image);
+
+        void setBudget(qint64 p_bytes);
+
+        Usage getUsage() const;
+
+        // Rasterize source data @p_data in @p_format.
+        // Thread-safe, so it could be called off the GUI thread.
+        static QImage rasterizeImage(const QString &p_format,
+                                     const QByteArray &p_data,
+                                     QRgb p_background,
+                                     qreal p_scaleFactor);
+
+    private:
+        struct Entry
+        {
+            QString m_format;
+
+            QByteArray m_data;
+
+            bool m_needScale = false;
+
+            // Parameters @m_image is rasterized with.
+            QRgb m_background = 0x0;
+
+            qreal m_scaleFactor = 1;
+
+            Image m_image;
+
+            // Tick of last access for LRU.
+            quint64 m_lastAccessed = 0;
+        };
+
+        PreviewImageCache();
+
+        // Rasterize @p_entry if it is dropped or rasterized with different parameters.
+        void rasterize(Entry &p_entry, QRgb p_background, qreal p_scaleFactor);
+
+        void setImage(Entry &p_entry, const QPixmap &p_image);
+
+        // Add @p_entry as @p_key and return its image.
+        Image insert(const QString &p_key, const Entry &p_entry);
+
+        static Entry createEntry(const QString &p_format,
+                                 const QByteArray &p_data,
+                                 bool p_needScale);
+
+        // Drop least recently used images, then entries, until the usage is within the budget.
+        void evict();
+
+        // Bytes of images held only by the cache.
+        qint64 detachedImageBytes() const;
+
+        static qint64 imageBytes(const QPixmap &p_image);
+
+        QHash<QString, Entry> m_entries;
+
+        qint64 m_budget = 0;
+
+        // Bytes of all rasterized images, including those shared with editors.
+        qint64 m_imageBytes = 0;
+
+        qint64 m_dataBytes = 0;
+
+        // Bytes of images found shared with editors at last check. Editors release images
+        // without notice, so it is an estimate refreshed once in a while.
+        qint64 m_sharedImageBytes = 0;
+
+        // Number of evict() calls skipped by the estimate since last check.
+        int m_skippedSharedChecks = 0;
+
+        quint64 m_tick = 0;
+
+        // An increasing index used as the image name.
+        int m_imageIndex = 0;
+    };
+}
+
+#endif // PREVIEWIMAGECACHE_H
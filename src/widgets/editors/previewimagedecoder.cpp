@@ -0,0 +1,35 @@
+#include "previewimagedecoder.h"
+
+#include "previewimagecache.h"
+
+using namespace vnotex;
+
+PreviewImageDecoder::PreviewImageDecoder(const QVector<Item> &p_items, QObject *p_parent)
+    : QThread(p_parent),
+      m_items(p_items)
+{
+}
+
+PreviewImageDecoder::~PreviewImageDecoder()
+{
+    wait();
+}
+
+void PreviewImageDecoder::run()
+{
+    for (auto &item : m_items) {
+        if (item.m_data.isEmpty()) {
+            continue;
+        }
+
+        item.m_image = PreviewImageCache::rasterizeImage(item.m_format,
+                                                         item.m_data,
+                                                         item.m_background,
+                                                         item.m_needScale ? item.m_scaleFactor : 1);
+    }
+}
+
+const QVector<PreviewImageDecoder::Item> &PreviewImageDecoder::getItems() const
+{
+    return m_items;
+}
@@ -0,0 +1,52 @@
+#ifndef PREVIEWIMAGEDECODER_H
+#define PREVIEWIMAGEDECODER_H
+
+#include <QThread>
+#include <QVector>
+#include <QImage>
+#include <QByteArray>
+
+namespace vnotex
+{
+    // Rasterize source data of preview images off the GUI thread.
+    // Results could be fetched via getItems() once finished() is emitted.
+    class PreviewImageDecoder : public QThread
+    {
+        Q_OBJECT
+    public:
+        struct Item
+        {
+            quint64 m_id = 0;
+
+            // Key in PreviewImageCache.
+            QString m_key;
+
+            QString m_format;
+
+            QByteArray m_data;
+
+            bool m_needScale = false;
+
+            QRgb m_background = 0x0;
+
+            qreal m_scaleFactor = 1;
+
+            // Output.
+            QImage m_image;
+        };
+
+        PreviewImageDecoder(const QVector<Item> &p_items, QObject *p_parent = nullptr);
+
+        ~PreviewImageDecoder();
+
+        const QVector<Item> &getItems() const;
+
+    protected:
+        void run() Q_DECL_OVERRIDE;
+
+    private:
+        QVector<Item> m_items;
+    };
+}
+
+#endif // PREVIEWIMAGEDECODER_H
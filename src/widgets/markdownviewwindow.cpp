@@ -10,6 +10,7 @@
 #include <QApplication>
 #include <QProgressDialog>
 #include <QMenu>
+#include <QDebug>
 #include <QActionGroup>
 #include <QTimer>
 #include <QPrinter>
@@ -17,6 +18,7 @@
 #include <core/fileopenparameters.h>
 #include <core/editorconfig.h>
 #include <core/htmltemplatehelper.h>
+#include <core/rendersnapshotcache.h>
 #include <vtextedit/vtextedit.h>
 #include <vtextedit/pegmarkdownhighlighter.h>
 #include <vtextedit/markdowneditorconfig.h>
@@ -44,6 +46,12 @@
 
 using namespace vnotex;
 
+// Bounds of the interval to sync editor contents to preview, which adapts to
+// the render time of the viewer.
+static const int c_minSyncPreviewInterval = 100;
+
+static const int c_maxSyncPreviewInterval = 2000;
+
 MarkdownViewWindow::MarkdownViewWindow(QWidget *p_parent)
     : ViewWindow(p_parent)
 {
@@ -215,6 +223,12 @@ QString MarkdownViewWindow::getLatestContent() const
     return m_editor->getText();
 }
 
+QString MarkdownViewWindow::getLatestContent(int p_position, int p_length) const
+{
+    Q_ASSERT(m_editor);
+    return TextViewWindowHelper::getEditorText(this, p_position, p_length);
+}
+
 void MarkdownViewWindow::syncEditorFromBuffer()
 {
     m_bufferRevision = getBuffer() ? getBuffer()->getRevision() : 0;
@@ -482,6 +496,31 @@ void MarkdownViewWindow::setupViewer()
             this, [this](const QStringList &p_texts, int p_totalMatches, int p_currentMatchIndex) {
                 this->showFindResult(p_texts, p_totalMatches, p_currentMatchIndex);
             });
+    connect(adapter, &MarkdownViewerAdapter::workFinished,
+            this, [this]() {
+                if (m_syncPreviewTimer) {
+                    // Sync no faster than the viewer could render.
+                    int interval = qBound(c_minSyncPreviewInterval,
+                                          this->adapter()->getRenderTime(),
+                                          c_maxSyncPreviewInterval);
+                    if (interval != m_syncPreviewTimer->interval()) {
+                        qDebug() << "sync preview interval" << interval << "ms";
+                        m_syncPreviewTimer->setInterval(interval);
+                    }
+                }
+
+                // Validate the snapshot against the first render of the content.
+                if (!m_snapshotKey.isEmpty()) {
+                    if (m_viewerBufferRevision == m_snapshotBufferRevision) {
+                        this->adapter()->requestSnapshot();
+                    } else {
+                        m_snapshotKey.clear();
+                        m_snapshotHtml.clear();
+                    }
+                }
+            });
+    connect(adapter, &MarkdownViewerAdapter::snapshotReady,
+            this, &MarkdownViewWindow::saveRenderSnapshot);
     connect(adapter, &MarkdownViewerAdapter::viewerReady,
             this, [this]() {
                 m_viewerReady = true;
@@ -506,7 +545,7 @@ void MarkdownViewWindow::syncTextEditorFromBuffer(bool p_syncPositionFromReadMod
     if (buffer) {
         m_editor->setReadOnly(buffer->isReadOnly());
         m_editor->setBasePath(buffer->getResourcePath());
-        m_editor->setText(buffer->getContent());
+        TextViewWindowHelper::setEditorTextFromBuffer(this, buffer);
         m_editor->setModified(buffer->isModified());
 
         int lineNumber = -1;
@@ -545,8 +584,10 @@ void MarkdownViewWindow::syncViewerFromBuffer(bool p_syncPositionFromEditMode)
         adapter()->reset();
         m_viewer->setHtml(HtmlTemplateHelper::getMarkdownViewerTemplate(),
                           PathUtils::pathToUrl(buffer->getContentPath()));
+        showRenderSnapshot(buffer);
         adapter()->setText(m_bufferRevision, buffer->getContent(), lineNumber);
     } else {
+        m_snapshotKey.clear();
         adapter()->reset();
         m_viewer->setHtml("");
         adapter()->setText(0, "", -1);
@@ -554,6 +595,43 @@ void MarkdownViewWindow::syncViewerFromBuffer(bool p_syncPositionFromEditMode)
     m_viewerBufferRevision = m_bufferRevision;
 }
 
+void MarkdownViewWindow::showRenderSnapshot(Buffer *p_buffer)
+{
+    m_snapshotKey.clear();
+    m_snapshotHtml.clear();
+
+    const auto &markdownEditorConfig = ConfigMgr::getInst().getEditorConfig().getMarkdownEditorConfig();
+    if (!markdownEditorConfig.getRenderSnapshotCacheEnabled()) {
+        return;
+    }
+
+    m_snapshotContentPath = p_buffer->getContentPath();
+    m_snapshotKey = RenderSnapshotCache::calculateKey(p_buffer->getContent(),
+                                                      HtmlTemplateHelper::getMarkdownViewerTemplate(),
+                                                      VNoteX::getInst().getThemeMgr().getCurrentTheme().name());
+    m_snapshotBufferRevision = m_bufferRevision;
+
+    m_snapshotHtml = RenderSnapshotCache::getInst().get(m_snapshotContentPath, m_snapshotKey);
+    if (!m_snapshotHtml.isEmpty()) {
+        adapter()->showSnapshot(m_snapshotHtml);
+    }
+}
+
+void MarkdownViewWindow::saveRenderSnapshot(const QString &p_html)
+{
+    if (m_snapshotKey.isEmpty()) {
+        return;
+    }
+
+    // Skip it if the snapshot shown is still up to date.
+    if (m_viewerBufferRevision == m_snapshotBufferRevision && p_html != m_snapshotHtml) {
+        RenderSnapshotCache::getInst().set(m_snapshotContentPath, m_snapshotKey, p_html);
+    }
+
+    m_snapshotKey.clear();
+    m_snapshotHtml.clear();
+}
+
 void MarkdownViewWindow::syncTextEditorFromBufferContent(bool p_syncPosition)
 {
     Q_ASSERT(m_editor);
@@ -569,7 +647,7 @@ void MarkdownViewWindow::syncTextEditorFromBufferContent(bool p_syncPosition)
 
     auto buffer = getBuffer();
     Q_ASSERT(buffer);
-    m_editor->setText(buffer->getContent());
+    TextViewWindowHelper::setEditorTextFromBuffer(this, buffer);
     m_editor->setModified(buffer->isModified());
 
     m_textEditorBufferRevision = m_bufferRevision;
@@ -1327,7 +1405,9 @@ void MarkdownViewWindow::setEditViewMode(MarkdownEditorConfig::EditViewMode p_mo
             if (!m_syncPreviewTimer) {
                 m_syncPreviewTimer = new QTimer(this);
                 m_syncPreviewTimer->setSingleShot(true);
-                m_syncPreviewTimer->setInterval(300);
+                m_syncPreviewTimer->setInterval(qBound(c_minSyncPreviewInterval,
+                                                       adapter()->getRenderTime(),
+                                                       c_maxSyncPreviewInterval));
                 connect(m_syncPreviewTimer, &QTimer::timeout,
                         this, &MarkdownViewWindow::syncEditorContentsToPreview);
             }
@@ -1357,6 +1437,11 @@ void MarkdownViewWindow::syncEditorContentsToPreview()
         return;
     }
 
+    if (m_editorContentLoading) {
+        // The last chunk inserted will trigger the sync again.
+        return;
+    }
+
     adapter()->setText(m_editor->getText(), m_editor->getTopLine());
 }
 
@@ -42,6 +42,8 @@ namespace vnotex
 
         QString getLatestContent() const Q_DECL_OVERRIDE;
 
+        QString getLatestContent(int p_position, int p_length) const Q_DECL_OVERRIDE;
+
         QString selectedText() const Q_DECL_OVERRIDE;
 
         void setMode(ViewWindowMode p_mode) Q_DECL_OVERRIDE;
@@ -132,6 +134,12 @@ namespace vnotex
 
         void syncViewerFromBufferContent(bool p_syncPosition);
 
+        // Show the cached rendered HTML of @p_buffer in viewer until it is rendered.
+        void showRenderSnapshot(Buffer *p_buffer);
+
+        // Persist the rendered HTML of viewer once the first render round finishes.
+        void saveRenderSnapshot(const QString &p_html);
+
         // When we have new changes to the buffer content from our ViewWindow,
         // we will invalidate the contents of the buffer and the buffer will
         // call this function to tell us now the latest buffer revision.
@@ -229,6 +237,17 @@ namespace vnotex
         MarkdownEditorConfig::EditViewMode m_editViewMode = MarkdownEditorConfig::EditViewMode::EditOnly;
 
         QTimer *m_syncPreviewTimer = nullptr;
+
+        // Key of the render snapshot of viewer content to validate. Empty if nothing to do.
+        QByteArray m_snapshotKey;
+
+        QString m_snapshotContentPath;
+
+        // Buffer revision the snapshot key is calculated from.
+        int m_snapshotBufferRevision = 0;
+
+        // Snapshot shown in viewer.
+        QString m_snapshotHtml;
     };
 }
 
@@ -6,6 +6,10 @@
 #include <QMenu>
 #include <QActionGroup>
 #include <QProgressDialog>
+#include <QLocale>
+#include <QThread>
+#include <QEventLoop>
+#include <QDebug>
 
 #include "titlebar.h"
 #include "dialogs/newnotebookdialog.h"
@@ -16,9 +20,13 @@
 #include "dialogs/importnotebookdialog.h"
 #include "dialogs/importfolderdialog.h"
 #include "dialogs/importlegacynotebookdialog.h"
+#include "dialogs/deleteconfirmdialog.h"
 #include <core/vnotex.h>
 #include "mainwindow.h"
 #include <notebook/notebook.h>
+#include <notebook/orphanfilecollector.h>
+#include <core/buffermgr.h>
+#include <buffer/buffer.h>
 #include <core/notebookmgr.h>
 #include <utils/iconutils.h>
 #include <utils/widgetutils.h>
@@ -170,6 +178,18 @@ TitleBar *NotebookExplorer::setupTitleBar(QWidget *p_parent)
                                 rebuildDatabase();
                             });
 
+    titleBar->addMenuAction(tr("Deduplicate Images"),
+                            titleBar,
+                            [this]() {
+                                deduplicateImages();
+                            });
+
+    titleBar->addMenuAction(tr("Clear Orphan Files"),
+                            titleBar,
+                            [this]() {
+                                clearOrphanFiles();
+                            });
+
     // External Files menu.
     {
         auto subMenu = titleBar->addMenuSubMenu(tr("External Files"));
@@ -560,3 +580,133 @@ void NotebookExplorer::rebuildDatabase()
         }
     }
 }
+
+void NotebookExplorer::deduplicateImages()
+{
+    if (!m_currentNotebook) {
+        return;
+    }
+
+    int okRet = MessageBoxHelper::questionOkCancel(MessageBoxHelper::Warning,
+        tr("Deduplicate images of notebook (%1)?").arg(m_currentNotebook->getName()),
+        tr("This operation will replace identical images in image folders with hard links to one copy. It may take time."),
+        tr("Hard linked images share the same data on disk, so editing one of them in place will change all of them."),
+        VNoteX::getInst().getMainWindow());
+    if (okRet != QMessageBox::Ok) {
+        return;
+    }
+
+    QProgressDialog proDlg(tr("Deduplicating images..."),
+                           QString(),
+                           0,
+                           0,
+                           this);
+    proDlg.setWindowFlags(proDlg.windowFlags() & ~Qt::WindowCloseButtonHint);
+    proDlg.setWindowModality(Qt::WindowModal);
+    proDlg.setMinimumDuration(1000);
+    proDlg.setValue(0);
+
+    int cnt = m_currentNotebook->deduplicateImages();
+
+    proDlg.cancel();
+
+    if (cnt >= 0) {
+        MessageBoxHelper::notify(MessageBoxHelper::Type::Information,
+                                 tr("Deduplicated %n image(s).", "", cnt),
+                                 VNoteX::getInst().getMainWindow());
+    } else {
+        MessageBoxHelper::notify(MessageBoxHelper::Type::Warning,
+                                 tr("Image deduplication is not supported by this notebook."),
+                                 VNoteX::getInst().getMainWindow());
+    }
+}
+
+void NotebookExplorer::clearOrphanFiles()
+{
+    if (!m_currentNotebook) {
+        return;
+    }
+
+    OrphanFileCollector collector(m_currentNotebook.data());
+
+    // Images inserted into unsaved buffers are referenced too.
+    const auto buffers = VNoteX::getInst().getBufferMgr().getModifiedBuffers();
+    for (auto buffer : buffers) {
+        collector.setContent(buffer->getContentPath(), buffer->getContent());
+    }
+
+    OrphanFileCollector::Result result;
+    {
+        QProgressDialog proDlg(tr("Collecting orphan files..."),
+                               QString(),
+                               0,
+                               0,
+                               this);
+        proDlg.setWindowFlags(proDlg.windowFlags() & ~Qt::WindowCloseButtonHint);
+        proDlg.setWindowModality(Qt::WindowModal);
+        proDlg.setMinimumDuration(1000);
+        proDlg.setValue(0);
+
+        collector.walk();
+
+        // Read and parse notes in a worker thread to keep the GUI responsive.
+        auto thread = QThread::create([&collector, &result]() {
+            result = collector.collect();
+        });
+        QEventLoop loop;
+        connect(thread, &QThread::finished,
+                &loop, &QEventLoop::quit);
+        thread->start();
+        // Exclude user input to keep nodes unchanged.
+        loop.exec(QEventLoop::ExcludeUserInputEvents);
+        thread->wait();
+        delete thread;
+
+        proDlg.cancel();
+    }
+
+    if (result.m_images.isEmpty() && result.m_attachmentFolders.isEmpty()) {
+        MessageBoxHelper::notify(MessageBoxHelper::Type::Information,
+                                 tr("No orphan files found in %n note(s).", "", result.m_noteCount),
+                                 VNoteX::getInst().getMainWindow());
+        return;
+    }
+
+    // Use the @m_data field to denote whether it is a folder.
+    QVector<ConfirmItemInfo> items;
+    for (const auto &image : result.m_images) {
+        items.push_back(ConfirmItemInfo(image, image, image, nullptr));
+    }
+    for (const auto &folder : result.m_attachmentFolders) {
+        items.push_back(ConfirmItemInfo(folder, folder, folder, reinterpret_cast<void *>(1ULL)));
+    }
+
+    DeleteConfirmDialog dialog(tr("Clear Orphan Files"),
+        tr("These images and attachment folders (%1) are not referenced by any note of notebook (%2). "
+           "Please confirm the deletion of them.").arg(QLocale().formattedDataSize(result.m_size), m_currentNotebook->getName()),
+        tr("Deleted files could be found in the recycle bin of notebook."),
+        items,
+        DeleteConfirmDialog::Flag::Preview,
+        false,
+        VNoteX::getInst().getMainWindow());
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+
+    items = dialog.getConfirmedItems();
+    int cnt = 0;
+    for (const auto &item : items) {
+        try {
+            if (item.m_data) {
+                m_currentNotebook->moveDirToRecycleBin(item.m_path);
+            } else {
+                m_currentNotebook->moveFileToRecycleBin(item.m_path);
+            }
+            ++cnt;
+        } catch (Exception &p_e) {
+            qWarning() << "failed to move orphan file to recycle bin" << item.m_path << p_e.what();
+        }
+    }
+
+    VNoteX::getInst().showStatusMessageShort(tr("Moved %n orphan file(s) to recycle bin", "", cnt));
+}
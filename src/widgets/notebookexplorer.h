@@ -81,6 +81,10 @@ namespace vnotex
 
         void rebuildDatabase();
 
+        void deduplicateImages();
+
+        void clearOrphanFiles();
+
         NotebookSelector *m_selector = nullptr;
 
         NotebookNodeExplorer *m_nodeExplorer = nullptr;
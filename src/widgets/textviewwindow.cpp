@@ -92,9 +92,10 @@ void TextViewWindow::syncEditorFromBuffer()
 
     auto buffer = getBuffer();
     if (buffer) {
-        m_editor->setSyntax(QFileInfo(buffer->getPath()).suffix());
+        // No syntax highlight for large file.
+        m_editor->setSyntax(buffer->isLargeFile() ? QString() : QFileInfo(buffer->getPath()).suffix());
         m_editor->setReadOnly(buffer->isReadOnly());
-        m_editor->setText(buffer->getContent());
+        TextViewWindowHelper::setEditorTextFromBuffer(this, buffer);
         m_editor->setModified(buffer->isModified());
     } else {
         m_editor->setSyntax("");
@@ -114,7 +115,7 @@ void TextViewWindow::syncEditorFromBufferContent()
 
     auto buffer = getBuffer();
     Q_ASSERT(buffer);
-    m_editor->setText(buffer->getContent());
+    TextViewWindowHelper::setEditorTextFromBuffer(this, buffer);
     m_editor->setModified(buffer->isModified());
 
     m_bufferRevision = buffer->getRevision();
@@ -126,6 +127,11 @@ QString TextViewWindow::getLatestContent() const
     return m_editor->getText();
 }
 
+QString TextViewWindow::getLatestContent(int p_position, int p_length) const
+{
+    return TextViewWindowHelper::getEditorText(this, p_position, p_length);
+}
+
 void TextViewWindow::setModified(bool p_modified)
 {
     m_editor->setModified(p_modified);
@@ -25,6 +25,8 @@ namespace vnotex
 
         QString getLatestContent() const Q_DECL_OVERRIDE;
 
+        QString getLatestContent(int p_position, int p_length) const Q_DECL_OVERRIDE;
+
         QString selectedText() const Q_DECL_OVERRIDE;
 
         void setMode(ViewWindowMode p_mode) Q_DECL_OVERRIDE;
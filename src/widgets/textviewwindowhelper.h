@@ -6,9 +6,13 @@
 #include <QRegularExpression>
 #include <QTextBlock>
 #include <QSharedPointer>
+#include <QCoreApplication>
+#include <QTextDocument>
+#include <QPointer>
 
 #include <vtextedit/texteditorconfig.h>
 #include <core/texteditorconfig.h>
+#include <buffer/buffer.h>
 #include <core/configmgr.h>
 #include <utils/widgetutils.h>
 #include <snippet/snippetmgr.h>
@@ -50,6 +54,107 @@ namespace vnotex
                                        });
                                }
                            });
+
+            // Record the changed range for the backup file, which is cheaper than diffing
+            // the whole content.
+            p_win->connect(editor->getTextEdit()->document(), &QTextDocument::contentsChange,
+                           p_win, [p_win](int p_position, int p_removed, int p_added) {
+                               if (p_win->m_propogateEditorToBuffer) {
+                                   p_win->getBuffer()->recordContentsChange(p_position, p_removed, p_added);
+                               }
+                           });
+        }
+
+        // Get text of range [@p_position, @p_position + @p_length) of the editor of @p_win
+        // in the same form as the full text.
+        // Return a null string if the range is out of the document.
+        template <typename _ViewWindow>
+        static QString getEditorText(const _ViewWindow *p_win, int p_position, int p_length)
+        {
+            auto doc = p_win->m_editor->getTextEdit()->document();
+            // Exclude the implicit paragraph separator at the end.
+            if (p_position < 0 || p_length < 0 || p_position + p_length > doc->characterCount() - 1) {
+                return QString();
+            }
+
+            if (p_length == 0) {
+                return QStringLiteral("");
+            }
+
+            QTextCursor cursor(doc);
+            cursor.setPosition(p_position);
+            cursor.setPosition(p_position + p_length, QTextCursor::KeepAnchor);
+            auto text = cursor.selectedText();
+            // Align with QTextDocument::toPlainText().
+            text.replace(QChar::ParagraphSeparator, QLatin1Char('\n'));
+            text.replace(QChar::LineSeparator, QLatin1Char('\n'));
+            text.replace(QChar::Nbsp, QLatin1Char(' '));
+            return text;
+        }
+
+        // Set the content of @p_buffer to the editor of @p_win.
+        // For large file, the content is loaded into the editor chunk by chunk without
+        // holding another full copy of it. Events are processed between chunks to keep the
+        // UI painting, while AutoSave and syncing with buffer are held back until it finishes.
+        template <typename _ViewWindow>
+        static void setEditorTextFromBuffer(_ViewWindow *p_win, Buffer *p_buffer)
+        {
+            auto editor = p_win->m_editor;
+            if (!p_buffer->isLargeFile()) {
+                editor->setText(p_buffer->getContent());
+                return;
+            }
+
+            if (p_win->m_editorContentLoading) {
+                // Re-entered via events processed by the ongoing loading, which will restart
+                // once it finds the buffer changed.
+                return;
+            }
+
+            p_win->m_editorContentLoading = true;
+            p_buffer->suspendAutoSave();
+
+            // The window or buffer may be closed by events processed during loading.
+            QPointer<_ViewWindow> win(p_win);
+            QPointer<Buffer> buffer(p_buffer);
+            QPointer<QTextDocument> doc(editor->getTextEdit()->document());
+            doc->setUndoRedoEnabled(false);
+
+            bool done = false;
+            while (!done) {
+                const int revision = buffer->getRevision();
+                editor->setText(QString());
+                QTextCursor cursor(doc);
+                buffer->readContentInChunks([&cursor, &win, &buffer, &doc, revision](const QString &p_chunk) {
+                    if (!win || !buffer || !doc || buffer->getRevision() != revision) {
+                        return false;
+                    }
+
+                    cursor.movePosition(QTextCursor::End);
+                    cursor.insertText(p_chunk);
+
+                    QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+                    return true;
+                });
+
+                if (!win || !buffer || !doc) {
+                    break;
+                }
+
+                done = buffer->getRevision() == revision;
+            }
+
+            if (doc) {
+                doc->setUndoRedoEnabled(true);
+            }
+
+            if (buffer) {
+                buffer->resumeAutoSave();
+            }
+
+            if (win) {
+                win->m_editorContentLoading = false;
+            }
         }
 
         template <typename _ViewWindow>
@@ -33,6 +33,7 @@
 #include <notebook/notebook.h>
 #include "editors/plantumlhelper.h"
 #include "editors/graphvizhelper.h"
+#include "editors/previewimagecache.h"
 #include <core/historymgr.h>
 
 using namespace vnotex;
@@ -104,6 +105,7 @@ ViewArea::ViewArea(QWidget *p_parent)
                                                  markdownEditorConfig.getGraphvizExe(),
                                                  markdownEditorConfig.getPlantUmlCommand());
                 GraphvizHelper::getInst().update(markdownEditorConfig.getGraphvizExe());
+                PreviewImageCache::getInst().setBudget(static_cast<qint64>(markdownEditorConfig.getPreviewImageCacheSize()) * 1024 * 1024);
             });
 
     m_fileCheckTimer = new QTimer(this);
@@ -15,6 +15,7 @@
 #include <QWheelEvent>
 #include <QWidgetAction>
 #include <QActionGroup>
+#include <QElapsedTimer>
 
 #include "toolbarhelper.h"
 #include "vnotex.h"
@@ -41,6 +42,12 @@
 
 using namespace vnotex;
 
+// Bounds of the interval to sync editor from buffer content, which adapts to
+// the time the sync takes.
+static const int c_minSyncBufferContentInterval = 500;
+
+static const int c_maxSyncBufferContentInterval = 2000;
+
 QIcon ViewWindow::s_savedIcon;
 
 QIcon ViewWindow::s_modifiedIcon;
@@ -67,12 +74,28 @@ ViewWindow::ViewWindow(QWidget *p_parent)
 
     m_syncBufferContentTimer = new QTimer(this);
     m_syncBufferContentTimer->setSingleShot(true);
-    m_syncBufferContentTimer->setInterval(500);
+    m_syncBufferContentTimer->setInterval(c_minSyncBufferContentInterval);
     connect(m_syncBufferContentTimer, &QTimer::timeout,
             this, [this]() {
                 Q_ASSERT(getBuffer());
+                if (m_editorContentLoading) {
+                    // Retry after the loading finishes.
+                    m_syncBufferContentTimer->start();
+                    return;
+                }
+
                 if (getBuffer()->getRevision() != m_bufferRevision) {
+                    QElapsedTimer timer;
+                    timer.start();
                     syncEditorFromBufferContent();
+
+                    // Sync no faster than twice the time it takes.
+                    int interval = qBound(c_minSyncBufferContentInterval,
+                                          static_cast<int>(timer.elapsed()) * 2,
+                                          c_maxSyncBufferContentInterval);
+                    if (interval != m_syncBufferContentTimer->interval()) {
+                        m_syncBufferContentTimer->setInterval(interval);
+                    }
                 }
             });
 }
@@ -70,6 +70,10 @@ namespace vnotex
         // Get latest content from editor instead of buffer.
         virtual QString getLatestContent() const = 0;
 
+        // Get range [@p_position, @p_position + @p_length) of the latest content from editor.
+        // Return a null string if not available.
+        virtual QString getLatestContent(int p_position, int p_length) const = 0;
+
         // Will be called before close.
         // Return true if it is OK to proceed.
         bool aboutToClose(bool p_force);
@@ -261,6 +265,10 @@ namespace vnotex
         // The revision of the buffer of the last sync content.
         int m_bufferRevision = 0;
 
+        // Whether the editor is loading the buffer content chunk by chunk, during which
+        // it holds a partial document and syncing with buffer should be held back.
+        bool m_editorContentLoading = false;
+
         // Whether there is change of editor config since last update.
         // Subclass should maintain it.
         int m_editorConfigRevision = 0;
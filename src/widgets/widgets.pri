@@ -45,13 +45,17 @@ SOURCES += \
     $$PWD/editors/editormarkdownvieweradapter.cpp \
     $$PWD/editors/graphhelper.cpp \
     $$PWD/editors/graphvizhelper.cpp \
+    $$PWD/editors/imagepreviewservice.cpp \
     $$PWD/editors/markdowneditor.cpp \
     $$PWD/editors/markdowntable.cpp \
     $$PWD/editors/markdowntablehelper.cpp \
     $$PWD/editors/markdownviewer.cpp \
     $$PWD/editors/markdownvieweradapter.cpp \
     $$PWD/editors/plantumlhelper.cpp \
+    $$PWD/editors/plantumldaemon.cpp \
     $$PWD/editors/previewhelper.cpp \
+    $$PWD/editors/previewimagecache.cpp \
+    $$PWD/editors/previewimagedecoder.cpp \
     $$PWD/editors/statuswidget.cpp \
     $$PWD/editors/texteditor.cpp \
     $$PWD/editreaddiscardaction.cpp \
@@ -173,13 +177,17 @@ HEADERS += \
     $$PWD/editors/editormarkdownvieweradapter.h \
     $$PWD/editors/graphhelper.h \
     $$PWD/editors/graphvizhelper.h \
+    $$PWD/editors/imagepreviewservice.h \
     $$PWD/editors/markdowneditor.h \
     $$PWD/editors/markdowntable.h \
     $$PWD/editors/markdowntablehelper.h \
     $$PWD/editors/markdownviewer.h \
     $$PWD/editors/markdownvieweradapter.h \
     $$PWD/editors/plantumlhelper.h \
+    $$PWD/editors/plantumldaemon.h \
     $$PWD/editors/previewhelper.h \
+    $$PWD/editors/previewimagecache.h \
+    $$PWD/editors/previewimagedecoder.h \
     $$PWD/editors/statuswidget.h \
     $$PWD/editors/texteditor.h \
     $$PWD/editreaddiscardaction.h \
@@ -0,0 +1,225 @@
+#include "test_imagefetcher.h"
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QNetworkProxy>
+#include <QSignalSpy>
+#include <QTimer>
+
+#include <core/imagefetcher.h>
+
+using namespace tests;
+
+using namespace vnotex;
+
+// Delay of the server to respond to "/img/".
+static const int c_responseDelay = 100;
+
+static const int c_maxConcurrencyPerHost = 4;
+
+TestImageFetcher::TestImageFetcher(QObject *p_parent)
+    : QObject(p_parent)
+{
+}
+
+void TestImageFetcher::initTestCase()
+{
+    QNetworkProxy::setApplicationProxy(QNetworkProxy::NoProxy);
+}
+
+void TestImageFetcher::init()
+{
+    m_requestCounts.clear();
+    m_runningCount = 0;
+    m_maxRunningCount = 0;
+    m_closedCount = 0;
+
+    m_server = new QTcpServer(this);
+    QVERIFY(m_server->listen(QHostAddress::LocalHost));
+    connect(m_server, &QTcpServer::newConnection,
+            this, [this]() {
+                while (auto socket = m_server->nextPendingConnection()) {
+                    connect(socket, &QTcpSocket::readyRead,
+                            this, [this, socket]() {
+                                handleRequest(socket);
+                            });
+                }
+            });
+}
+
+void TestImageFetcher::cleanup()
+{
+    delete m_server;
+    m_server = nullptr;
+}
+
+void TestImageFetcher::handleRequest(QTcpSocket *p_socket)
+{
+    // Wait for the whole header.
+    if (!p_socket->peek(p_socket->bytesAvailable()).contains("\r\n\r\n")) {
+        return;
+    }
+
+    const auto request = p_socket->readAll();
+    const auto path = QString::fromUtf8(request.split(' ').value(1));
+    ++m_requestCounts[path];
+    ++m_runningCount;
+    m_maxRunningCount = qMax(m_maxRunningCount, m_runningCount);
+
+    if (path.startsWith("/hang/")) {
+        connect(p_socket, &QTcpSocket::disconnected,
+                this, [this]() {
+                    --m_runningCount;
+                    ++m_closedCount;
+                });
+        return;
+    }
+
+    QTimer::singleShot(c_responseDelay, p_socket, [this, p_socket, path]() {
+        const auto data = getImageData(path);
+        QByteArray response("HTTP/1.1 200 OK\r\n"
+                            "Content-Type: application/octet-stream\r\n"
+                            "Connection: close\r\n");
+        response += "Content-Length: " + QByteArray::number(data.size()) + "\r\n\r\n";
+        response += data;
+        p_socket->write(response);
+        --m_runningCount;
+        p_socket->disconnectFromHost();
+    });
+}
+
+QUrl TestImageFetcher::getUrl(const QString &p_path) const
+{
+    return QUrl(QString("http://127.0.0.1:%1%2").arg(m_server->serverPort()).arg(p_path));
+}
+
+int TestImageFetcher::getRequestCount() const
+{
+    int cnt = 0;
+    for (auto it = m_requestCounts.constBegin(); it != m_requestCounts.constEnd(); ++it) {
+        cnt += it.value();
+    }
+    return cnt;
+}
+
+QByteArray TestImageFetcher::getImageData(const QString &p_path)
+{
+    // PNG signature followed by the path to tell images apart.
+    return QByteArray("\x89PNG\r\n\x1a\n", 8) + p_path.toUtf8();
+}
+
+static QByteArray readFile(const QString &p_filePath)
+{
+    QFile file(p_filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+void TestImageFetcher::testDuplicatedUrls()
+{
+    ImageFetcher fetcher;
+    fetcher.addUrl(getUrl("/img/a.png"), "png");
+    fetcher.addUrl(getUrl("/img/a.png"), "png");
+    fetcher.addUrl(getUrl("/img/b"), "jpg");
+    fetcher.addUrl(getUrl("/img/a.png"), "png");
+    QCOMPARE(fetcher.getUrlCount(), 2);
+
+    QSignalSpy progressSpy(&fetcher, &ImageFetcher::progressUpdated);
+    QSignalSpy finishedSpy(&fetcher, &ImageFetcher::finished);
+    fetcher.start();
+    QVERIFY(finishedSpy.wait(10000));
+    QVERIFY(fetcher.isFinished());
+
+    QCOMPARE(progressSpy.count(), 2);
+    QCOMPARE(progressSpy.last().at(0).toInt(), 2);
+    QCOMPARE(progressSpy.last().at(1).toInt(), 2);
+
+    QCOMPARE(m_requestCounts.value("/img/a.png"), 1);
+    QCOMPARE(m_requestCounts.value("/img/b"), 1);
+
+    for (const auto &path : {QString("/img/a.png"), QString("/img/b")}) {
+        const auto filePath = fetcher.getFilePath(getUrl(path));
+        QVERIFY(!filePath.isEmpty());
+        QCOMPARE(readFile(filePath), getImageData(path));
+        // Suffix is guessed from the data.
+        QVERIFY(filePath.endsWith(".png"));
+    }
+
+    QVERIFY(fetcher.getFilePath(getUrl("/img/c.png")).isEmpty());
+}
+
+void TestImageFetcher::testConcurrencyPerHost()
+{
+    ImageFetcher fetcher;
+    for (int i = 0; i < 10; ++i) {
+        fetcher.addUrl(getUrl(QString("/img/%1.png").arg(i)), "png");
+    }
+
+    QSignalSpy finishedSpy(&fetcher, &ImageFetcher::finished);
+    fetcher.start();
+    QVERIFY(finishedSpy.wait(10000));
+
+    QCOMPARE(getRequestCount(), 10);
+    QCOMPARE(m_maxRunningCount, c_maxConcurrencyPerHost);
+    for (int i = 0; i < 10; ++i) {
+        QVERIFY(!fetcher.getFilePath(getUrl(QString("/img/%1.png").arg(i))).isEmpty());
+    }
+}
+
+void TestImageFetcher::testIdleTimeout()
+{
+    ImageFetcher fetcher;
+    fetcher.setIdleTimeout(200);
+    for (int i = 0; i < 6; ++i) {
+        fetcher.addUrl(getUrl(QString("/hang/%1.png").arg(i)), "png");
+    }
+
+    QSignalSpy progressSpy(&fetcher, &ImageFetcher::progressUpdated);
+    QSignalSpy finishedSpy(&fetcher, &ImageFetcher::finished);
+    fetcher.start();
+    QVERIFY(finishedSpy.wait(10000));
+
+    // All are done but failed.
+    QCOMPARE(progressSpy.count(), 6);
+    for (int i = 0; i < 6; ++i) {
+        QVERIFY(fetcher.getFilePath(getUrl(QString("/hang/%1.png").arg(i))).isEmpty());
+    }
+
+    // The host is given up after timing out several times, leaving the rest not requested.
+    QVERIFY(getRequestCount() < 6);
+    QTRY_COMPARE(m_closedCount, getRequestCount());
+}
+
+void TestImageFetcher::testAbort()
+{
+    ImageFetcher fetcher;
+    for (int i = 0; i < 6; ++i) {
+        fetcher.addUrl(getUrl(QString("/hang/%1.png").arg(i)), "png");
+    }
+
+    QSignalSpy finishedSpy(&fetcher, &ImageFetcher::finished);
+    fetcher.start();
+    QTRY_COMPARE(getRequestCount(), c_maxConcurrencyPerHost);
+
+    // Running requests are aborted at once.
+    fetcher.abort();
+    QCOMPARE(finishedSpy.count(), 1);
+    QVERIFY(fetcher.isFinished());
+    for (int i = 0; i < 6; ++i) {
+        QVERIFY(fetcher.getFilePath(getUrl(QString("/hang/%1.png").arg(i))).isEmpty());
+    }
+
+    QTRY_COMPARE(m_closedCount, c_maxConcurrencyPerHost);
+
+    // Pending ones are not requested.
+    QTest::qWait(200);
+    QCOMPARE(getRequestCount(), c_maxConcurrencyPerHost);
+
+    // Aborting again does nothing.
+    fetcher.abort();
+    QCOMPARE(finishedSpy.count(), 1);
+}
+
+QTEST_MAIN(tests::TestImageFetcher)
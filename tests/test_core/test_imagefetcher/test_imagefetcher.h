@@ -0,0 +1,59 @@
+#ifndef TESTS_CORE_TEST_IMAGEFETCHER_H
+#define TESTS_CORE_TEST_IMAGEFETCHER_H
+
+#include <QtTest>
+#include <QHash>
+
+class QTcpServer;
+class QTcpSocket;
+
+namespace tests
+{
+    // Fetch images from a local HTTP server, which responds to "/img/" after a delay
+    // and never responds to "/hang/".
+    class TestImageFetcher : public QObject
+    {
+        Q_OBJECT
+    public:
+        explicit TestImageFetcher(QObject *p_parent = nullptr);
+
+    private slots:
+        void initTestCase();
+
+        void init();
+
+        void cleanup();
+
+        void testDuplicatedUrls();
+
+        void testConcurrencyPerHost();
+
+        void testIdleTimeout();
+
+        void testAbort();
+
+    private:
+        void handleRequest(QTcpSocket *p_socket);
+
+        QUrl getUrl(const QString &p_path) const;
+
+        int getRequestCount() const;
+
+        static QByteArray getImageData(const QString &p_path);
+
+        QTcpServer *m_server = nullptr;
+
+        // Path -> number of requests.
+        QHash<QString, int> m_requestCounts;
+
+        // Number of requests not responded yet.
+        int m_runningCount = 0;
+
+        int m_maxRunningCount = 0;
+
+        // Number of connections of "/hang/" closed by the client.
+        int m_closedCount = 0;
+    };
+} // ns tests
+
+#endif // TESTS_CORE_TEST_IMAGEFETCHER_H
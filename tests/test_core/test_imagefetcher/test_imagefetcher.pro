@@ -0,0 +1,10 @@
+include($$PWD/../../commonfull.pri)
+
+TARGET = test_imagefetcher
+TEMPLATE = app
+
+SOURCES += \
+    test_imagefetcher.cpp
+
+HEADERS += \
+    test_imagefetcher.h
@@ -0,0 +1,341 @@
+#include "test_imageuploadqueue.h"
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QNetworkProxy>
+#include <QSignalSpy>
+#include <QTimer>
+#include <QFile>
+
+#include <imagehost/imagehost.h>
+#include <imagehost/imageuploadqueue.h>
+
+using namespace tests;
+
+using namespace vnotex;
+
+// Delay of the server to respond.
+static const int c_responseDelay = 300;
+
+namespace
+{
+    // Image host putting images to @m_baseUrl, which responds with the Url of the image.
+    class MockImageHost : public ImageHost
+    {
+    public:
+        explicit MockImageHost(const QString &p_baseUrl)
+            : m_baseUrl(p_baseUrl)
+        {
+        }
+
+        Type getType() const Q_DECL_OVERRIDE
+        {
+            return Type::GitHub;
+        }
+
+        bool ready() const Q_DECL_OVERRIDE
+        {
+            return true;
+        }
+
+        QJsonObject getConfig() const Q_DECL_OVERRIDE
+        {
+            return QJsonObject();
+        }
+
+        void setConfig(const QJsonObject &p_jobj) Q_DECL_OVERRIDE
+        {
+            Q_UNUSED(p_jobj);
+        }
+
+        bool testConfig(const QJsonObject &p_jobj, QString &p_msg) Q_DECL_OVERRIDE
+        {
+            Q_UNUSED(p_jobj);
+            Q_UNUSED(p_msg);
+            return true;
+        }
+
+        bool remove(const QString &p_url, QString &p_msg) Q_DECL_OVERRIDE
+        {
+            Q_UNUSED(p_url);
+            Q_UNUSED(p_msg);
+            return false;
+        }
+
+        bool ownsUrl(const QString &p_url) const Q_DECL_OVERRIDE
+        {
+            return p_url.startsWith(m_baseUrl);
+        }
+
+    protected:
+        void doCreateAsync(const QByteArray &p_data,
+                           const QString &p_path,
+                           const CreateCallback &p_callback) Q_DECL_OVERRIDE
+        {
+            sendRequest("PUT", QUrl(m_baseUrl + p_path), vte::NetworkAccess::RawHeaderPairs(), p_data,
+                        [p_callback](QNetworkReply::NetworkError p_error, const QByteArray &p_replyData) {
+                CreateResult result;
+                if (p_error == QNetworkReply::NoError) {
+                    result.m_url = QString::fromUtf8(p_replyData);
+                } else {
+                    result.m_msg = vte::NetworkUtils::networkErrorStr(p_error);
+                    result.m_retryable = isRetryableError(p_error);
+                }
+                p_callback(result);
+            });
+        }
+
+    private:
+        QString m_baseUrl;
+    };
+}
+
+TestImageUploadQueue::TestImageUploadQueue(QObject *p_parent)
+    : QObject(p_parent)
+{
+}
+
+void TestImageUploadQueue::initTestCase()
+{
+    QNetworkProxy::setApplicationProxy(QNetworkProxy::NoProxy);
+    QVERIFY(m_dir.isValid());
+}
+
+void TestImageUploadQueue::init()
+{
+    m_requestCounts.clear();
+    m_runningCount = 0;
+    m_maxRunningCount = 0;
+    m_closedCount = 0;
+
+    m_server = new QTcpServer(this);
+    QVERIFY(m_server->listen(QHostAddress::LocalHost));
+    connect(m_server, &QTcpServer::newConnection,
+            this, [this]() {
+                while (auto socket = m_server->nextPendingConnection()) {
+                    connect(socket, &QTcpSocket::readyRead,
+                            this, [this, socket]() {
+                                handleRequest(socket);
+                            });
+                }
+            });
+}
+
+void TestImageUploadQueue::cleanup()
+{
+    delete m_server;
+    m_server = nullptr;
+}
+
+void TestImageUploadQueue::handleRequest(QTcpSocket *p_socket)
+{
+    // Wait for the whole request with the body.
+    const auto data = p_socket->peek(p_socket->bytesAvailable());
+    const int headerEnd = data.indexOf("\r\n\r\n");
+    if (headerEnd == -1) {
+        return;
+    }
+    QRegularExpression lengthRegExp("Content-Length:\\s*(\\d+)", QRegularExpression::CaseInsensitiveOption);
+    const auto match = lengthRegExp.match(QString::fromUtf8(data.left(headerEnd)));
+    const int contentLength = match.hasMatch() ? match.captured(1).toInt() : 0;
+    if (data.size() < headerEnd + 4 + contentLength) {
+        return;
+    }
+
+    const auto request = p_socket->readAll();
+    const auto path = QString::fromUtf8(request.split(' ').value(1));
+    const int cnt = ++m_requestCounts[path];
+    ++m_runningCount;
+    m_maxRunningCount = qMax(m_maxRunningCount, m_runningCount);
+
+    if (path.startsWith("/hang/")) {
+        connect(p_socket, &QTcpSocket::disconnected,
+                this, [this]() {
+                    --m_runningCount;
+                    ++m_closedCount;
+                });
+        return;
+    }
+
+    QByteArray status("200 OK");
+    if (path.startsWith("/bad/")) {
+        status = "400 Bad Request";
+    } else if (path.startsWith("/flaky/") && cnt == 1) {
+        status = "503 Service Unavailable";
+    }
+
+    QTimer::singleShot(c_responseDelay, p_socket, [this, p_socket, path, status]() {
+        const auto body = (getBaseUrl() + path).toUtf8();
+        QByteArray response("HTTP/1.1 " + status + "\r\n"
+                            "Content-Type: text/plain\r\n"
+                            "Connection: close\r\n");
+        response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n";
+        response += body;
+        p_socket->write(response);
+        --m_runningCount;
+        p_socket->disconnectFromHost();
+    });
+}
+
+QString TestImageUploadQueue::getBaseUrl() const
+{
+    return QString("http://127.0.0.1:%1").arg(m_server->serverPort());
+}
+
+QString TestImageUploadQueue::createImageFile(const QString &p_name)
+{
+    const auto filePath = m_dir.filePath(p_name);
+    QFile file(filePath);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QByteArray("\x89PNG\r\n\x1a\n", 8) + p_name.toUtf8());
+    }
+    return filePath;
+}
+
+int TestImageUploadQueue::getRequestCount() const
+{
+    int cnt = 0;
+    for (auto it = m_requestCounts.constBegin(); it != m_requestCounts.constEnd(); ++it) {
+        cnt += it.value();
+    }
+    return cnt;
+}
+
+void TestImageUploadQueue::testConcurrency()
+{
+    MockImageHost host(getBaseUrl());
+    ImageUploadQueue queue(&host, 3);
+    for (int i = 0; i < 8; ++i) {
+        const auto name = QString("%1.png").arg(i);
+        queue.addImage(createImageFile(name), "/ok/" + name);
+    }
+    QCOMPARE(queue.getImageCount(), 8);
+
+    QSignalSpy uploadedSpy(&queue, &ImageUploadQueue::imageUploaded);
+    QSignalSpy failedSpy(&queue, &ImageUploadQueue::imageFailed);
+    QSignalSpy progressSpy(&queue, &ImageUploadQueue::progressUpdated);
+    QSignalSpy finishedSpy(&queue, &ImageUploadQueue::finished);
+    queue.start();
+    QVERIFY(finishedSpy.wait(10000));
+    QVERIFY(queue.isFinished());
+
+    QCOMPARE(uploadedSpy.count(), 8);
+    QCOMPARE(failedSpy.count(), 0);
+    QCOMPARE(progressSpy.count(), 8);
+    QCOMPARE(progressSpy.last().at(0).toInt(), 8);
+    QCOMPARE(getRequestCount(), 8);
+    QCOMPARE(m_maxRunningCount, 3);
+
+    for (const auto &args : uploadedSpy) {
+        const auto fileName = QFileInfo(args.at(0).toString()).fileName();
+        QCOMPARE(args.at(1).toString(), getBaseUrl() + "/ok/" + fileName);
+    }
+}
+
+void TestImageUploadQueue::testRetry()
+{
+    MockImageHost host(getBaseUrl());
+    ImageUploadQueue queue(&host, 2);
+    queue.addImage(createImageFile("a.png"), "/flaky/a.png");
+    queue.addImage(createImageFile("b.png"), "/ok/b.png");
+
+    QSignalSpy uploadedSpy(&queue, &ImageUploadQueue::imageUploaded);
+    QSignalSpy failedSpy(&queue, &ImageUploadQueue::imageFailed);
+    QSignalSpy finishedSpy(&queue, &ImageUploadQueue::finished);
+
+    QElapsedTimer timer;
+    timer.start();
+    queue.start();
+    QVERIFY(finishedSpy.wait(10000));
+
+    QCOMPARE(uploadedSpy.count(), 2);
+    QCOMPARE(failedSpy.count(), 0);
+    QCOMPARE(m_requestCounts.value("/flaky/a.png"), 2);
+    QCOMPARE(m_requestCounts.value("/ok/b.png"), 1);
+
+    // It backs off before retrying.
+    QVERIFY(timer.elapsed() >= 1000);
+}
+
+void TestImageUploadQueue::testNonRetryableError()
+{
+    MockImageHost host(getBaseUrl());
+    ImageUploadQueue queue(&host, 2);
+    queue.addImage(createImageFile("a.png"), "/bad/a.png");
+    queue.addImage(createImageFile("b.png"), "/ok/b.png");
+    queue.addImage(m_dir.filePath("missing.png"), "/ok/missing.png");
+
+    QSignalSpy uploadedSpy(&queue, &ImageUploadQueue::imageUploaded);
+    QSignalSpy failedSpy(&queue, &ImageUploadQueue::imageFailed);
+    QSignalSpy finishedSpy(&queue, &ImageUploadQueue::finished);
+    queue.start();
+    QVERIFY(finishedSpy.wait(10000));
+
+    QCOMPARE(uploadedSpy.count(), 1);
+    QCOMPARE(failedSpy.count(), 2);
+    QCOMPARE(m_requestCounts.value("/bad/a.png"), 1);
+
+    // Missing local file is not uploaded.
+    QCOMPARE(m_requestCounts.value("/ok/missing.png"), 0);
+}
+
+void TestImageUploadQueue::testAbort()
+{
+    MockImageHost host(getBaseUrl());
+    ImageUploadQueue queue(&host, 2);
+    for (int i = 0; i < 5; ++i) {
+        const auto name = QString("%1.png").arg(i);
+        queue.addImage(createImageFile(name), "/hang/" + name);
+    }
+
+    QSignalSpy failedSpy(&queue, &ImageUploadQueue::imageFailed);
+    QSignalSpy finishedSpy(&queue, &ImageUploadQueue::finished);
+    queue.start();
+    QTRY_COMPARE(getRequestCount(), 2);
+
+    // Ongoing uploads are aborted at once without retrying.
+    queue.abort();
+    QCOMPARE(finishedSpy.count(), 1);
+    QVERIFY(queue.isFinished());
+    QCOMPARE(failedSpy.count(), 2);
+
+    QTRY_COMPARE(m_closedCount, 2);
+
+    // Pending ones are not uploaded.
+    QTest::qWait(200);
+    QCOMPARE(getRequestCount(), 2);
+
+    // Aborting again does nothing.
+    queue.abort();
+    QCOMPARE(finishedSpy.count(), 1);
+}
+
+void TestImageUploadQueue::testAbortSharedHost()
+{
+    MockImageHost host(getBaseUrl());
+    ImageUploadQueue hangQueue(&host, 2);
+    hangQueue.addImage(createImageFile("a.png"), "/hang/a.png");
+    hangQueue.addImage(createImageFile("b.png"), "/hang/b.png");
+
+    ImageUploadQueue okQueue(&host, 2);
+    okQueue.addImage(createImageFile("c.png"), "/ok/c.png");
+    okQueue.addImage(createImageFile("d.png"), "/ok/d.png");
+
+    QSignalSpy hangFinishedSpy(&hangQueue, &ImageUploadQueue::finished);
+    QSignalSpy okUploadedSpy(&okQueue, &ImageUploadQueue::imageUploaded);
+    QSignalSpy okFailedSpy(&okQueue, &ImageUploadQueue::imageFailed);
+    QSignalSpy okFinishedSpy(&okQueue, &ImageUploadQueue::finished);
+    hangQueue.start();
+    okQueue.start();
+    QTRY_COMPARE(getRequestCount(), 4);
+
+    // Requests of the other queue sharing the host are kept.
+    hangQueue.abort();
+    QCOMPARE(hangFinishedSpy.count(), 1);
+
+    QVERIFY(okFinishedSpy.count() == 1 || okFinishedSpy.wait(10000));
+    QCOMPARE(okUploadedSpy.count(), 2);
+    QCOMPARE(okFailedSpy.count(), 0);
+}
+
+QTEST_MAIN(tests::TestImageUploadQueue)
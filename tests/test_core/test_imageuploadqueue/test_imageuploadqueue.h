@@ -0,0 +1,65 @@
+#ifndef TESTS_CORE_TEST_IMAGEUPLOADQUEUE_H
+#define TESTS_CORE_TEST_IMAGEUPLOADQUEUE_H
+
+#include <QtTest>
+#include <QHash>
+#include <QTemporaryDir>
+
+class QTcpServer;
+class QTcpSocket;
+
+namespace tests
+{
+    // Upload images to a local HTTP server, which responds to "/ok/" with the Url,
+    // fails "/flaky/" once with 503, fails "/bad/" with 400 and never responds to "/hang/".
+    class TestImageUploadQueue : public QObject
+    {
+        Q_OBJECT
+    public:
+        explicit TestImageUploadQueue(QObject *p_parent = nullptr);
+
+    private slots:
+        void initTestCase();
+
+        void init();
+
+        void cleanup();
+
+        void testConcurrency();
+
+        void testRetry();
+
+        void testNonRetryableError();
+
+        void testAbort();
+
+        void testAbortSharedHost();
+
+    private:
+        void handleRequest(QTcpSocket *p_socket);
+
+        QString getBaseUrl() const;
+
+        // Create a local image file named @p_name.
+        QString createImageFile(const QString &p_name);
+
+        int getRequestCount() const;
+
+        QTcpServer *m_server = nullptr;
+
+        QTemporaryDir m_dir;
+
+        // Path -> number of requests.
+        QHash<QString, int> m_requestCounts;
+
+        // Number of requests not responded yet.
+        int m_runningCount = 0;
+
+        int m_maxRunningCount = 0;
+
+        // Number of connections of "/hang/" closed by the client.
+        int m_closedCount = 0;
+    };
+} // ns tests
+
+#endif // TESTS_CORE_TEST_IMAGEUPLOADQUEUE_H
@@ -0,0 +1,10 @@
+include($$PWD/../../commonfull.pri)
+
+TARGET = test_imageuploadqueue
+TEMPLATE = app
+
+SOURCES += \
+    test_imageuploadqueue.cpp
+
+HEADERS += \
+    test_imageuploadqueue.h
@@ -0,0 +1,297 @@
+#include "test_archivewriter.h"
+
+#include <QTemporaryDir>
+#include <QRandomGenerator>
+#include <QProcess>
+#include <QStandardPaths>
+
+#include <export/archivewriter.h>
+
+using namespace tests;
+
+using namespace vnotex;
+
+namespace
+{
+    // Entry read back from the central directory of an archive.
+    struct ZipEntry
+    {
+        QString m_name;
+
+        quint16 m_flags = 0;
+
+        quint16 m_method = 0;
+
+        quint32 m_crc = 0;
+
+        quint32 m_compressedSize = 0;
+
+        quint32 m_uncompressedSize = 0;
+
+        // Raw data as stored in the archive.
+        QByteArray m_data;
+    };
+}
+
+static quint16 readUint16(const QByteArray &p_data, int p_pos)
+{
+    return static_cast<quint16>(static_cast<quint8>(p_data[p_pos]) | (static_cast<quint8>(p_data[p_pos + 1]) << 8));
+}
+
+static quint32 readUint32(const QByteArray &p_data, int p_pos)
+{
+    return readUint16(p_data, p_pos) | (static_cast<quint32>(readUint16(p_data, p_pos + 2)) << 16);
+}
+
+static quint32 crc32(const QByteArray &p_data)
+{
+    quint32 crc = 0xFFFFFFFFU;
+    for (const auto ch : p_data) {
+        crc ^= static_cast<quint8>(ch);
+        for (int k = 0; k < 8; ++k) {
+            crc = (crc & 1) ? (0xEDB88320U ^ (crc >> 1)) : (crc >> 1);
+        }
+    }
+    return crc ^ 0xFFFFFFFFU;
+}
+
+// Inflate raw deflate data by wrapping it as the input of qUncompress(), which verifies the
+// Adler-32 checksum of @p_expected.
+static QByteArray inflate(const QByteArray &p_raw, const QByteArray &p_expected)
+{
+    quint32 a = 1;
+    quint32 b = 0;
+    for (const auto ch : p_expected) {
+        a = (a + static_cast<quint8>(ch)) % 65521;
+        b = (b + a) % 65521;
+    }
+    const quint32 adler = (b << 16) | a;
+
+    QByteArray data;
+    const auto size = static_cast<quint32>(p_expected.size());
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        data.append(static_cast<char>((size >> shift) & 0xFF));
+    }
+    data.append('\x78');
+    data.append('\x9C');
+    data.append(p_raw);
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        data.append(static_cast<char>((adler >> shift) & 0xFF));
+    }
+    return qUncompress(data);
+}
+
+// A minimal reader of archives without ZIP64 records.
+static bool readArchive(const QString &p_filePath, QVector<ZipEntry> &p_entries)
+{
+    QFile file(p_filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const auto data = file.readAll();
+
+    // End of central directory record without comment.
+    const int eocd = data.size() - 22;
+    if (eocd < 0 || readUint32(data, eocd) != 0x06054b50 || readUint16(data, eocd + 20) != 0) {
+        return false;
+    }
+
+    const int numOfEntries = readUint16(data, eocd + 10);
+    const auto cdSize = readUint32(data, eocd + 12);
+    int pos = static_cast<int>(readUint32(data, eocd + 16));
+    if (pos + cdSize != static_cast<quint32>(eocd)) {
+        return false;
+    }
+
+    for (int i = 0; i < numOfEntries; ++i) {
+        if (pos + 46 > eocd || readUint32(data, pos) != 0x02014b50) {
+            return false;
+        }
+
+        ZipEntry entry;
+        entry.m_flags = readUint16(data, pos + 8);
+        entry.m_method = readUint16(data, pos + 10);
+        entry.m_crc = readUint32(data, pos + 16);
+        entry.m_compressedSize = readUint32(data, pos + 20);
+        entry.m_uncompressedSize = readUint32(data, pos + 24);
+        const int nameLen = readUint16(data, pos + 28);
+        const int extraLen = readUint16(data, pos + 30);
+        const int commentLen = readUint16(data, pos + 32);
+        const int offset = static_cast<int>(readUint32(data, pos + 42));
+        entry.m_name = QString::fromUtf8(data.mid(pos + 46, nameLen));
+        pos += 46 + nameLen + extraLen + commentLen;
+
+        // Local file header.
+        if (readUint32(data, offset) != 0x04034b50
+            || readUint16(data, offset + 6) != entry.m_flags
+            || readUint16(data, offset + 8) != entry.m_method
+            || data.mid(offset + 30, readUint16(data, offset + 26)) != entry.m_name.toUtf8()) {
+            return false;
+        }
+        const int dataPos = offset + 30 + readUint16(data, offset + 26) + readUint16(data, offset + 28);
+        entry.m_data = data.mid(dataPos, static_cast<int>(entry.m_compressedSize));
+
+        if (entry.m_flags & 0x0008) {
+            // Data descriptor.
+            const int ddPos = dataPos + static_cast<int>(entry.m_compressedSize);
+            if (readUint32(data, ddPos) != 0x08074b50
+                || readUint32(data, ddPos + 4) != entry.m_crc
+                || readUint32(data, ddPos + 8) != entry.m_compressedSize
+                || readUint32(data, ddPos + 12) != entry.m_uncompressedSize) {
+                return false;
+            }
+        } else if (readUint32(data, offset + 14) != entry.m_crc
+                   || readUint32(data, offset + 18) != entry.m_compressedSize
+                   || readUint32(data, offset + 22) != entry.m_uncompressedSize) {
+            return false;
+        }
+
+        p_entries.push_back(entry);
+    }
+
+    return true;
+}
+
+static void writeTestFile(const QString &p_filePath, const QByteArray &p_data)
+{
+    QFile file(p_filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(p_data), static_cast<qint64>(p_data.size()));
+}
+
+static QByteArray randomData(int p_size)
+{
+    QRandomGenerator gen(static_cast<quint32>(p_size));
+    QByteArray data(p_size, '\0');
+    for (int i = 0; i < p_size; ++i) {
+        data[i] = static_cast<char>(gen.bounded(256));
+    }
+    return data;
+}
+
+TestArchiveWriter::TestArchiveWriter(QObject *p_parent)
+    : QObject(p_parent)
+{
+}
+
+void TestArchiveWriter::testWrite()
+{
+    QTemporaryDir dir;
+    const QString testFolderPath(dir.path());
+
+    const QByteArray smallData = QByteArray("# Note\n\nSome text of the note.\n").repeated(100);
+    const QByteArray tinyData("hi");
+    const auto mediumData = randomData(1024 * 1024);
+    // Larger than the limit of in-memory files.
+    const auto largeData = randomData(5 * 1024 * 1024 + 123);
+
+    const auto emptyFilePath = testFolderPath + "/empty";
+    writeTestFile(emptyFilePath, QByteArray());
+    const auto mediumFilePath = testFolderPath + "/medium";
+    writeTestFile(mediumFilePath, mediumData);
+    const auto largeFilePath = testFolderPath + "/large";
+    writeTestFile(largeFilePath, largeData);
+
+    const auto archivePath = testFolderPath + "/test.zip";
+    {
+        ArchiveWriter writer(archivePath);
+        QVERIFY(writer.open());
+        QVERIFY(writer.addFile("notes/small.md", smallData));
+        QVERIFY(writer.addFile("tiny.txt", tinyData));
+        QVERIFY(writer.addFile("empty.txt", QByteArray()));
+        QVERIFY(writer.addFileFromDisk("attachments/empty.bin", emptyFilePath));
+        QVERIFY(writer.addFileFromDisk("attachments/medium.png", mediumFilePath));
+        QVERIFY(writer.addFileFromDisk("attachments/large.bin", largeFilePath));
+        QVERIFY(!writer.addFileFromDisk("missing.bin", testFolderPath + "/missing"));
+        QVERIFY(!writer.errorString().isEmpty());
+        QVERIFY(writer.finish());
+    }
+
+    QVector<ZipEntry> entries;
+    QVERIFY(readArchive(archivePath, entries));
+    QCOMPARE(entries.size(), 6);
+
+    const QVector<QPair<QString, QByteArray>> expectedEntries = {
+        qMakePair(QString("notes/small.md"), smallData),
+        qMakePair(QString("tiny.txt"), tinyData),
+        qMakePair(QString("empty.txt"), QByteArray()),
+        qMakePair(QString("attachments/empty.bin"), QByteArray()),
+        qMakePair(QString("attachments/medium.png"), mediumData),
+        qMakePair(QString("attachments/large.bin"), largeData)
+    };
+    for (int i = 0; i < entries.size(); ++i) {
+        const auto &entry = entries[i];
+        const auto &expected = expectedEntries[i].second;
+        QCOMPARE(entry.m_name, expectedEntries[i].first);
+        QCOMPARE(entry.m_uncompressedSize, static_cast<quint32>(expected.size()));
+        QCOMPARE(entry.m_crc, crc32(expected));
+        // UTF-8 names.
+        QVERIFY(entry.m_flags & 0x0800);
+
+        if (entry.m_method == 8) {
+            QCOMPARE(inflate(entry.m_data, expected), expected);
+        } else {
+            QCOMPARE(entry.m_method, static_cast<quint16>(0));
+            QCOMPARE(entry.m_data, expected);
+        }
+    }
+
+    // Compressible text is deflated while tiny and random data are stored.
+    QCOMPARE(entries[0].m_method, static_cast<quint16>(8));
+    QVERIFY(entries[0].m_compressedSize < entries[0].m_uncompressedSize);
+    QCOMPARE(entries[1].m_method, static_cast<quint16>(0));
+    QCOMPARE(entries[4].m_method, static_cast<quint16>(0));
+
+    // Only large files are streamed with a data descriptor.
+    for (int i = 0; i < entries.size(); ++i) {
+        QCOMPARE(bool(entries[i].m_flags & 0x0008), i == 5);
+    }
+
+    // Let unzip verify it too if available.
+    const auto unzip = QStandardPaths::findExecutable("unzip");
+    if (!unzip.isEmpty()) {
+        QProcess proc;
+        proc.start(unzip, {"-tq", archivePath});
+        QVERIFY(proc.waitForFinished());
+        QCOMPARE(proc.exitCode(), 0);
+    }
+}
+
+void TestArchiveWriter::testNames()
+{
+    QTemporaryDir dir;
+
+    ArchiveWriter writer(dir.path() + "/test.zip");
+    QVERIFY(writer.open());
+    QVERIFY(writer.addFile("notes/a.md", QByteArray("a")));
+    QVERIFY(writer.addFile("notes/a_1.md", QByteArray("a")));
+    QVERIFY(writer.addFile("b", QByteArray("b")));
+
+    QVERIFY(writer.contains("NOTES/A.md"));
+    QVERIFY(writer.contains("notes"));
+    QVERIFY(!writer.contains("a.md"));
+
+    QCOMPARE(writer.generateName("c.md"), QString("c.md"));
+    QCOMPARE(writer.generateName("notes/A.md"), QString("notes/A_2.md"));
+    QCOMPARE(writer.generateName("b"), QString("b_1"));
+    QCOMPARE(writer.generateName("notes"), QString("notes_1"));
+
+    QVERIFY(writer.finish());
+}
+
+void TestArchiveWriter::testUnfinished()
+{
+    QTemporaryDir dir;
+    const auto archivePath = dir.path() + "/test.zip";
+
+    {
+        ArchiveWriter writer(archivePath);
+        QVERIFY(writer.open());
+        QVERIFY(writer.addFile("a.md", QByteArray("a")));
+        QVERIFY(QFileInfo::exists(archivePath));
+    }
+
+    QVERIFY(!QFileInfo::exists(archivePath));
+}
+
+QTEST_MAIN(tests::TestArchiveWriter)
@@ -0,0 +1,24 @@
+#ifndef TESTS_EXPORT_TEST_ARCHIVEWRITER_H
+#define TESTS_EXPORT_TEST_ARCHIVEWRITER_H
+
+#include <QtTest>
+
+namespace tests
+{
+    class TestArchiveWriter : public QObject
+    {
+        Q_OBJECT
+    public:
+        explicit TestArchiveWriter(QObject *p_parent = nullptr);
+
+    private slots:
+        // Small, empty and large files which are streamed from disk.
+        void testWrite();
+
+        void testNames();
+
+        void testUnfinished();
+    };
+} // ns tests
+
+#endif // TESTS_EXPORT_TEST_ARCHIVEWRITER_H
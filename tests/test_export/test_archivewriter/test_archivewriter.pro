@@ -0,0 +1,17 @@
+include($$PWD/../../common.pri)
+
+TARGET = test_archivewriter
+TEMPLATE = app
+
+SRC_FOLDER = $$PWD/../../../src
+EXPORT_FOLDER = $$SRC_FOLDER/export
+
+INCLUDEPATH *= $$SRC_FOLDER
+
+SOURCES += \
+    test_archivewriter.cpp \
+    $$EXPORT_FOLDER/archivewriter.cpp
+
+HEADERS += \
+    test_archivewriter.h \
+    $$EXPORT_FOLDER/archivewriter.h
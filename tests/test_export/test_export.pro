@@ -0,0 +1,6 @@
+TEMPLATE = subdirs
+
+SUBDIRS = \
+    test_markdownhtmlrenderer \
+    test_archivewriter \
+    test_exportmanifest
@@ -0,0 +1,96 @@
+#include "test_exportmanifest.h"
+
+#include <QTemporaryDir>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include <export/exportmanifest.h>
+
+using namespace tests;
+
+using namespace vnotex;
+
+static void touchFile(const QString &p_filePath)
+{
+    QFile file(p_filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("vnote");
+}
+
+TestExportManifest::TestExportManifest(QObject *p_parent)
+    : QObject(p_parent)
+{
+}
+
+void TestExportManifest::testGetAbsolutePath_data()
+{
+    QTest::addColumn<QString>("relativePath");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("file") << "a.html" << "/export/root/a.html";
+    QTest::newRow("sub") << "a_files/b.png" << "/export/root/a_files/b.png";
+    QTest::newRow("sub_dotdot") << "a_files/../b.html" << "/export/root/b.html";
+    QTest::newRow("empty") << "" << "";
+    QTest::newRow("dot") << "." << "";
+    QTest::newRow("root_by_dotdot") << "a_files/.." << "";
+    QTest::newRow("parent") << ".." << "";
+    QTest::newRow("grandparent") << "../.." << "";
+    QTest::newRow("sibling") << "../root2/a.html" << "";
+    QTest::newRow("escape_via_sub") << "a_files/../../a.html" << "";
+}
+
+void TestExportManifest::testGetAbsolutePath()
+{
+    QFETCH(QString, relativePath);
+    QFETCH(QString, expected);
+
+    ExportManifest manifest("/export/root");
+    QCOMPARE(manifest.getAbsolutePath(relativePath), expected);
+}
+
+void TestExportManifest::testRemoveOutputs()
+{
+    QTemporaryDir dir;
+    QDir topDir(dir.path());
+    QVERIFY(topDir.mkpath("root/a_files"));
+    const auto rootFolder = topDir.filePath("root");
+
+    touchFile(topDir.filePath("outside.html"));
+    touchFile(topDir.filePath("root/a.html"));
+    touchFile(topDir.filePath("root/a_files/b.png"));
+    touchFile(topDir.filePath("root/kept.html"));
+
+    QJsonObject entryObj;
+    entryObj["output_file"] = "a.html";
+    entryObj["outputs"] = QJsonArray::fromStringList({"a.html", "a_files", "../outside.html", "", ".", "..", "a_files/../.."});
+
+    QJsonObject files;
+    files["a.md"] = entryObj;
+
+    QJsonObject obj;
+    obj["option_hash"] = "hash";
+    obj["files"] = files;
+
+    {
+        QFile file(topDir.filePath("root/vx_export_manifest.json"));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(QJsonDocument(obj).toJson());
+    }
+
+    ExportManifest manifest(rootFolder);
+    manifest.load();
+    QCOMPARE(manifest.getEntries().size(), 1);
+
+    manifest.removeAllOutputs();
+    QVERIFY(manifest.getEntries().isEmpty());
+
+    QVERIFY(!QFileInfo::exists(topDir.filePath("root/a.html")));
+    QVERIFY(!QFileInfo::exists(topDir.filePath("root/a_files")));
+
+    QVERIFY(QFileInfo::exists(topDir.filePath("outside.html")));
+    QVERIFY(QFileInfo::exists(topDir.filePath("root/kept.html")));
+    QVERIFY(QFileInfo::exists(topDir.filePath("root/vx_export_manifest.json")));
+}
+
+QTEST_MAIN(tests::TestExportManifest)
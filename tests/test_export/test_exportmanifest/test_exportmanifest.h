@@ -0,0 +1,23 @@
+#ifndef TESTS_EXPORT_TEST_EXPORTMANIFEST_H
+#define TESTS_EXPORT_TEST_EXPORTMANIFEST_H
+
+#include <QtTest>
+
+namespace tests
+{
+    class TestExportManifest : public QObject
+    {
+        Q_OBJECT
+    public:
+        explicit TestExportManifest(QObject *p_parent = nullptr);
+
+    private slots:
+        void testGetAbsolutePath_data();
+        void testGetAbsolutePath();
+
+        // Outputs read from the manifest must not escape the output folder.
+        void testRemoveOutputs();
+    };
+} // ns tests
+
+#endif // TESTS_EXPORT_TEST_EXPORTMANIFEST_H
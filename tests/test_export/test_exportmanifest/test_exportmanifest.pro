@@ -0,0 +1,24 @@
+include($$PWD/../../common.pri)
+
+TARGET = test_exportmanifest
+TEMPLATE = app
+
+SRC_FOLDER = $$PWD/../../../src
+EXPORT_FOLDER = $$SRC_FOLDER/export
+UTILS_FOLDER = $$SRC_FOLDER/utils
+
+INCLUDEPATH *= $$SRC_FOLDER
+
+SOURCES += \
+    test_exportmanifest.cpp \
+    $$EXPORT_FOLDER/exportmanifest.cpp \
+    $$UTILS_FOLDER/utils.cpp \
+    $$UTILS_FOLDER/pathutils.cpp \
+    $$UTILS_FOLDER/fileutils.cpp
+
+HEADERS += \
+    test_exportmanifest.h \
+    $$EXPORT_FOLDER/exportmanifest.h \
+    $$UTILS_FOLDER/utils.h \
+    $$UTILS_FOLDER/pathutils.h \
+    $$UTILS_FOLDER/fileutils.h
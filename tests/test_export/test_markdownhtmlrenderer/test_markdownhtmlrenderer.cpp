@@ -0,0 +1,220 @@
+#include "test_markdownhtmlrenderer.h"
+
+#include <export/markdownhtmlrenderer.h>
+
+using namespace tests;
+
+using namespace vnotex;
+
+// Permalink appended to headings by markdown-it-anchor.
+static QString headerAnchor(const QString &p_id)
+{
+    return QStringLiteral("<a class=\"vx-header-anchor\" href=\"#%1\" vx-data-anchor-icon=\"%2\"></a>")
+             .arg(p_id, QString(QChar(0x00B6)));
+}
+
+TestMarkdownHtmlRenderer::TestMarkdownHtmlRenderer(QObject *p_parent)
+    : QObject(p_parent)
+{
+}
+
+void TestMarkdownHtmlRenderer::testRender_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QString>("html");
+
+    // Expected HTML is the output of markdown-it of the web side.
+    QTest::newRow("atx")
+        << QString("# Title\n"
+                   "\n"
+                   "## Sub *title*\n"
+                   "\n"
+                   "### Title\n")
+        << QString("<h1 id=\"title\">Title") + headerAnchor("title") + QString("</h1>\n")
+           + QString("<h2 id=\"sub-title\">Sub <em>title</em>") + headerAnchor("sub-title") + QString("</h2>\n")
+           + QString("<h3 id=\"title-1\">Title") + headerAnchor("title-1") + QString("</h3>\n");
+
+    QTest::newRow("setext")
+        << QString("Hello\n"
+                   "World\n"
+                   "=====\n"
+                   "\n"
+                   "Sub\n"
+                   "---\n")
+        << QString("<h1 id=\"helloworld\">Hello\nWorld") + headerAnchor("helloworld") + QString("</h1>\n")
+           + QString("<h2 id=\"sub\">Sub") + headerAnchor("sub") + QString("</h2>\n");
+
+    QTest::newRow("bullet")
+        << QString("- one\n"
+                   "- two\n"
+                   "  - nested\n"
+                   "- three\n")
+        << QString("<ul>\n"
+                   "<li>one</li>\n"
+                   "<li>two\n"
+                   "<ul>\n"
+                   "<li>nested</li>\n"
+                   "</ul>\n"
+                   "</li>\n"
+                   "<li>three</li>\n"
+                   "</ul>\n");
+
+    QTest::newRow("ordered")
+        << QString("3. a\n"
+                   "4. b\n"
+                   "\n"
+                   "5. c\n")
+        << QString("<ol start=\"3\">\n"
+                   "<li>\n"
+                   "<p>a</p>\n"
+                   "</li>\n"
+                   "<li>\n"
+                   "<p>b</p>\n"
+                   "</li>\n"
+                   "<li>\n"
+                   "<p>c</p>\n"
+                   "</li>\n"
+                   "</ol>\n");
+
+    QTest::newRow("task")
+        << QString("- [ ] todo\n"
+                   "- [x] done\n")
+        << QString("<ul class=\"contains-task-list\">\n"
+                   "<li class=\"task-list-item\"><input class=\"task-list-item-checkbox\" disabled=\"\" type=\"checkbox\"> todo</li>\n"
+                   "<li class=\"task-list-item\"><input class=\"task-list-item-checkbox\" checked=\"\" disabled=\"\" type=\"checkbox\"> done</li>\n"
+                   "</ul>\n");
+
+    QTest::newRow("table")
+        << QString("| Name | Left | Center | Right |\n"
+                   "| --- | :--- | :---: | ---: |\n"
+                   "| `a` | **b** | c | d |\n"
+                   "| e |\n")
+        << QString("<table>\n"
+                   "<thead>\n"
+                   "<tr>\n"
+                   "<th>Name</th>\n"
+                   "<th style=\"text-align:left\">Left</th>\n"
+                   "<th style=\"text-align:center\">Center</th>\n"
+                   "<th style=\"text-align:right\">Right</th>\n"
+                   "</tr>\n"
+                   "</thead>\n"
+                   "<tbody>\n"
+                   "<tr>\n"
+                   "<td><code>a</code></td>\n"
+                   "<td style=\"text-align:left\"><strong>b</strong></td>\n"
+                   "<td style=\"text-align:center\">c</td>\n"
+                   "<td style=\"text-align:right\">d</td>\n"
+                   "</tr>\n"
+                   "<tr>\n"
+                   "<td>e</td>\n"
+                   "<td style=\"text-align:left\"></td>\n"
+                   "<td style=\"text-align:center\"></td>\n"
+                   "<td style=\"text-align:right\"></td>\n"
+                   "</tr>\n"
+                   "</tbody>\n"
+                   "</table>\n");
+
+    QTest::newRow("fence")
+        << QString("```cpp\n"
+                   "int main() {\n"
+                   "    return a < b;\n"
+                   "}\n"
+                   "```\n")
+        << QString("<pre><code class=\"lang-cpp\">int main() {\n"
+                   "    return a &lt; b;\n"
+                   "}\n"
+                   "</code></pre>\n");
+
+    QTest::newRow("indented")
+        << QString("    code & more\n"
+                   "\n"
+                   "    again\n")
+        << QString("<pre><code>code &amp; more\n"
+                   "\n"
+                   "again\n"
+                   "</code></pre>\n");
+
+    QTest::newRow("autolink")
+        << QString("See <https://vnotex.github.io> and www.example.com or https://example.com/a?b=c.\n")
+        << QString("<p>See <a href=\"https://vnotex.github.io\">https://vnotex.github.io</a> and <a href=\"http://www.example.com\">www.example.com</a> or <a href=\"https://example.com/a?b=c\">https://example.com/a?b=c</a>.</p>\n");
+
+    QTest::newRow("htmlblock")
+        << QString("<div class=\"box\">\n"
+                   "*not emphasis*\n"
+                   "</div>\n"
+                   "\n"
+                   "Text with <span>inline</span> tag.\n")
+        << QString("<div class=\"box\">\n"
+                   "*not emphasis*\n"
+                   "</div>\n"
+                   "<p>Text with <span>inline</span> tag.</p>\n");
+
+    QTest::newRow("quote")
+        << QString("> quoted\n"
+                   "lazy\n"
+                   "\n"
+                   "> - item\n")
+        << QString("<blockquote>\n"
+                   "<p>quoted\n"
+                   "lazy</p>\n"
+                   "</blockquote>\n"
+                   "<blockquote>\n"
+                   "<ul>\n"
+                   "<li>item</li>\n"
+                   "</ul>\n"
+                   "</blockquote>\n");
+
+    QTest::newRow("inline")
+        << QString("**bold** _em_ ~~del~~ `code` [link](https://a.com \"T\") ![alt](img.png)\n"
+                   "\n"
+                   "![figure](fig.png)\n")
+        << QString("<p><strong>bold</strong> <em>em</em> <s>del</s> <code>code</code> <a href=\"https://a.com\" title=\"T\">link</a> <img src=\"img.png\" alt=\"alt\"></p>\n"
+                   "<figure><img src=\"fig.png\" alt=\"\"><figcaption>figure</figcaption></figure>\n");
+}
+
+void TestMarkdownHtmlRenderer::testRender()
+{
+    QFETCH(QString, text);
+    QFETCH(QString, html);
+
+    QVERIFY(MarkdownHtmlRenderer::isSupported(text));
+
+    MarkdownHtmlRenderer renderer(MarkdownHtmlRenderer::Options{});
+    QCOMPARE(renderer.render(text), html);
+}
+
+void TestMarkdownHtmlRenderer::testIsSupported_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<bool>("supported");
+
+    QTest::newRow("plain") << QString("# Title\n\ntext") << true;
+    QTest::newRow("strikethrough") << QString("~~del~~") << true;
+    QTest::newRow("table alignment") << QString("| a | b |\n| :---: | :-: |") << true;
+    QTest::newRow("code fence") << QString("```cpp\nint a;\n```") << true;
+
+    // Fall back to the web side.
+    QTest::newRow("front matter") << QString("---\ntitle: a\n---\n\ntext") << false;
+    QTest::newRow("inline math") << QString("Euler $e^{i\\pi}$") << false;
+    QTest::newRow("math environment") << QString("\\begin{equation}\na\n\\end{equation}") << false;
+    QTest::newRow("toc") << QString("[TOC]\n\n# Title") << false;
+    QTest::newRow("footnote") << QString("text[^1]\n\n[^1]: note") << false;
+    QTest::newRow("emoji") << QString("smile :smile:") << false;
+    QTest::newRow("subscript") << QString("H~2~O") << false;
+    QTest::newRow("superscript") << QString("2^10^") << false;
+    QTest::newRow("container") << QString("::: alert-info\ninfo\n:::") << false;
+    QTest::newRow("image size") << QString("![a](a.png =100x20)") << false;
+    QTest::newRow("mermaid") << QString("```mermaid\ngraph LR\n```") << false;
+    QTest::newRow("plantuml") << QString("```puml\n@startuml\n@enduml\n```") << false;
+    QTest::newRow("graphviz") << QString("~~~dot\ndigraph {}\n~~~") << false;
+}
+
+void TestMarkdownHtmlRenderer::testIsSupported()
+{
+    QFETCH(QString, text);
+    QFETCH(bool, supported);
+
+    QCOMPARE(MarkdownHtmlRenderer::isSupported(text), supported);
+}
+
+QTEST_MAIN(tests::TestMarkdownHtmlRenderer)
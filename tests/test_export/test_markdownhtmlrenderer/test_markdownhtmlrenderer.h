@@ -0,0 +1,25 @@
+#ifndef TESTS_EXPORT_TEST_MARKDOWNHTMLRENDERER_H
+#define TESTS_EXPORT_TEST_MARKDOWNHTMLRENDERER_H
+
+#include <QtTest>
+
+namespace tests
+{
+    // Compare the output of the native renderer with the one of the web side, which is
+    // markdown-it configured as MarkdownViewer without injected line numbers.
+    class TestMarkdownHtmlRenderer : public QObject
+    {
+        Q_OBJECT
+    public:
+        explicit TestMarkdownHtmlRenderer(QObject *p_parent = nullptr);
+
+    private slots:
+        void testRender_data();
+        void testRender();
+
+        void testIsSupported_data();
+        void testIsSupported();
+    };
+} // ns tests
+
+#endif // TESTS_EXPORT_TEST_MARKDOWNHTMLRENDERER_H
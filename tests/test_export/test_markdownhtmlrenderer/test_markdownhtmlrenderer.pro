@@ -0,0 +1,17 @@
+include($$PWD/../../common.pri)
+
+TARGET = test_markdownhtmlrenderer
+TEMPLATE = app
+
+SRC_FOLDER = $$PWD/../../../src
+EXPORT_FOLDER = $$SRC_FOLDER/export
+
+INCLUDEPATH *= $$SRC_FOLDER
+
+SOURCES += \
+    test_markdownhtmlrenderer.cpp \
+    $$EXPORT_FOLDER/markdownhtmlrenderer.cpp
+
+HEADERS += \
+    test_markdownhtmlrenderer.h \
+    $$EXPORT_FOLDER/markdownhtmlrenderer.h
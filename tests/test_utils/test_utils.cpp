@@ -7,6 +7,7 @@
 #include <utils/utils.h>
 #include <utils/pathutils.h>
 #include <utils/fileutils.h>
+#include <core/exception.h>
 
 using namespace tests;
 
@@ -291,4 +292,107 @@ void TestUtils::testIsText()
     }
 }
 
+static void writeTestFile(const QString &p_filePath, const QByteArray &p_data)
+{
+    QDir().mkpath(PathUtils::parentDirPath(p_filePath));
+    QFile file(p_filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(p_data), static_cast<qint64>(p_data.size()));
+}
+
+static QByteArray readTestFile(const QString &p_filePath)
+{
+    QFile file(p_filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+void TestUtils::testCopyFiles()
+{
+    QTemporaryDir dir;
+    const QString testFolderPath(dir.path());
+
+    // More files than copy threads, including empty ones and ones to nested folders.
+    QVector<QPair<QString, QString>> files;
+    for (int i = 0; i < 30; ++i) {
+        const auto srcFilePath = QString("%1/src/file%2").arg(testFolderPath).arg(i);
+        writeTestFile(srcFilePath, QByteArray(i * 1000, static_cast<char>('a' + i % 26)));
+        const auto destFilePath = QString("%1/dest/%2/file%3").arg(testFolderPath).arg(i % 3).arg(i);
+        files.push_back(qMakePair(srcFilePath, destFilePath));
+    }
+
+    FileUtils::copyFiles(files);
+
+    for (const auto &file : files) {
+        QVERIFY(QFileInfo::exists(file.second));
+        QCOMPARE(readTestFile(file.second), readTestFile(file.first));
+    }
+
+    // Nothing to copy.
+    FileUtils::copyFiles(QVector<QPair<QString, QString>>());
+}
+
+void TestUtils::testCopyFilesWithErrors()
+{
+    QTemporaryDir dir;
+    const QString testFolderPath(dir.path());
+
+    QVector<QPair<QString, QString>> files;
+    for (int i = 0; i < 10; ++i) {
+        const auto srcFilePath = QString("%1/src/file%2").arg(testFolderPath).arg(i);
+        // Every third source is missing.
+        if (i % 3 != 0) {
+            writeTestFile(srcFilePath, QByteArray::number(i));
+        }
+        files.push_back(qMakePair(srcFilePath, QString("%1/dest/file%2").arg(testFolderPath).arg(i)));
+    }
+
+    bool thrown = false;
+    try {
+        FileUtils::copyFiles(files);
+    } catch (Exception &p_e) {
+        thrown = true;
+        QVERIFY(p_e.m_type == Exception::Type::FailToCopyFile);
+
+        // All failures are reported at once.
+        const auto msg = QString::fromStdString(p_e.what());
+        QVERIFY(msg.contains("failed to copy 4 of 10 files"));
+        for (int i = 0; i < files.size(); i += 3) {
+            QVERIFY(msg.contains(files[i].first));
+        }
+    }
+    QVERIFY(thrown);
+
+    // The others are still copied.
+    for (int i = 0; i < files.size(); ++i) {
+        if (i % 3 == 0) {
+            QVERIFY(!QFileInfo::exists(files[i].second));
+        } else {
+            QCOMPARE(readTestFile(files[i].second), QByteArray::number(i));
+        }
+    }
+}
+
+void TestUtils::testCopyFilesFallback()
+{
+    QTemporaryDir dir;
+    const QString testFolderPath(dir.path());
+
+    const QString resourcePath(":/data/resource.txt");
+    const auto data = readTestFile(resourcePath);
+    QVERIFY(!data.isEmpty());
+
+    QVector<QPair<QString, QString>> files;
+    files.push_back(qMakePair(resourcePath, testFolderPath + "/resource.txt"));
+    files.push_back(qMakePair(resourcePath, testFolderPath + "/sub/resource.txt"));
+
+    FileUtils::copyFiles(files);
+
+    for (const auto &file : files) {
+        QCOMPARE(readTestFile(file.second), data);
+    }
+}
+
 QTEST_MAIN(tests::TestUtils)
@@ -42,6 +42,13 @@ namespace tests
 
         void testIsText();
 
+        void testCopyFiles();
+
+        void testCopyFilesWithErrors();
+
+        // Sources could not be copied in kernel, such as resource files.
+        void testCopyFilesFallback();
+
     private:
         QJsonObject m_obj;
     };
@@ -19,3 +19,6 @@ HEADERS += \
     $$UTILS_FOLDER/utils.h \
     $$UTILS_FOLDER/pathutils.h \
     $$UTILS_FOLDER/fileutils.h
+
+RESOURCES += \
+    test_utils.qrc
@@ -3,4 +3,5 @@ TEMPLATE = subdirs
 SUBDIRS = \
     test_utils \
     test_core \
-    test_task
+    test_task \
+    test_export